@@ -0,0 +1,590 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "EbsdArrayAllocator.h"
+
+#include <cstdlib>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryFile>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+// -----------------------------------------------------------------------------
+size_t roundUp(size_t value, size_t multiple)
+{
+  return ((value + multiple - 1) / multiple) * multiple;
+}
+
+// -----------------------------------------------------------------------------
+size_t validAlignment(size_t alignment)
+{
+  size_t valid = sizeof(void*);
+  while(valid < alignment)
+  {
+    valid *= 2;
+  }
+  return valid;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+EbsdArrayAllocator::EbsdArrayAllocator() = default;
+
+// -----------------------------------------------------------------------------
+EbsdArrayAllocator::~EbsdArrayAllocator() = default;
+
+// -----------------------------------------------------------------------------
+EbsdArrayAllocator::Pointer EbsdArrayAllocator::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdArrayAllocator::getNameOfClass() const
+{
+  return QString("EbsdArrayAllocator");
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdArrayAllocator::ClassName()
+{
+  return QString("EbsdArrayAllocator");
+}
+
+// -----------------------------------------------------------------------------
+bool EbsdArrayAllocator::providesZeroedMemory() const
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+EbsdArrayAllocator::Pointer EbsdArrayAllocator::getDerivedAllocator()
+{
+  return shared_from_this();
+}
+
+const size_t EbsdAlignedAllocator::k_DefaultAlignment;
+const size_t EbsdAlignedAllocator::k_HugePageSize;
+const size_t EbsdArenaAllocator::k_DefaultBlockSize;
+const size_t EbsdMappedFileAllocator::k_PageAlignment;
+
+// -----------------------------------------------------------------------------
+EbsdAlignedAllocator::EbsdAlignedAllocator(size_t alignment, bool useHugePages)
+: m_Alignment(validAlignment(alignment))
+, m_UseHugePages(useHugePages)
+{
+}
+
+// -----------------------------------------------------------------------------
+EbsdAlignedAllocator::~EbsdAlignedAllocator() = default;
+
+// -----------------------------------------------------------------------------
+EbsdAlignedAllocator::Pointer EbsdAlignedAllocator::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+EbsdAlignedAllocator::Pointer EbsdAlignedAllocator::New(size_t alignment, bool useHugePages)
+{
+  Pointer sharedPtr(new EbsdAlignedAllocator(alignment, useHugePages));
+  return sharedPtr;
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdAlignedAllocator::getNameOfClass() const
+{
+  return QString("EbsdAlignedAllocator");
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdAlignedAllocator::ClassName()
+{
+  return QString("EbsdAlignedAllocator");
+}
+
+// -----------------------------------------------------------------------------
+void EbsdAlignedAllocator::getBlockLayout(size_t numBytes, size_t& alignment, size_t& blockSize) const
+{
+  alignment = m_Alignment;
+  blockSize = roundUp(numBytes, m_Alignment);
+  if(m_UseHugePages && numBytes >= k_HugePageSize && alignment < k_HugePageSize)
+  {
+    alignment = k_HugePageSize;
+    blockSize = roundUp(numBytes, k_HugePageSize);
+  }
+}
+
+// -----------------------------------------------------------------------------
+void* EbsdAlignedAllocator::allocate(size_t numBytes)
+{
+  if(numBytes == 0)
+  {
+    return nullptr;
+  }
+  size_t alignment = 0;
+  size_t blockSize = 0;
+  getBlockLayout(numBytes, alignment, blockSize);
+
+  void* ptr = nullptr;
+#if defined(_MSC_VER)
+  ptr = _aligned_malloc(blockSize, alignment);
+#else
+  if(posix_memalign(&ptr, alignment, blockSize) != 0)
+  {
+    ptr = nullptr;
+  }
+#endif
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if(nullptr != ptr && alignment == k_HugePageSize)
+  {
+    // Only a hint, the block is still usable if the kernel does not support transparent huge pages
+    madvise(ptr, blockSize, MADV_HUGEPAGE);
+  }
+#endif
+  return ptr;
+}
+
+// -----------------------------------------------------------------------------
+void EbsdAlignedAllocator::deallocate(void* ptr, size_t numBytes)
+{
+  (void)numBytes;
+#if defined(_MSC_VER)
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+size_t EbsdAlignedAllocator::getAlignment() const
+{
+  return m_Alignment;
+}
+
+// -----------------------------------------------------------------------------
+bool EbsdAlignedAllocator::getUseHugePages() const
+{
+  return m_UseHugePages;
+}
+
+// -----------------------------------------------------------------------------
+EbsdArenaAllocator::EbsdArenaAllocator(size_t blockSize, size_t alignment, bool useHugePages)
+: m_BlockAllocator(EbsdAlignedAllocator::New(alignment, useHugePages))
+{
+  m_BlockSize = roundUp(blockSize > 0 ? blockSize : k_DefaultBlockSize, m_BlockAllocator->getAlignment());
+}
+
+// -----------------------------------------------------------------------------
+EbsdArenaAllocator::~EbsdArenaAllocator()
+{
+  for(auto& entry : m_Blocks)
+  {
+    m_BlockAllocator->deallocate(entry.second.data, entry.second.size);
+  }
+}
+
+// -----------------------------------------------------------------------------
+EbsdArenaAllocator::Pointer EbsdArenaAllocator::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+EbsdArenaAllocator::Pointer EbsdArenaAllocator::New(size_t blockSize, size_t alignment, bool useHugePages)
+{
+  Pointer sharedPtr(new EbsdArenaAllocator(blockSize, alignment, useHugePages));
+  return sharedPtr;
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdArenaAllocator::getNameOfClass() const
+{
+  return QString("EbsdArenaAllocator");
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdArenaAllocator::ClassName()
+{
+  return QString("EbsdArenaAllocator");
+}
+
+// -----------------------------------------------------------------------------
+void* EbsdArenaAllocator::allocate(size_t numBytes)
+{
+  if(numBytes == 0)
+  {
+    return nullptr;
+  }
+  size_t alignment = m_BlockAllocator->getAlignment();
+  size_t alignedBytes = roundUp(numBytes, alignment);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  // Large requests get a block of their own so they do not waste the rest of the current block
+  if(alignedBytes > m_BlockSize / 2)
+  {
+    auto data = static_cast<uint8_t*>(m_BlockAllocator->allocate(alignedBytes));
+    if(nullptr == data)
+    {
+      return nullptr;
+    }
+    Block& block = m_Blocks[reinterpret_cast<uintptr_t>(data)];
+    block.data = data;
+    block.size = alignedBytes;
+    block.used = alignedBytes;
+    block.liveAllocations = 1;
+    return data;
+  }
+
+  auto current = m_Blocks.find(m_CurrentBlock);
+  if(current == m_Blocks.end() || current->second.used + alignedBytes > current->second.size)
+  {
+    // Retire the current block. It is freed right away if nothing lives in it anymore
+    if(current != m_Blocks.end() && current->second.liveAllocations == 0)
+    {
+      m_BlockAllocator->deallocate(current->second.data, current->second.size);
+      m_Blocks.erase(current);
+    }
+    m_CurrentBlock = 0;
+
+    auto data = static_cast<uint8_t*>(m_BlockAllocator->allocate(m_BlockSize));
+    if(nullptr == data)
+    {
+      return nullptr;
+    }
+    m_CurrentBlock = reinterpret_cast<uintptr_t>(data);
+    current = m_Blocks.emplace(m_CurrentBlock, Block()).first;
+    current->second.data = data;
+    current->second.size = m_BlockSize;
+  }
+
+  Block& block = current->second;
+  uint8_t* ptr = block.data + block.used;
+  block.used += alignedBytes;
+  block.liveAllocations++;
+  return ptr;
+}
+
+// -----------------------------------------------------------------------------
+void EbsdArenaAllocator::deallocate(void* ptr, size_t numBytes)
+{
+  (void)numBytes;
+  if(nullptr == ptr)
+  {
+    return;
+  }
+  auto address = reinterpret_cast<uintptr_t>(ptr);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto iter = m_Blocks.upper_bound(address);
+  if(iter == m_Blocks.begin())
+  {
+    return;
+  }
+  --iter;
+  Block& block = iter->second;
+  if(address >= iter->first + block.size || block.liveAllocations == 0)
+  {
+    return;
+  }
+  block.liveAllocations--;
+  if(block.liveAllocations > 0)
+  {
+    return;
+  }
+  if(iter->first == m_CurrentBlock)
+  {
+    // Nothing lives in the current block anymore so it can be filled again from the start
+    block.used = 0;
+    return;
+  }
+  m_BlockAllocator->deallocate(block.data, block.size);
+  m_Blocks.erase(iter);
+}
+
+// -----------------------------------------------------------------------------
+size_t EbsdArenaAllocator::getAlignment() const
+{
+  return m_BlockAllocator->getAlignment();
+}
+
+// -----------------------------------------------------------------------------
+size_t EbsdArenaAllocator::getBlockSize() const
+{
+  return m_BlockSize;
+}
+
+// -----------------------------------------------------------------------------
+size_t EbsdArenaAllocator::getNumberOfBlocks() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Blocks.size();
+}
+
+// -----------------------------------------------------------------------------
+size_t EbsdArenaAllocator::getReservedBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  size_t bytes = 0;
+  for(const auto& entry : m_Blocks)
+  {
+    bytes += entry.second.size;
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+EbsdMappedFileAllocator::EbsdMappedFileAllocator(FileMode mode, const QString& path)
+: m_FileMode(mode)
+, m_Path(path)
+{
+  if(m_FileMode == FileMode::Temporary && m_Path.isEmpty())
+  {
+    m_Path = QDir::tempPath();
+  }
+}
+
+// -----------------------------------------------------------------------------
+EbsdMappedFileAllocator::~EbsdMappedFileAllocator()
+{
+  for(auto& entry : m_Mappings)
+  {
+    entry.second.file->unmap(reinterpret_cast<uchar*>(entry.first));
+  }
+}
+
+// -----------------------------------------------------------------------------
+EbsdMappedFileAllocator::Pointer EbsdMappedFileAllocator::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+EbsdMappedFileAllocator::Pointer EbsdMappedFileAllocator::New(FileMode mode, const QString& path)
+{
+  Pointer sharedPtr(new EbsdMappedFileAllocator(mode, path));
+  return sharedPtr;
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdMappedFileAllocator::getNameOfClass() const
+{
+  return QString("EbsdMappedFileAllocator");
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdMappedFileAllocator::ClassName()
+{
+  return QString("EbsdMappedFileAllocator");
+}
+
+// -----------------------------------------------------------------------------
+bool EbsdMappedFileAllocator::isMapped(const QString& filePath) const
+{
+  for(const auto& entry : m_Mappings)
+  {
+    if(entry.second.filePath == filePath)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+void* EbsdMappedFileAllocator::allocate(size_t numBytes)
+{
+  if(numBytes == 0)
+  {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  std::unique_ptr<QFile> file;
+  if(m_FileMode == FileMode::Temporary)
+  {
+    auto tempFile = new QTemporaryFile(m_Path + "/EbsdLib_XXXXXX.tmp");
+    file.reset(tempFile);
+    if(!tempFile->open())
+    {
+      return nullptr;
+    }
+  }
+  else
+  {
+    QString filePath = m_Path;
+    if(isMapped(filePath))
+    {
+      // The array is being resized. The new memory replaces the file once the old memory is released
+      filePath = m_Path + ".resize";
+      if(isMapped(filePath))
+      {
+        return nullptr;
+      }
+      QFile::remove(filePath);
+    }
+    file.reset(new QFile(filePath));
+    if(!file->open(QIODevice::ReadWrite))
+    {
+      return nullptr;
+    }
+  }
+
+  // Growing the file does not write anything, the new part reads as zero
+  if(!file->resize(static_cast<qint64>(numBytes)))
+  {
+    return nullptr;
+  }
+  uchar* ptr = file->map(0, static_cast<qint64>(numBytes));
+  if(nullptr == ptr)
+  {
+    return nullptr;
+  }
+  Mapping& mapping = m_Mappings[reinterpret_cast<uintptr_t>(ptr)];
+  mapping.filePath = file->fileName();
+  mapping.file = std::move(file);
+  return ptr;
+}
+
+// -----------------------------------------------------------------------------
+void EbsdMappedFileAllocator::deallocate(void* ptr, size_t numBytes)
+{
+  (void)numBytes;
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto iter = m_Mappings.find(reinterpret_cast<uintptr_t>(ptr));
+  if(iter == m_Mappings.end())
+  {
+    return;
+  }
+  QString filePath = iter->second.filePath;
+  iter->second.file->unmap(static_cast<uchar*>(ptr));
+  iter->second.file->close();
+  // Destroying a QTemporaryFile removes the file
+  m_Mappings.erase(iter);
+
+  if(m_FileMode == FileMode::Persistent && filePath == m_Path)
+  {
+    QString resizePath = m_Path + ".resize";
+    for(auto& entry : m_Mappings)
+    {
+      if(entry.second.filePath != resizePath)
+      {
+        continue;
+      }
+      // The resized memory stays mapped so its address does not change. Some systems (Windows) refuse to
+      // rename a mapped file, the old file is only removed once the resized file has taken its name.
+      QString oldPath = m_Path + ".old";
+      QFile::remove(oldPath);
+      if(!QFile::rename(m_Path, oldPath))
+      {
+        qDebug() << "EbsdMappedFileAllocator: Unable to replace " << m_Path << " with " << resizePath << ". The values are kept in " << resizePath;
+        break;
+      }
+      if(!QFile::rename(resizePath, m_Path))
+      {
+        QFile::rename(oldPath, m_Path);
+        qDebug() << "EbsdMappedFileAllocator: Unable to rename " << resizePath << " to " << m_Path << ". The values are kept in " << resizePath;
+        break;
+      }
+      QFile::remove(oldPath);
+      entry.second.filePath = m_Path;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+size_t EbsdMappedFileAllocator::getAlignment() const
+{
+  return k_PageAlignment;
+}
+
+// -----------------------------------------------------------------------------
+bool EbsdMappedFileAllocator::providesZeroedMemory() const
+{
+  // A persistent file keeps the values that it already holds
+  return m_FileMode == FileMode::Temporary;
+}
+
+// -----------------------------------------------------------------------------
+EbsdArrayAllocator::Pointer EbsdMappedFileAllocator::getDerivedAllocator()
+{
+  if(m_FileMode == FileMode::Temporary)
+  {
+    return shared_from_this();
+  }
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if(nullptr == m_DerivedAllocator)
+  {
+    m_DerivedAllocator = New(FileMode::Temporary, QFileInfo(m_Path).absolutePath());
+  }
+  return m_DerivedAllocator;
+}
+
+// -----------------------------------------------------------------------------
+EbsdMappedFileAllocator::FileMode EbsdMappedFileAllocator::getFileMode() const
+{
+  return m_FileMode;
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdMappedFileAllocator::getPath() const
+{
+  return m_Path;
+}
+
+// -----------------------------------------------------------------------------
+QString EbsdMappedFileAllocator::getMappedFilePath(const void* ptr) const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto iter = m_Mappings.find(reinterpret_cast<uintptr_t>(ptr));
+  if(iter == m_Mappings.end())
+  {
+    return QString();
+  }
+  return iter->second.filePath;
+}
@@ -0,0 +1,374 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include "EbsdLib/EbsdLib.h"
+
+/**
+ * @class EbsdArrayAllocator EbsdArrayAllocator.h EbsdLib/Core/EbsdArrayAllocator.h
+ * @brief Interface for the objects that provide the memory of an EbsdDataArray. An allocator hands out
+ * raw, uninitialized memory. The EbsdDataArray decides if the memory gets initialized or not.
+ *
+ * Implementations must be thread safe because a single allocator can be shared between arrays that
+ * are filled on different threads.
+ */
+class EbsdLib_EXPORT EbsdArrayAllocator : public std::enable_shared_from_this<EbsdArrayAllocator>
+{
+public:
+  using Self = EbsdArrayAllocator;
+  using Pointer = std::shared_ptr<Self>;
+  using ConstPointer = std::shared_ptr<const Self>;
+  using WeakPointer = std::weak_ptr<Self>;
+  using ConstWeakPointer = std::weak_ptr<const Self>;
+  static Pointer NullPointer();
+
+  virtual ~EbsdArrayAllocator();
+
+  /**
+   * @brief Returns the name of the class for EbsdArrayAllocator
+   */
+  virtual QString getNameOfClass() const;
+  /**
+   * @brief Returns the name of the class for EbsdArrayAllocator
+   */
+  static QString ClassName();
+
+  /**
+   * @brief Allocates numBytes of uninitialized memory.
+   * @param numBytes
+   * @return The memory or nullptr if the memory could not be allocated.
+   */
+  virtual void* allocate(size_t numBytes) = 0;
+
+  /**
+   * @brief Returns memory that was handed out by allocate() of the same allocator.
+   * @param ptr
+   * @param numBytes The value that was given to allocate()
+   */
+  virtual void deallocate(void* ptr, size_t numBytes) = 0;
+
+  /**
+   * @brief Returns the alignment in bytes of every block that is handed out by allocate()
+   */
+  virtual size_t getAlignment() const = 0;
+
+  /**
+   * @brief Returns true if the memory handed out by allocate() always reads as zero. An EbsdDataArray
+   * then skips writing zeros into newly allocated memory.
+   */
+  virtual bool providesZeroedMemory() const;
+
+  /**
+   * @brief Returns the allocator for arrays that are derived from an array of this allocator, e.g. by
+   * EbsdDataArray<T>::deepCopy() or createNewArray(). The default returns this allocator.
+   */
+  virtual Pointer getDerivedAllocator();
+
+protected:
+  EbsdArrayAllocator();
+
+public:
+  EbsdArrayAllocator(const EbsdArrayAllocator&) = delete;            // Copy Constructor Not Implemented
+  EbsdArrayAllocator(EbsdArrayAllocator&&) = delete;                 // Move Constructor Not Implemented
+  EbsdArrayAllocator& operator=(const EbsdArrayAllocator&) = delete; // Copy Assignment Not Implemented
+  EbsdArrayAllocator& operator=(EbsdArrayAllocator&&) = delete;      // Move Assignment Not Implemented
+};
+
+/**
+ * @class EbsdAlignedAllocator EbsdArrayAllocator.h EbsdLib/Core/EbsdArrayAllocator.h
+ * @brief Allocates aligned blocks from the heap. The default alignment of 64 bytes is one cache line and
+ * the width of an AVX-512 register, so vectorized loops never need a peeling iteration.
+ *
+ * When huge pages are requested, blocks of at least 2 MB are aligned to 2 MB and on Linux the kernel
+ * is advised to back them with transparent huge pages. This cuts the page faults and TLB misses when
+ * arrays of several GB are filled. On other platforms the blocks are only aligned.
+ */
+class EbsdLib_EXPORT EbsdAlignedAllocator : public EbsdArrayAllocator
+{
+public:
+  using Self = EbsdAlignedAllocator;
+  using Pointer = std::shared_ptr<Self>;
+  using ConstPointer = std::shared_ptr<const Self>;
+  using WeakPointer = std::weak_ptr<Self>;
+  using ConstWeakPointer = std::weak_ptr<const Self>;
+  static Pointer NullPointer();
+
+  static const size_t k_DefaultAlignment = 64;
+  static const size_t k_HugePageSize = 2 * 1024 * 1024;
+
+  /**
+   * @brief Creates a new allocator
+   * @param alignment The alignment in bytes. It is rounded up to a power of two of at least sizeof(void*)
+   * @param useHugePages Back large blocks with huge pages
+   */
+  static Pointer New(size_t alignment = k_DefaultAlignment, bool useHugePages = false);
+
+  ~EbsdAlignedAllocator() override;
+
+  /**
+   * @brief Returns the name of the class for EbsdAlignedAllocator
+   */
+  QString getNameOfClass() const override;
+  /**
+   * @brief Returns the name of the class for EbsdAlignedAllocator
+   */
+  static QString ClassName();
+
+  void* allocate(size_t numBytes) override;
+  void deallocate(void* ptr, size_t numBytes) override;
+  size_t getAlignment() const override;
+
+  /**
+   * @brief Returns if blocks of at least k_HugePageSize bytes are backed by huge pages
+   */
+  bool getUseHugePages() const;
+
+protected:
+  EbsdAlignedAllocator(size_t alignment, bool useHugePages);
+
+  /**
+   * @brief Returns the alignment and the rounded up size that are used for a block of numBytes
+   */
+  void getBlockLayout(size_t numBytes, size_t& alignment, size_t& blockSize) const;
+
+private:
+  size_t m_Alignment = k_DefaultAlignment;
+  bool m_UseHugePages = false;
+
+public:
+  EbsdAlignedAllocator(const EbsdAlignedAllocator&) = delete;            // Copy Constructor Not Implemented
+  EbsdAlignedAllocator(EbsdAlignedAllocator&&) = delete;                 // Move Constructor Not Implemented
+  EbsdAlignedAllocator& operator=(const EbsdAlignedAllocator&) = delete; // Copy Assignment Not Implemented
+  EbsdAlignedAllocator& operator=(EbsdAlignedAllocator&&) = delete;      // Move Assignment Not Implemented
+};
+
+/**
+ * @class EbsdArenaAllocator EbsdArrayAllocator.h EbsdLib/Core/EbsdArrayAllocator.h
+ * @brief Hands out memory from large aligned blocks by bumping an offset. This makes creating many
+ * small or medium arrays, e.g. the columns of every slice of a volume, almost free. A block is returned
+ * to the system once every array that lives in it is gone. Requests larger than half a block get a block
+ * of their own.
+ *
+ * The blocks come from an EbsdAlignedAllocator so the arena supports the same alignment and huge page
+ * options.
+ */
+class EbsdLib_EXPORT EbsdArenaAllocator : public EbsdArrayAllocator
+{
+public:
+  using Self = EbsdArenaAllocator;
+  using Pointer = std::shared_ptr<Self>;
+  using ConstPointer = std::shared_ptr<const Self>;
+  using WeakPointer = std::weak_ptr<Self>;
+  using ConstWeakPointer = std::weak_ptr<const Self>;
+  static Pointer NullPointer();
+
+  static const size_t k_DefaultBlockSize = 64 * 1024 * 1024;
+
+  /**
+   * @brief Creates a new arena
+   * @param blockSize The size in bytes of each block
+   * @param alignment The alignment of every array in the arena
+   * @param useHugePages Back the blocks with huge pages
+   */
+  static Pointer New(size_t blockSize = k_DefaultBlockSize, size_t alignment = EbsdAlignedAllocator::k_DefaultAlignment, bool useHugePages = false);
+
+  ~EbsdArenaAllocator() override;
+
+  /**
+   * @brief Returns the name of the class for EbsdArenaAllocator
+   */
+  QString getNameOfClass() const override;
+  /**
+   * @brief Returns the name of the class for EbsdArenaAllocator
+   */
+  static QString ClassName();
+
+  void* allocate(size_t numBytes) override;
+  void deallocate(void* ptr, size_t numBytes) override;
+  size_t getAlignment() const override;
+
+  /**
+   * @brief Returns the block size of the arena
+   */
+  size_t getBlockSize() const;
+
+  /**
+   * @brief Returns the number of blocks that are currently held by the arena
+   */
+  size_t getNumberOfBlocks() const;
+
+  /**
+   * @brief Returns the number of bytes that are currently held by the arena
+   */
+  size_t getReservedBytes() const;
+
+protected:
+  EbsdArenaAllocator(size_t blockSize, size_t alignment, bool useHugePages);
+
+private:
+  struct Block
+  {
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t used = 0;
+    size_t liveAllocations = 0;
+  };
+
+  EbsdAlignedAllocator::Pointer m_BlockAllocator;
+  size_t m_BlockSize = k_DefaultBlockSize;
+  // Keyed by the start address of each block so the owner of a pointer is found with upper_bound()
+  std::map<uintptr_t, Block> m_Blocks;
+  uintptr_t m_CurrentBlock = 0;
+  mutable std::mutex m_Mutex;
+
+public:
+  EbsdArenaAllocator(const EbsdArenaAllocator&) = delete;            // Copy Constructor Not Implemented
+  EbsdArenaAllocator(EbsdArenaAllocator&&) = delete;                 // Move Constructor Not Implemented
+  EbsdArenaAllocator& operator=(const EbsdArenaAllocator&) = delete; // Copy Assignment Not Implemented
+  EbsdArenaAllocator& operator=(EbsdArenaAllocator&&) = delete;      // Move Assignment Not Implemented
+};
+
+/**
+ * @class EbsdMappedFileAllocator EbsdArrayAllocator.h EbsdLib/Core/EbsdArrayAllocator.h
+ * @brief Backs every allocation with a memory mapped file so an array can be larger than the physical
+ * memory. The operating system pages the values in and out as they are used, the array itself works
+ * exactly like an array on the heap.
+ *
+ * In Temporary mode each allocation gets its own temporary file in the given directory (the system
+ * temporary directory by default). The file is removed when the memory is deallocated and new memory
+ * reads as zero.
+ *
+ * In Persistent mode the memory is mapped from a single file that is kept after the array is gone. The
+ * values of an existing file are kept so a volume can be opened again with
+ * EbsdDataArray<T>::CreateFileBackedArray(). Only one array can use the file. While that array is
+ * resized its new memory is mapped from "<file>.resize", which replaces the file once the old memory is
+ * released. If the system does not allow the mapped "<file>.resize" to be renamed the file is left in
+ * place, the values are then kept in "<file>.resize" and getMappedFilePath() returns that path. Arrays
+ * derived from a persistent array use temporary files in the directory of the file.
+ */
+class EbsdLib_EXPORT EbsdMappedFileAllocator : public EbsdArrayAllocator
+{
+public:
+  using Self = EbsdMappedFileAllocator;
+  using Pointer = std::shared_ptr<Self>;
+  using ConstPointer = std::shared_ptr<const Self>;
+  using WeakPointer = std::weak_ptr<Self>;
+  using ConstWeakPointer = std::weak_ptr<const Self>;
+  static Pointer NullPointer();
+
+  enum class FileMode : int
+  {
+    Temporary = 0,
+    Persistent = 1
+  };
+
+  static const size_t k_PageAlignment = 4096;
+
+  /**
+   * @brief Creates a new allocator
+   * @param mode Temporary or persistent files
+   * @param path The directory of the temporary files or the path of the persistent file
+   */
+  static Pointer New(FileMode mode = FileMode::Temporary, const QString& path = QString());
+
+  ~EbsdMappedFileAllocator() override;
+
+  /**
+   * @brief Returns the name of the class for EbsdMappedFileAllocator
+   */
+  QString getNameOfClass() const override;
+  /**
+   * @brief Returns the name of the class for EbsdMappedFileAllocator
+   */
+  static QString ClassName();
+
+  void* allocate(size_t numBytes) override;
+  void deallocate(void* ptr, size_t numBytes) override;
+  size_t getAlignment() const override;
+  bool providesZeroedMemory() const override;
+  EbsdArrayAllocator::Pointer getDerivedAllocator() override;
+
+  /**
+   * @brief Returns the file mode of the allocator
+   */
+  FileMode getFileMode() const;
+
+  /**
+   * @brief Returns the directory of the temporary files or the path of the persistent file
+   */
+  QString getPath() const;
+
+  /**
+   * @brief Returns the path of the file that backs the memory at ptr or an empty string if ptr was not
+   * allocated by this allocator
+   */
+  QString getMappedFilePath(const void* ptr) const;
+
+protected:
+  EbsdMappedFileAllocator(FileMode mode, const QString& path);
+
+  /**
+   * @brief Returns true if the file at filePath currently backs memory of this allocator
+   */
+  bool isMapped(const QString& filePath) const;
+
+private:
+  struct Mapping
+  {
+    std::unique_ptr<QFile> file;
+    QString filePath;
+  };
+
+  FileMode m_FileMode = FileMode::Temporary;
+  QString m_Path;
+  std::map<uintptr_t, Mapping> m_Mappings;
+  EbsdArrayAllocator::Pointer m_DerivedAllocator;
+  mutable std::mutex m_Mutex;
+
+public:
+  EbsdMappedFileAllocator(const EbsdMappedFileAllocator&) = delete;            // Copy Constructor Not Implemented
+  EbsdMappedFileAllocator(EbsdMappedFileAllocator&&) = delete;                 // Move Constructor Not Implemented
+  EbsdMappedFileAllocator& operator=(const EbsdMappedFileAllocator&) = delete; // Copy Assignment Not Implemented
+  EbsdMappedFileAllocator& operator=(EbsdMappedFileAllocator&&) = delete;      // Move Assignment Not Implemented
+};
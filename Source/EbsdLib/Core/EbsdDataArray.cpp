@@ -89,6 +89,7 @@
 #define EBSDLIB_ENDIAN_INTRINSIC_MSG "no byte swap intrinsics"
 #endif // EBSDLIB_ENDIAN_NO_INTRINSICS
 
+#include <algorithm>
 #include <string>
 #include <cstring>
 #include <functional>
@@ -212,7 +213,8 @@ typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::CreateArray(size_t numTuple
   }
   comp_dims_type cDims = {1};
   auto d = new EbsdDataArray<T>(numTuples, name, cDims, static_cast<T>(0), allocate);
-  if(allocate)
+  // The constructor has already allocated and initialized the memory when allocate is true
+  if(allocate && !d->isAllocated())
   {
     if(d->allocate() < 0)
     {
@@ -239,7 +241,8 @@ typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::CreateArray(size_t numTuple
     cDims[i] = dims[i];
   }
   auto d = new EbsdDataArray<T>(numTuples, name, cDims, static_cast<T>(0), allocate);
-  if(allocate)
+  // The constructor has already allocated and initialized the memory when allocate is true
+  if(allocate && !d->isAllocated())
   {
     if(d->allocate() < 0)
     {
@@ -261,7 +264,8 @@ typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::CreateArray(size_t numTuple
     return NullPointer();
   }
   EbsdDataArray<T>* d = new EbsdDataArray<T>(numTuples, name, compDims, static_cast<T>(0), allocate);
-  if(allocate)
+  // The constructor has already allocated and initialized the memory when allocate is true
+  if(allocate && !d->isAllocated())
   {
     if(d->allocate() < 0)
     {
@@ -286,7 +290,8 @@ typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::CreateArray(const comp_dims
   size_t numTuples = std::accumulate(tupleDims.begin(), tupleDims.end(), static_cast<size_t>(1), std::multiplies<>());
 
   auto d = new EbsdDataArray<T>(numTuples, name, compDims, static_cast<T>(0), allocate);
-  if(allocate)
+  // The constructor has already allocated and initialized the memory when allocate is true
+  if(allocate && !d->isAllocated())
   {
     if(d->allocate() < 0)
     {
@@ -299,17 +304,66 @@ typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::CreateArray(const comp_dims
   return ptr;
 }
 
+// -----------------------------------------------------------------------------
+template <typename T>
+typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::CreateUninitializedArray(size_t numTuples, const comp_dims_type& compDims, const QString& name, const EbsdArrayAllocator::Pointer& allocator)
+{
+  if(name.isEmpty())
+  {
+    return NullPointer();
+  }
+  Pointer ptr(new EbsdDataArray<T>(numTuples, name, compDims, static_cast<T>(0), false));
+  ptr->m_Allocator = allocator;
+  if(ptr->allocateArray(false) < 0)
+  {
+    return NullPointer();
+  }
+  return ptr;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::CreateFileBackedArray(size_t numTuples, const comp_dims_type& compDims, const QString& name, const QString& filePath)
+{
+  EbsdMappedFileAllocator::Pointer allocator;
+  if(filePath.isEmpty())
+  {
+    allocator = EbsdMappedFileAllocator::New(EbsdMappedFileAllocator::FileMode::Temporary);
+  }
+  else
+  {
+    allocator = EbsdMappedFileAllocator::New(EbsdMappedFileAllocator::FileMode::Persistent, filePath);
+  }
+  return CreateUninitializedArray(numTuples, compDims, name, allocator);
+}
+
 template <typename T>
 typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::createNewArray(size_t numTuples, int rank, const size_t* compDims, const QString& name, bool allocate) const
 {
-  EbsdDataArray<T>::Pointer p = EbsdDataArray<T>::CreateArray(numTuples, rank, compDims, name, allocate);
-  return p;
+  comp_dims_type cDims(compDims, compDims + rank);
+  return createNewArray(numTuples, cDims, name, allocate);
 }
 
 template <typename T>
 typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::createNewArray(size_t numTuples, const comp_dims_type& compDims, const QString& name, bool allocate) const
 {
-  EbsdDataArray<T>::Pointer p = EbsdDataArray<T>::CreateArray(numTuples, compDims, name, allocate);
+  if(nullptr == m_Allocator)
+  {
+    EbsdDataArray<T>::Pointer p = EbsdDataArray<T>::CreateArray(numTuples, compDims, name, allocate);
+    return p;
+  }
+  // The new array is stored the same way as this array, e.g. in a memory mapped file
+  EbsdDataArray<T>::Pointer p = EbsdDataArray<T>::CreateArray(numTuples, compDims, name, false);
+  if(nullptr == p)
+  {
+    return p;
+  }
+  p->m_Allocator = m_Allocator->getDerivedAllocator();
+  p->m_InitializeOnAllocate = m_InitializeOnAllocate;
+  if(allocate && p->allocateArray(true) < 0)
+  {
+    return NullPointer();
+  }
   return p;
 }
 
@@ -420,9 +474,20 @@ typename EbsdDataArray<T>::Pointer EbsdDataArray<T>::deepCopy(bool forceNoAlloca
   {
     allocate = false;
   }
-  EbsdDataArray<T>::Pointer daCopy = createNewArray(getNumberOfTuples(), getComponentDimensions(), getName(), allocate);
-  if(m_IsAllocated && !forceNoAllocate)
+  // createNewArray() hands the allocator of this array on to the copy
+  EbsdDataArray<T>::Pointer daCopy = createNewArray(getNumberOfTuples(), getComponentDimensions(), getName(), false);
+  if(nullptr == daCopy)
   {
+    return daCopy;
+  }
+  daCopy->m_InitializeOnAllocate = m_InitializeOnAllocate;
+  if(allocate)
+  {
+    // Every value is overwritten by the copy so the memory is not initialized first
+    if(daCopy->allocateArray(false) < 0)
+    {
+      return NullPointer();
+    }
     T* src = getPointer(0);
     void* dest = daCopy->getVoidPointer(0);
     size_t totalBytes = (getNumberOfTuples() * static_cast<size_t>(getNumberOfComponents()) * sizeof(T));
@@ -653,15 +718,78 @@ void EbsdDataArray<T>::releaseOwnership()
   m_OwnsData = false;
 }
 
+// -----------------------------------------------------------------------------
+template <typename T>
+void EbsdDataArray<T>::setAllocator(const EbsdArrayAllocator::Pointer& allocator)
+{
+  m_Allocator = allocator;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+EbsdArrayAllocator::Pointer EbsdDataArray<T>::getAllocator() const
+{
+  return m_Allocator;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+EbsdArrayAllocator::Pointer EbsdDataArray<T>::getArrayAllocator() const
+{
+  return m_ArrayAllocator;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void EbsdDataArray<T>::setInitializeOnAllocate(bool value)
+{
+  m_InitializeOnAllocate = value;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+bool EbsdDataArray<T>::getInitializeOnAllocate() const
+{
+  return m_InitializeOnAllocate;
+}
+
 // -----------------------------------------------------------------------------
 template <typename T>
 int32_t EbsdDataArray<T>::allocate()
+{
+  return allocateArray(m_InitializeOnAllocate);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+T* EbsdDataArray<T>::allocateElements(size_t numElements, bool initialize) const
+{
+  if(nullptr == m_Allocator)
+  {
+    if(initialize)
+    {
+      return new T[numElements]();
+    }
+    return new T[numElements];
+  }
+  auto ptr = static_cast<T*>(m_Allocator->allocate(numElements * sizeof(T)));
+  if(nullptr != ptr && initialize && !m_Allocator->providesZeroedMemory())
+  {
+    std::fill_n(ptr, numElements, T());
+  }
+  return ptr;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+int32_t EbsdDataArray<T>::allocateArray(bool initialize)
 {
   if((nullptr != m_Array) && (true == m_OwnsData))
   {
     deallocate();
   }
   m_Array = nullptr;
+  m_ArrayAllocator = nullptr;
   m_OwnsData = true;
   m_IsAllocated = false;
   if(m_Size == 0)
@@ -671,12 +799,13 @@ int32_t EbsdDataArray<T>::allocate()
   }
 
   size_t newSize = m_Size;
-  m_Array = new T[newSize]();
+  m_Array = allocateElements(newSize, initialize);
   if(!m_Array)
   {
     qDebug() << "Unable to allocate " << newSize << " elements of size " << sizeof(T) << " bytes. ";
     return -1;
   }
+  m_ArrayAllocator = m_Allocator;
   m_Size = newSize;
   m_IsAllocated = true;
 
@@ -741,7 +870,12 @@ int EbsdDataArray<T>::eraseTuples(comp_dims_type& idxs)
   size_t newSize = (getNumberOfTuples() - idxs.size()) * m_NumComponents;
 
   // Create a new m_Array to copy into
-  T* newArray = new T[newSize]();
+  T* newArray = allocateElements(newSize, false);
+  if(nullptr == newArray)
+  {
+    qDebug() << "Unable to allocate " << newSize << " elements of size " << sizeof(T) << " bytes. ";
+    return -101;
+  }
 
   // Splat AB across the array so we know if we are copying the values or not
   ::memset(newArray, 0xAB, newSize * sizeof(T));
@@ -771,6 +905,7 @@ int EbsdDataArray<T>::eraseTuples(comp_dims_type& idxs)
     deallocate(); // We are done copying - delete the current m_Array
     m_Size = newSize;
     m_Array = newArray;
+    m_ArrayAllocator = m_Allocator;
     m_OwnsData = true;
     m_MaxId = newSize - 1;
     m_IsAllocated = true;
@@ -814,6 +949,7 @@ int EbsdDataArray<T>::eraseTuples(comp_dims_type& idxs)
   // Allocation was successful.  Save it.
   m_Size = newSize;
   m_Array = newArray;
+  m_ArrayAllocator = m_Allocator;
   // This object has now allocated its memory and owns it.
   m_OwnsData = true;
   m_IsAllocated = true;
@@ -1591,6 +1727,7 @@ void EbsdDataArray<T>::clear()
     deallocate();
   }
   m_Array = nullptr;
+  m_ArrayAllocator = nullptr;
   m_Size = 0;
   m_OwnsData = true;
   m_MaxId = 0;
@@ -1606,8 +1743,14 @@ void EbsdDataArray<T>::clear()
 template <typename T>
 void EbsdDataArray<T>::deallocate()
 {
-  // We are going to splat 0xABABAB across the first value of the array as a debugging aid
+  // We are going to splat 0xABABAB across the first value of the array as a debugging aid. A persistent
+  // file keeps its values after the array is gone so it is left alone.
   auto cptr = reinterpret_cast<unsigned char*>(m_Array);
+  auto mappedAllocator = std::dynamic_pointer_cast<EbsdMappedFileAllocator>(m_ArrayAllocator);
+  if(nullptr != mappedAllocator && mappedAllocator->getFileMode() == EbsdMappedFileAllocator::FileMode::Persistent)
+  {
+    cptr = nullptr;
+  }
   if(nullptr != cptr)
   {
     if(m_Size > 0)
@@ -1645,9 +1788,17 @@ void EbsdDataArray<T>::deallocate()
         Q_ASSERT(false);
       }
 #endif
-  delete[](m_Array);
+  if(nullptr != m_ArrayAllocator)
+  {
+    m_ArrayAllocator->deallocate(m_Array, m_Size * sizeof(T));
+  }
+  else
+  {
+    delete[](m_Array);
+  }
 
   m_Array = nullptr;
+  m_ArrayAllocator = nullptr;
   m_IsAllocated = false;
 }
 
@@ -1675,14 +1826,12 @@ T* EbsdDataArray<T>::resizeAndExtend(size_t size)
 {
   T* newArray = nullptr;
   size_t newSize = 0;
-  size_t oldSize = 0;
 
   if(size == m_Size) // Requested size is equal to current size.  Do nothing.
   {
     return m_Array;
   }
   newSize = size;
-  oldSize = m_Size;
 
   // Wipe out the array completely if new size is zero.
   if(newSize == 0)
@@ -1691,7 +1840,8 @@ T* EbsdDataArray<T>::resizeAndExtend(size_t size)
     return m_Array;
   }
 
-  newArray = new T[newSize]();
+  // The old values are copied and the new tuples are initialized below so the memory is not value initialized here
+  newArray = allocateElements(newSize, false);
   if(!newArray)
   {
     qDebug() << "Unable to allocate " << newSize << " elements of size " << sizeof(T) << " bytes. ";
@@ -1699,9 +1849,11 @@ T* EbsdDataArray<T>::resizeAndExtend(size_t size)
   }
 
   // Copy the data from the old array.
+  size_t initOffset = 0;
   if(m_Array != nullptr)
   {
-    std::memcpy(newArray, m_Array, (newSize < m_Size ? newSize : m_Size) * sizeof(T));
+    initOffset = (newSize < m_Size ? newSize : m_Size);
+    std::memcpy(newArray, m_Array, initOffset * sizeof(T));
   }
 
   // Allocate a new array if we DO NOT own the current array
@@ -1714,6 +1866,7 @@ T* EbsdDataArray<T>::resizeAndExtend(size_t size)
   // Allocation was successful.  Save it.
   m_Size = newSize;
   m_Array = newArray;
+  m_ArrayAllocator = m_Allocator;
 
   // This object has now allocated its memory and owns it.
   m_OwnsData = true;
@@ -1722,9 +1875,9 @@ T* EbsdDataArray<T>::resizeAndExtend(size_t size)
   m_IsAllocated = true;
 
   // Initialize the new tuples if newSize is larger than old size
-  if(newSize > oldSize)
+  if(newSize > initOffset && m_InitializeOnAllocate)
   {
-    initializeWithValue(m_InitValue, oldSize);
+    initializeWithValue(m_InitValue, initOffset);
   }
 
   return m_Array;
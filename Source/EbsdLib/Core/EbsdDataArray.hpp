@@ -35,6 +35,7 @@
 #pragma once
 
 // STL Includes
+#include <algorithm>
 #include <cassert>
 #include <vector>
 #include <iterator>
@@ -46,6 +47,7 @@
 #include <hdf5.h>
 
 #include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/Core/EbsdArrayAllocator.h"
 #include "EbsdLib/Core/EbsdLibConstants.h"
 
 /**
@@ -172,6 +174,31 @@ public:
    */
   static Pointer CreateArray(const comp_dims_type& tupleDims, const comp_dims_type& compDims, const QString& name, bool allocate);
 
+  /**
+   * @brief Static constructor for arrays that are completely overwritten right after they are created, e.g.
+   * by a file reader. The memory is allocated but not initialized so no page is touched before the data
+   * is written.
+   * @param numTuples The number of tuples in the array.
+   * @param compDims The number of elements in each axis dimension.
+   * @param name The name of the array
+   * @param allocator The allocator for the memory. A nullptr uses new[].
+   * @return Std::Shared_Ptr wrapping an instance of EbsdDataArrayTemplate<T> or a nullptr if the memory could not be allocated
+   */
+  static Pointer CreateUninitializedArray(size_t numTuples, const comp_dims_type& compDims, const QString& name, const EbsdArrayAllocator::Pointer& allocator = EbsdArrayAllocator::NullPointer());
+
+  /**
+   * @brief Static constructor for arrays that are stored in a memory mapped file instead of the heap (See
+   * EbsdMappedFileAllocator). The array can be larger than the physical memory and is used like any other
+   * array. Arrays created from it with deepCopy() or createNewArray() are file backed as well.
+   * @param numTuples The number of tuples in the array.
+   * @param compDims The number of elements in each axis dimension.
+   * @param name The name of the array
+   * @param filePath An empty path stores the array in a temporary file whose values start at zero. Otherwise
+   * the array is stored in filePath, which is kept after the array is gone. The values of an existing file are kept.
+   * @return Std::Shared_Ptr wrapping an instance of EbsdDataArrayTemplate<T> or a nullptr if the file could not be mapped
+   */
+  static Pointer CreateFileBackedArray(size_t numTuples, const comp_dims_type& compDims, const QString& name, const QString& filePath = QString());
+
   //========================================= Instance Constructing EbsdDataArray Objects =================================
   /**
    * @brief createNewArray Creates a new EbsdDataArray object using the same POD type as the existing instance
@@ -235,11 +262,18 @@ public:
   static Pointer WrapPointer(T* data, size_t numTuples, const comp_dims_type& compDims, const QString& name, bool ownsData);
 
   /**
-   * @brief Use this method to move the pointer ownership from this class to another similar class, such as SIMPLib::DataArray<T>
+   * @brief Use this method to move the pointer ownership from this class to another similar class, such as SIMPLib::DataArray<T>.
+   * Memory that came from an EbsdArrayAllocator can not be freed by the other class so it receives a copy instead.
    */
   template <typename DataArrayType>
   std::shared_ptr<DataArrayType> moveToDataArrayType()
   {
+    if(nullptr != m_ArrayAllocator && nullptr != m_Array)
+    {
+      T* copy = new T[m_Size];
+      std::copy(m_Array, m_Array + m_Size, copy);
+      return DataArrayType::WrapPointer(copy, getNumberOfTuples(), getComponentDimensions(), getName(), true);
+    }
     std::shared_ptr<DataArrayType> output = DataArrayType::WrapPointer(data(), getNumberOfTuples(), getComponentDimensions(), getName(), true);
     releaseOwnership();
     return output;
@@ -336,10 +370,42 @@ public:
   /**
    * @brief This class will NOT free the memory associated with the internal pointer.
    * This can be useful if the user wishes to keep the data around after this
-   * class goes out of scope.
+   * class goes out of scope. Memory that came from an EbsdArrayAllocator must be returned to
+   * that allocator (See getArrayAllocator()).
    */
   void releaseOwnership();
 
+  /**
+   * @brief Sets the allocator that is used for all memory that this array allocates from now on. The
+   * current memory is not moved. A nullptr, the default, uses new[] which is what WrapPointer() and
+   * moveToDataArrayType() expect of memory that changes owner.
+   * @param allocator
+   */
+  void setAllocator(const EbsdArrayAllocator::Pointer& allocator);
+
+  /**
+   * @brief Returns the allocator that is used for new memory
+   */
+  EbsdArrayAllocator::Pointer getAllocator() const;
+
+  /**
+   * @brief Returns the allocator that provided the current memory or a nullptr if the memory came from new[]
+   */
+  EbsdArrayAllocator::Pointer getArrayAllocator() const;
+
+  /**
+   * @brief Sets if allocate() and resizing initialize the memory. When false, allocate() leaves the values
+   * undefined and resizing does not write the init value into the new tuples. This avoids touching every
+   * page twice when all values are written right after the allocation.
+   * @param value
+   */
+  void setInitializeOnAllocate(bool value);
+
+  /**
+   * @brief Returns if allocate() and resizing initialize the memory
+   */
+  bool getInitializeOnAllocate() const;
+
   /**
    * @brief Allocates the memory needed for this class
    * @return 1 on success, -1 on failure
@@ -1034,6 +1100,21 @@ protected:
    */
   T* resizeAndExtend(size_t size);
 
+  /**
+   * @brief Allocates the memory for numElements values with the current allocator
+   * @param numElements
+   * @param initialize Value initialize the memory
+   * @return The memory or nullptr if it could not be allocated
+   */
+  T* allocateElements(size_t numElements, bool initialize) const;
+
+  /**
+   * @brief Allocates m_Size values and replaces the current memory
+   * @param initialize Value initialize the memory
+   * @return 1 on success, -1 on failure
+   */
+  int32_t allocateArray(bool initialize);
+
 private:
   QString m_Name = {};
   T* m_Array = nullptr;
@@ -1045,6 +1126,9 @@ private:
   comp_dims_type m_CompDims = {1};
   bool m_IsAllocated = false;
   bool m_OwnsData = true;
+  bool m_InitializeOnAllocate = true;
+  EbsdArrayAllocator::Pointer m_Allocator;
+  EbsdArrayAllocator::Pointer m_ArrayAllocator;
 };
 
 // -----------------------------------------------------------------------------
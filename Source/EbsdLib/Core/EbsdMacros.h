@@ -166,26 +166,47 @@
   }
 
 #define ANG_READER_ALLOCATE_AND_READ(name, h5name, type)                                                                                                                                               \
+  if(isBorrowedArray(get##name##Pointer())) /* Destination buffers of the caller are only forgotten */                                                                                                 \
+  {                                                                                                                                                                                                    \
+    set##name##Pointer(nullptr);                                                                                                                                                                       \
+  }                                                                                                                                                                                                    \
   free##name##Pointer(); /* Always free the current data before reading new data */                                                                                                                    \
   if(m_ReadAllArrays == true || m_ArrayNames.find(h5name) != m_ArrayNames.end())                                                                                                                       \
   {                                                                                                                                                                                                    \
-    auto _##name = allocateArray<type>(totalDataRows);                                                                                                                                                 \
-    if(nullptr != _##name)                                                                                                                                                                             \
+    bool _##name##Region = (m_RoiWidth > 0 && m_RoiHeight > 0);                                                                                                                                        \
+    type* _##name = _##name##Region ? nullptr : mapColumnArray<type>(gid, h5name, totalDataRows);                                                                                                      \
+    if(nullptr == _##name) /* The dataset was not mapped from the file so it is read */                                                                                                                \
     {                                                                                                                                                                                                  \
-      ::memset(_##name, 0, numBytes);                                                                                                                                                                  \
-      QString dataName = h5name;                                                                                                                                                                       \
-      err = QH5Lite::readPointerDataset(gid, dataName, _##name);                                                                                                                                       \
-      if(err < 0)                                                                                                                                                                                      \
+      size_t _##name##Stride = 1;                                                                                                                                                                      \
+      _##name = allocateColumnArray<type>(h5name, totalDataRows, _##name##Stride);                                                                                                                     \
+      if(nullptr != _##name)                                                                                                                                                                           \
       {                                                                                                                                                                                                \
-        deallocateArrayData(_##name); /*deallocate the array*/                                                                                                                                         \
-        setErrorCode(-90020);                                                                                                                                                                          \
-        ss << "Error reading dataset '" << #name                                                                                                                                                       \
-           << "' from the HDF5 file. This data set is required to be in the file because either "                                                                                                      \
-              "the program is set to read ALL the Data arrays or the program was instructed to read this array.";                                                                                      \
-        setErrorMessage(sBuf);                                                                                                                                                                         \
-        err = H5Gclose(gid);                                                                                                                                                                           \
-        return -90020;                                                                                                                                                                                 \
+        if(_##name##Stride == 1)                                                                                                                                                                       \
+        {                                                                                                                                                                                              \
+          ::memset(_##name, 0, numBytes);                                                                                                                                                              \
+        }                                                                                                                                                                                              \
+        QString dataName = h5name;                                                                                                                                                                     \
+        if(_##name##Region)                                                                                                                                                                            \
+        {                                                                                                                                                                                              \
+          err = EbsdLib::H5ScanRegion::readDataset(gid, dataName, nColumns, m_RoiX0, m_RoiY0, m_RoiWidth, m_RoiHeight, _##name, _##name##Stride);                                                      \
+        }                                                                                                                                                                                              \
+        else                                                                                                                                                                                           \
+        {                                                                                                                                                                                              \
+          err = EbsdLib::H5ScanRegion::readAllPoints(gid, dataName, totalDataRows, _##name, _##name##Stride);                                                                                          \
+        }                                                                                                                                                                                              \
+        if(err < 0)                                                                                                                                                                                    \
+        {                                                                                                                                                                                              \
+          deallocateArrayData(_##name); /*deallocate the array*/                                                                                                                                       \
+          setErrorCode(-90020);                                                                                                                                                                        \
+          ss << "Error reading dataset '" << #name                                                                                                                                                     \
+             << "' from the HDF5 file. This data set is required to be in the file because either "                                                                                                    \
+                "the program is set to read ALL the Data arrays or the program was instructed to read this array.";                                                                                    \
+          setErrorMessage(sBuf);                                                                                                                                                                       \
+          err = H5Gclose(gid);                                                                                                                                                                         \
+          return -90020;                                                                                                                                                                               \
+        }                                                                                                                                                                                              \
       }                                                                                                                                                                                                \
     }                                                                                                                                                                                                  \
     set##name##Pointer(_##name);                                                                                                                                                                       \
   }
+
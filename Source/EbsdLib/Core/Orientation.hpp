@@ -48,6 +48,11 @@
  * allocate the "size" number of elements which represent a single orientation
  * in space. Alternate constructors can allow the class to simply wrap an existing
  * array of values which makes looping through an array of orientations easier.
+ *
+ * Orientations of up to k_InlineCapacity elements (every Euler, Rodrigues, Quaternion,
+ * Axis-Angle, Homochoric, Cubochoric and 3x3 matrix representation) are stored in a
+ * buffer that lives inside the object so that temporaries created while converting
+ * between representations do not touch the heap. Larger arrays fall back to new[].
  */
 template <typename T>
 class Orientation
@@ -62,6 +67,11 @@ public:
   using pointer = T*;
   using difference_type = value_type;
 
+  /**
+   * @brief The largest number of elements that is stored inside the object instead of on the heap
+   */
+  static const size_t k_InlineCapacity = 9;
+
   Orientation() = default;
 
   /**
@@ -173,7 +183,7 @@ public:
    */
   virtual ~Orientation()
   {
-    if(m_Array != nullptr && m_OwnsData == true)
+    if(m_Array != nullptr && m_OwnsData == true && m_Array != m_Inline)
     {
       delete[] m_Array;
     }
@@ -226,7 +236,16 @@ public:
       deallocate();
       m_OwnsData = std::move(rhs.m_OwnsData);
       m_Size = std::move(rhs.m_Size);
-      m_Array = std::move(rhs.m_Array);
+      if(rhs.m_Array == rhs.m_Inline)
+      {
+        // Values held in the inline buffer of `rhs` can not be stolen so copy them into ours
+        ::memcpy(m_Inline, rhs.m_Inline, sizeof(T) * m_Size);
+        m_Array = m_Inline;
+      }
+      else
+      {
+        m_Array = std::move(rhs.m_Array);
+      }
       rhs.m_Array = nullptr;
       rhs.m_Size = 0;
       rhs.m_OwnsData = false;
@@ -596,77 +615,42 @@ public:
    */
   void resize(size_t size)
   {
-    T* newArray;
-    size_t newSize;
-    size_t oldSize;
-
     if(size == m_Size) // Requested size is equal to current size.  Do nothing.
     {
       return;
     }
-    newSize = size;
-    oldSize = m_Size;
 
     // Wipe out the array completely if new size is zero.
-    if(newSize == 0)
+    if(size == 0)
     {
       clear();
       return;
     }
-    // OS X's realloc does not free memory if the new block is smaller.  This
-    // is a very serious problem and causes huge amount of memory to be
-    // wasted. Do not use realloc on the Mac.
-    bool dontUseRealloc = false;
-#if defined __APPLE__
-    dontUseRealloc = true;
-#endif
 
-    // Allocate a new array if we DO NOT own the current array
-    if((nullptr != m_Array) && (false == m_OwnsData))
-    {
-      // The old array is owned by the user so we cannot try to
-      // reallocate it.  Just allocate new memory that we will own.
-      newArray = new T[newSize]();
+    // Small arrays go into the inline buffer, everything else gets a new heap block.
+    T* newArray = (size <= k_InlineCapacity) ? m_Inline : new T[size]();
+    size_t numToKeep = (m_Array == nullptr) ? 0 : (size < m_Size ? size : m_Size);
 
-      if(!newArray)
-      {
-        std::cout << "Unable to allocate " << newSize << " elements of size " << sizeof(T) << " bytes. ";
-        return;
-      }
-
-      // Copy the data from the old array.
-      std::memcpy(newArray, m_Array, (newSize < m_Size ? newSize : m_Size) * sizeof(T));
-    }
-    else if(!dontUseRealloc)
+    // Copy the data from the old array. When both old and new arrays are the inline buffer the values are already in place.
+    if(m_Array != nullptr && m_Array != newArray)
     {
-      newArray = new T[newSize]();
-
-      if(!newArray)
-      {
-        std::cout << "Unable to allocate " << newSize << " elements of size " << sizeof(T) << " bytes. ";
-        return;
-      }
+      std::memcpy(newArray, m_Array, numToKeep * sizeof(T));
     }
-    else
+    if(newArray == m_Inline)
     {
-      newArray = new T[newSize]();
-      if(!newArray)
+      for(size_t i = numToKeep; i < size; i++)
       {
-        std::cout << "Unable to allocate " << newSize << " elements of size " << sizeof(T) << " bytes. ";
-        return;
+        m_Inline[i] = static_cast<T>(0);
       }
+    }
 
-      // Copy the data from the old array.
-      if(m_Array != nullptr)
-      {
-        std::memcpy(newArray, m_Array, (newSize < m_Size ? newSize : m_Size) * sizeof(T));
-      }
-      // Free the old array
-      deallocate();
+    // Free the old array if it was ours and lived on the heap
+    if(m_Array != nullptr && m_OwnsData && m_Array != m_Inline && m_Array != newArray)
+    {
+      delete[] m_Array;
     }
 
-    // Allocation was successful.  Save it.
-    m_Size = newSize;
+    m_Size = size;
     m_Array = newArray;
 
     // This object has now allocated its memory and owns it.
@@ -693,6 +677,15 @@ protected:
     }
 
     size_t newSize = m_Size;
+    if(newSize <= k_InlineCapacity)
+    {
+      m_Array = m_Inline;
+      for(size_t i = 0; i < newSize; i++)
+      {
+        m_Inline[i] = static_cast<T>(0);
+      }
+      return;
+    }
     m_Array = new T[newSize]();
     if(!m_Array)
     {
@@ -746,7 +739,10 @@ protected:
         Q_∂(false);
       }
 #endif
-    delete[](m_Array);
+    if(m_Array != m_Inline)
+    {
+      delete[](m_Array);
+    }
 
     m_Array = nullptr;
   }
@@ -755,8 +751,12 @@ private:
   T* m_Array = nullptr;
   size_t m_Size = 0;
   bool m_OwnsData = true;
+  T m_Inline[k_InlineCapacity];
 };
 
+template <typename T>
+const size_t Orientation<T>::k_InlineCapacity;
+
 using OrientationType = Orientation<double>;
 using OrientationD = Orientation<double>;
 using OrientationF = Orientation<float>;
@@ -0,0 +1,549 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "OrientationContainer.hpp"
+
+#include <algorithm>
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+namespace
+{
+// -----------------------------------------------------------------------------
+// The number of components is a template parameter for the common orientation sizes so that the
+// compiler unrolls the inner loop. Everything else goes through the runtime version.
+// -----------------------------------------------------------------------------
+template <typename T, size_t N>
+void interleaveTuples(const T* const* planar, T* interleaved, size_t begin, size_t end)
+{
+  for(size_t i = begin; i < end; i++)
+  {
+    T* out = interleaved + i * N;
+    for(size_t c = 0; c < N; c++)
+    {
+      out[c] = planar[c][i];
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void interleaveTuples(const T* const* planar, size_t numComps, T* interleaved, size_t begin, size_t end)
+{
+  switch(numComps)
+  {
+  case 3:
+    interleaveTuples<T, 3>(planar, interleaved, begin, end);
+    break;
+  case 4:
+    interleaveTuples<T, 4>(planar, interleaved, begin, end);
+    break;
+  case 9:
+    interleaveTuples<T, 9>(planar, interleaved, begin, end);
+    break;
+  default:
+    for(size_t i = begin; i < end; i++)
+    {
+      T* out = interleaved + i * numComps;
+      for(size_t c = 0; c < numComps; c++)
+      {
+        out[c] = planar[c][i];
+      }
+    }
+    break;
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t N>
+void deinterleaveTuples(const T* interleaved, T* const* planar, size_t begin, size_t end)
+{
+  for(size_t i = begin; i < end; i++)
+  {
+    const T* in = interleaved + i * N;
+    for(size_t c = 0; c < N; c++)
+    {
+      planar[c][i] = in[c];
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void deinterleaveTuples(const T* interleaved, T* const* planar, size_t numComps, size_t begin, size_t end)
+{
+  switch(numComps)
+  {
+  case 3:
+    deinterleaveTuples<T, 3>(interleaved, planar, begin, end);
+    break;
+  case 4:
+    deinterleaveTuples<T, 4>(interleaved, planar, begin, end);
+    break;
+  case 9:
+    deinterleaveTuples<T, 9>(interleaved, planar, begin, end);
+    break;
+  default:
+    for(size_t i = begin; i < end; i++)
+    {
+      const T* in = interleaved + i * numComps;
+      for(size_t c = 0; c < numComps; c++)
+      {
+        planar[c][i] = in[c];
+      }
+    }
+    break;
+  }
+}
+
+/**
+ * @brief Transposes a range of k_BlockSize tuple blocks in either direction.
+ */
+template <typename T>
+class TransposeImpl
+{
+public:
+  TransposeImpl(const T* const* planarIn, T* const* planarOut, size_t numComps, const T* interleavedIn, T* interleavedOut, size_t numTuples)
+  : m_PlanarIn(planarIn)
+  , m_PlanarOut(planarOut)
+  , m_NumComps(numComps)
+  , m_InterleavedIn(interleavedIn)
+  , m_InterleavedOut(interleavedOut)
+  , m_NumTuples(numTuples)
+  {
+  }
+  virtual ~TransposeImpl() = default;
+
+  void convert(size_t startBlock, size_t endBlock) const
+  {
+    for(size_t block = startBlock; block < endBlock; block++)
+    {
+      size_t begin = block * OrientationContainer<T>::k_BlockSize;
+      size_t end = std::min(begin + OrientationContainer<T>::k_BlockSize, m_NumTuples);
+      if(nullptr != m_InterleavedOut)
+      {
+        interleaveTuples<T>(m_PlanarIn, m_NumComps, m_InterleavedOut, begin, end);
+      }
+      else
+      {
+        deinterleaveTuples<T>(m_InterleavedIn, m_PlanarOut, m_NumComps, begin, end);
+      }
+    }
+  }
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  const T* const* m_PlanarIn;
+  T* const* m_PlanarOut;
+  size_t m_NumComps;
+  const T* m_InterleavedIn;
+  T* m_InterleavedOut;
+  size_t m_NumTuples;
+};
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void runTranspose(const TransposeImpl<T>& impl, size_t numTuples)
+{
+  size_t numBlocks = (numTuples + OrientationContainer<T>::k_BlockSize - 1) / OrientationContainer<T>::k_BlockSize;
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  if(numBlocks > 1)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numBlocks), impl, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    impl.convert(0, numBlocks);
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+T* arrayData(const typename EbsdDataArray<T>::Pointer& array)
+{
+  return (array->getSize() > 0) ? array->getPointer(0) : nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// New storage is created with the same kind of allocator as the array it is transposed from
+template <typename T>
+typename EbsdDataArray<T>::Pointer createLike(const typename EbsdDataArray<T>::Pointer& source, size_t numTuples, size_t numComps, const QString& name)
+{
+  EbsdArrayAllocator::Pointer allocator = source->getAllocator();
+  if(nullptr != allocator)
+  {
+    allocator = allocator->getDerivedAllocator();
+  }
+  typename EbsdDataArray<T>::comp_dims_type cDims = {numComps};
+  return EbsdDataArray<T>::CreateUninitializedArray(numTuples, cDims, name, allocator);
+}
+
+// -----------------------------------------------------------------------------
+QString componentName(const QString& name, size_t comp)
+{
+  return QString("%1_%2").arg(name).arg(comp);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+template <typename T>
+const size_t OrientationContainer<T>::k_BlockSize;
+
+// -----------------------------------------------------------------------------
+template <typename T>
+OrientationContainer<T>::OrientationContainer() = default;
+
+// -----------------------------------------------------------------------------
+template <typename T>
+OrientationContainer<T>::~OrientationContainer() = default;
+
+// -----------------------------------------------------------------------------
+template <typename T>
+typename OrientationContainer<T>::Pointer OrientationContainer<T>::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+QString OrientationContainer<T>::getNameOfClass() const
+{
+  return QString("OrientationContainer<T>");
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+QString OrientationContainer<T>::ClassName()
+{
+  return QString("OrientationContainer<T>");
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+typename OrientationContainer<T>::Pointer OrientationContainer<T>::New(size_t numTuples, size_t numComponents, Layout layout, const QString& name)
+{
+  if(numComponents == 0 || name.isEmpty())
+  {
+    return NullPointer();
+  }
+  Pointer container(new OrientationContainer<T>());
+  container->m_Name = name;
+  container->m_Layout = layout;
+  container->m_NumTuples = numTuples;
+  container->m_NumComponents = numComponents;
+  if(layout == Layout::Interleaved)
+  {
+    typename DataArrayType::comp_dims_type cDims = {numComponents};
+    container->m_Interleaved = DataArrayType::CreateUninitializedArray(numTuples, cDims, name);
+    if(nullptr == container->m_Interleaved)
+    {
+      return NullPointer();
+    }
+    return container;
+  }
+  typename DataArrayType::comp_dims_type cDims = {1};
+  for(size_t c = 0; c < numComponents; c++)
+  {
+    DataArrayPointer component = DataArrayType::CreateUninitializedArray(numTuples, cDims, componentName(name, c));
+    if(nullptr == component)
+    {
+      return NullPointer();
+    }
+    container->m_Planar.push_back(component);
+  }
+  return container;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+typename OrientationContainer<T>::Pointer OrientationContainer<T>::FromInterleaved(const DataArrayPointer& array)
+{
+  if(nullptr == array || array->getNumberOfComponents() < 1)
+  {
+    return NullPointer();
+  }
+  Pointer container(new OrientationContainer<T>());
+  container->m_Name = array->getName();
+  container->m_Layout = Layout::Interleaved;
+  container->m_NumTuples = array->getNumberOfTuples();
+  container->m_NumComponents = static_cast<size_t>(array->getNumberOfComponents());
+  container->m_Interleaved = array;
+  return container;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+typename OrientationContainer<T>::Pointer OrientationContainer<T>::FromPlanar(const std::vector<DataArrayPointer>& components, const QString& name)
+{
+  if(components.empty() || name.isEmpty())
+  {
+    return NullPointer();
+  }
+  for(const auto& component : components)
+  {
+    if(nullptr == component || component->getNumberOfComponents() != 1 || component->getNumberOfTuples() != components[0]->getNumberOfTuples())
+    {
+      return NullPointer();
+    }
+  }
+  Pointer container(new OrientationContainer<T>());
+  container->m_Name = name;
+  container->m_Layout = Layout::Planar;
+  container->m_NumTuples = components[0]->getNumberOfTuples();
+  container->m_NumComponents = components.size();
+  container->m_Planar = components;
+  return container;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+typename OrientationContainer<T>::Pointer OrientationContainer<T>::WrapPlanar(const std::vector<T*>& components, size_t numTuples, const QString& name)
+{
+  if(name.isEmpty())
+  {
+    return NullPointer();
+  }
+  std::vector<DataArrayPointer> arrays;
+  typename DataArrayType::comp_dims_type cDims = {1};
+  for(size_t c = 0; c < components.size(); c++)
+  {
+    if(nullptr == components[c])
+    {
+      return NullPointer();
+    }
+    arrays.push_back(DataArrayType::WrapPointer(components[c], numTuples, cDims, componentName(name, c), false));
+  }
+  return FromPlanar(arrays, name);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+QString OrientationContainer<T>::getName() const
+{
+  return m_Name;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+typename OrientationContainer<T>::Layout OrientationContainer<T>::getLayout() const
+{
+  return m_Layout;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+size_t OrientationContainer<T>::getNumberOfTuples() const
+{
+  return m_NumTuples;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+size_t OrientationContainer<T>::getNumberOfComponents() const
+{
+  return m_NumComponents;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+typename OrientationContainer<T>::DataArrayPointer OrientationContainer<T>::getInterleavedArray() const
+{
+  return m_Interleaved;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+std::vector<typename OrientationContainer<T>::DataArrayPointer> OrientationContainer<T>::getPlanarArrays() const
+{
+  return m_Planar;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+T* OrientationContainer<T>::getComponentPointer(size_t comp) const
+{
+  if(m_Layout != Layout::Planar || comp >= m_Planar.size())
+  {
+    return nullptr;
+  }
+  return arrayData<T>(m_Planar[comp]);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+T OrientationContainer<T>::getValue(size_t tuple, size_t comp) const
+{
+  if(m_Layout == Layout::Interleaved)
+  {
+    return m_Interleaved->getValue(tuple * m_NumComponents + comp);
+  }
+  return m_Planar[comp]->getValue(tuple);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void OrientationContainer<T>::setValue(size_t tuple, size_t comp, T value)
+{
+  if(m_Layout == Layout::Interleaved)
+  {
+    m_Interleaved->setValue(tuple * m_NumComponents + comp, value);
+    return;
+  }
+  m_Planar[comp]->setValue(tuple, value);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+bool OrientationContainer<T>::setLayout(Layout layout)
+{
+  if(layout == m_Layout)
+  {
+    return true;
+  }
+  if(layout == Layout::Interleaved)
+  {
+    DataArrayPointer interleaved = toInterleaved();
+    if(nullptr == interleaved)
+    {
+      return false;
+    }
+    m_Interleaved = interleaved;
+    m_Planar.clear();
+  }
+  else
+  {
+    std::vector<DataArrayPointer> planar = toPlanar();
+    if(planar.size() != m_NumComponents)
+    {
+      return false;
+    }
+    m_Planar = planar;
+    m_Interleaved = DataArrayPointer();
+  }
+  m_Layout = layout;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+typename OrientationContainer<T>::DataArrayPointer OrientationContainer<T>::toInterleaved() const
+{
+  if(m_Layout == Layout::Interleaved)
+  {
+    return m_Interleaved;
+  }
+  DataArrayPointer interleaved = createLike<T>(m_Planar[0], m_NumTuples, m_NumComponents, m_Name);
+  if(nullptr == interleaved)
+  {
+    return interleaved;
+  }
+  std::vector<const T*> planar(m_NumComponents, nullptr);
+  for(size_t c = 0; c < m_NumComponents; c++)
+  {
+    planar[c] = arrayData<T>(m_Planar[c]);
+  }
+  Interleave(planar, arrayData<T>(interleaved), m_NumTuples);
+  return interleaved;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+std::vector<typename OrientationContainer<T>::DataArrayPointer> OrientationContainer<T>::toPlanar() const
+{
+  if(m_Layout == Layout::Planar)
+  {
+    return m_Planar;
+  }
+  std::vector<DataArrayPointer> arrays;
+  std::vector<T*> planar(m_NumComponents, nullptr);
+  for(size_t c = 0; c < m_NumComponents; c++)
+  {
+    DataArrayPointer component = createLike<T>(m_Interleaved, m_NumTuples, 1, componentName(m_Name, c));
+    if(nullptr == component)
+    {
+      return std::vector<DataArrayPointer>();
+    }
+    arrays.push_back(component);
+    planar[c] = arrayData<T>(component);
+  }
+  Deinterleave(arrayData<T>(m_Interleaved), planar, m_NumTuples);
+  return arrays;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void OrientationContainer<T>::Interleave(const std::vector<const T*>& planar, T* interleaved, size_t numTuples)
+{
+  if(planar.empty() || numTuples == 0)
+  {
+    return;
+  }
+  TransposeImpl<T> impl(planar.data(), nullptr, planar.size(), nullptr, interleaved, numTuples);
+  runTranspose<T>(impl, numTuples);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void OrientationContainer<T>::Deinterleave(const T* interleaved, const std::vector<T*>& planar, size_t numTuples)
+{
+  if(planar.empty() || numTuples == 0)
+  {
+    return;
+  }
+  TransposeImpl<T> impl(nullptr, planar.data(), planar.size(), interleaved, nullptr, numTuples);
+  runTranspose<T>(impl, numTuples);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+#if !defined(__APPLE__) && !defined(_MSC_VER)
+#undef EbsdLib_EXPORT
+#define EbsdLib_EXPORT
+#endif
+
+template class EbsdLib_EXPORT OrientationContainer<float>;
+template class EbsdLib_EXPORT OrientationContainer<double>;
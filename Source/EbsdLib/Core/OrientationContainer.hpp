@@ -0,0 +1,229 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/Core/EbsdDataArray.hpp"
+
+/**
+ * @class OrientationContainer OrientationContainer.hpp EbsdLib/Core/OrientationContainer.hpp
+ * @brief Holds an array of orientations with numComponents values each (3 for Euler angles, 4 for
+ * quaternions, 9 for orientation matrices...) in one of two memory layouts:
+ *
+ * Interleaved: A single EbsdDataArray with numComponents components per tuple. This is what
+ * OrientationConverter and the LaueOps classes consume.
+ * Planar: One single component EbsdDataArray per component. This is how the readers hand out the
+ * Phi1/Phi/Phi2 arrays and what the SIMD kernels (@see QuaternionBatchMath) consume.
+ *
+ * The container only transposes when asked for the layout it does not currently have. The transposition
+ * works on blocks of k_BlockSize tuples which are distributed over threads when parallel algorithms are enabled.
+ */
+template <typename T>
+class OrientationContainer
+{
+public:
+  using Self = OrientationContainer<T>;
+  using Pointer = std::shared_ptr<Self>;
+  using ConstPointer = std::shared_ptr<const Self>;
+  using WeakPointer = std::weak_ptr<Self>;
+  using ConstWeakPointer = std::weak_ptr<const Self>;
+  static Pointer NullPointer();
+
+  using DataArrayType = EbsdDataArray<T>;
+  using DataArrayPointer = typename DataArrayType::Pointer;
+
+  enum class Layout : int
+  {
+    Interleaved = 0,
+    Planar = 1
+  };
+
+  /**
+   * @brief The number of tuples that the transposition kernels process as one unit of work.
+   */
+  static const size_t k_BlockSize = 1024;
+
+  /**
+   * @brief Creates a container with uninitialized storage in the given layout.
+   * @param numTuples
+   * @param numComponents
+   * @param layout
+   * @param name
+   * @return The container or a NullPointer() if the arguments are invalid or the memory could not be allocated.
+   */
+  static Pointer New(size_t numTuples, size_t numComponents, Layout layout, const QString& name);
+
+  /**
+   * @brief Creates an interleaved container that shares the storage of array. Nothing is copied.
+   * @param array
+   */
+  static Pointer FromInterleaved(const DataArrayPointer& array);
+
+  /**
+   * @brief Creates a planar container that shares the storage of the single component arrays in components.
+   * All arrays must have the same number of tuples. Nothing is copied.
+   * @param components
+   * @param name
+   */
+  static Pointer FromPlanar(const std::vector<DataArrayPointer>& components, const QString& name);
+
+  /**
+   * @brief Creates a planar container around raw component pointers, e.g. the Phi1, Phi and Phi2 pointers of
+   * a reader. The container does not take ownership so the pointers must outlive it.
+   * @param components
+   * @param numTuples
+   * @param name
+   */
+  static Pointer WrapPlanar(const std::vector<T*>& components, size_t numTuples, const QString& name);
+
+  virtual ~OrientationContainer();
+
+  /**
+   * @brief Returns the name of the class for OrientationContainer
+   */
+  QString getNameOfClass() const;
+  /**
+   * @brief Returns the name of the class for OrientationContainer
+   */
+  static QString ClassName();
+
+  QString getName() const;
+  Layout getLayout() const;
+  size_t getNumberOfTuples() const;
+  size_t getNumberOfComponents() const;
+
+  /**
+   * @brief Returns the interleaved array or a NullPointer() if the container is planar.
+   */
+  DataArrayPointer getInterleavedArray() const;
+
+  /**
+   * @brief Returns the component arrays or an empty vector if the container is interleaved.
+   */
+  std::vector<DataArrayPointer> getPlanarArrays() const;
+
+  /**
+   * @brief Returns the first value of component comp of a planar container or nullptr if the container is interleaved.
+   * @param comp
+   */
+  T* getComponentPointer(size_t comp) const;
+
+  /**
+   * @brief Returns a single value independent of the layout.
+   * @param tuple
+   * @param comp
+   */
+  T getValue(size_t tuple, size_t comp) const;
+
+  /**
+   * @brief Sets a single value independent of the layout.
+   * @param tuple
+   * @param comp
+   * @param value
+   */
+  void setValue(size_t tuple, size_t comp, T value);
+
+  /**
+   * @brief Transposes the storage into layout. The new storage uses the same kind of allocator as the old one.
+   * Does nothing if the container already has that layout.
+   * @param layout
+   * @return false if the new storage could not be allocated. The container is unchanged in that case.
+   */
+  bool setLayout(Layout layout);
+
+  /**
+   * @brief Returns the values as an interleaved array. This is the container's own array if it is interleaved,
+   * otherwise a transposed copy.
+   */
+  DataArrayPointer toInterleaved() const;
+
+  /**
+   * @brief Returns the values as single component arrays. These are the container's own arrays if it is
+   * planar, otherwise a transposed copy.
+   */
+  std::vector<DataArrayPointer> toPlanar() const;
+
+  /**
+   * @brief Copies planar.size() component arrays of numTuples values each into interleaved which must hold
+   * numTuples * planar.size() values.
+   * @param planar
+   * @param interleaved
+   * @param numTuples
+   */
+  static void Interleave(const std::vector<const T*>& planar, T* interleaved, size_t numTuples);
+
+  /**
+   * @brief Copies interleaved, which holds numTuples * planar.size() values, into planar.size() component arrays.
+   * @param interleaved
+   * @param planar
+   * @param numTuples
+   */
+  static void Deinterleave(const T* interleaved, const std::vector<T*>& planar, size_t numTuples);
+
+protected:
+  OrientationContainer();
+
+private:
+  QString m_Name;
+  Layout m_Layout = Layout::Interleaved;
+  size_t m_NumTuples = 0;
+  size_t m_NumComponents = 0;
+  DataArrayPointer m_Interleaved;
+  std::vector<DataArrayPointer> m_Planar;
+
+public:
+  OrientationContainer(const OrientationContainer&) = delete;            // Copy Constructor Not Implemented
+  OrientationContainer(OrientationContainer&&) = delete;                 // Move Constructor Not Implemented
+  OrientationContainer& operator=(const OrientationContainer&) = delete; // Copy Assignment Not Implemented
+  OrientationContainer& operator=(OrientationContainer&&) = delete;      // Move Assignment Not Implemented
+};
+
+// -----------------------------------------------------------------------------
+// Declare our extern templates
+extern template class OrientationContainer<float>;
+extern template class OrientationContainer<double>;
+
+// -----------------------------------------------------------------------------
+// Declare our aliases
+namespace EbsdLib
+{
+using FloatOrientationContainer = OrientationContainer<float>;
+using DoubleOrientationContainer = OrientationContainer<double>;
+} // namespace EbsdLib
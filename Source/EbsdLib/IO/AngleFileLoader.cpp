@@ -35,8 +35,18 @@
 
 #include "AngleFileLoader.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
 
 #include <QtCore/QFileInfo>
 #include <QtCore/QFile>
@@ -46,8 +56,237 @@
 #include "EbsdLib/Core/Orientation.hpp"
 #include "EbsdLib/Core/OrientationTransformation.hpp"
 #include "EbsdLib/Core/Quaternion.hpp"
+#include "EbsdLib/IO/EbsdTokenParser.hpp"
 #include "EbsdLib/Math/EbsdLibMath.h"
 
+namespace TokenParser = EbsdLib::TokenParser;
+
+namespace
+{
+/* Chunks of the angle data smaller than this are not worth handing to another thread */
+const size_t k_MinimumChunkBytes = 64 * 1024;
+const size_t k_NoError = std::numeric_limits<size_t>::max();
+const int k_MaxTokens = 6;
+const int k_NumComponents = 5;
+
+/**
+ * @brief A line aligned byte range of the angle data along with the bookkeeping needed to place
+ * its lines into the output array.
+ */
+struct AngleDataChunk
+{
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  size_t startLine = 0;
+  size_t numLines = 0;
+  size_t errorLine = k_NoError;
+  int errorTokenCount = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Splits [begin, end) into ranges that always start at the beginning of a line
+// -----------------------------------------------------------------------------
+std::vector<AngleDataChunk> createDataChunks(const char* begin, const char* end)
+{
+  const size_t numBytes = static_cast<size_t>(end - begin);
+  size_t numChunks = 1;
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  size_t numThreads = std::max(1U, std::thread::hardware_concurrency());
+  numChunks = std::max(static_cast<size_t>(1), std::min(numThreads * 4, numBytes / k_MinimumChunkBytes));
+#endif
+
+  std::vector<AngleDataChunk> chunks;
+  chunks.reserve(numChunks);
+  const char* chunkBegin = begin;
+  for(size_t i = 1; i <= numChunks && chunkBegin < end; i++)
+  {
+    const char* chunkEnd = (i == numChunks) ? end : begin + (numBytes * i) / numChunks;
+    chunkEnd = std::max(chunkEnd, chunkBegin);
+    if(chunkEnd < end && (chunkEnd == begin || *(chunkEnd - 1) != '\n'))
+    {
+      const char* eol = static_cast<const char*>(::memchr(chunkEnd, '\n', static_cast<size_t>(end - chunkEnd)));
+      chunkEnd = (nullptr == eol) ? end : eol + 1;
+    }
+    AngleDataChunk chunk;
+    chunk.begin = chunkBegin;
+    chunk.end = chunkEnd;
+    chunks.push_back(chunk);
+    chunkBegin = chunkEnd;
+  }
+  return chunks;
+}
+
+/**
+ * @brief Counts the lines in each chunk. A final line without a newline is also counted.
+ */
+class CountAngleLinesImpl
+{
+  std::vector<AngleDataChunk>* m_Chunks;
+  const char* m_DataEnd;
+
+public:
+  CountAngleLinesImpl(std::vector<AngleDataChunk>* chunks, const char* dataEnd)
+  : m_Chunks(chunks)
+  , m_DataEnd(dataEnd)
+  {
+  }
+
+  void generate(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      AngleDataChunk& chunk = (*m_Chunks)[i];
+      chunk.numLines = static_cast<size_t>(std::count(chunk.begin, chunk.end, '\n'));
+      if(chunk.end == m_DataEnd && chunk.end > chunk.begin && *(chunk.end - 1) != '\n')
+      {
+        chunk.numLines++;
+      }
+    }
+  }
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    generate(r.begin(), r.end());
+  }
+#endif
+};
+
+/**
+ * @brief Parses the lines of each chunk straight into the output array. Line 'i' of the angle
+ * data is stored in tuple 'i' so every chunk writes into its own part of the array and no locking
+ * is needed. The orientation is converted to Euler angles and into the requested angle units in
+ * the same pass.
+ */
+class ParseAngleLinesImpl
+{
+  std::vector<AngleDataChunk>* m_Chunks;
+  float* m_Output;
+  size_t m_NumOrients;
+  uint32_t m_AngleRepresentation;
+  char m_Delimiter;
+  bool m_IgnoreMultipleDelimiters;
+  double m_UnitConversion;
+
+public:
+  ParseAngleLinesImpl(std::vector<AngleDataChunk>* chunks, float* output, size_t numOrients, uint32_t angleRepresentation, char delimiter, bool ignoreMultipleDelimiters, double unitConversion)
+  : m_Chunks(chunks)
+  , m_Output(output)
+  , m_NumOrients(numOrients)
+  , m_AngleRepresentation(angleRepresentation)
+  , m_Delimiter(delimiter)
+  , m_IgnoreMultipleDelimiters(ignoreMultipleDelimiters)
+  , m_UnitConversion(unitConversion)
+  {
+  }
+
+  void generate(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      parseChunk((*m_Chunks)[i]);
+    }
+  }
+
+  void parseChunk(AngleDataChunk& chunk) const
+  {
+    const int numRequired = (m_AngleRepresentation == AngleFileLoader::QuaternionAngles) ? 6 : 5;
+    TokenParser::Token tokens[k_MaxTokens];
+    size_t lineIndex = chunk.startLine;
+    const char* cursor = chunk.begin;
+    while(cursor < chunk.end && lineIndex < m_NumOrients)
+    {
+      const char* eol = TokenParser::findLineEnd(cursor, chunk.end);
+      const char* first = cursor;
+      const char* last = eol;
+      cursor = (eol < chunk.end) ? eol + 1 : chunk.end;
+      size_t tuple = lineIndex++;
+
+      // Comment lines still use up a tuple which is left at its initial value
+      if(first != last && *first == '#')
+      {
+        continue;
+      }
+      TokenParser::trim(first, last);
+
+      int numTokens = 0;
+      if(m_IgnoreMultipleDelimiters && TokenParser::isWhiteSpace(m_Delimiter))
+      {
+        // QByteArray::simplified() would have turned every run of white space into a single space
+        if(m_Delimiter == ' ')
+        {
+          numTokens = TokenParser::splitOnWhiteSpace(first, last, tokens, k_MaxTokens);
+        }
+        else
+        {
+          tokens[0].first = first;
+          tokens[0].last = last;
+          numTokens = 1;
+        }
+      }
+      else
+      {
+        // Runs of white space inside the tokens do not need collapsing as the number
+        // conversion ignores leading and trailing white space anyway
+        numTokens = TokenParser::split(first, last, m_Delimiter, tokens, k_MaxTokens);
+      }
+      if(numTokens < numRequired)
+      {
+        chunk.errorLine = tuple;
+        chunk.errorTokenCount = numTokens;
+        return;
+      }
+
+      float values[k_MaxTokens] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+      for(int t = 0; t < numRequired; t++)
+      {
+        values[t] = TokenParser::toFloat(tokens[t].first, tokens[t].last);
+      }
+
+      float* out = m_Output + tuple * k_NumComponents;
+      if(m_AngleRepresentation == AngleFileLoader::EulerAngles)
+      {
+        out[0] = static_cast<float>(values[0] * m_UnitConversion);
+        out[1] = static_cast<float>(values[1] * m_UnitConversion);
+        out[2] = static_cast<float>(values[2] * m_UnitConversion);
+        out[3] = values[3];
+        out[4] = values[4];
+      }
+      else if(m_AngleRepresentation == AngleFileLoader::QuaternionAngles)
+      {
+        QuatF quat(values[0], values[1], values[2], values[3]);
+        OrientationF euler = OrientationTransformation::qu2eu<QuatF, OrientationF>(quat);
+        out[0] = static_cast<float>(euler[0] * m_UnitConversion);
+        out[1] = static_cast<float>(euler[1] * m_UnitConversion);
+        out[2] = static_cast<float>(euler[2] * m_UnitConversion);
+        out[3] = values[4];
+        out[4] = values[5];
+      }
+      else if(m_AngleRepresentation == AngleFileLoader::RodriguezAngles)
+      {
+        OrientationF rod(4, 0.0f);
+        rod[0] = values[0];
+        rod[1] = values[1];
+        rod[2] = values[2];
+        OrientationF euler = OrientationTransformation::ro2eu<OrientationF, OrientationF>(rod);
+        out[0] = static_cast<float>(euler[0] * m_UnitConversion);
+        out[1] = static_cast<float>(euler[1] * m_UnitConversion);
+        out[2] = static_cast<float>(euler[2] * m_UnitConversion);
+        out[3] = values[3];
+        out[4] = values[4];
+      }
+    }
+  }
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    generate(r.begin(), r.end());
+  }
+#endif
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -102,11 +341,10 @@ EbsdLib::FloatArrayType::Pointer AngleFileLoader::loadData()
   // the total number of angles that will be read
 
   int numOrients = 0;
-  QByteArray buf;
 
-  // Open the file and read the first line
+  // Open the file and map it into memory. If the file can not be mapped it is read in one go.
   QFile reader(getInputFile());
-  if(!reader.open(QIODevice::ReadOnly | QIODevice::Text))
+  if(!reader.open(QIODevice::ReadOnly))
   {
     QString msg = QObject::tr("Angle file could not be opened: %1").arg(getInputFile());
     setErrorCode(-100);
@@ -114,13 +352,27 @@ EbsdLib::FloatArrayType::Pointer AngleFileLoader::loadData()
     return angles;
   }
 
-  bool ok = false;
-  buf = reader.readLine();
-  while(buf[0] == '#')
+  QByteArray contents;
+  uchar* mapped = (reader.size() > 0) ? reader.map(0, reader.size()) : nullptr;
+  const char* begin = reinterpret_cast<const char*>(mapped);
+  const char* end = begin + reader.size();
+  if(nullptr == mapped)
+  {
+    contents = reader.readAll();
+    begin = contents.constData();
+    end = begin + contents.size();
+  }
+
+  // Skip the comment lines and read the header line
+  const char* cursor = begin;
+  const char* eol = TokenParser::findLineEnd(cursor, end);
+  while(cursor != end && *cursor == '#')
   {
-    buf = reader.readLine();
+    cursor = (eol < end) ? eol + 1 : end;
+    eol = TokenParser::findLineEnd(cursor, end);
   }
-  buf = buf.trimmed();
+  QByteArray buf = QByteArray(cursor, static_cast<int>(eol - cursor)).trimmed();
+  const char* dataBegin = (eol < end) ? eol + 1 : end;
 
   // Split the next line into a pair of tokens delimited by the ":" character
   QList<QByteArray> tokens = buf.split(':');
@@ -139,89 +391,100 @@ EbsdLib::FloatArrayType::Pointer AngleFileLoader::loadData()
     setErrorMessage(msg);
     return angles;
   }
+  bool ok = false;
   numOrients = tokens[1].toInt(&ok, 10);
 
   // Allocate enough for the angles
-  std::vector<size_t> dims(1, 5);
+  std::vector<size_t> dims(1, k_NumComponents);
   angles = EbsdLib::FloatArrayType::CreateArray(numOrients, dims, "EulerAngles_From_File", true);
+  if(numOrients <= 0)
+  {
+    return angles;
+  }
 
-  for(int i = 0; i < numOrients; i++)
+  QString delimiter = getDelimiter();
+  if(delimiter.compare("\t") == 0)
   {
-    float weight = 0.0f;
-    float sigma = 1.0f;
-    buf = reader.readLine();
-    // Skip any lines that start with a '#' character
-    if(buf[0] == '#')
-    {
-      continue;
-    }
-    buf = buf.trimmed();
+    setDelimiter(" ");
+  }
 
-    // Remove multiple Delimiters if wanted by the user.
-    if(m_IgnoreMultipleDelimiters)
-    {
-      buf = buf.simplified();
-    }
-    QString delimiter = getDelimiter();
-    if(delimiter.compare("\t") == 0)
-    {
-      setDelimiter(" ");
-    }
-    tokens = buf.split(*(getDelimiter().toLatin1().data()));
+  // Values in File are in Radians and the user wants them in Degrees or the values are in
+  // Degrees but the user wants them in Radians. The conversion is done while parsing.
+  double unitConversion = 1.0;
+  if(!m_FileAnglesInDegrees && m_OutputAnglesInDegrees)
+  {
+    unitConversion = EbsdLib::Constants::k_RadToDeg;
+  }
+  else if(m_FileAnglesInDegrees && !m_OutputAnglesInDegrees)
+  {
+    unitConversion = EbsdLib::Constants::k_DegToRad;
+  }
 
-    OrientationF euler(3);
-    if(m_AngleRepresentation == EulerAngles)
-    {
-      euler[0] = tokens[0].trimmed().toFloat(&ok);
-      euler[1] = tokens[1].trimmed().toFloat(&ok);
-      euler[2] = tokens[2].trimmed().toFloat(&ok);
-      weight = tokens[3].trimmed().toFloat(&ok);
-      sigma = tokens[4].trimmed().toFloat(&ok);
-    }
-    else if(m_AngleRepresentation == QuaternionAngles)
-    {
-      QuatF quat(4);
-      quat[0] = tokens[0].trimmed().toFloat(&ok);
-      quat[1] = tokens[1].trimmed().toFloat(&ok);
-      quat[2] = tokens[2].trimmed().toFloat(&ok);
-      quat[3] = tokens[3].trimmed().toFloat(&ok);
-      euler = OrientationTransformation::qu2eu<QuatF, OrientationF>(quat);
-      weight = tokens[4].trimmed().toFloat(&ok);
-      sigma = tokens[5].trimmed().toFloat(&ok);
-    }
-    else if(m_AngleRepresentation == RodriguezAngles)
-    {
-      Orientation<float> rod(4, 0.0);
-      rod[0] = tokens[0].trimmed().toFloat(&ok);
-      rod[1] = tokens[1].trimmed().toFloat(&ok);
-      rod[2] = tokens[2].trimmed().toFloat(&ok);
-      euler = OrientationTransformation::ro2eu<OrientationF, OrientationF>(rod);
-      weight = tokens[3].trimmed().toFloat(&ok);
-      sigma = tokens[4].trimmed().toFloat(&ok);
-    }
+  std::vector<AngleDataChunk> chunks = createDataChunks(dataBegin, end);
 
-    // Values in File are in Radians and the user wants them in Degrees
-    if(!m_FileAnglesInDegrees && m_OutputAnglesInDegrees)
-    {
-      euler[0] = euler[0] * EbsdLib::Constants::k_RadToDeg;
-      euler[1] = euler[1] * EbsdLib::Constants::k_RadToDeg;
-      euler[2] = euler[2] * EbsdLib::Constants::k_RadToDeg;
-    }
-    // Values are in Degrees but user wants them in Radians
-    else if(m_FileAnglesInDegrees && !m_OutputAnglesInDegrees)
+  // Count the lines in each chunk so that every chunk knows the tuple index of its first line
+  CountAngleLinesImpl countLines(&chunks, end);
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  bool doParallel = true;
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size()), countLines, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    countLines.generate(0, chunks.size());
+  }
+
+  size_t totalLines = 0;
+  for(auto& chunk : chunks)
+  {
+    chunk.startLine = totalLines;
+    totalLines += chunk.numLines;
+  }
+
+  char delimiterChar = *(getDelimiter().toLatin1().constData());
+  ParseAngleLinesImpl parseLines(&chunks, angles->getPointer(0), static_cast<size_t>(numOrients), m_AngleRepresentation, delimiterChar, m_IgnoreMultipleDelimiters, unitConversion);
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size()), parseLines, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    parseLines.generate(0, chunks.size());
+  }
+
+  if(nullptr != mapped)
+  {
+    reader.unmap(mapped);
+  }
+
+  // Report the first error in file order, just like the line by line parser would. Lines
+  // missing from the end of the file are treated as empty lines.
+  size_t errorLine = k_NoError;
+  int errorTokenCount = 1;
+  for(const auto& chunk : chunks)
+  {
+    if(chunk.errorLine != k_NoError)
     {
-      euler[0] = euler[0] * EbsdLib::Constants::k_DegToRad;
-      euler[1] = euler[1] * EbsdLib::Constants::k_DegToRad;
-      euler[2] = euler[2] * EbsdLib::Constants::k_DegToRad;
+      errorLine = chunk.errorLine;
+      errorTokenCount = chunk.errorTokenCount;
+      break;
     }
-
-    // Store the values into our array
-    angles->setComponent(i, 0, euler[0]);
-    angles->setComponent(i, 1, euler[1]);
-    angles->setComponent(i, 2, euler[2]);
-    angles->setComponent(i, 3, weight);
-    angles->setComponent(i, 4, sigma);
-    //   qDebug() << "reading line: " << i ;
+  }
+  if(errorLine == k_NoError && totalLines < static_cast<size_t>(numOrients))
+  {
+    errorLine = totalLines;
+  }
+  if(errorLine != k_NoError)
+  {
+    int numRequired = (m_AngleRepresentation == QuaternionAngles) ? 6 : 5;
+    QString msg = QObject::tr("Line %1 of the angle data has %2 values but %3 values are required").arg(errorLine).arg(errorTokenCount).arg(numRequired);
+    setErrorCode(-103);
+    setErrorMessage(msg);
+    return EbsdLib::FloatArrayType::NullPointer();
   }
 
   return angles;
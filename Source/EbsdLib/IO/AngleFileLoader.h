@@ -167,6 +167,13 @@ public:
    */
   bool getIgnoreMultipleDelimiters() const;
 
+  /**
+   * @brief Reads the angle file into an array with 5 components per tuple: the 3 Euler angles, the
+   * weight and the sigma. The file is memory mapped and its lines are parsed in parallel straight
+   * into the array, converting Quaternions and Rodrigues vectors to Euler angles and the angles into
+   * the requested units in the same pass.
+   * @return The angles or a nullptr if the file could not be read (See getErrorCode())
+   */
   EbsdLib::FloatArrayType::Pointer loadData();
 
 protected:
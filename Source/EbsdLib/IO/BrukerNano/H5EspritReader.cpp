@@ -46,6 +46,7 @@
 #include "EbsdLib/Core/EbsdLibConstants.h"
 #include "EbsdLib/Core/EbsdMacros.h"
 #include "EbsdLib/IO/BrukerNano/EspritPhase.h"
+#include "EbsdLib/IO/H5ScanRegion.hpp"
 
 // -----------------------------------------------------------------------------
 H5EspritReader::H5EspritReader()
@@ -600,6 +601,29 @@ int H5EspritReader::readData(hid_t parId)
     return -301;
   }
 
+  // Only the rows and columns of the region of interest are read when one was set
+  bool readRegion = (m_RoiWidth > 0 && m_RoiHeight > 0);
+  if(readRegion)
+  {
+    if(!EbsdLib::H5ScanRegion::fitsInScan(m_RoiX0, m_RoiY0, m_RoiWidth, m_RoiHeight, nColumns, nRows))
+    {
+      QString msg;
+      QTextStream ss(&msg);
+      ss << "The region of interest X=" << m_RoiX0 << " Y=" << m_RoiY0 << " Width=" << m_RoiWidth << " Height=" << m_RoiHeight << " does not fit inside the scan of " << nColumns << " x " << nRows
+         << " points.";
+      setErrorCode(-90302);
+      setErrorMessage(msg);
+      return -302;
+    }
+    totalDataRows = static_cast<size_t>(m_RoiWidth) * static_cast<size_t>(m_RoiHeight);
+  }
+
+  // Buffers the caller registered must hold every scan point before HDF5 writes into them
+  if(checkDestinationBuffers(totalDataRows) < 0)
+  {
+    return getErrorCode();
+  }
+
   hid_t gid = H5Gopen(parId, EbsdLib::H5Esprit::Data.toLatin1().data(), H5P_DEFAULT);
   if(gid < 0)
   {
@@ -644,16 +668,28 @@ int H5EspritReader::readData(hid_t parId)
     QVector<hsize_t> dims;
     size_t type_size = 0;
     err = QH5Lite::getDatasetInfo(gid, EbsdLib::H5Esprit::RawPatterns, dims, type_class, type_size);
-    if(err >= 0) // Only read the pattern data if the pattern data is available.
+    if(err >= 0 && m_PatternBinFactor > 1)
     {
-      totalDataRows = std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>());
+      err = readBinnedPatternData(nColumns, readRegion ? totalDataRows : static_cast<size_t>(dims[0]));
+    }
+    else if(err >= 0) // Only read the pattern data if the pattern data is available.
+    {
+      size_t numPatterns = readRegion ? totalDataRows : static_cast<size_t>(dims[0]);
+      totalDataRows = std::accumulate(dims.begin() + 1, dims.end(), numPatterns, std::multiplies<size_t>());
 
       // Set the pattern dimensions
       m_PatternDims[0] = dims[1];
       m_PatternDims[1] = dims[2];
 
       m_PatternData = this->allocateArray<uint8_t>(totalDataRows);
-      err = QH5Lite::readPointerDataset(gid, EbsdLib::H5Esprit::RawPatterns, m_PatternData);
+      if(readRegion)
+      {
+        err = EbsdLib::H5ScanRegion::readDataset(gid, EbsdLib::H5Esprit::RawPatterns, nColumns, m_RoiX0, m_RoiY0, m_RoiWidth, m_RoiHeight, m_PatternData);
+      }
+      else
+      {
+        err = QH5Lite::readPointerDataset(gid, EbsdLib::H5Esprit::RawPatterns, m_PatternData);
+      }
     }
   }
   err = H5Gclose(gid);
@@ -661,6 +697,49 @@ int H5EspritReader::readData(hid_t parId)
   return err;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5EspritReader::readBinnedPatternData(size_t nColumns, size_t numPatterns)
+{
+  H5PatternAccessor::Pointer accessor = createPatternAccessor();
+  if(nullptr == accessor)
+  {
+    return getErrorCode();
+  }
+  std::vector<size_t> binnedDims = accessor->getBinnedPatternDims(static_cast<size_t>(m_PatternBinFactor));
+  if(binnedDims.empty())
+  {
+    setErrorCode(-90041);
+    setErrorMessage(QString("H5EspritReader Error: The patterns can not be binned by a factor of %1").arg(m_PatternBinFactor));
+    return getErrorCode();
+  }
+  m_PatternDims[0] = static_cast<int>(binnedDims[0]);
+  m_PatternDims[1] = static_cast<int>(binnedDims[1]);
+
+  // Nothing is cached, each block of full resolution patterns is dropped once it has been binned
+  accessor->setCacheSize(0);
+  m_PatternData = this->allocateArray<uint8_t>(numPatterns * binnedDims[0] * binnedDims[1]);
+  size_t factor = static_cast<size_t>(m_PatternBinFactor);
+  int err = 0;
+  if(m_RoiWidth > 0 && m_RoiHeight > 0)
+  {
+    err = accessor->readBinnedRegion(nColumns, static_cast<size_t>(m_RoiX0), static_cast<size_t>(m_RoiY0), static_cast<size_t>(m_RoiWidth), static_cast<size_t>(m_RoiHeight), factor, m_PatternBinningMode,
+                                     m_PatternData);
+  }
+  else
+  {
+    err = accessor->readBinnedPatterns(0, numPatterns, factor, m_PatternBinningMode, m_PatternData);
+  }
+  if(err < 0)
+  {
+    setErrorCode(-90042);
+    setErrorMessage(accessor->getErrorMessage());
+    return getErrorCode();
+  }
+  return 0;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -678,6 +757,58 @@ void H5EspritReader::readAllArrays(bool b)
   m_ReadAllArrays = b;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5EspritReader::setRegionOfInterest(int x0, int y0, int width, int height)
+{
+  m_RoiX0 = x0;
+  m_RoiY0 = y0;
+  m_RoiWidth = width;
+  m_RoiHeight = height;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5EspritReader::setPatternBinning(int factor, EbsdLib::PatternBinning::Mode mode)
+{
+  m_PatternBinFactor = factor;
+  m_PatternBinningMode = mode;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5EspritReader::getPatternBinFactor() const
+{
+  return m_PatternBinFactor;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdLib::PatternBinning::Mode H5EspritReader::getPatternBinningMode() const
+{
+  return m_PatternBinningMode;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5PatternAccessor::Pointer H5EspritReader::createPatternAccessor()
+{
+  QString datasetPath = QString("%1/%2/%3/%4").arg(m_HDF5Path, EbsdLib::H5Esprit::EBSD, EbsdLib::H5Esprit::Data, EbsdLib::H5Esprit::RawPatterns);
+  H5PatternAccessor::Pointer accessor = H5PatternAccessor::New();
+  if(accessor->open(getFileName(), datasetPath) < 0)
+  {
+    setErrorCode(-90040);
+    setErrorMessage(accessor->getErrorMessage());
+    return H5PatternAccessor::NullPointer();
+  }
+  return accessor;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -38,6 +38,7 @@
 
 #include "EbsdLib/EbsdLib.h"
 #include "EbsdLib/Core/EbsdSetGetMacros.h"
+#include "EbsdLib/IO/H5PatternAccessor.h"
 #include "EbsdLib/IO/BrukerNano/EspritConstants.h"
 #include "EbsdLib/IO/BrukerNano/EspritPhase.h"
 #include "EbsdLib/IO/EbsdReader.h"
@@ -211,6 +212,46 @@ public:
    */
   void readAllArrays(bool b);
 
+  /**
+   * @brief Restricts readFile() to a rectangular region of the scan. Every requested dataset, including
+   * the pattern data, is read with a strided HDF5 hyperslab selection so only the region is transferred
+   * from the file. The arrays hold width * height points in row major order and getNumberOfElements()
+   * returns that count, while the header values still describe the complete scan. Passing a width or
+   * height of zero reads the complete scan again.
+   * @param x0 The first column of the region
+   * @param y0 The first row of the region
+   * @param width The number of columns in the region
+   * @param height The number of rows in the region
+   */
+  void setRegionOfInterest(int x0, int y0, int width, int height);
+
+  /**
+   * @brief Bins the patterns as ReadPatternData reads them. The pattern dataset is read one block of
+   * chunks at a time and each block is binned into PatternData, so the full resolution patterns are
+   * never held in memory. PatternDims then holds the binned dimensions. A factor of 1 reads the full
+   * resolution patterns.
+   * @param factor The number of pattern pixels along each side of a binned pixel
+   * @param mode Average the pixels of a block or keep only its top left pixel
+   */
+  void setPatternBinning(int factor, EbsdLib::PatternBinning::Mode mode = EbsdLib::PatternBinning::Mode::Average);
+
+  /**
+   * @brief Returns the pattern binning factor
+   */
+  int getPatternBinFactor() const;
+
+  /**
+   * @brief Returns how the pixels of the pattern are binned
+   */
+  EbsdLib::PatternBinning::Mode getPatternBinningMode() const;
+
+  /**
+   * @brief Opens the pattern dataset of the scan for random access. Unlike ReadPatternData this does not
+   * load the patterns into memory, they are read on demand through the cache of the accessor.
+   * @return The opened accessor or a nullptr if the pattern dataset could not be opened (See getErrorCode())
+   */
+  H5PatternAccessor::Pointer createPatternAccessor();
+
   int getXDimension() override;
   void setXDimension(int xdim) override;
   int getYDimension() override;
@@ -226,6 +267,14 @@ protected:
    */
   int readData(hid_t parId);
 
+  /**
+   * @brief Reads the pattern data through a pattern accessor and bins it by the PatternBinFactor
+   * @param nColumns The number of columns of the scan
+   * @param numPatterns The number of patterns to read, which is the size of the region of interest if one is set
+   * @return Zero on success or a negative error code
+   */
+  int readBinnedPatternData(size_t nColumns, size_t numPatterns);
+
   /**
    * @brief sanityCheckForOpening
    * @return
@@ -237,6 +286,12 @@ private:
 
   QSet<QString> m_ArrayNames;
   bool m_ReadAllArrays = true;
+  int m_RoiX0 = 0;
+  int m_RoiY0 = 0;
+  int m_RoiWidth = 0;
+  int m_RoiHeight = 0;
+  int m_PatternBinFactor = 1;
+  EbsdLib::PatternBinning::Mode m_PatternBinningMode = EbsdLib::PatternBinning::Mode::Average;
 
   QVector<EspritPhase::Pointer> m_Phases;
 
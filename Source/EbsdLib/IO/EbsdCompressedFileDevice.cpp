@@ -0,0 +1,606 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "EbsdCompressedFileDevice.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <QtCore/QFile>
+
+#ifdef EbsdLib_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef EbsdLib_USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace
+{
+const size_t k_InputBufferSize = 256 * 1024;
+const size_t k_MaxQueuedBlocks = 4;
+
+using BlockSink = std::function<bool(QByteArray&)>;
+
+#ifdef EbsdLib_USE_ZLIB
+// -----------------------------------------------------------------------------
+// Inflates every gzip member of the file, handing each full output block to the sink
+// -----------------------------------------------------------------------------
+QString inflateGzip(QFile& file, size_t blockSize, const BlockSink& sink)
+{
+  z_stream strm;
+  ::memset(&strm, 0, sizeof(z_stream));
+  // Adding 32 to the window bits lets zlib detect and skip the gzip header
+  if(inflateInit2(&strm, 15 + 32) != Z_OK)
+  {
+    return QString("zlib could not be initialized");
+  }
+
+  std::vector<char> input(k_InputBufferSize);
+  QByteArray block(static_cast<int>(blockSize), Qt::Uninitialized);
+  strm.next_out = reinterpret_cast<Bytef*>(block.data());
+  strm.avail_out = static_cast<uInt>(blockSize);
+
+  QString error;
+  bool streamEnded = false;
+  bool cancelled = false;
+  while(error.isEmpty() && !cancelled)
+  {
+    qint64 numRead = file.read(input.data(), static_cast<qint64>(input.size()));
+    if(numRead < 0)
+    {
+      error = file.errorString();
+      break;
+    }
+    if(numRead == 0)
+    {
+      break;
+    }
+    strm.next_in = reinterpret_cast<Bytef*>(input.data());
+    strm.avail_in = static_cast<uInt>(numRead);
+
+    bool outputFull = false;
+    do
+    {
+      // Another gzip member follows the one that just ended
+      if(streamEnded && strm.avail_in > 0)
+      {
+        inflateReset(&strm);
+        streamEnded = false;
+      }
+      int ret = inflate(&strm, Z_NO_FLUSH);
+      if(ret == Z_STREAM_END)
+      {
+        streamEnded = true;
+      }
+      else if(ret != Z_OK && ret != Z_BUF_ERROR)
+      {
+        error = QString("The gzip data is corrupt: %1").arg(nullptr != strm.msg ? strm.msg : "Unknown zlib error");
+        break;
+      }
+      outputFull = (strm.avail_out == 0);
+      if(outputFull)
+      {
+        if(!sink(block))
+        {
+          cancelled = true;
+          break;
+        }
+        block = QByteArray(static_cast<int>(blockSize), Qt::Uninitialized);
+        strm.next_out = reinterpret_cast<Bytef*>(block.data());
+        strm.avail_out = static_cast<uInt>(blockSize);
+      }
+    } while(strm.avail_in > 0 || outputFull);
+  }
+
+  if(error.isEmpty() && !cancelled)
+  {
+    if(!streamEnded)
+    {
+      error = QString("The gzip data ended before the end of the compressed stream. The file is probably truncated.");
+    }
+    else if(strm.avail_out < blockSize)
+    {
+      block.resize(static_cast<int>(blockSize - strm.avail_out));
+      sink(block);
+    }
+  }
+  inflateEnd(&strm);
+  return error;
+}
+#endif
+
+#ifdef EbsdLib_USE_ZSTD
+// -----------------------------------------------------------------------------
+// Decompresses every zstd frame of the file, handing each full output block to the sink
+// -----------------------------------------------------------------------------
+QString decompressZstd(QFile& file, size_t blockSize, const BlockSink& sink)
+{
+  ZSTD_DStream* dstream = ZSTD_createDStream();
+  if(nullptr == dstream)
+  {
+    return QString("The zstd decompression stream could not be created");
+  }
+  ZSTD_initDStream(dstream);
+
+  std::vector<char> input(ZSTD_DStreamInSize());
+  QByteArray block(static_cast<int>(blockSize), Qt::Uninitialized);
+  size_t filled = 0;
+
+  QString error;
+  size_t lastRet = 0;
+  bool cancelled = false;
+  while(error.isEmpty() && !cancelled)
+  {
+    qint64 numRead = file.read(input.data(), static_cast<qint64>(input.size()));
+    if(numRead < 0)
+    {
+      error = file.errorString();
+      break;
+    }
+    if(numRead == 0)
+    {
+      break;
+    }
+    ZSTD_inBuffer in = {input.data(), static_cast<size_t>(numRead), 0};
+    bool outputFull = false;
+    while(in.pos < in.size || outputFull)
+    {
+      ZSTD_outBuffer out = {block.data() + filled, blockSize - filled, 0};
+      lastRet = ZSTD_decompressStream(dstream, &out, &in);
+      if(ZSTD_isError(lastRet) != 0u)
+      {
+        error = QString("The zstd data is corrupt: %1").arg(ZSTD_getErrorName(lastRet));
+        break;
+      }
+      filled += out.pos;
+      outputFull = (filled == blockSize);
+      if(outputFull)
+      {
+        if(!sink(block))
+        {
+          cancelled = true;
+          break;
+        }
+        block = QByteArray(static_cast<int>(blockSize), Qt::Uninitialized);
+        filled = 0;
+      }
+    }
+  }
+
+  if(error.isEmpty() && !cancelled)
+  {
+    if(lastRet != 0)
+    {
+      error = QString("The zstd data ended before the end of the last frame. The file is probably truncated.");
+    }
+    else if(filled > 0)
+    {
+      block.resize(static_cast<int>(filled));
+      sink(block);
+    }
+  }
+  ZSTD_freeDStream(dstream);
+  return error;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString compressionName(EbsdCompressedFileDevice::Compression compression)
+{
+  switch(compression)
+  {
+  case EbsdCompressedFileDevice::Compression::Gzip:
+    return QString("gzip");
+  case EbsdCompressedFileDevice::Compression::Zstd:
+    return QString("zstd");
+  default:
+    break;
+  }
+  return QString("uncompressed");
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdCompressedFileDevice::EbsdCompressedFileDevice(const QString& filePath, size_t blockSize)
+: m_FilePath(filePath)
+, m_BlockSize(std::max(blockSize, static_cast<size_t>(1)))
+, m_Compression(DetectCompression(filePath))
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdCompressedFileDevice::~EbsdCompressedFileDevice()
+{
+  stopWorker();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdCompressedFileDevice::Compression EbsdCompressedFileDevice::DetectCompression(const QString& filePath)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return Compression::None;
+  }
+  QByteArray magic = file.read(4);
+  if(magic.size() >= 2 && static_cast<uint8_t>(magic[0]) == 0x1F && static_cast<uint8_t>(magic[1]) == 0x8B)
+  {
+    return Compression::Gzip;
+  }
+  if(magic.size() == 4 && static_cast<uint8_t>(magic[0]) == 0x28 && static_cast<uint8_t>(magic[1]) == 0xB5 && static_cast<uint8_t>(magic[2]) == 0x2F && static_cast<uint8_t>(magic[3]) == 0xFD)
+  {
+    return Compression::Zstd;
+  }
+  return Compression::None;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdCompressedFileDevice::IsSupported(Compression compression)
+{
+  switch(compression)
+  {
+  case Compression::None:
+    return true;
+  case Compression::Gzip:
+#ifdef EbsdLib_USE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+  case Compression::Zstd:
+#ifdef EbsdLib_USE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::unique_ptr<QIODevice> EbsdCompressedFileDevice::OpenForReading(const QString& filePath, QIODevice::OpenMode mode, QString& errorMessage)
+{
+  std::unique_ptr<QIODevice> device;
+  if(DetectCompression(filePath) == Compression::None)
+  {
+    device.reset(new QFile(filePath));
+  }
+  else
+  {
+    device.reset(new EbsdCompressedFileDevice(filePath));
+  }
+  if(!device->open(mode))
+  {
+    errorMessage = device->errorString();
+    device.reset();
+  }
+  return device;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdCompressedFileDevice::Compression EbsdCompressedFileDevice::getCompression() const
+{
+  return m_Compression;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdCompressedFileDevice::open(QIODevice::OpenMode mode)
+{
+  if(isOpen())
+  {
+    return false;
+  }
+  if((mode & QIODevice::WriteOnly) != 0 || (mode & QIODevice::ReadOnly) == 0)
+  {
+    setErrorString(QString("Compressed files can only be opened for reading"));
+    return false;
+  }
+  if(m_Compression == Compression::None || !IsSupported(m_Compression))
+  {
+    setErrorString(QString("This build of EbsdLib can not decompress %1 files").arg(compressionName(m_Compression)));
+    return false;
+  }
+  QFile file(m_FilePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    setErrorString(file.errorString());
+    return false;
+  }
+  file.close();
+
+  m_Blocks.clear();
+  m_CurrentBlock.clear();
+  m_CurrentPos = 0;
+  m_Finished = false;
+  m_Cancel = false;
+  m_DecompressionError.clear();
+  QIODevice::open(mode);
+  m_Worker = std::thread(&EbsdCompressedFileDevice::decompress, this);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdCompressedFileDevice::close()
+{
+  stopWorker();
+  QIODevice::close();
+  m_Blocks.clear();
+  m_CurrentBlock.clear();
+  m_CurrentPos = 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdCompressedFileDevice::stopWorker()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Cancel = true;
+  }
+  m_SpaceReady.notify_all();
+  if(m_Worker.joinable())
+  {
+    m_Worker.join();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdCompressedFileDevice::isSequential() const
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdCompressedFileDevice::atEnd() const
+{
+  if(!isOpen())
+  {
+    return true;
+  }
+  if(QIODevice::bytesAvailable() > 0 || m_CurrentPos < m_CurrentBlock.size())
+  {
+    return false;
+  }
+  return !waitForBlock();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 EbsdCompressedFileDevice::bytesAvailable() const
+{
+  qint64 numBytes = QIODevice::bytesAvailable() + (m_CurrentBlock.size() - m_CurrentPos);
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for(const auto& block : m_Blocks)
+  {
+    numBytes += block.size();
+  }
+  return numBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdCompressedFileDevice::waitForBlock() const
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_BlockReady.wait(lock, [this] { return !m_Blocks.empty() || m_Finished; });
+  return !m_Blocks.empty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int EbsdCompressedFileDevice::nextBlock()
+{
+  if(m_CurrentPos < m_CurrentBlock.size())
+  {
+    return 1;
+  }
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_BlockReady.wait(lock, [this] { return !m_Blocks.empty() || m_Finished; });
+  if(m_Blocks.empty())
+  {
+    if(!m_DecompressionError.isEmpty())
+    {
+      setErrorString(m_DecompressionError);
+      return -1;
+    }
+    return 0;
+  }
+  m_CurrentBlock = std::move(m_Blocks.front());
+  m_Blocks.pop_front();
+  m_CurrentPos = 0;
+  lock.unlock();
+  m_SpaceReady.notify_one();
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 EbsdCompressedFileDevice::readData(char* data, qint64 maxSize)
+{
+  qint64 numRead = 0;
+  while(numRead < maxSize)
+  {
+    int status = nextBlock();
+    if(status < 0)
+    {
+      return (numRead > 0) ? numRead : -1;
+    }
+    if(status == 0)
+    {
+      break;
+    }
+    qint64 count = std::min(maxSize - numRead, static_cast<qint64>(m_CurrentBlock.size()) - m_CurrentPos);
+    ::memcpy(data + numRead, m_CurrentBlock.constData() + m_CurrentPos, static_cast<size_t>(count));
+    m_CurrentPos += count;
+    numRead += count;
+  }
+  return numRead;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 EbsdCompressedFileDevice::readLineData(char* data, qint64 maxSize)
+{
+  // Copy whole runs of the current block up to the newline instead of a character at a time
+  qint64 numRead = 0;
+  while(numRead < maxSize)
+  {
+    int status = nextBlock();
+    if(status < 0)
+    {
+      return (numRead > 0) ? numRead : -1;
+    }
+    if(status == 0)
+    {
+      break;
+    }
+    const char* first = m_CurrentBlock.constData() + m_CurrentPos;
+    qint64 count = std::min(maxSize - numRead, static_cast<qint64>(m_CurrentBlock.size()) - m_CurrentPos);
+    const char* newLine = static_cast<const char*>(::memchr(first, '\n', static_cast<size_t>(count)));
+    if(nullptr != newLine)
+    {
+      count = (newLine - first) + 1;
+    }
+    ::memcpy(data + numRead, first, static_cast<size_t>(count));
+    m_CurrentPos += count;
+    numRead += count;
+    if(nullptr != newLine)
+    {
+      break;
+    }
+  }
+  return numRead;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 EbsdCompressedFileDevice::writeData(const char* data, qint64 maxSize)
+{
+  Q_UNUSED(data)
+  Q_UNUSED(maxSize)
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdCompressedFileDevice::pushBlock(QByteArray& block)
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_SpaceReady.wait(lock, [this] { return m_Cancel || m_Blocks.size() < k_MaxQueuedBlocks; });
+  if(m_Cancel)
+  {
+    return false;
+  }
+  m_Blocks.push_back(std::move(block));
+  lock.unlock();
+  m_BlockReady.notify_one();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdCompressedFileDevice::decompress()
+{
+  QString error;
+  // The worker owns its own QFile so the file is only ever touched by this thread
+  QFile file(m_FilePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    error = file.errorString();
+  }
+  else
+  {
+    BlockSink sink = [this](QByteArray& block) { return pushBlock(block); };
+    switch(m_Compression)
+    {
+#ifdef EbsdLib_USE_ZLIB
+    case Compression::Gzip:
+      error = inflateGzip(file, m_BlockSize, sink);
+      break;
+#endif
+#ifdef EbsdLib_USE_ZSTD
+    case Compression::Zstd:
+      error = decompressZstd(file, m_BlockSize, sink);
+      break;
+#endif
+    default:
+      error = QString("This build of EbsdLib can not decompress %1 files").arg(compressionName(m_Compression));
+      break;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_DecompressionError = error;
+    m_Finished = true;
+  }
+  m_BlockReady.notify_all();
+}
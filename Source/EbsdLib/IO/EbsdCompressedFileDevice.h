@@ -0,0 +1,168 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QIODevice>
+#include <QtCore/QString>
+
+#include "EbsdLib/EbsdLib.h"
+
+/**
+ * @class EbsdCompressedFileDevice EbsdCompressedFileDevice.h EbsdLib/IO/EbsdCompressedFileDevice.h
+ * @brief A read only, sequential QIODevice that decompresses a gzip or zstd compressed file as a
+ * stream. A worker thread reads and decompresses the file in fixed size blocks and hands them to the
+ * reading thread through a small bounded queue, so decompression overlaps with parsing and the
+ * decompressed file is never held in memory or written to disk as a whole.
+ *
+ * gzip support needs EbsdLib_USE_ZLIB and zstd support needs EbsdLib_USE_ZSTD to be enabled when
+ * EbsdLib is built. Opening a file whose compression is not supported fails with an error string
+ * that says so.
+ */
+class EbsdLib_EXPORT EbsdCompressedFileDevice : public QIODevice
+{
+public:
+  enum class Compression : int
+  {
+    None = 0,
+    Gzip = 1,
+    Zstd = 2
+  };
+
+  static const size_t k_DefaultBlockSize = 1024 * 1024;
+
+  /**
+   * @brief Creates a device for a compressed file.
+   * @param filePath The compressed file
+   * @param blockSize The number of decompressed bytes in each block that is handed to the reading thread
+   */
+  EbsdCompressedFileDevice(const QString& filePath, size_t blockSize = k_DefaultBlockSize);
+  ~EbsdCompressedFileDevice() override;
+
+  /**
+   * @brief Detects the compression of a file from the magic bytes at its start.
+   * @param filePath
+   * @return Compression::None if the file is not compressed or can not be read
+   */
+  static Compression DetectCompression(const QString& filePath);
+
+  /**
+   * @brief Returns true if this build of EbsdLib can decompress the given type of compression.
+   * @param compression
+   * @return
+   */
+  static bool IsSupported(Compression compression);
+
+  /**
+   * @brief Opens a file for reading. Compressed files are returned as an open EbsdCompressedFileDevice,
+   * all other files as an open QFile, so the caller can tell the two apart with qobject_cast<QFile*>().
+   * @param filePath The file to open
+   * @param mode The open mode, which must include QIODevice::ReadOnly
+   * @param errorMessage Output: The reason the file could not be opened
+   * @return The open device or nullptr if the file could not be opened
+   */
+  static std::unique_ptr<QIODevice> OpenForReading(const QString& filePath, QIODevice::OpenMode mode, QString& errorMessage);
+
+  /**
+   * @brief Returns the compression of the file this device reads.
+   */
+  Compression getCompression() const;
+
+  bool open(QIODevice::OpenMode mode) override;
+  void close() override;
+  bool isSequential() const override;
+  bool atEnd() const override;
+  qint64 bytesAvailable() const override;
+
+protected:
+  qint64 readData(char* data, qint64 maxSize) override;
+  qint64 readLineData(char* data, qint64 maxSize) override;
+  qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+  QString m_FilePath;
+  size_t m_BlockSize;
+  Compression m_Compression;
+
+  std::thread m_Worker;
+  mutable std::mutex m_Mutex;
+  mutable std::condition_variable m_BlockReady;
+  std::condition_variable m_SpaceReady;
+  std::deque<QByteArray> m_Blocks;
+  QByteArray m_CurrentBlock;
+  qint64 m_CurrentPos = 0;
+  bool m_Finished = false;
+  bool m_Cancel = false;
+  QString m_DecompressionError;
+
+  /**
+   * @brief Runs on the worker thread: Reads and decompresses the file and queues the decompressed blocks.
+   */
+  void decompress();
+
+  /**
+   * @brief Queues a decompressed block, waiting while the queue is full.
+   * @return False if the device was closed and decompression should stop
+   */
+  bool pushBlock(QByteArray& block);
+
+  /**
+   * @brief Waits until a decompressed block is available or the worker has finished.
+   * @return False if there is no more data
+   */
+  bool waitForBlock() const;
+
+  /**
+   * @brief Makes the next queued block the current block if the current block was consumed.
+   * @return 1 if there is data in the current block, 0 at the end of the data or -1 if decompression failed
+   */
+  int nextBlock();
+
+  void stopWorker();
+
+public:
+  EbsdCompressedFileDevice(const EbsdCompressedFileDevice&) = delete;            // Copy Constructor Not Implemented
+  EbsdCompressedFileDevice(EbsdCompressedFileDevice&&) = delete;                 // Move Constructor Not Implemented
+  EbsdCompressedFileDevice& operator=(const EbsdCompressedFileDevice&) = delete; // Copy Assignment Not Implemented
+  EbsdCompressedFileDevice& operator=(EbsdCompressedFileDevice&&) = delete;      // Move Assignment Not Implemented
+};
@@ -34,6 +34,7 @@
 * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #pragma once
 
+#include <QtCore/QStringList>
 #include <QtCore/QtDebug>
 
 #include "EbsdLib/EbsdLib.h"
@@ -116,6 +117,79 @@ class EbsdLib_EXPORT EbsdImporter
       return m_Cancel;
     }
 
+    /**
+    * @brief Setter property for NumberOfParseThreads. The number of files that importFiles() parses
+    * concurrently. Zero uses the number of hardware threads.
+    */
+    void setNumberOfParseThreads(int value)
+    {
+      m_NumberOfParseThreads = value;
+    }
+
+    /**
+    * @brief Getter property for NumberOfParseThreads
+    * @return Value of NumberOfParseThreads
+    */
+    int getNumberOfParseThreads() const
+    {
+      return m_NumberOfParseThreads;
+    }
+
+    /**
+    * @brief Setter property for MaxQueuedFiles. The largest number of parsed files that importFiles()
+    * holds in memory at once, which bounds the memory use of a batch import.
+    */
+    void setMaxQueuedFiles(int value)
+    {
+      m_MaxQueuedFiles = value;
+    }
+
+    /**
+    * @brief Getter property for MaxQueuedFiles
+    * @return Value of MaxQueuedFiles
+    */
+    int getMaxQueuedFiles() const
+    {
+      return m_MaxQueuedFiles;
+    }
+
+    /**
+    * @brief Setter property for ChunkRows. The number of scan rows stored in each chunk of the data
+    * arrays. Zero writes the data arrays with a contiguous layout.
+    */
+    void setChunkRows(int value)
+    {
+      m_ChunkRows = value;
+    }
+
+    /**
+    * @brief Getter property for ChunkRows
+    * @return Value of ChunkRows
+    */
+    int getChunkRows() const
+    {
+      return m_ChunkRows;
+    }
+
+    /**
+    * @brief Setter property for CompressionLevel. The deflate level (1 - 9) of the chunked data arrays,
+    * which are also shuffled before they are compressed. Zero disables compression. Only used when
+    * ChunkRows is greater than zero.
+    */
+    void setCompressionLevel(int value)
+    {
+      m_CompressionLevel = value;
+    }
+
+    /**
+    * @brief Getter property for CompressionLevel
+    * @return Value of CompressionLevel
+    */
+    int getCompressionLevel() const
+    {
+      return m_CompressionLevel;
+    }
+
     /**
      * @brief Either prints a message or sends the message to the User Interface
      * @param message The message to print
@@ -146,6 +220,29 @@ class EbsdLib_EXPORT EbsdImporter
      */
     virtual int importFile(hid_t fileId, int64_t index, const QString& ebsd) = 0;
 
+    /**
+     * @brief Imports a stack of EBSD files. The slices of each file are stored after the slices of the
+     * file before it, starting at index z. This implementation imports the files one after the other,
+     * subclasses may parse several files concurrently (See setNumberOfParseThreads()).
+     * @param fileId HDF5 fileId of an open HDF5 file that the data will be stored into
+     * @param z The integer index value of the first slice
+     * @param ebsdFiles The raw data files from the manufacturer in slice order
+     * @return Zero on success, negative if a file could not be imported
+     */
+    virtual int importFiles(hid_t fileId, int64_t z, const QStringList& ebsdFiles)
+    {
+      for(const auto& ebsdFile : ebsdFiles)
+      {
+        int err = importFile(fileId, z, ebsdFile);
+        if(err < 0)
+        {
+          return err;
+        }
+        z += numberOfSlicesImported();
+      }
+      return 0;
+    }
+
     /**
      * @brief Returns the dimensions for the EBSD Data set
      * @param x Number of X Voxels (out)
@@ -185,4 +282,8 @@ class EbsdLib_EXPORT EbsdImporter
   private:
     int m_ErrorCode = 0;
     bool m_Cancel = false;
+    int m_NumberOfParseThreads = 0;
+    int m_MaxQueuedFiles = 4;
+    int m_ChunkRows = 0;
+    int m_CompressionLevel = 0;
 };
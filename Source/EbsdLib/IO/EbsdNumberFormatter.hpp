@@ -0,0 +1,192 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief The NumberFormatter namespace holds the number to text conversions that are shared by the
+ * text based writers (.ang, .ctf). Every function writes directly into a caller provided buffer and
+ * returns the position one past the last character that was written, so whole blocks of lines can be
+ * formatted without any per value allocations or calls into the C library. The text is identical to
+ * the text that printf("%*d") and printf("%*.*f") produce, except that the decimal separator is
+ * always a '.', whatever the current locale is.
+ */
+namespace EbsdLib
+{
+namespace NumberFormatter
+{
+/**
+ * @brief The largest number of characters formatInt32() writes when the width is smaller than this.
+ */
+const int k_MaxInt32Length = 11;
+
+namespace Detail
+{
+const double k_PowersOf10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+const int k_MaxFastPrecision = 9;
+
+/**
+ * @brief Scaled values must stay below 2^52 so that the fraction of the scaled value is exact.
+ */
+const double k_MaxFastScaled = 4503599627370496.0;
+
+/**
+ * @brief The scaled value is within half an ulp (2^-53 relative) of the exact product. A fraction that
+ * is closer than 8 times that to one half might round the other way with exact arithmetic.
+ */
+const double k_TieTolerance = 1.0 / 1125899906842624.0; // 2^-50
+
+/**
+ * @brief Right aligns 'length' characters in a field that is 'width' characters wide
+ */
+inline char* padAndCopy(char* out, const char* text, int length, int width)
+{
+  for(int i = length; i < width; i++)
+  {
+    *out++ = ' ';
+  }
+  ::memcpy(out, text, static_cast<size_t>(length));
+  return out + length;
+}
+} // namespace Detail
+
+/**
+ * @brief Returns the size of the buffer that formatFixed() needs for a float value. This includes room
+ * for the terminating null character that the C library fallback writes.
+ * @param precision The number of digits after the decimal point
+ * @param width The minimum field width
+ */
+inline size_t maxFixedLength(int precision, int width)
+{
+  // FLT_MAX has 39 integer digits, plus a sign and the decimal point
+  return static_cast<size_t>(std::max(width, 41 + precision)) + 1;
+}
+
+/**
+ * @brief Formats an integer the same way printf("%*d", width, value) does.
+ * @param out The buffer to write into. It must hold at least max(width, k_MaxInt32Length) characters.
+ * @param value
+ * @param width The minimum field width. Shorter values are padded with leading spaces.
+ * @return One past the last character that was written
+ */
+inline char* formatInt32(char* out, int32_t value, int width = 0)
+{
+  char text[16];
+  char* first = text + sizeof(text);
+  int64_t signedValue = value;
+  uint64_t digits = static_cast<uint64_t>(signedValue < 0 ? -signedValue : signedValue);
+  do
+  {
+    *--first = static_cast<char>('0' + digits % 10);
+    digits /= 10;
+  } while(digits != 0);
+  if(signedValue < 0)
+  {
+    *--first = '-';
+  }
+  return Detail::padAndCopy(out, first, static_cast<int>(text + sizeof(text) - first), width);
+}
+
+/**
+ * @brief Formats a float the same way printf("%*.*f", width, precision, value) does. Values are
+ * rounded with integer arithmetic. Only values that the C library would have to round on an exact
+ * tie, non finite values and values that are too large for the fast path are handed to snprintf().
+ * @param out The buffer to write into. It must hold at least maxFixedLength(precision, width) characters.
+ * @param value
+ * @param precision The number of digits after the decimal point
+ * @param width The minimum field width. Shorter values are padded with leading spaces.
+ * @return One past the last character that was written
+ */
+inline char* formatFixed(char* out, float value, int precision, int width = 0)
+{
+  double v = static_cast<double>(value);
+  if(precision >= 0 && precision <= Detail::k_MaxFastPrecision && std::isfinite(v))
+  {
+    double scaled = std::fabs(v) * Detail::k_PowersOf10[precision];
+    if(scaled < Detail::k_MaxFastScaled)
+    {
+      double whole = std::floor(scaled);
+      double fraction = scaled - whole;
+      if(std::fabs(fraction - 0.5) > scaled * Detail::k_TieTolerance)
+      {
+        uint64_t digits = static_cast<uint64_t>(whole) + (fraction > 0.5 ? 1 : 0);
+        char text[40];
+        char* first = text + sizeof(text);
+        for(int i = 0; i < precision; i++)
+        {
+          *--first = static_cast<char>('0' + digits % 10);
+          digits /= 10;
+        }
+        if(precision > 0)
+        {
+          *--first = '.';
+        }
+        do
+        {
+          *--first = static_cast<char>('0' + digits % 10);
+          digits /= 10;
+        } while(digits != 0);
+        if(std::signbit(v))
+        {
+          *--first = '-';
+        }
+        return Detail::padAndCopy(out, first, static_cast<int>(text + sizeof(text) - first), width);
+      }
+    }
+  }
+
+  int length = ::snprintf(out, maxFixedLength(precision, width), "%*.*f", width, precision, v);
+  if(length < 0)
+  {
+    return out;
+  }
+  // The files always use a '.' as the decimal separator
+  const char decimalPoint = ::localeconv()->decimal_point[0];
+  if(decimalPoint != '.')
+  {
+    std::replace(out, out + length, decimalPoint, '.');
+  }
+  return out + length;
+}
+} // namespace NumberFormatter
+} // namespace EbsdLib
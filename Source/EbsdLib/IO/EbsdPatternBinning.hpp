@@ -0,0 +1,137 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The PatternBinning namespace reduces EBSD patterns to a lower resolution. A pattern of
+ * 'rows' x 'cols' pixels becomes a pattern of (rows / factor) x (cols / factor) pixels. Pixels in the
+ * last rows and columns that do not fill a complete factor x factor block are dropped, the same way
+ * the camera software bins patterns.
+ */
+namespace EbsdLib
+{
+namespace PatternBinning
+{
+enum class Mode : int
+{
+  Average = 0,  //!< Each output pixel is the rounded mean of its factor x factor block
+  Subsample = 1 //!< Each output pixel is the top left pixel of its factor x factor block
+};
+
+/**
+ * @brief Returns the size of a dimension of the binned pattern
+ */
+inline size_t binnedDimension(size_t dim, size_t factor)
+{
+  return (factor == 0) ? 0 : dim / factor;
+}
+
+/**
+ * @brief Bins consecutive patterns. The input and the output may not overlap.
+ * @param patterns The 'count' patterns of rows x cols pixels, stored row by row
+ * @param count The number of patterns
+ * @param rows The number of rows of an input pattern
+ * @param cols The number of columns of an input pattern
+ * @param factor The number of input pixels along each side of an output pixel
+ * @param mode How the pixels of a block are combined
+ * @param binned Output: Room for count * binnedDimension(rows, factor) * binnedDimension(cols, factor) values
+ */
+inline void binPatterns(const uint8_t* patterns, size_t count, size_t rows, size_t cols, size_t factor, Mode mode, uint8_t* binned)
+{
+  const size_t binnedRows = binnedDimension(rows, factor);
+  const size_t binnedCols = binnedDimension(cols, factor);
+  if(binnedRows == 0 || binnedCols == 0)
+  {
+    return;
+  }
+  const size_t patternSize = rows * cols;
+  const size_t binnedSize = binnedRows * binnedCols;
+
+  if(mode == Mode::Subsample)
+  {
+    for(size_t p = 0; p < count; p++)
+    {
+      const uint8_t* pattern = patterns + p * patternSize;
+      uint8_t* out = binned + p * binnedSize;
+      for(size_t r = 0; r < binnedRows; r++)
+      {
+        const uint8_t* row = pattern + r * factor * cols;
+        for(size_t c = 0; c < binnedCols; c++)
+        {
+          *out++ = row[c * factor];
+        }
+      }
+    }
+    return;
+  }
+
+  // The input rows of a block are summed column by column first so every input pixel is read once in order
+  const uint32_t blockPixels = static_cast<uint32_t>(factor * factor);
+  std::vector<uint32_t> sums(binnedCols);
+  for(size_t p = 0; p < count; p++)
+  {
+    const uint8_t* pattern = patterns + p * patternSize;
+    uint8_t* out = binned + p * binnedSize;
+    for(size_t r = 0; r < binnedRows; r++)
+    {
+      std::fill(sums.begin(), sums.end(), 0);
+      for(size_t fr = 0; fr < factor; fr++)
+      {
+        const uint8_t* row = pattern + (r * factor + fr) * cols;
+        for(size_t c = 0; c < binnedCols; c++)
+        {
+          const uint8_t* block = row + c * factor;
+          uint32_t sum = 0;
+          for(size_t fc = 0; fc < factor; fc++)
+          {
+            sum += block[fc];
+          }
+          sums[c] += sum;
+        }
+      }
+      for(size_t c = 0; c < binnedCols; c++)
+      {
+        *out++ = static_cast<uint8_t>((sums[c] + blockPixels / 2) / blockPixels);
+      }
+    }
+  }
+}
+} // namespace PatternBinning
+} // namespace EbsdLib
@@ -67,6 +67,155 @@ void EbsdReader::appendOriginalHeader(const QString& more)
   m_OriginalHeader.append(more);
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int EbsdReader::readFileInBatches(size_t batchSize, const EbsdRowBatchCallback& callback)
+{
+  (void)(batchSize);
+  (void)(callback);
+  setErrorCode(-10);
+  setErrorMessage("This reader does not support reading the file in batches");
+  return -10;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int EbsdReader::setDestinationBuffer(const QString& featureName, void* data, size_t capacity, size_t stride)
+{
+  if(nullptr == data || 0 == stride)
+  {
+    setErrorCode(-95000);
+    setErrorMessage(QString("The destination buffer for '%1' needs a valid pointer and a stride of at least 1").arg(featureName));
+    return -95000;
+  }
+  DestinationBuffer buffer;
+  buffer.data = data;
+  buffer.capacity = capacity;
+  buffer.stride = stride;
+  m_DestinationBuffers[featureName] = buffer;
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdReader::DestinationBuffer EbsdReader::getDestinationBuffer(const QString& featureName) const
+{
+  return m_DestinationBuffers.value(featureName, DestinationBuffer());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdReader::removeDestinationBuffer(const QString& featureName)
+{
+  m_DestinationBuffers.remove(featureName);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdReader::clearDestinationBuffers()
+{
+  m_DestinationBuffers.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t EbsdReader::getArrayStride(const void* ptr) const
+{
+  auto iter = m_BorrowedArrays.find(ptr);
+  return (iter == m_BorrowedArrays.end()) ? 1 : iter->second;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdReader::isBorrowedArray(const void* ptr) const
+{
+  return nullptr != ptr && m_BorrowedArrays.find(ptr) != m_BorrowedArrays.end();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray EbsdReader::replaceHeaderValue(const QByteArray& header, const QString& key, int value)
+{
+  const QByteArray keyBytes = key.toLatin1();
+  QList<QByteArray> lines = header.split('\n');
+  for(auto& line : lines)
+  {
+    int start = 0;
+    while(start < line.size() && (line.at(start) == '#' || line.at(start) == ' ' || line.at(start) == '\t'))
+    {
+      start++;
+    }
+    int valueStart = start + keyBytes.size();
+    // The key must be followed by its separator so that a key is not matched by a longer one
+    if(line.mid(start, keyBytes.size()) != keyBytes || valueStart >= line.size() || (line.at(valueStart) != ':' && line.at(valueStart) != ' ' && line.at(valueStart) != '\t'))
+    {
+      continue;
+    }
+    while(valueStart < line.size() && (line.at(valueStart) == ':' || line.at(valueStart) == ' ' || line.at(valueStart) == '\t'))
+    {
+      valueStart++;
+    }
+    QByteArray lineEnd = line.endsWith('\r') ? QByteArray("\r") : QByteArray();
+    line = line.left(valueStart) + QByteArray::number(value) + lineEnd;
+  }
+  return lines.join('\n');
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdReader::destinationBufferFits(const DestinationBuffer& buffer, size_t numberOfElements)
+{
+  if(numberOfElements == 0)
+  {
+    return true;
+  }
+  return (numberOfElements - 1) * buffer.stride < buffer.capacity;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int EbsdReader::checkDestinationBuffers(size_t numberOfElements)
+{
+  for(auto iter = m_DestinationBuffers.constBegin(); iter != m_DestinationBuffers.constEnd(); ++iter)
+  {
+    if(!destinationBufferFits(iter.value(), numberOfElements))
+    {
+      setErrorCode(-95001);
+      setErrorMessage(QString("The destination buffer for '%1' holds %2 values which is not enough for %3 scan points with a stride of %4")
+                          .arg(iter.key())
+                          .arg(iter.value().capacity)
+                          .arg(numberOfElements)
+                          .arg(iter.value().stride));
+      return -95001;
+    }
+  }
+  return 0;
+}
+
+#ifdef EbsdLib_ENABLE_HDF5
+// -----------------------------------------------------------------------------
+void EbsdReader::setMapContiguousDatasets(bool value)
+{
+  m_MapContiguousDatasets = value;
+}
+
+// -----------------------------------------------------------------------------
+bool EbsdReader::getMapContiguousDatasets() const
+{
+  return m_MapContiguousDatasets;
+}
+#endif
+
 // -----------------------------------------------------------------------------
 void EbsdReader::setErrorMessage(const QString& value)
 {
@@ -35,6 +35,10 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+
+#include <QtCore/QByteArray>
 #include <QtCore/QString>
 #include <QtCore/QMap>
 
@@ -42,11 +46,14 @@
 #include "EbsdLib/Core/EbsdSetGetMacros.h"
 #include "EbsdLib/EbsdLib.h"
 #include "EbsdLib/IO/EbsdHeaderEntry.h"
+#include "EbsdLib/IO/EbsdRowBatch.h"
 
 #ifdef EbsdLib_ENABLE_HDF5
 #include "H5Support/H5Lite.h"
 #include "H5Support/QH5Lite.h"
 #include <hdf5.h>
+
+#include "EbsdLib/IO/H5ContiguousDataset.hpp"
 #endif
 
 /**
@@ -200,6 +207,70 @@ class EbsdLib_EXPORT EbsdReader
     */
     virtual int readHeaderOnly() = 0;
 
+    /**
+    * @brief Reads the EBSD data file in batches of at most 'batchSize' scan points. Instead of
+    * allocating arrays for the complete scan the reader parses each batch into buffers that are
+    * reused for the next batch and hands them to the callback, so the peak memory use is set by
+    * the batch size and not by the size of the scan. The header values are available from the
+    * reader as soon as the first batch arrives. Readers that do not support streaming return a
+    * negative error code.
+    * @param batchSize The maximum number of scan points in each batch
+    * @param callback Receives each batch in file order. Returning false stops the read.
+    * @return 0 or positive value on success
+    */
+    virtual int readFileInBatches(size_t batchSize, const EbsdRowBatchCallback& callback);
+
+    /**
+     * @brief Describes memory owned by the caller that a column of data is read into.
+     * The value for scan point 'i' is written to data[i * stride], so an interleaved
+     * array (the three Euler angles of one point stored next to each other, for example)
+     * can be filled by registering each column with an offset pointer and a stride of 3.
+     * The capacity is the number of elements of the column's primitive type that 'data' can hold.
+     */
+    struct DestinationBuffer
+    {
+      void* data = nullptr;
+      size_t capacity = 0;
+      size_t stride = 1;
+    };
+
+    /**
+     * @brief Registers a caller owned buffer that the column 'featureName' is read into instead of
+     * memory allocated by the reader. The buffer is used by readFile() for every column that is read
+     * and is never freed by the reader; getPointerByName() returns it. The names are the same as the
+     * ones given to setArraysToRead() and the element type must match getPointerType(). The batched
+     * read ignores the registered buffers because it reuses its own batch sized arrays.
+     * @param featureName The name of the column
+     * @param data Pointer to the first value of the column
+     * @param capacity The number of elements that 'data' can hold
+     * @param stride The number of elements between the values of two consecutive scan points
+     * @return 0 on success, negative error code if the buffer is not valid
+     */
+    int setDestinationBuffer(const QString& featureName, void* data, size_t capacity, size_t stride = 1);
+
+    /**
+     * @brief Returns the buffer registered for the column or an empty buffer if there is none.
+     */
+    DestinationBuffer getDestinationBuffer(const QString& featureName) const;
+
+    /**
+     * @brief Removes the buffer registered for the column so the reader allocates it again.
+     */
+    void removeDestinationBuffer(const QString& featureName);
+
+    /**
+     * @brief Removes all the registered buffers.
+     */
+    void clearDestinationBuffers();
+
+    /**
+     * @brief Returns the number of elements between the values of two consecutive scan points in an
+     * array returned by the reader. This is the stride of the destination buffer when the array is
+     * one and 1 otherwise.
+     * @param ptr A column pointer returned by the reader
+     */
+    size_t getArrayStride(const void* ptr) const;
+
     /**
      * @brief Allocats a contiguous chunk of memory to store values from the .ang file
      * @param numberOfElements The number of elements in the Array. This method can
@@ -225,6 +296,13 @@ class EbsdLib_EXPORT EbsdReader
     template<typename T>
     void deallocateArrayData(T*& ptr)
     {
+      if(ptr != nullptr && m_BorrowedArrays.erase(ptr) > 0)
+      {
+        // The memory belongs to a destination buffer registered by the caller or to a mapped file
+        m_MappedArrays.erase(ptr);
+        ptr = nullptr;
+        return;
+      }
       if(ptr != nullptr && this->m_ManageMemory)
       {
 #if defined ( EBSD_USE_SSE ) && defined ( __SSE2__ )
@@ -239,6 +317,37 @@ class EbsdLib_EXPORT EbsdReader
 
 #ifdef EbsdLib_ENABLE_HDF5
 
+    /**
+     * @brief When set, the HDF5 readers map the columns whose datasets are stored contiguous and
+     * uncompressed straight from the file instead of reading them into memory, see
+     * EbsdLib::H5ContiguousDataset. Columns of other datasets, columns that have a destination buffer
+     * and reads of a region of interest are read as usual. The default is false.
+     */
+    void setMapContiguousDatasets(bool value);
+    /**
+     * @brief Getter property for MapContiguousDatasets
+     * @return Value of MapContiguousDatasets
+     */
+    bool getMapContiguousDatasets() const;
+
+    /**
+     * @brief Returns the view of a column that was mapped from the file by the last read. The view keeps
+     * the file mapped after the reader moved on, so it is the way to hold on to a mapped column; its
+     * pointer must never be freed.
+     * @param featureName The name of the column
+     * @return The view or nullptr if the column was not mapped
+     */
+    template <typename T>
+    typename EbsdDataArray<T>::Pointer getMappedArray(const QString& featureName)
+    {
+      auto iter = m_MappedArrays.find(getPointerByName(featureName));
+      if(iter == m_MappedArrays.end())
+      {
+        return EbsdDataArray<T>::NullPointer();
+      }
+      return std::static_pointer_cast<EbsdDataArray<T>>(iter->second);
+    }
+
     /**
      * @brief
      */
@@ -296,6 +405,81 @@ class EbsdLib_EXPORT EbsdReader
   protected:
     QMap<QString, EbsdHeaderEntry::Pointer> m_HeaderMap;
 
+    /**
+     * @brief Checks that every registered destination buffer can hold a column of 'numberOfElements'
+     * values. Sets the error code and message if one of them is too small.
+     * @return 0 if all the buffers are large enough, negative error code otherwise
+     */
+    int checkDestinationBuffers(size_t numberOfElements);
+
+    /**
+     * @brief Returns true if 'ptr' is a destination buffer of the caller that the reader must not free.
+     */
+    bool isBorrowedArray(const void* ptr) const;
+
+    /**
+     * @brief Returns the header with the value of the entry 'key' set to 'value', e.g. to describe the
+     * region of interest that was read. Any leading '#' marks, the key and the separator in front of
+     * the old value are kept. Lines of other entries are left untouched.
+     */
+    static QByteArray replaceHeaderValue(const QByteArray& header, const QString& key, int value);
+
+    /**
+     * @brief Returns the destination buffer registered for the column if there is one that can hold
+     * 'numberOfElements' values, otherwise allocates an array that the reader owns. Either way the
+     * returned pointer is released with deallocateArrayData().
+     * @param featureName The name of the column
+     * @param numberOfElements The number of values in the column
+     * @param stride Set to the number of elements between the values of two consecutive scan points
+     * @return Pointer to the memory for the column
+     */
+    template<typename T>
+    T* allocateColumnArray(const QString& featureName, size_t numberOfElements, size_t& stride)
+    {
+      stride = 1;
+      auto iter = m_DestinationBuffers.find(featureName);
+      if(iter == m_DestinationBuffers.end() || !destinationBufferFits(iter.value(), numberOfElements))
+      {
+        return allocateArray<T>(numberOfElements);
+      }
+      stride = iter.value().stride;
+      T* ptr = static_cast<T*>(iter.value().data);
+      m_BorrowedArrays[ptr] = stride;
+      return ptr;
+    }
+
+#ifdef EbsdLib_ENABLE_HDF5
+    /**
+     * @brief Maps the dataset of the column from the file if MapContiguousDatasets is set and the
+     * dataset allows it. The returned pointer is released with deallocateArrayData() like any other.
+     * @param locId The HDF5 group holding the dataset
+     * @param featureName The name of the column, which is also the name of the dataset
+     * @param numberOfElements The number of values the dataset must hold
+     * @return The mapped values or nullptr if the column has to be read
+     */
+    template <typename T>
+    T* mapColumnArray(hid_t locId, const QString& featureName, size_t numberOfElements)
+    {
+      if(!m_MapContiguousDatasets || m_DestinationBuffers.contains(featureName))
+      {
+        return nullptr;
+      }
+      if(nullptr == m_MappingFile || m_MappingFile->fileName() != getFileName())
+      {
+        m_MappingFile = EbsdLib::H5ContiguousDataset::OpenFileOf(locId);
+      }
+      typename EbsdDataArray<T>::Pointer view = EbsdLib::H5ContiguousDataset::MapDataset<T>(locId, featureName, m_MappingFile);
+      if(nullptr == view || view->getSize() != numberOfElements)
+      {
+        return nullptr;
+      }
+      T* ptr = view->data();
+      m_BorrowedArrays[ptr] = 1;
+      m_MappedArrays[ptr] = view;
+      return ptr;
+    }
+#endif
+
 
   public:
     EbsdReader(const EbsdReader&) = delete;     // Copy Constructor Not Implemented
@@ -309,6 +493,16 @@ class EbsdLib_EXPORT EbsdReader
     QString m_FileName = {};
     QString m_OriginalHeader = {};
 
+    QMap<QString, DestinationBuffer> m_DestinationBuffers;
+    std::map<const void*, size_t> m_BorrowedArrays;
+    std::map<const void*, std::shared_ptr<void>> m_MappedArrays;
+#ifdef EbsdLib_ENABLE_HDF5
+    bool m_MapContiguousDatasets = false;
+    std::shared_ptr<QFile> m_MappingFile;
+#endif
+
+    static bool destinationBufferFits(const DestinationBuffer& buffer, size_t numberOfElements);
+
 };
 
 
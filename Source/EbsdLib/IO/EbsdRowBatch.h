@@ -0,0 +1,149 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "EbsdLib/Core/EbsdLibConstants.h"
+#include "EbsdLib/Core/EbsdSetGetMacros.h"
+
+/**
+ * @class EbsdRowBatch EbsdRowBatch.h EbsdLib/IO/EbsdRowBatch.h
+ * @brief A block of consecutive scan points that is handed to the callback of a streaming
+ * read (EbsdReader::readFileInBatches()). Each column is a view into a buffer that is owned by
+ * the reader and is reused for the next batch, so the values must be copied out before the
+ * callback returns if they are needed later.
+ */
+class EbsdRowBatch
+{
+public:
+  EbsdRowBatch()
+  : m_StartIndex(0)
+  , m_NumberOfPoints(0)
+  {
+  }
+  ~EbsdRowBatch() = default;
+
+  /** @brief The index of the first scan point of this batch within the complete scan */
+  EBSD_INSTANCE_PROPERTY(size_t, StartIndex)
+
+  /** @brief The number of valid scan points in each column of this batch */
+  EBSD_INSTANCE_PROPERTY(size_t, NumberOfPoints)
+
+  /**
+   * @brief Adds a column view to the batch. This is called by the readers.
+   * @param name The name of the column (The same name that the reader's getPointerByName() uses)
+   * @param type The numeric type of the values
+   * @param data The buffer holding the values of the column
+   */
+  void addColumn(const QString& name, EbsdLib::NumericTypes::Type type, void* data)
+  {
+    m_Columns.push_back({name, type, data});
+  }
+
+  /**
+   * @brief Returns the names of all the columns in this batch
+   */
+  QList<QString> getColumnNames() const
+  {
+    QList<QString> names;
+    for(const auto& column : m_Columns)
+    {
+      names.push_back(column.name);
+    }
+    return names;
+  }
+
+  /**
+   * @brief Returns the pointer to the values of a column or nullptr if the column is not part of the batch
+   * @param featureName The name of the column
+   */
+  void* getPointerByName(const QString& featureName) const
+  {
+    for(const auto& column : m_Columns)
+    {
+      if(column.name == featureName)
+      {
+        return column.data;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Returns the numeric type of a column or UnknownNumType if the column is not part of the batch
+   * @param featureName The name of the column
+   */
+  EbsdLib::NumericTypes::Type getPointerType(const QString& featureName) const
+  {
+    for(const auto& column : m_Columns)
+    {
+      if(column.name == featureName)
+      {
+        return column.type;
+      }
+    }
+    return EbsdLib::NumericTypes::Type::UnknownNumType;
+  }
+
+  /**
+   * @brief Convenience version of getPointerByName() that casts the pointer to the value type
+   */
+  template <typename T>
+  T* getPointer(const QString& featureName) const
+  {
+    return static_cast<T*>(getPointerByName(featureName));
+  }
+
+private:
+  struct Column
+  {
+    QString name;
+    EbsdLib::NumericTypes::Type type;
+    void* data;
+  };
+  QVector<Column> m_Columns;
+};
+
+/**
+ * @brief The callback that receives each batch of a streaming read. Returning false stops the read.
+ */
+using EbsdRowBatchCallback = std::function<bool(const EbsdRowBatch&)>;
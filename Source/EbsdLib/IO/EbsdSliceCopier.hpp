@@ -0,0 +1,228 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "EbsdLib/EbsdLib.h"
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+/**
+ * @class EbsdSliceCopier EbsdSliceCopier.hpp EbsdLib/IO/EbsdSliceCopier.hpp
+ * @brief Places the arrays of a single slice into the arrays of a volume. The slice is centered in
+ * the XY plane of the volume, the way the volume readers have always placed slices that are smaller
+ * than the volume. Each row of the slice is moved with a single memcpy per array and when the slice
+ * is as wide as the volume a whole band of rows is moved at once. The rows are split across threads
+ * when the parallel algorithms are enabled.
+ */
+class EbsdSliceCopier
+{
+public:
+  /**
+   * @param sliceWidth The number of columns of the slice
+   * @param sliceHeight The number of rows of the slice
+   * @param volumeWidth The number of columns of the volume
+   * @param volumeHeight The number of rows of the volume
+   * @param z The index of the slice in the volume
+   */
+  EbsdSliceCopier(size_t sliceWidth, size_t sliceHeight, size_t volumeWidth, size_t volumeHeight, size_t z)
+  : EbsdSliceCopier(sliceWidth, sliceHeight, volumeWidth, volumeHeight, z, CenteredStart(sliceWidth, volumeWidth), CenteredStart(sliceHeight, volumeHeight))
+  {
+  }
+
+  /**
+   * @param sliceWidth The number of columns of the slice
+   * @param sliceHeight The number of rows of the slice
+   * @param volumeWidth The number of columns of the volume
+   * @param volumeHeight The number of rows of the volume
+   * @param z The index of the slice in the volume
+   * @param xStart The column of the volume that receives the first column of the slice
+   * @param yStart The row of the volume that receives the first row of the slice
+   */
+  EbsdSliceCopier(size_t sliceWidth, size_t sliceHeight, size_t volumeWidth, size_t volumeHeight, size_t z, size_t xStart, size_t yStart)
+  : m_SliceWidth(sliceWidth)
+  , m_SliceHeight(sliceHeight)
+  , m_VolumeWidth(volumeWidth)
+  , m_DestOffset((z * volumeHeight + yStart) * volumeWidth + xStart)
+  {
+  }
+
+  ~EbsdSliceCopier() = default;
+
+  /**
+   * @brief Returns false if the slice is larger than the volume in X or Y.
+   */
+  static bool FitsInVolume(size_t sliceWidth, size_t sliceHeight, size_t volumeWidth, size_t volumeHeight)
+  {
+    return sliceWidth <= volumeWidth && sliceHeight <= volumeHeight;
+  }
+
+  /**
+   * @brief Returns the first column (or row) of the volume that a centered slice covers.
+   */
+  static size_t CenteredStart(size_t sliceSize, size_t volumeSize)
+  {
+    return (volumeSize - std::min(sliceSize, volumeSize)) / 2;
+  }
+
+  /**
+   * @brief The part of a centered slice that lies inside a box of the volume
+   */
+  struct Placement
+  {
+    size_t sliceX0 = 0; // First column of the slice to read
+    size_t sliceY0 = 0; // First row of the slice to read
+    size_t boxX0 = 0;   // Column of the box that receives sliceX0
+    size_t boxY0 = 0;   // Row of the box that receives sliceY0
+    size_t width = 0;
+    size_t height = 0;
+  };
+
+  /**
+   * @brief Intersects a slice that is centered in the XY plane of the volume with the columns
+   * [boxX0, boxX0 + boxWidth) and rows [boxY0, boxY0 + boxHeight) of the volume.
+   * @return false if the slice and the box do not overlap
+   */
+  static bool ClipToBox(size_t sliceWidth, size_t sliceHeight, size_t volumeWidth, size_t volumeHeight, size_t boxX0, size_t boxY0, size_t boxWidth, size_t boxHeight, Placement& placement)
+  {
+    size_t xStart = CenteredStart(sliceWidth, volumeWidth);
+    size_t yStart = CenteredStart(sliceHeight, volumeHeight);
+    size_t x0 = std::max(xStart, boxX0);
+    size_t x1 = std::min(xStart + sliceWidth, boxX0 + boxWidth);
+    size_t y0 = std::max(yStart, boxY0);
+    size_t y1 = std::min(yStart + sliceHeight, boxY0 + boxHeight);
+    if(x0 >= x1 || y0 >= y1)
+    {
+      return false;
+    }
+    placement.sliceX0 = x0 - xStart;
+    placement.sliceY0 = y0 - yStart;
+    placement.boxX0 = x0 - boxX0;
+    placement.boxY0 = y0 - boxY0;
+    placement.width = x1 - x0;
+    placement.height = y1 - y0;
+    return true;
+  }
+
+  /**
+   * @brief Adds an array to copy. Arrays where either pointer is nullptr are skipped.
+   * @param dest The array of the volume
+   * @param source The array of the slice
+   */
+  template <typename T>
+  void addArray(T* dest, const T* source)
+  {
+    if(nullptr != dest && nullptr != source)
+    {
+      m_Arrays.push_back({reinterpret_cast<uint8_t*>(dest), reinterpret_cast<const uint8_t*>(source), sizeof(T)});
+    }
+  }
+
+  /**
+   * @brief Copies all the arrays that were added.
+   */
+  void copy() const
+  {
+    if(m_Arrays.empty() || m_SliceWidth == 0 || m_SliceHeight == 0)
+    {
+      return;
+    }
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+    bool doParallel = true;
+    if(doParallel)
+    {
+      // Keep each task large enough that the threads are not dominated by scheduling
+      size_t grainSize = std::max(static_cast<size_t>(1), k_MinPointsPerTask / m_SliceWidth);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, m_SliceHeight, grainSize), *this, tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      generate(0, m_SliceHeight);
+    }
+  }
+
+  /**
+   * @brief Copies the rows [start, end) of every array.
+   */
+  void generate(size_t start, size_t end) const
+  {
+    for(const auto& array : m_Arrays)
+    {
+      const size_t typeSize = array.typeSize;
+      if(m_SliceWidth == m_VolumeWidth)
+      {
+        // The rows are contiguous in the volume as well
+        ::memcpy(array.dest + (m_DestOffset + start * m_VolumeWidth) * typeSize, array.source + start * m_SliceWidth * typeSize, (end - start) * m_SliceWidth * typeSize);
+        continue;
+      }
+      for(size_t row = start; row < end; row++)
+      {
+        ::memcpy(array.dest + (m_DestOffset + row * m_VolumeWidth) * typeSize, array.source + row * m_SliceWidth * typeSize, m_SliceWidth * typeSize);
+      }
+    }
+  }
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    generate(r.begin(), r.end());
+  }
+#endif
+
+private:
+  struct ArrayPair
+  {
+    uint8_t* dest;
+    const uint8_t* source;
+    size_t typeSize;
+  };
+
+  static const size_t k_MinPointsPerTask = 16384;
+
+  size_t m_SliceWidth = 0;
+  size_t m_SliceHeight = 0;
+  size_t m_VolumeWidth = 0;
+  size_t m_DestOffset = 0;
+  std::vector<ArrayPair> m_Arrays;
+};
@@ -0,0 +1,204 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class EbsdSliceImportPipeline EbsdSliceImportPipeline.hpp EbsdLib/IO/EbsdSliceImportPipeline.hpp
+ * @brief Runs the import of a stack of slice files as a pipeline. Worker threads parse slice files
+ * concurrently and hand the parsed slices to the calling thread, which writes them one at a time in
+ * slice order. The importers use this to keep every HDF5 call on a single thread while the text
+ * parsing runs in parallel. The volume readers run it with a single worker that reads the next slice
+ * from the HDF5 file while the calling thread places the current slice into the volume.
+ *
+ * At most MaxQueuedSlices slices are alive at any time, counting the slices that are being parsed,
+ * the slices that wait to be written and the slice that is being written. A worker only starts on a
+ * slice once the slice that is MaxQueuedSlices positions before it has been written, so a slow slice
+ * can never be overtaken by more parsed slices than the queue holds.
+ *
+ * The parse function is called on the worker threads and must not touch any shared state. The write
+ * function and the cancel function are only called on the calling thread.
+ */
+template <typename SliceType>
+class EbsdSliceImportPipeline
+{
+public:
+  using SlicePointer = std::unique_ptr<SliceType>;
+  using ParseFunction = std::function<SlicePointer(size_t index)>;
+  using WriteFunction = std::function<int(size_t index, SliceType& slice)>;
+  using CancelFunction = std::function<bool()>;
+
+  /**
+   * @param numSlices The number of slices to import
+   * @param numWorkers The number of parsing threads. Zero uses the number of hardware threads.
+   * @param maxQueuedSlices The largest number of slices that are held in memory at once
+   */
+  EbsdSliceImportPipeline(size_t numSlices, size_t numWorkers, size_t maxQueuedSlices)
+  : m_NumSlices(numSlices)
+  , m_NumWorkers(numWorkers)
+  , m_MaxQueuedSlices(std::max(maxQueuedSlices, static_cast<size_t>(1)))
+  {
+    if(0 == m_NumWorkers)
+    {
+      m_NumWorkers = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    // More workers than queue slots would only wait for a free slot
+    m_NumWorkers = std::min(m_NumWorkers, m_MaxQueuedSlices);
+    m_NumWorkers = std::min(m_NumWorkers, std::max(m_NumSlices, static_cast<size_t>(1)));
+  }
+
+  ~EbsdSliceImportPipeline() = default;
+
+  /**
+   * @brief Parses and writes all slices. The first negative value returned by the write function
+   * stops the pipeline. Slices that were already parsed after that point are discarded.
+   * @param parse Parses the slice with the given index. A nullptr is reported as an error (-1).
+   * @param write Writes a parsed slice. Slices are written in index order.
+   * @param isCanceled Checked before each slice is written. Canceling stops the pipeline.
+   * @return Zero on success, the error of the write function or -1 for a slice that could not be parsed
+   */
+  int run(const ParseFunction& parse, const WriteFunction& write, const CancelFunction& isCanceled = CancelFunction())
+  {
+    m_NextToParse = 0;
+    m_NextToWrite = 0;
+    m_Stop = false;
+    m_ParsedSlices.clear();
+
+    std::vector<std::thread> workers;
+    workers.reserve(m_NumWorkers);
+    for(size_t i = 0; i < m_NumWorkers; i++)
+    {
+      workers.emplace_back([this, &parse]() { parseSlices(parse); });
+    }
+
+    int err = 0;
+    for(size_t index = 0; index < m_NumSlices; index++)
+    {
+      SlicePointer slice;
+      {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_SliceParsed.wait(lock, [this, index]() { return m_ParsedSlices.count(index) != 0; });
+        slice = std::move(m_ParsedSlices[index]);
+        m_ParsedSlices.erase(index);
+      }
+
+      if(isCanceled && isCanceled())
+      {
+        break;
+      }
+      err = (nullptr == slice) ? -1 : write(index, *slice);
+      slice.reset();
+
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_NextToWrite = index + 1;
+      }
+      m_SlotFreed.notify_all();
+      if(err < 0)
+      {
+        break;
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stop = true;
+    }
+    m_SlotFreed.notify_all();
+    for(auto& worker : workers)
+    {
+      worker.join();
+    }
+    m_ParsedSlices.clear();
+    return err;
+  }
+
+private:
+  size_t m_NumSlices = 0;
+  size_t m_NumWorkers = 0;
+  size_t m_MaxQueuedSlices = 1;
+
+  std::mutex m_Mutex;
+  std::condition_variable m_SlotFreed;
+  std::condition_variable m_SliceParsed;
+  std::map<size_t, SlicePointer> m_ParsedSlices;
+  size_t m_NextToParse = 0;
+  size_t m_NextToWrite = 0;
+  bool m_Stop = false;
+
+  /**
+   * @brief The loop of each worker thread
+   */
+  void parseSlices(const ParseFunction& parse)
+  {
+    while(true)
+    {
+      size_t index = 0;
+      {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_SlotFreed.wait(lock, [this]() { return m_Stop || m_NextToParse >= m_NumSlices || m_NextToParse < m_NextToWrite + m_MaxQueuedSlices; });
+        if(m_Stop || m_NextToParse >= m_NumSlices)
+        {
+          return;
+        }
+        index = m_NextToParse++;
+      }
+
+      SlicePointer slice = parse(index);
+
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ParsedSlices[index] = std::move(slice);
+      }
+      m_SliceParsed.notify_all();
+    }
+  }
+
+public:
+  EbsdSliceImportPipeline(const EbsdSliceImportPipeline&) = delete;            // Copy Constructor Not Implemented
+  EbsdSliceImportPipeline(EbsdSliceImportPipeline&&) = delete;                 // Move Constructor Not Implemented
+  EbsdSliceImportPipeline& operator=(const EbsdSliceImportPipeline&) = delete; // Copy Assignment Not Implemented
+  EbsdSliceImportPipeline& operator=(EbsdSliceImportPipeline&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,305 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "EbsdTextFileIndex.h"
+
+#include <cstring>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+namespace
+{
+const quint32 k_SidecarMagic = 0x45424958; // "EBIX"
+const quint32 k_SidecarVersion = 1;
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdFileStamp::EbsdFileStamp()
+: m_FilePath("")
+, m_FileSize(-1)
+, m_LastModified(-1)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdFileStamp::~EbsdFileStamp() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdFileStamp EbsdFileStamp::Create(const QString& filePath)
+{
+  EbsdFileStamp stamp;
+  QFileInfo fi(filePath);
+  if(fi.exists())
+  {
+    stamp.m_FilePath = fi.absoluteFilePath();
+    stamp.m_FileSize = fi.size();
+    stamp.m_LastModified = fi.lastModified().toMSecsSinceEpoch();
+  }
+  return stamp;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdFileStamp::isValid() const
+{
+  return m_FileSize >= 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdFileStamp::operator==(const EbsdFileStamp& rhs) const
+{
+  return m_FilePath == rhs.m_FilePath && m_FileSize == rhs.m_FileSize && m_LastModified == rhs.m_LastModified;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdFileStamp::operator!=(const EbsdFileStamp& rhs) const
+{
+  return !(*this == rhs);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdTextFileIndex::EbsdTextFileIndex()
+: m_HeaderLength(0)
+, m_DataStartOffset(0)
+, m_LineStride(1)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdTextFileIndex::~EbsdTextFileIndex() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString EbsdTextFileIndex::GetSidecarFilePath(const QString& filePath)
+{
+  return filePath + QString(".idx");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdTextFileIndex::clear()
+{
+  m_FileStamp = EbsdFileStamp();
+  m_HeaderLength = 0;
+  m_DataStartOffset = 0;
+  m_LineStride = 1;
+  m_NumberOfLines = 0;
+  m_LineOffsets.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int EbsdTextFileIndex::build(const QString& filePath, const char* begin, const char* end, qint64 headerLength, qint64 dataStartOffset, size_t lineStride)
+{
+  clear();
+  if(lineStride == 0 || headerLength < 0 || headerLength > dataStartOffset || dataStartOffset > (end - begin))
+  {
+    return -1;
+  }
+  m_HeaderLength = headerLength;
+  m_DataStartOffset = dataStartOffset;
+  m_LineStride = lineStride;
+
+  const char* cursor = begin + dataStartOffset;
+  while(cursor < end)
+  {
+    if(m_NumberOfLines % lineStride == 0)
+    {
+      m_LineOffsets.push_back(static_cast<qint64>(cursor - begin));
+    }
+    const char* lineEnd = static_cast<const char*>(::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+    cursor = (nullptr == lineEnd) ? end : lineEnd + 1;
+    m_NumberOfLines++;
+  }
+
+  m_FileStamp = EbsdFileStamp::Create(filePath);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdTextFileIndex::isValidFor(const QString& filePath) const
+{
+  return m_FileStamp.isValid() && m_FileStamp == EbsdFileStamp::Create(filePath);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdTextFileIndex::readSidecarFile(const QString& filePath, size_t minNumberOfLines)
+{
+  clear();
+  EbsdFileStamp stamp = EbsdFileStamp::Create(filePath);
+  if(!stamp.isValid())
+  {
+    return false;
+  }
+
+  QFile in(GetSidecarFilePath(filePath));
+  if(!in.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+  QDataStream stream(&in);
+  stream.setVersion(QDataStream::Qt_5_0);
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  qint64 fileSize = 0;
+  qint64 lastModified = 0;
+  quint64 lineStride = 0;
+  quint64 numLines = 0;
+  quint64 numOffsets = 0;
+  stream >> magic >> version;
+  if(magic != k_SidecarMagic || version != k_SidecarVersion)
+  {
+    return false;
+  }
+  stream >> fileSize >> lastModified;
+  // The data file was changed after the index was written
+  if(fileSize != stamp.getFileSize() || lastModified != stamp.getLastModified())
+  {
+    return false;
+  }
+  stream >> m_HeaderLength >> m_DataStartOffset >> lineStride >> numLines >> numOffsets;
+  if(stream.status() != QDataStream::Ok || m_HeaderLength < 0 || m_HeaderLength > m_DataStartOffset || m_DataStartOffset > stamp.getFileSize())
+  {
+    clear();
+    return false;
+  }
+  // Every data line holds at least one byte. This also bounds the number of offsets before anything
+  // is allocated for a corrupt sidecar file.
+  quint64 dataSize = static_cast<quint64>(stamp.getFileSize() - m_DataStartOffset);
+  if(lineStride == 0 || numLines > dataSize || numLines < minNumberOfLines || numOffsets != (numLines + lineStride - 1) / lineStride)
+  {
+    clear();
+    return false;
+  }
+
+  m_LineOffsets.resize(static_cast<size_t>(numOffsets));
+  qint64 previous = m_DataStartOffset;
+  for(auto& offset : m_LineOffsets)
+  {
+    stream >> offset;
+    if(offset < previous || offset > stamp.getFileSize())
+    {
+      clear();
+      return false;
+    }
+    previous = offset;
+  }
+  if(stream.status() != QDataStream::Ok)
+  {
+    clear();
+    return false;
+  }
+  m_LineStride = static_cast<size_t>(lineStride);
+  m_NumberOfLines = static_cast<size_t>(numLines);
+  m_FileStamp = stamp;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdTextFileIndex::writeSidecarFile() const
+{
+  if(!m_FileStamp.isValid())
+  {
+    return false;
+  }
+  // The getters of the stamp are not const
+  EbsdFileStamp stamp = m_FileStamp;
+  QFile out(GetSidecarFilePath(stamp.getFilePath()));
+  if(!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    return false;
+  }
+  QDataStream stream(&out);
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream << k_SidecarMagic << k_SidecarVersion;
+  stream << stamp.getFileSize() << stamp.getLastModified();
+  stream << m_HeaderLength << m_DataStartOffset << static_cast<quint64>(m_LineStride) << static_cast<quint64>(m_NumberOfLines) << static_cast<quint64>(m_LineOffsets.size());
+  for(const auto& offset : m_LineOffsets)
+  {
+    stream << offset;
+  }
+  return stream.status() == QDataStream::Ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t EbsdTextFileIndex::getNumberOfLines() const
+{
+  return m_NumberOfLines;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 EbsdTextFileIndex::getLineOffset(size_t line, size_t& linesToSkip) const
+{
+  linesToSkip = 0;
+  if(line >= m_NumberOfLines)
+  {
+    return -1;
+  }
+  linesToSkip = line % m_LineStride;
+  return m_LineOffsets[line / m_LineStride];
+}
@@ -0,0 +1,161 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/Core/EbsdSetGetMacros.h"
+
+/**
+ * @brief The EbsdFileStamp class identifies one version of a file on disk by its path, its size and
+ * its last modification time. Cached information that was derived from a file is only reused while
+ * the stamp of the file is unchanged.
+ */
+class EbsdLib_EXPORT EbsdFileStamp
+{
+public:
+  EbsdFileStamp();
+  ~EbsdFileStamp();
+
+  /**
+   * @brief Creates the stamp of the file as it currently exists on disk. The stamp is invalid if the file does not exist.
+   * @param filePath
+   * @return
+   */
+  static EbsdFileStamp Create(const QString& filePath);
+
+  EBSD_INSTANCE_PROPERTY(QString, FilePath)
+  EBSD_INSTANCE_PROPERTY(qint64, FileSize)
+  EBSD_INSTANCE_PROPERTY(qint64, LastModified)
+
+  bool isValid() const;
+
+  bool operator==(const EbsdFileStamp& rhs) const;
+  bool operator!=(const EbsdFileStamp& rhs) const;
+};
+
+/**
+ * @brief The EbsdTextFileIndex class holds the byte offsets into the data section of a text based
+ * EBSD file (.ang, .ctf) so that a reader can seek directly to any data line instead of walking the
+ * file from the top. The offset of every LineStride-th data line is stored, the readers use the number
+ * of points in a scan row as the stride so the table holds one entry per row.
+ *
+ * The index can be saved next to the data file as a sidecar file (see GetSidecarFilePath()). A saved
+ * index is only used again if the size and modification time of the data file are unchanged.
+ */
+class EbsdLib_EXPORT EbsdTextFileIndex
+{
+public:
+  EbsdTextFileIndex();
+  ~EbsdTextFileIndex();
+
+  /** @brief The number of bytes in the header section of the file */
+  EBSD_INSTANCE_PROPERTY(qint64, HeaderLength)
+
+  /** @brief The byte offset of the first data line */
+  EBSD_INSTANCE_PROPERTY(qint64, DataStartOffset)
+
+  /** @brief The number of data lines between two stored offsets */
+  EBSD_INSTANCE_PROPERTY(size_t, LineStride)
+
+  /**
+   * @brief Returns the path of the sidecar index file for a data file.
+   * @param filePath
+   * @return
+   */
+  static QString GetSidecarFilePath(const QString& filePath);
+
+  /**
+   * @brief Scans the data section of a file and records the offset of every lineStride-th line.
+   * @param filePath The data file
+   * @param begin The first byte of the complete file
+   * @param end One past the last byte of the complete file
+   * @param headerLength The number of bytes in the header section
+   * @param dataStartOffset The byte offset of the first data line
+   * @param lineStride The number of lines between two stored offsets
+   * @return Zero on success, negative if the arguments do not describe a valid data section
+   */
+  int build(const QString& filePath, const char* begin, const char* end, qint64 headerLength, qint64 dataStartOffset, size_t lineStride);
+
+  /**
+   * @brief Returns true if the index was built for the file as it currently exists on disk.
+   * @param filePath
+   * @return
+   */
+  bool isValidFor(const QString& filePath) const;
+
+  /**
+   * @brief Loads the sidecar index of a data file. The index is only loaded if it was written for the
+   * data file with its current size and modification time and its offsets fit inside the data file.
+   * @param filePath The data file (Not the sidecar file)
+   * @param minNumberOfLines The number of data lines the caller expects, e.g. rows x columns of the scan
+   * @return True if a valid index was loaded
+   */
+  bool readSidecarFile(const QString& filePath, size_t minNumberOfLines = 0);
+
+  /**
+   * @brief Writes the index to the sidecar file of the data file it was built for.
+   * @return True if the sidecar file was written
+   */
+  bool writeSidecarFile() const;
+
+  /**
+   * @brief Returns the number of data lines in the file.
+   */
+  size_t getNumberOfLines() const;
+
+  /**
+   * @brief Returns the byte offset of the closest stored line at or before a data line.
+   * @param line The zero based data line
+   * @param linesToSkip The number of lines that have to be skipped after seeking to the returned offset
+   * @return The byte offset or -1 if the line is past the end of the file
+   */
+  qint64 getLineOffset(size_t line, size_t& linesToSkip) const;
+
+  /**
+   * @brief Resets the index to an empty state.
+   */
+  void clear();
+
+private:
+  EbsdFileStamp m_FileStamp;
+  size_t m_NumberOfLines = 0;
+  std::vector<qint64> m_LineOffsets;
+};
@@ -0,0 +1,247 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "EbsdTextWriter.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+#include "EbsdLib/IO/EbsdNumberFormatter.hpp"
+
+namespace NumberFormatter = EbsdLib::NumberFormatter;
+
+namespace
+{
+const size_t k_DefaultRowsPerBlock = 8192;
+
+/**
+ * @brief Formats consecutive blocks of rows, each into its own buffer. The blocks do not share any
+ * state so they can be formatted in any order.
+ */
+class FormatTextBlocksImpl
+{
+  const std::vector<EbsdTextWriter::Column>* m_Columns;
+  std::vector<std::vector<char>>* m_Buffers;
+  std::vector<size_t>* m_Lengths;
+  size_t m_FirstRow;
+  size_t m_RowsPerBlock;
+  size_t m_NumRows;
+
+public:
+  FormatTextBlocksImpl(const std::vector<EbsdTextWriter::Column>* columns, std::vector<std::vector<char>>* buffers, std::vector<size_t>* lengths, size_t firstRow, size_t rowsPerBlock,
+                       size_t numRows)
+  : m_Columns(columns)
+  , m_Buffers(buffers)
+  , m_Lengths(lengths)
+  , m_FirstRow(firstRow)
+  , m_RowsPerBlock(rowsPerBlock)
+  , m_NumRows(numRows)
+  {
+  }
+
+  void generate(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      size_t firstRow = m_FirstRow + i * m_RowsPerBlock;
+      size_t lastRow = std::min(firstRow + m_RowsPerBlock, m_NumRows);
+      char* first = (*m_Buffers)[i].data();
+      char* out = first;
+      for(size_t row = firstRow; row < lastRow; row++)
+      {
+        for(const auto& column : *m_Columns)
+        {
+          if(column.isFloat)
+          {
+            out = NumberFormatter::formatFixed(out, nullptr == column.floatData ? 0.0f : column.floatData[row * column.stride], column.precision, column.width);
+          }
+          else
+          {
+            out = NumberFormatter::formatInt32(out, nullptr == column.intData ? 0 : column.intData[row * column.stride], column.width);
+          }
+          *out++ = column.separator;
+        }
+        *out++ = '\n';
+      }
+      (*m_Lengths)[i] = static_cast<size_t>(out - first);
+    }
+  }
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    generate(r.begin(), r.end());
+  }
+#endif
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdTextWriter::EbsdTextWriter()
+: m_RowsPerBlock(k_DefaultRowsPerBlock)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdTextWriter::~EbsdTextWriter() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdTextWriter::addInt32Column(const int32_t* data, int width, char separator, size_t stride)
+{
+  Column column;
+  column.intData = data;
+  column.isFloat = false;
+  column.stride = stride;
+  column.width = width;
+  column.separator = separator;
+  m_Columns.push_back(column);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdTextWriter::addFloatColumn(const float* data, int width, int precision, char separator, size_t stride)
+{
+  Column column;
+  column.floatData = data;
+  column.isFloat = true;
+  column.stride = stride;
+  column.width = width;
+  column.precision = precision;
+  column.separator = separator;
+  m_Columns.push_back(column);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const std::vector<EbsdTextWriter::Column>& EbsdTextWriter::getColumns() const
+{
+  return m_Columns;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdTextWriter::clear()
+{
+  m_Columns.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t EbsdTextWriter::getMaxLineLength() const
+{
+  size_t length = 1; // The '\n'
+  for(const auto& column : m_Columns)
+  {
+    if(column.isFloat)
+    {
+      length += NumberFormatter::maxFixedLength(column.precision, column.width);
+    }
+    else
+    {
+      length += static_cast<size_t>(std::max(column.width, NumberFormatter::k_MaxInt32Length));
+    }
+    length++; // The separator
+  }
+  return length;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int EbsdTextWriter::writeRows(FILE* f, size_t numRows) const
+{
+  if(nullptr == f)
+  {
+    return -1;
+  }
+  const size_t rowsPerBlock = std::max(m_RowsPerBlock, static_cast<size_t>(1));
+  const size_t numBlocks = (numRows + rowsPerBlock - 1) / rowsPerBlock;
+
+  // Format a few blocks per thread before writing them out so the threads stay busy while memory
+  // use is bounded by the size of one wave of blocks
+  size_t blocksPerWave = 2 * static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1U));
+  blocksPerWave = std::min(blocksPerWave, numBlocks);
+
+  const size_t bufferSize = rowsPerBlock * getMaxLineLength();
+  std::vector<std::vector<char>> buffers(blocksPerWave, std::vector<char>(bufferSize));
+  std::vector<size_t> lengths(blocksPerWave, 0);
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  bool doParallel = true;
+#endif
+
+  for(size_t block = 0; block < numBlocks; block += blocksPerWave)
+  {
+    size_t waveBlocks = std::min(blocksPerWave, numBlocks - block);
+    FormatTextBlocksImpl formatBlocks(&m_Columns, &buffers, &lengths, block * rowsPerBlock, rowsPerBlock, numRows);
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+    if(doParallel)
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, waveBlocks, 1), formatBlocks, tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      formatBlocks.generate(0, waveBlocks);
+    }
+
+    // The blocks are written in row order
+    for(size_t i = 0; i < waveBlocks; i++)
+    {
+      if(::fwrite(buffers[i].data(), 1, lengths[i], f) != lengths[i])
+      {
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
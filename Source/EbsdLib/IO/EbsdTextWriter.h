@@ -0,0 +1,130 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/Core/EbsdSetGetMacros.h"
+
+/**
+ * @brief The EbsdTextWriter class writes the data section of a text based EBSD file (.ang, .ctf) from
+ * a set of column arrays. Blocks of rows are formatted into memory buffers (in parallel when the
+ * library is built with parallel algorithms) and each block is then written with a single fwrite()
+ * call, in row order. The numbers are formatted with the functions in EbsdNumberFormatter.hpp so the
+ * output is identical to what the same printf() style format would produce.
+ *
+ * Every column is written as the formatted value followed by its separator character and each row
+ * ends with a '\n'.
+ */
+class EbsdLib_EXPORT EbsdTextWriter
+{
+public:
+  EbsdTextWriter();
+  ~EbsdTextWriter();
+
+  /**
+   * @brief The Column struct describes how one column is formatted. A column without data is written
+   * as zeros.
+   */
+  struct Column
+  {
+    const int32_t* intData = nullptr;
+    const float* floatData = nullptr;
+    bool isFloat = false;
+    size_t stride = 1;
+    int width = 0;
+    int precision = 0;
+    char separator = ' ';
+  };
+
+  /** @brief The number of rows that are formatted into one buffer */
+  EBSD_INSTANCE_PROPERTY(size_t, RowsPerBlock)
+
+  /**
+   * @brief Appends an integer column that is formatted like printf("%*d")
+   * @param data The values or nullptr to write zeros
+   * @param width The minimum field width
+   * @param separator The character written after each value
+   * @param stride The number of elements between the values of two consecutive rows
+   */
+  void addInt32Column(const int32_t* data, int width, char separator, size_t stride = 1);
+
+  /**
+   * @brief Appends a float column that is formatted like printf("%*.*f")
+   * @param data The values or nullptr to write zeros
+   * @param width The minimum field width
+   * @param precision The number of digits after the decimal point
+   * @param separator The character written after each value
+   * @param stride The number of elements between the values of two consecutive rows
+   */
+  void addFloatColumn(const float* data, int width, int precision, char separator, size_t stride = 1);
+
+  /**
+   * @brief Returns the columns in the order they are written
+   */
+  const std::vector<Column>& getColumns() const;
+
+  /**
+   * @brief Removes all columns
+   */
+  void clear();
+
+  /**
+   * @brief Returns the largest number of bytes a single row can take
+   */
+  size_t getMaxLineLength() const;
+
+  /**
+   * @brief Formats the first numRows values of every column and appends the rows to the file.
+   * @param f An open file
+   * @param numRows
+   * @return Zero on success, -1 if writing to the file failed
+   */
+  int writeRows(FILE* f, size_t numRows) const;
+
+private:
+  std::vector<Column> m_Columns;
+
+public:
+  EbsdTextWriter(const EbsdTextWriter&) = delete;            // Copy Constructor Not Implemented
+  EbsdTextWriter(EbsdTextWriter&&) = delete;                 // Move Constructor Not Implemented
+  EbsdTextWriter& operator=(const EbsdTextWriter&) = delete; // Copy Assignment Not Implemented
+  EbsdTextWriter& operator=(EbsdTextWriter&&) = delete;      // Move Assignment Not Implemented
+};
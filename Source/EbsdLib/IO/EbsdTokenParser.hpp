@@ -0,0 +1,483 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+/**
+ * @brief The TokenParser namespace holds the tokenizing and number conversion functions that are
+ * shared by the text based readers (.ang, .ctf and angle files). Every function works directly on a
+ * [first, last) range of characters inside of a larger buffer (a line, a memory mapped file) so that
+ * no memory is allocated per line or per token. Conversion failures are reported through the 'ok'
+ * argument in the same way that QByteArray::toInt() and QByteArray::toFloat() report them, and the
+ * converted values are identical to the values those Qt functions return.
+ */
+namespace EbsdLib
+{
+namespace TokenParser
+{
+/**
+ * @brief The character(s) that are accepted as the decimal separator of a floating point value.
+ * PointOrComma allows European style files to be read without first replacing every ',' in the line.
+ */
+enum class DecimalSeparator : uint8_t
+{
+  Point = 0,
+  Comma = 1,
+  PointOrComma = 2
+};
+
+/**
+ * @brief A [first, last) range of characters inside of a larger buffer
+ */
+struct Token
+{
+  const char* first = nullptr;
+  const char* last = nullptr;
+};
+
+namespace Detail
+{
+/* Powers of 10 that are exactly representable as a double */
+const double k_ExactPowersOf10[] = {1.0e0,  1.0e1,  1.0e2,  1.0e3,  1.0e4,  1.0e5,  1.0e6,  1.0e7,  1.0e8,  1.0e9,  1.0e10, 1.0e11,
+                                    1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18, 1.0e19, 1.0e20, 1.0e21, 1.0e22};
+
+/* Decimal values with more significant digits than this can not take the exact fast path */
+const int k_MaxExactDigits = 15;
+const int k_MaxExactExponent = 22;
+
+// -----------------------------------------------------------------------------
+inline bool isDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+// -----------------------------------------------------------------------------
+inline bool isDecimalSeparator(char c, DecimalSeparator separator)
+{
+  switch(separator)
+  {
+  case DecimalSeparator::Point:
+    return c == '.';
+  case DecimalSeparator::Comma:
+    return c == ',';
+  case DecimalSeparator::PointOrComma:
+    return c == '.' || c == ',';
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// The special values are only accepted in the same canonical forms that QByteArray accepts
+// -----------------------------------------------------------------------------
+inline bool parseSpecialValue(const char* first, const char* last, double& value)
+{
+  size_t length = static_cast<size_t>(last - first);
+  if(length == 3 && ::strncmp(first, "nan", 3) == 0)
+  {
+    value = std::numeric_limits<double>::quiet_NaN();
+    return true;
+  }
+  double sign = 1.0;
+  if(length == 4 && (*first == '-' || *first == '+'))
+  {
+    sign = (*first == '-') ? -1.0 : 1.0;
+    ++first;
+    --length;
+  }
+  if(length == 3 && ::strncmp(first, "inf", 3) == 0)
+  {
+    value = sign * std::numeric_limits<double>::infinity();
+    return true;
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// Correctly rounded conversion of a token that has already passed the syntax check in
+// parseDouble() but has too many digits or too large of an exponent for the exact fast path.
+// The decimal separator is replaced with the one of the current C locale so the result does
+// not depend on the locale that the application has set.
+// -----------------------------------------------------------------------------
+inline bool slowParseDouble(const char* first, const char* last, double& value, DecimalSeparator separator, bool nonZeroDigits)
+{
+  const char* localePoint = ::localeconv()->decimal_point;
+  const size_t pointLength = ::strlen(localePoint);
+  const size_t required = static_cast<size_t>(last - first) + pointLength + 1;
+
+  char stackBuffer[128];
+  std::string heapBuffer;
+  char* buffer = stackBuffer;
+  if(required > sizeof(stackBuffer))
+  {
+    heapBuffer.resize(required);
+    buffer = &heapBuffer[0];
+  }
+  char* out = buffer;
+  for(const char* p = first; p != last; ++p)
+  {
+    if(isDecimalSeparator(*p, separator))
+    {
+      ::memcpy(out, localePoint, pointLength);
+      out += pointLength;
+    }
+    else
+    {
+      *out++ = *p;
+    }
+  }
+  *out = '\0';
+
+  char* endPtr = nullptr;
+  double d = std::strtod(buffer, &endPtr);
+  // Overflow to infinity and underflow to zero are both treated as conversion failures
+  if(endPtr != out || std::isinf(d) || (d == 0.0 && nonZeroDigits))
+  {
+    return false;
+  }
+  value = d;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Accepts [+-]ddd[.ddd][(e|E)[+-]ddd] where either the integer or the fraction digits may be
+// omitted. Values with at most 15 significant digits and a power of ten that is itself exactly
+// representable are converted with a single multiply or divide, which is correctly rounded.
+// -----------------------------------------------------------------------------
+inline bool parseDouble(const char* first, const char* last, double& value, DecimalSeparator separator)
+{
+  const char* p = first;
+  bool negative = false;
+  if(p != last && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+  uint64_t mantissa = 0;
+  int sigDigits = 0;
+  int numDigits = 0;
+  int exponent = 0;
+  while(p != last && isDigit(*p))
+  {
+    if(mantissa != 0 || *p != '0')
+    {
+      ++sigDigits;
+    }
+    if(sigDigits <= k_MaxExactDigits)
+    {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+    }
+    ++numDigits;
+    ++p;
+  }
+  if(p != last && isDecimalSeparator(*p, separator))
+  {
+    ++p;
+    while(p != last && isDigit(*p))
+    {
+      if(mantissa != 0 || *p != '0')
+      {
+        ++sigDigits;
+      }
+      if(sigDigits <= k_MaxExactDigits)
+      {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        --exponent;
+      }
+      ++numDigits;
+      ++p;
+    }
+  }
+  if(numDigits == 0)
+  {
+    return parseSpecialValue(first, last, value);
+  }
+  if(p != last && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    bool negExp = false;
+    if(p != last && (*p == '-' || *p == '+'))
+    {
+      negExp = (*p == '-');
+      ++p;
+    }
+    const char* expStart = p;
+    int expValue = 0;
+    while(p != last && isDigit(*p))
+    {
+      if(expValue < 100000)
+      {
+        expValue = expValue * 10 + (*p - '0');
+      }
+      ++p;
+    }
+    if(p == expStart)
+    {
+      return false;
+    }
+    exponent += negExp ? -expValue : expValue;
+  }
+  if(p != last)
+  {
+    return false;
+  }
+  if(sigDigits > k_MaxExactDigits || exponent < -k_MaxExactExponent || exponent > k_MaxExactExponent)
+  {
+    return slowParseDouble(first, last, value, separator, sigDigits > 0);
+  }
+  double d = static_cast<double>(mantissa);
+  d = (exponent < 0) ? d / k_ExactPowersOf10[-exponent] : d * k_ExactPowersOf10[exponent];
+  value = negative ? -d : d;
+  return true;
+}
+} // namespace Detail
+
+/**
+ * @brief Returns true for the same set of characters that QByteArray::simplified() and
+ * QByteArray::trimmed() consider white space.
+ */
+inline bool isWhiteSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+/**
+ * @brief Moves first and last inwards past any leading and trailing white space.
+ */
+inline void trim(const char*& first, const char*& last)
+{
+  while(first != last && isWhiteSpace(*first))
+  {
+    ++first;
+  }
+  while(last != first && isWhiteSpace(*(last - 1)))
+  {
+    --last;
+  }
+}
+
+/**
+ * @brief Returns a pointer to the next '\n' character at or after cursor or 'end' if there is none.
+ */
+inline const char* findLineEnd(const char* cursor, const char* end)
+{
+  if(cursor == end)
+  {
+    return end;
+  }
+  const char* eol = static_cast<const char*>(::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+  return (nullptr == eol) ? end : eol;
+}
+
+/**
+ * @brief Splits the range on runs of white space. This gives the same tokens as
+ * QByteArray::simplified().split(' ') which means that an empty line produces a single empty token.
+ * @param first Start of the range
+ * @param last End of the range
+ * @param tokens Output: Storage for the tokens
+ * @param maxTokens The number of tokens that will fit in 'tokens'
+ * @return The total number of tokens in the range. Only the first 'maxTokens' are stored.
+ */
+inline int splitOnWhiteSpace(const char* first, const char* last, Token* tokens, int maxTokens)
+{
+  int count = 0;
+  const char* p = first;
+  while(true)
+  {
+    while(p != last && isWhiteSpace(*p))
+    {
+      ++p;
+    }
+    if(p == last)
+    {
+      break;
+    }
+    const char* tokenBegin = p;
+    while(p != last && !isWhiteSpace(*p))
+    {
+      ++p;
+    }
+    if(count < maxTokens)
+    {
+      tokens[count].first = tokenBegin;
+      tokens[count].last = p;
+    }
+    ++count;
+  }
+  if(count == 0 && maxTokens > 0)
+  {
+    tokens[0].first = first;
+    tokens[0].last = first;
+  }
+  return (count == 0) ? 1 : count;
+}
+
+/**
+ * @brief Splits the range on every occurrence of the delimiter. This gives the same tokens as
+ * QByteArray::split() including any empty tokens between adjacent delimiters.
+ * @param first Start of the range
+ * @param last End of the range
+ * @param delimiter The character that separates the tokens
+ * @param tokens Output: Storage for the tokens
+ * @param maxTokens The number of tokens that will fit in 'tokens'
+ * @return The total number of tokens in the range. Only the first 'maxTokens' are stored.
+ */
+inline int split(const char* first, const char* last, char delimiter, Token* tokens, int maxTokens)
+{
+  int count = 0;
+  const char* tokenBegin = first;
+  while(true)
+  {
+    const char* tokenEnd = last;
+    if(tokenBegin != last)
+    {
+      const char* found = static_cast<const char*>(::memchr(tokenBegin, delimiter, static_cast<size_t>(last - tokenBegin)));
+      tokenEnd = (nullptr == found) ? last : found;
+    }
+    if(count < maxTokens)
+    {
+      tokens[count].first = tokenBegin;
+      tokens[count].last = tokenEnd;
+    }
+    ++count;
+    if(tokenEnd == last)
+    {
+      break;
+    }
+    tokenBegin = tokenEnd + 1;
+  }
+  return count;
+}
+
+/**
+ * @brief Converts the range to a base 10 integer. Leading and trailing white space is ignored.
+ * @param first Start of the range
+ * @param last End of the range
+ * @param ok Output: Set to false if the range is not a valid integer or does not fit into an int32_t.
+ * @return The value or zero if the conversion failed.
+ */
+inline int32_t toInt32(const char* first, const char* last, bool* ok = nullptr)
+{
+  trim(first, last);
+  const char* p = first;
+  bool negative = false;
+  if(p != last && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+  const char* digitsBegin = p;
+  int64_t value = 0;
+  while(p != last && Detail::isDigit(*p))
+  {
+    value = value * 10 + (*p - '0');
+    if(value > static_cast<int64_t>(std::numeric_limits<int32_t>::max()) + 1)
+    {
+      break;
+    }
+    ++p;
+  }
+  value = negative ? -value : value;
+  bool success = (p == last && p != digitsBegin && value >= std::numeric_limits<int32_t>::min() && value <= std::numeric_limits<int32_t>::max());
+  if(nullptr != ok)
+  {
+    *ok = success;
+  }
+  return success ? static_cast<int32_t>(value) : 0;
+}
+
+/**
+ * @brief Converts the range to a double. Leading and trailing white space is ignored.
+ * @param first Start of the range
+ * @param last End of the range
+ * @param ok Output: Set to false if the range is not a valid number or the value is out of range.
+ * @param separator The decimal separator(s) to accept
+ * @return The value or zero if the conversion failed.
+ */
+inline double toDouble(const char* first, const char* last, bool* ok = nullptr, DecimalSeparator separator = DecimalSeparator::Point)
+{
+  trim(first, last);
+  double value = 0.0;
+  bool success = Detail::parseDouble(first, last, value, separator);
+  if(nullptr != ok)
+  {
+    *ok = success;
+  }
+  return success ? value : 0.0;
+}
+
+/**
+ * @brief Converts the range to a float. Leading and trailing white space is ignored. Values that
+ * overflow or underflow a float are reported as failures just like QByteArray::toFloat() does.
+ * @param first Start of the range
+ * @param last End of the range
+ * @param ok Output: Set to false if the range is not a valid number or the value is out of range.
+ * @param separator The decimal separator(s) to accept
+ * @return The value or zero if the conversion failed.
+ */
+inline float toFloat(const char* first, const char* last, bool* ok = nullptr, DecimalSeparator separator = DecimalSeparator::Point)
+{
+  bool success = false;
+  double d = toDouble(first, last, &success, separator);
+  float value = 0.0f;
+  if(success && !std::isinf(d) && std::fabs(d) > static_cast<double>(std::numeric_limits<float>::max()))
+  {
+    success = false;
+    value = (d < 0.0) ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+  }
+  else if(success)
+  {
+    value = static_cast<float>(d);
+    if(value == 0.0f && d != 0.0)
+    {
+      success = false;
+    }
+  }
+  if(nullptr != ok)
+  {
+    *ok = success;
+  }
+  return value;
+}
+} // namespace TokenParser
+} // namespace EbsdLib
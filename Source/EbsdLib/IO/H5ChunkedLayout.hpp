@@ -0,0 +1,142 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <hdf5.h>
+
+#include <QtCore/QString>
+
+#include "H5Support/QH5Lite.h"
+
+#include "EbsdLib/EbsdLib.h"
+
+namespace EbsdLib
+{
+/**
+ * @brief Writes the per scan point datasets of the H5Ebsd files with a chunked layout. Each chunk
+ * holds a whole number of scan rows so reading a band of rows (a region of interest or a streamed
+ * batch) only touches the chunks of those rows. The chunks can be compressed with the shuffle and
+ * deflate filters that ship with every HDF5 library.
+ */
+namespace H5ChunkedLayout
+{
+/**
+ * @brief Returns the number of scan points in a chunk of chunkRows rows, clamped to the size of the dataset.
+ */
+inline hsize_t chunkSize(hsize_t numPoints, size_t rowLength, int chunkRows)
+{
+  hsize_t size = static_cast<hsize_t>(rowLength) * static_cast<hsize_t>(chunkRows);
+  return std::max<hsize_t>(1, std::min(size, numPoints));
+}
+
+/**
+ * @brief Writes the dataset. If chunkRows is not positive or the dataset is empty the dataset is written
+ * contiguous and uncompressed with QH5Lite::writePointerDataset.
+ * @param locId The HDF5 group that will hold the dataset
+ * @param datasetName The name of the dataset
+ * @param rank The rank of the dataset. The first dimension is the scan point.
+ * @param dims The dimensions of the dataset
+ * @param rowLength The number of scan points in a row of the scan
+ * @param chunkRows The number of scan rows in each chunk
+ * @param compressionLevel The deflate level (1 - 9). Zero writes the chunks uncompressed.
+ * @param data The values to write
+ * @return Negative on error
+ */
+template <typename T>
+herr_t writeDataset(hid_t locId, const QString& datasetName, int32_t rank, const hsize_t* dims, size_t rowLength, int chunkRows, int compressionLevel, const T* data)
+{
+  if(chunkRows <= 0 || rowLength == 0 || rank < 1 || dims[0] == 0)
+  {
+#if defined(H5Support_NAMESPACE)
+    return H5Support_NAMESPACE::QH5Lite::writePointerDataset(locId, datasetName, rank, dims, data);
+#else
+    return QH5Lite::writePointerDataset(locId, datasetName, rank, dims, data);
+#endif
+  }
+
+  std::vector<hsize_t> chunkDims(dims, dims + rank);
+  chunkDims[0] = chunkSize(dims[0], rowLength, chunkRows);
+
+  hid_t dcplId = H5Pcreate(H5P_DATASET_CREATE);
+  herr_t err = H5Pset_chunk(dcplId, rank, chunkDims.data());
+  if(err >= 0 && compressionLevel > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+  {
+    // Shuffling the bytes groups the exponents of neighboring values which deflate compresses far better
+    err = H5Pset_shuffle(dcplId);
+    if(err >= 0)
+    {
+      err = H5Pset_deflate(dcplId, static_cast<unsigned>(std::min(compressionLevel, 9)));
+    }
+  }
+  if(err < 0)
+  {
+    H5Pclose(dcplId);
+    return err;
+  }
+
+  T value = 0x0;
+#if defined(H5Support_NAMESPACE)
+  hid_t typeId = H5Support_NAMESPACE::QH5Lite::HDFTypeForPrimitive(value);
+#else
+  hid_t typeId = QH5Lite::HDFTypeForPrimitive(value);
+#endif
+  hid_t spaceId = H5Screate_simple(rank, dims, nullptr);
+  hid_t datasetId = -1;
+  if(H5Lexists(locId, datasetName.toLatin1().data(), H5P_DEFAULT) > 0)
+  {
+    datasetId = H5Dopen(locId, datasetName.toLatin1().data(), H5P_DEFAULT);
+  }
+  else
+  {
+    datasetId = H5Dcreate(locId, datasetName.toLatin1().data(), typeId, spaceId, H5P_DEFAULT, dcplId, H5P_DEFAULT);
+  }
+  if(datasetId < 0)
+  {
+    err = -1;
+  }
+  else
+  {
+    err = H5Dwrite(datasetId, typeId, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5Dclose(datasetId);
+  }
+  H5Sclose(spaceId);
+  H5Pclose(dcplId);
+  return err;
+}
+} // namespace H5ChunkedLayout
+} // namespace EbsdLib
@@ -0,0 +1,208 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <hdf5.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include "H5Support/QH5Lite.h"
+
+#include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/Core/EbsdDataArray.hpp"
+
+namespace EbsdLib
+{
+/**
+ * @brief Maps datasets that HDF5 stored contiguous and uncompressed straight from the file into memory.
+ * The values of such a dataset are a single block of bytes at a fixed offset of the file, so when they
+ * are stored in the byte order and size of the native type the block can be used as is. The operating
+ * system then pages the values in on first use and processes that map the same file share the pages.
+ *
+ * The mapping is private: values written through a view stay in the memory of the process and never
+ * reach the file. A view is only valid while the file is not changed by someone else.
+ */
+namespace H5ContiguousDataset
+{
+/**
+ * @brief Where the values of a dataset are found in the file
+ */
+struct Location
+{
+  qint64 offset = -1;
+  std::vector<hsize_t> dims;
+  size_t numElements = 0;
+};
+
+/**
+ * @brief Finds the location of the values of the dataset. This only succeeds if the dataset is
+ * contiguous, has no filters, is stored inside the file that was opened with the default (sec2) driver,
+ * its space has been allocated and its type is the native type of T.
+ * @param locId The HDF5 group holding the dataset
+ * @param datasetName The name of the dataset
+ * @param location Output: The offset and dimensions of the dataset
+ * @return True if the values can be mapped from the file
+ */
+template <typename T>
+bool getLocation(hid_t locId, const QString& datasetName, Location& location)
+{
+  location = Location();
+  hid_t datasetId = H5Dopen(locId, datasetName.toLatin1().data(), H5P_DEFAULT);
+  if(datasetId < 0)
+  {
+    return false;
+  }
+
+  bool mappable = false;
+  hid_t dcplId = H5Dget_create_plist(datasetId);
+  hid_t fileTypeId = H5Dget_type(datasetId);
+  hid_t fileSpaceId = H5Dget_space(datasetId);
+  hid_t fileId = H5Iget_file_id(datasetId);
+  hid_t faplId = (fileId >= 0) ? H5Fget_access_plist(fileId) : -1;
+  T value = 0x0;
+#if defined(H5Support_NAMESPACE)
+  hid_t memTypeId = H5Support_NAMESPACE::QH5Lite::HDFTypeForPrimitive(value);
+#else
+  hid_t memTypeId = QH5Lite::HDFTypeForPrimitive(value);
+#endif
+  if(dcplId >= 0 && fileTypeId >= 0 && fileSpaceId >= 0 && faplId >= 0 && H5Pget_layout(dcplId) == H5D_CONTIGUOUS && H5Pget_nfilters(dcplId) == 0 && H5Pget_external_count(dcplId) == 0 &&
+     H5Pget_driver(faplId) == H5FD_SEC2 && H5Tequal(fileTypeId, memTypeId) > 0)
+  {
+    int rank = H5Sget_simple_extent_ndims(fileSpaceId);
+    haddr_t offset = H5Dget_offset(datasetId);
+    if(rank > 0 && offset != HADDR_UNDEF)
+    {
+      location.dims.resize(static_cast<size_t>(rank), 0);
+      H5Sget_simple_extent_dims(fileSpaceId, location.dims.data(), nullptr);
+      location.numElements = static_cast<size_t>(H5Sget_simple_extent_npoints(fileSpaceId));
+      location.offset = static_cast<qint64>(offset);
+      // Datasets that were never written have no storage and misaligned values can not be used in place
+      mappable = location.numElements > 0 && H5Dget_storage_size(datasetId) == location.numElements * sizeof(T) && (offset % alignof(T)) == 0;
+    }
+  }
+
+  if(faplId >= 0)
+  {
+    H5Pclose(faplId);
+  }
+  if(fileId >= 0)
+  {
+    H5Fclose(fileId);
+  }
+  if(fileSpaceId >= 0)
+  {
+    H5Sclose(fileSpaceId);
+  }
+  if(fileTypeId >= 0)
+  {
+    H5Tclose(fileTypeId);
+  }
+  if(dcplId >= 0)
+  {
+    H5Pclose(dcplId);
+  }
+  H5Dclose(datasetId);
+  if(!mappable)
+  {
+    location = Location();
+  }
+  return mappable;
+}
+
+/**
+ * @brief Opens the file that holds the HDF5 object for mapping
+ * @return The open file or nullptr
+ */
+inline std::shared_ptr<QFile> OpenFileOf(hid_t locId)
+{
+  ssize_t length = H5Fget_name(locId, nullptr, 0);
+  if(length <= 0)
+  {
+    return std::shared_ptr<QFile>();
+  }
+  std::vector<char> name(static_cast<size_t>(length) + 1, 0);
+  H5Fget_name(locId, name.data(), name.size());
+  auto file = std::make_shared<QFile>(QString::fromLocal8Bit(name.data()));
+  if(!file->open(QIODevice::ReadOnly))
+  {
+    return std::shared_ptr<QFile>();
+  }
+  return file;
+}
+
+/**
+ * @brief Returns a view of the dataset that reads its values straight from the mapped file. The first
+ * dimension of the dataset is the number of tuples and the others are the component dimensions. The
+ * view keeps the file mapped for as long as it exists.
+ * @param locId The HDF5 group holding the dataset
+ * @param datasetName The name of the dataset
+ * @param file The file to map the values from. The file that holds 'locId' is opened if this is nullptr.
+ * @return The view or nullptr if the dataset can not be mapped, in which case it has to be read with H5Dread
+ */
+template <typename T>
+typename EbsdDataArray<T>::Pointer MapDataset(hid_t locId, const QString& datasetName, std::shared_ptr<QFile> file = std::shared_ptr<QFile>())
+{
+  Location location;
+  if(!getLocation<T>(locId, datasetName, location))
+  {
+    return EbsdDataArray<T>::NullPointer();
+  }
+  if(nullptr == file)
+  {
+    file = OpenFileOf(locId);
+  }
+  uchar* mapped = (nullptr != file) ? file->map(location.offset, static_cast<qint64>(location.numElements * sizeof(T)), QFileDevice::MapPrivateOption) : nullptr;
+  if(nullptr == mapped)
+  {
+    return EbsdDataArray<T>::NullPointer();
+  }
+
+  typename EbsdDataArray<T>::comp_dims_type compDims(location.dims.begin() + 1, location.dims.end());
+  if(compDims.empty())
+  {
+    compDims.push_back(1);
+  }
+  typename EbsdDataArray<T>::Pointer array = EbsdDataArray<T>::WrapPointer(reinterpret_cast<T*>(mapped), static_cast<size_t>(location.dims[0]), compDims, datasetName, false);
+  // The returned pointer shares the array and owns the mapping, which is undone once the last copy is gone
+  return typename EbsdDataArray<T>::Pointer(array.get(), [array, file, mapped](EbsdDataArray<T>*) { file->unmap(mapped); });
+}
+} // namespace H5ContiguousDataset
+} // namespace EbsdLib
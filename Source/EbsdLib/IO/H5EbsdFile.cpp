@@ -0,0 +1,216 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "H5EbsdFile.h"
+
+#include <iterator>
+
+#include <QtCore/QFileInfo>
+
+#include "H5Support/QH5Utilities.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+namespace
+{
+/**
+ * @brief The files that are currently open, keyed by their absolute path. The entries do not keep
+ * the files open, a file is closed as soon as the last object holding it lets go.
+ */
+std::mutex& OpenFilesMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<QString, H5EbsdFile::WeakPointer>& OpenFiles()
+{
+  static std::map<QString, H5EbsdFile::WeakPointer> openFiles;
+  return openFiles;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5EbsdFile::H5EbsdFile() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5EbsdFile::~H5EbsdFile()
+{
+  for(auto& group : m_Groups)
+  {
+    if(H5Iis_valid(group.second) > 0)
+    {
+      H5Gclose(group.second);
+    }
+  }
+  m_Groups.clear();
+  // Only the file id is closed. QH5Utilities::closeFile() would also close the objects that other
+  // code opened through its own id of the same file.
+  if(m_FileId >= 0)
+  {
+    H5Fclose(m_FileId);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5EbsdFile::Pointer H5EbsdFile::Open(const QString& fileName)
+{
+  QFileInfo fi(fileName);
+  if(!fi.exists())
+  {
+    return NullPointer();
+  }
+  QString key = fi.absoluteFilePath();
+
+  std::lock_guard<std::mutex> lock(OpenFilesMutex());
+  std::map<QString, WeakPointer>& openFiles = OpenFiles();
+  auto iter = openFiles.find(key);
+  if(iter != openFiles.end())
+  {
+    Pointer file = iter->second.lock();
+    if(nullptr != file && file->isCurrent())
+    {
+      return file;
+    }
+  }
+
+  Pointer file(new H5EbsdFile);
+  file->m_FileName = fileName;
+  file->m_LastModified = fi.lastModified();
+  file->m_FileSize = fi.size();
+  file->m_FileId = QH5Utilities::openFile(fileName, true);
+  if(file->m_FileId < 0)
+  {
+    return NullPointer();
+  }
+  openFiles[key] = file;
+
+  // Drop the entries of files that were closed in the mean time
+  for(auto entry = openFiles.begin(); entry != openFiles.end();)
+  {
+    entry = entry->second.expired() ? openFiles.erase(entry) : std::next(entry);
+  }
+  return file;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString H5EbsdFile::getFileName() const
+{
+  return m_FileName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t H5EbsdFile::getFileId() const
+{
+  return m_FileId;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5EbsdFile::isCurrent() const
+{
+  QFileInfo fi(m_FileName);
+  return fi.exists() && fi.lastModified() == m_LastModified && fi.size() == m_FileSize;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t H5EbsdFile::getGroup(const QString& path)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  // A group can be closed behind our back when other code closes its own id of the same file with
+  // QH5Utilities::closeFile(), in that case the group is opened again
+  auto iter = m_Groups.find(path);
+  if(iter != m_Groups.end() && H5Iis_valid(iter->second) > 0)
+  {
+    return iter->second;
+  }
+  // Missing groups are not remembered, a later call tries to open them again
+  hid_t gid = H5Gopen(m_FileId, path.toLatin1().data(), H5P_DEFAULT);
+  if(gid >= 0)
+  {
+    m_Groups[path] = gid;
+  }
+  return gid;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::shared_ptr<QFile> H5EbsdFile::getMappingFile()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if(nullptr == m_MappingFile)
+  {
+    auto file = std::make_shared<QFile>(m_FileName);
+    if(file->open(QIODevice::ReadOnly))
+    {
+      m_MappingFile = file;
+    }
+  }
+  return m_MappingFile;
+}
+
+// -----------------------------------------------------------------------------
+H5EbsdFile::Pointer H5EbsdFile::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+QString H5EbsdFile::getNameOfClass() const
+{
+  return QString("H5EbsdFile");
+}
+
+// -----------------------------------------------------------------------------
+QString H5EbsdFile::ClassName()
+{
+  return QString("H5EbsdFile");
+}
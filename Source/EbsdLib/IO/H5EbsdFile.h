@@ -0,0 +1,186 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <hdf5.h>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/IO/H5ContiguousDataset.hpp"
+
+/**
+ * @class H5EbsdFile H5EbsdFile.h EbsdLib/IO/H5EbsdFile.h
+ * @brief A read only .h5ebsd file that stays open while any object holds on to it. Open() hands out
+ * the same object to every caller that asks for the same file, so H5EbsdVolumeInfo, the volume readers
+ * and the per slice readers of a volume all share one file id. The groups that were opened through
+ * getGroup() stay open with the file and any values that were put in the cache stay there, so loading
+ * a volume does not open the file and the slice groups again for every slice.
+ *
+ * The modification time and size of the file are recorded when it is opened. Once either changes
+ * isCurrent() returns false and Open() opens the file again with an empty cache.
+ *
+ * The groups and cached values are guarded by a mutex. The HDF5 calls themselves are not, so only a
+ * single thread should use the file at a time unless HDF5 was built thread safe.
+ */
+class EbsdLib_EXPORT H5EbsdFile
+{
+public:
+  using Self = H5EbsdFile;
+  using Pointer = std::shared_ptr<Self>;
+  using ConstPointer = std::shared_ptr<const Self>;
+  using WeakPointer = std::weak_ptr<Self>;
+  using ConstWeakPointer = std::weak_ptr<const Self>;
+  static Pointer NullPointer();
+
+  /**
+   * @brief Returns the name of the class for H5EbsdFile
+   */
+  QString getNameOfClass() const;
+  /**
+   * @brief Returns the name of the class for H5EbsdFile
+   */
+  static QString ClassName();
+
+  /**
+   * @brief Returns the open file for the given path. An object that is still in use elsewhere is
+   * returned when the file has not changed since it was opened, otherwise the file is opened again.
+   * @param fileName The .h5ebsd file
+   * @return The file or nullptr if it could not be opened
+   */
+  static Pointer Open(const QString& fileName);
+
+  ~H5EbsdFile();
+
+  /**
+   * @brief Returns the path of the file
+   */
+  QString getFileName() const;
+
+  /**
+   * @brief Returns the HDF5 id of the file. It must not be closed by the caller.
+   */
+  hid_t getFileId() const;
+
+  /**
+   * @brief Returns false once the modification time or the size of the file changed since it was opened
+   */
+  bool isCurrent() const;
+
+  /**
+   * @brief Returns the group at the given path, opening it the first time it is asked for. The group
+   * stays open until this object is destroyed and must not be closed by the caller.
+   * @param path The path of the group relative to the root of the file
+   * @return The group id or a negative value if the group does not exist
+   */
+  hid_t getGroup(const QString& path);
+
+  /**
+   * @brief Returns a read only view of a contiguous, uncompressed dataset that is mapped straight from
+   * the file instead of being read into memory. See EbsdLib::H5ContiguousDataset.
+   * @param groupPath The path of the group holding the dataset
+   * @param datasetName The name of the dataset
+   * @return The view or nullptr if the dataset does not exist or can not be mapped
+   */
+  template <typename T>
+  typename EbsdDataArray<T>::Pointer mapDataset(const QString& groupPath, const QString& datasetName)
+  {
+    hid_t gid = getGroup(groupPath);
+    std::shared_ptr<QFile> file = (gid >= 0) ? getMappingFile() : std::shared_ptr<QFile>();
+    if(nullptr == file)
+    {
+      return EbsdDataArray<T>::NullPointer();
+    }
+    return EbsdLib::H5ContiguousDataset::MapDataset<T>(gid, datasetName, file);
+  }
+
+  /**
+   * @brief Returns the file opened for mapping datasets, which all the views of this file share
+   * @return The open file or nullptr if it could not be opened
+   */
+  std::shared_ptr<QFile> getMappingFile();
+
+  /**
+   * @brief Returns the value that was stored under the key with setCachedValue() or nullptr if there
+   * is none. The caller must ask for the same type that was stored.
+   */
+  template <typename T>
+  std::shared_ptr<T> getCachedValue(const QString& key) const
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto iter = m_Cache.find(key);
+    if(iter == m_Cache.end())
+    {
+      return std::shared_ptr<T>();
+    }
+    return std::static_pointer_cast<T>(iter->second);
+  }
+
+  /**
+   * @brief Stores a value that was read from the file so later readers of the same file can use it
+   */
+  template <typename T>
+  void setCachedValue(const QString& key, const std::shared_ptr<T>& value)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Cache[key] = std::static_pointer_cast<void>(value);
+  }
+
+protected:
+  H5EbsdFile();
+
+private:
+  QString m_FileName;
+  hid_t m_FileId = -1;
+  QDateTime m_LastModified;
+  qint64 m_FileSize = 0;
+
+  mutable std::mutex m_Mutex;
+  std::map<QString, hid_t> m_Groups;
+  std::map<QString, std::shared_ptr<void>> m_Cache;
+  std::shared_ptr<QFile> m_MappingFile;
+
+public:
+  H5EbsdFile(const H5EbsdFile&) = delete;            // Copy Constructor Not Implemented
+  H5EbsdFile(H5EbsdFile&&) = delete;                 // Move Constructor Not Implemented
+  H5EbsdFile& operator=(const H5EbsdFile&) = delete; // Copy Assignment Not Implemented
+  H5EbsdFile& operator=(H5EbsdFile&&) = delete;      // Move Assignment Not Implemented
+};
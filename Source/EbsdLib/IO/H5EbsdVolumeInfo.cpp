@@ -50,7 +50,6 @@
   err = H5Lite::readScalarDataset(fileId, path.toStdString(), var);\
   if (err < 0) {\
     qDebug() << "H5EbsdVolumeInfo Error: Could not load header value for " << path ;\
-    err = H5Utilities::closeFile(fileId);\
     return err;\
   }
 
@@ -60,7 +59,6 @@
     if(err < 0)                                                                                                                                                                                        \
     {                                                                                                                                                                                                  \
       qDebug() << "H5EbsdVolumeInfo Error: Could not load header (as vector) for " << path;                                                                                                            \
-      err = H5Utilities::closeFile(fileId);                                                                                                                                                            \
       return err;                                                                                                                                                                                      \
     }                                                                                                                                                                                                  \
   }
@@ -70,7 +68,6 @@
     err = H5Lite::readScalarDataset(fileId, path.toStdString(), t);\
     if (err < 0) {\
       qDebug() << "H5EbsdVolumeInfo Error: Could not load header value (with cast) for " << path ;\
-      err = H5Utilities::closeFile(fileId);\
       return err;\
     }\
     var = static_cast<m_msgType>(t); }
@@ -79,6 +76,36 @@
 using namespace H5Support_NAMESPACE;
 #endif
 
+namespace
+{
+const QString k_VolumeInfoCacheKey("H5EbsdVolumeInfo");
+
+/**
+ * @brief The values that readVolumeInfo() reads from the file. They are kept with the shared
+ * H5EbsdFile so every object that reads the same file only reads them once.
+ */
+struct VolumeInfoValues
+{
+  uint32_t FileVersion = 0;
+  int XDim = 0;
+  int YDim = 0;
+  int ZDim = 0;
+  float XRes = 0.0f;
+  float YRes = 0.0f;
+  float ZRes = 0.0f;
+  int ZStart = 0;
+  int ZEnd = 0;
+  uint32_t StackingOrder = EbsdLib::RefFrameZDir::LowtoHigh;
+  int NumPhases = 0;
+  float SampleTransformationAngle = 0.0f;
+  std::array<float, 3> SampleTransformationAxis = {{0.0f, 0.0f, 1.0f}};
+  float EulerTransformationAngle = 0.0f;
+  std::array<float, 3> EulerTransformationAxis = {{0.0f, 0.0f, 1.0f}};
+  QSet<QString> DataArrayNames;
+  QString Manufacturer;
+};
+} // namespace
+
 
 // -----------------------------------------------------------------------------
 //
@@ -135,6 +162,14 @@ int H5EbsdVolumeInfo::updateToLatestVersion()
   return 0;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5EbsdFile::Pointer H5EbsdVolumeInfo::getH5EbsdFile()
+{
+  return H5EbsdFile::Open(m_FileName);
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -143,13 +178,39 @@ int H5EbsdVolumeInfo::readVolumeInfo()
   int err = -1;
   m_ValuesAreCached = false;
   int retErr = 0;
-  hid_t fileId = H5Utilities::openFile(m_FileName.toStdString(), true);
-  if (fileId < 0)
+  H5EbsdFile::Pointer h5File = getH5EbsdFile();
+  if(nullptr == h5File)
   {
     //std::cout << "Error Opening file '" << m_FileName << "'" << std::endl;
     return -1;
   }
-  H5ScopedFileSentinel sentinel(&fileId, true);
+
+  // Another reader of the same file may have read the values already
+  std::shared_ptr<VolumeInfoValues> values = h5File->getCachedValue<VolumeInfoValues>(k_VolumeInfoCacheKey);
+  if(nullptr != values)
+  {
+    m_FileVersion = values->FileVersion;
+    m_XDim = values->XDim;
+    m_YDim = values->YDim;
+    m_ZDim = values->ZDim;
+    m_XRes = values->XRes;
+    m_YRes = values->YRes;
+    m_ZRes = values->ZRes;
+    m_ZStart = values->ZStart;
+    m_ZEnd = values->ZEnd;
+    m_StackingOrder = values->StackingOrder;
+    m_NumPhases = values->NumPhases;
+    m_SampleTransformationAngle = values->SampleTransformationAngle;
+    m_SampleTransformationAxis = values->SampleTransformationAxis;
+    m_EulerTransformationAngle = values->EulerTransformationAngle;
+    m_EulerTransformationAxis = values->EulerTransformationAxis;
+    m_DataArrayNames = values->DataArrayNames;
+    m_Manufacturer = values->Manufacturer;
+    m_ValuesAreCached = true;
+    return retErr;
+  }
+
+  hid_t fileId = h5File->getFileId();
 
   m_FileVersion = 0;
   // Attempt to read the file version number. If it is not there that is OK as early h5ebsd
@@ -178,7 +239,6 @@ int H5EbsdVolumeInfo::readVolumeInfo()
   if (err < 0)
   {
     std::cout << "H5EbsdVolumeInfo Error: Could not load header value for " << EbsdLib::H5Ebsd::Manufacturer.toStdString() << std::endl;
-    err = H5Utilities::closeFile(fileId);
     return err;
   }
   m_Manufacturer = QString::fromStdString(data);
@@ -186,8 +246,9 @@ int H5EbsdVolumeInfo::readVolumeInfo()
   // Get the Number of Phases in the Material
   // DO NOT Use the accessor methods below to get variables. Directly access them otherwise you
   // will cause an infinite recursion to occur.
+  m_DataArrayNames.clear();
   QString index = QString::number(m_ZStart);
-  hid_t gid = H5Gopen(fileId, index.toStdString().c_str(), H5P_DEFAULT);
+  hid_t gid = h5File->getGroup(index);
   if (gid > 0)
   {
     hid_t headerId = H5Gopen(gid, EbsdLib::H5Ebsd::Header.toStdString().c_str(), H5P_DEFAULT);
@@ -223,7 +284,6 @@ int H5EbsdVolumeInfo::readVolumeInfo()
       }
       H5Gclose(dataGid);
     }
-    H5Gclose(gid);
   }
 
 // we are going to selectively replace some of the data array names with some common names instead
@@ -261,8 +321,26 @@ int H5EbsdVolumeInfo::readVolumeInfo()
 
 
   m_ValuesAreCached = true;
-  err = H5Utilities::closeFile(fileId);
-  fileId = -1;
+
+  values = std::make_shared<VolumeInfoValues>();
+  values->FileVersion = m_FileVersion;
+  values->XDim = m_XDim;
+  values->YDim = m_YDim;
+  values->ZDim = m_ZDim;
+  values->XRes = m_XRes;
+  values->YRes = m_YRes;
+  values->ZRes = m_ZRes;
+  values->ZStart = m_ZStart;
+  values->ZEnd = m_ZEnd;
+  values->StackingOrder = m_StackingOrder;
+  values->NumPhases = m_NumPhases;
+  values->SampleTransformationAngle = m_SampleTransformationAngle;
+  values->SampleTransformationAxis = m_SampleTransformationAxis;
+  values->EulerTransformationAngle = m_EulerTransformationAngle;
+  values->EulerTransformationAxis = m_EulerTransformationAxis;
+  values->DataArrayNames = m_DataArrayNames;
+  values->Manufacturer = m_Manufacturer;
+  h5File->setCachedValue(k_VolumeInfoCacheKey, values);
   return retErr;
 }
 
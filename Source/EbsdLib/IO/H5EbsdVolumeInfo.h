@@ -42,6 +42,7 @@
 #include "EbsdLib/EbsdLib.h"
 #include "EbsdLib/Core/EbsdSetGetMacros.h"
 #include "EbsdLib/Core/EbsdLibConstants.h"
+#include "EbsdLib/IO/H5EbsdFile.h"
 
 /**
  * @class H5EbsdVolumeInfo H5EbsdVolumeInfo.h EbsdLib/H5EbsdVolumeInfo.h
@@ -116,6 +117,14 @@ class  EbsdLib_EXPORT H5EbsdVolumeInfo
      */
     virtual void invalidateCache();
 
+    /**
+     * @brief Returns the open file that is shared with every other reader of the same file. The
+     * file is opened again when it changed on disk since it was opened. This object does not hold
+     * on to the file, it stays open only as long as the caller or another reader keeps the pointer.
+     * @return The file or nullptr if it could not be opened
+     */
+    H5EbsdFile::Pointer getH5EbsdFile();
+
     /**
      * @brief Returns the file version of the H5Ebsd file. This is an attribute attached
      * to the root "/" data set.
@@ -130,6 +130,63 @@ void H5EbsdVolumeReader::readAllArrays(bool b)
   m_ReadAllArrays = b;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5EbsdVolumeReader::setSubVolume(int64_t x0, int64_t y0, int64_t z0, int64_t width, int64_t height, int64_t depth)
+{
+  m_SubVolumeOrigin = {{x0, y0, z0}};
+  m_SubVolumeSize = {{width, height, depth}};
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5EbsdVolumeReader::hasSubVolume() const
+{
+  return m_SubVolumeSize[0] > 0 && m_SubVolumeSize[1] > 0 && m_SubVolumeSize[2] > 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::array<int64_t, 3> H5EbsdVolumeReader::getSubVolumeOrigin() const
+{
+  return m_SubVolumeOrigin;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::array<int64_t, 3> H5EbsdVolumeReader::getSubVolumeSize() const
+{
+  return m_SubVolumeSize;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5EbsdVolumeReader::getLoadBox(int64_t xpoints, int64_t ypoints, int64_t zpoints, std::array<int64_t, 3>& origin, std::array<int64_t, 3>& size) const
+{
+  std::array<int64_t, 3> dims = {{xpoints, ypoints, zpoints}};
+  if(!hasSubVolume())
+  {
+    origin = {{0, 0, 0}};
+    size = dims;
+    return true;
+  }
+  origin = m_SubVolumeOrigin;
+  size = m_SubVolumeSize;
+  for(size_t i = 0; i < 3; i++)
+  {
+    if(origin[i] < 0 || origin[i] + size[i] > dims[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 H5EbsdVolumeReader::Pointer H5EbsdVolumeReader::NullPointer()
 {
@@ -36,6 +36,8 @@
 
 #pragma once
 
+#include <array>
+
 #include <QtCore/QString>
 #include <QtCore/QSet>
 
@@ -153,14 +155,56 @@ class EbsdLib_EXPORT H5EbsdVolumeReader : public H5EbsdVolumeInfo
     virtual void readAllArrays(bool b);
     virtual bool getReadAllArrays();
 
+    /**
+     * @brief Restricts loadData() to a box of the volume. Only the slices and the rows and columns of
+     * each slice that intersect the box are read from the file. The arrays hold width * height * depth
+     * points with X varying fastest and getNumberOfElements() returns that count. The box is given in
+     * the coordinates of the volume after the slices were stacked according to ZDir, so the box holds
+     * exactly the values found at the same place in the complete volume. Passing a width, height or
+     * depth of zero loads the complete volume again.
+     * @param x0 The first column of the box
+     * @param y0 The first row of the box
+     * @param z0 The first slice of the box
+     * @param width The number of columns in the box
+     * @param height The number of rows in the box
+     * @param depth The number of slices in the box
+     */
+    void setSubVolume(int64_t x0, int64_t y0, int64_t z0, int64_t width, int64_t height, int64_t depth);
+
+    /**
+     * @brief Returns true if a box was set with setSubVolume()
+     */
+    bool hasSubVolume() const;
+
+    /**
+     * @brief Returns the first column, row and slice of the box set with setSubVolume()
+     */
+    std::array<int64_t, 3> getSubVolumeOrigin() const;
+
+    /**
+     * @brief Returns the number of columns, rows and slices of the box set with setSubVolume()
+     */
+    std::array<int64_t, 3> getSubVolumeSize() const;
+
   protected:
     H5EbsdVolumeReader();
 
+    /**
+     * @brief Returns the box that loadData() fills for a volume of xpoints x ypoints x zpoints. That
+     * is the box set with setSubVolume() or the complete volume when no box was set.
+     * @param origin Output: The first column, row and slice of the box
+     * @param size Output: The number of columns, rows and slices of the box
+     * @return false if the box set with setSubVolume() does not fit inside the volume
+     */
+    bool getLoadBox(int64_t xpoints, int64_t ypoints, int64_t zpoints, std::array<int64_t, 3>& origin, std::array<int64_t, 3>& size) const;
+
   private:
 
 
     QSet<QString>         m_ArrayNames;
     bool                  m_ReadAllArrays;
+    std::array<int64_t, 3> m_SubVolumeOrigin = {{0, 0, 0}};
+    std::array<int64_t, 3> m_SubVolumeSize = {{0, 0, 0}};
 
   public:
     H5EbsdVolumeReader(const H5EbsdVolumeReader&) = delete; // Copy Constructor Not Implemented
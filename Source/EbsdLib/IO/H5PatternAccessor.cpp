@@ -0,0 +1,518 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "H5PatternAccessor.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "H5Support/QH5Utilities.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+namespace
+{
+/* Contiguous datasets have no chunks to line the blocks up with so they are read in blocks of about this size */
+const size_t k_ContiguousBlockBytes = 1024 * 1024;
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5PatternAccessor::H5PatternAccessor()
+: m_CacheSize(256 * 1024 * 1024)
+, m_ErrorCode(0)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5PatternAccessor::~H5PatternAccessor()
+{
+  close();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5PatternAccessor::open(const QString& filePath, const QString& datasetPath)
+{
+  close();
+  setErrorCode(0);
+  setErrorMessage("");
+
+  m_FileId = QH5Utilities::openFile(filePath, true);
+  if(m_FileId < 0)
+  {
+    setErrorCode(-10);
+    setErrorMessage(QString("Could not open the HDF5 file '%1'").arg(filePath));
+    return getErrorCode();
+  }
+
+  // The decoded chunks are cached by this class so the chunk cache of HDF5 would only hold a second copy
+  hid_t daplId = H5Pcreate(H5P_DATASET_ACCESS);
+  H5Pset_chunk_cache(daplId, H5D_CHUNK_CACHE_NSLOTS_DEFAULT, 0, H5D_CHUNK_CACHE_W0_DEFAULT);
+  m_DatasetId = H5Dopen(m_FileId, datasetPath.toLatin1().data(), daplId);
+  H5Pclose(daplId);
+  if(m_DatasetId < 0)
+  {
+    close();
+    setErrorCode(-11);
+    setErrorMessage(QString("Could not open the pattern dataset '%1' in the HDF5 file '%2'").arg(datasetPath, filePath));
+    return getErrorCode();
+  }
+
+  hid_t spaceId = H5Dget_space(m_DatasetId);
+  int rank = H5Sget_simple_extent_ndims(spaceId);
+  if(rank >= 2)
+  {
+    m_Dims.resize(static_cast<size_t>(rank));
+    H5Sget_simple_extent_dims(spaceId, m_Dims.data(), nullptr);
+  }
+  H5Sclose(spaceId);
+  if(rank < 2)
+  {
+    close();
+    setErrorCode(-12);
+    setErrorMessage(QString("The pattern dataset '%1' needs at least 2 dimensions").arg(datasetPath));
+    return getErrorCode();
+  }
+
+  m_PatternSize = 1;
+  for(size_t i = 1; i < m_Dims.size(); i++)
+  {
+    m_PatternSize *= static_cast<size_t>(m_Dims[i]);
+  }
+
+  // Line the blocks up with the chunks so each chunk is decoded once per block read
+  m_PatternsPerBlock = std::max(static_cast<size_t>(1), k_ContiguousBlockBytes / std::max(static_cast<size_t>(1), m_PatternSize));
+  hid_t dcplId = H5Dget_create_plist(m_DatasetId);
+  if(H5Pget_layout(dcplId) == H5D_CHUNKED)
+  {
+    std::vector<hsize_t> chunkDims(m_Dims.size(), 0);
+    H5Pget_chunk(dcplId, rank, chunkDims.data());
+    m_PatternsPerBlock = std::max(static_cast<size_t>(1), static_cast<size_t>(chunkDims[0]));
+  }
+  H5Pclose(dcplId);
+
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5PatternAccessor::close()
+{
+  if(m_DatasetId >= 0)
+  {
+    H5Dclose(m_DatasetId);
+    m_DatasetId = -1;
+  }
+  if(m_FileId >= 0)
+  {
+    QH5Utilities::closeFile(m_FileId);
+    m_FileId = -1;
+  }
+  m_Dims.clear();
+  m_PatternSize = 0;
+  m_PatternsPerBlock = 1;
+  m_NumberOfBlockReads = 0;
+  m_BinningBlock.clear();
+  m_BinningBlock.shrink_to_fit();
+  clearCache();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5PatternAccessor::isOpen() const
+{
+  return m_DatasetId >= 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t H5PatternAccessor::getNumberOfPatterns() const
+{
+  return m_Dims.empty() ? 0 : static_cast<size_t>(m_Dims[0]);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<size_t> H5PatternAccessor::getPatternDims() const
+{
+  std::vector<size_t> dims;
+  for(size_t i = 1; i < m_Dims.size(); i++)
+  {
+    dims.push_back(static_cast<size_t>(m_Dims[i]));
+  }
+  return dims;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t H5PatternAccessor::getPatternSize() const
+{
+  return m_PatternSize;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t H5PatternAccessor::getPatternsPerBlock() const
+{
+  return m_PatternsPerBlock;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5PatternAccessor::readPattern(size_t index, uint8_t* pattern)
+{
+  int err = checkRange(index, 1);
+  if(err < 0)
+  {
+    return err;
+  }
+  size_t block = index / m_PatternsPerBlock;
+  const std::vector<uint8_t>* data = getBlock(block);
+  if(nullptr == data)
+  {
+    return getErrorCode();
+  }
+  ::memcpy(pattern, data->data() + (index - block * m_PatternsPerBlock) * m_PatternSize, m_PatternSize);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5PatternAccessor::readPatterns(size_t first, size_t count, uint8_t* patterns)
+{
+  int err = checkRange(first, count);
+  if(err < 0)
+  {
+    return err;
+  }
+  const size_t numPatterns = getNumberOfPatterns();
+  const size_t last = first + count;
+  size_t index = first;
+  while(index < last)
+  {
+    size_t block = index / m_PatternsPerBlock;
+    size_t blockFirst = block * m_PatternsPerBlock;
+    size_t blockLast = std::min(blockFirst + m_PatternsPerBlock, numPatterns);
+    size_t copyLast = std::min(blockLast, last);
+    uint8_t* destination = patterns + (index - first) * m_PatternSize;
+    bool covered = (count > m_PatternsPerBlock && index == blockFirst && copyLast == blockLast);
+    if(covered && m_Cache.find(block) == m_Cache.end())
+    {
+      if(readFromFile(blockFirst, blockLast - blockFirst, destination) < 0)
+      {
+        return getErrorCode();
+      }
+    }
+    else
+    {
+      const std::vector<uint8_t>* data = getBlock(block);
+      if(nullptr == data)
+      {
+        return getErrorCode();
+      }
+      ::memcpy(destination, data->data() + (index - blockFirst) * m_PatternSize, (copyLast - index) * m_PatternSize);
+    }
+    index = copyLast;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5PatternAccessor::readPatterns(const std::vector<size_t>& indices, uint8_t* patterns)
+{
+  for(size_t i = 0; i < indices.size(); i++)
+  {
+    int err = readPattern(indices[i], patterns + i * m_PatternSize);
+    if(err < 0)
+    {
+      return err;
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<size_t> H5PatternAccessor::getBinnedPatternDims(size_t factor) const
+{
+  std::vector<size_t> dims = getPatternDims();
+  if(dims.size() != 2 || EbsdLib::PatternBinning::binnedDimension(dims[0], factor) == 0 || EbsdLib::PatternBinning::binnedDimension(dims[1], factor) == 0)
+  {
+    return std::vector<size_t>();
+  }
+  dims[0] = EbsdLib::PatternBinning::binnedDimension(dims[0], factor);
+  dims[1] = EbsdLib::PatternBinning::binnedDimension(dims[1], factor);
+  return dims;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5PatternAccessor::readBinnedPatterns(size_t first, size_t count, size_t factor, EbsdLib::PatternBinning::Mode mode, uint8_t* patterns)
+{
+  int err = checkRange(first, count);
+  if(err < 0)
+  {
+    return err;
+  }
+  std::vector<size_t> binnedDims = getBinnedPatternDims(factor);
+  if(binnedDims.empty())
+  {
+    setErrorCode(-4);
+    setErrorMessage(QString("The patterns of the dataset can not be binned by a factor of %1").arg(factor));
+    return getErrorCode();
+  }
+  const size_t rows = static_cast<size_t>(m_Dims[1]);
+  const size_t cols = static_cast<size_t>(m_Dims[2]);
+  const size_t binnedSize = binnedDims[0] * binnedDims[1];
+
+  const size_t numPatterns = getNumberOfPatterns();
+  const size_t last = first + count;
+  size_t index = first;
+  while(index < last)
+  {
+    size_t block = index / m_PatternsPerBlock;
+    size_t blockFirst = block * m_PatternsPerBlock;
+    size_t blockLast = std::min(blockFirst + m_PatternsPerBlock, numPatterns);
+    size_t copyLast = std::min(blockLast, last);
+
+    const uint8_t* source = nullptr;
+    bool covered = (index == blockFirst && copyLast == blockLast);
+    if(covered && m_Cache.find(block) == m_Cache.end())
+    {
+      // A block that is binned completely is not needed again and does not go into the cache
+      m_BinningBlock.resize(m_PatternsPerBlock * m_PatternSize);
+      if(readFromFile(blockFirst, blockLast - blockFirst, m_BinningBlock.data()) < 0)
+      {
+        return getErrorCode();
+      }
+      source = m_BinningBlock.data();
+    }
+    else
+    {
+      // The rest of a partly binned block is likely asked for next, e.g. by the next row of a region
+      const std::vector<uint8_t>* data = getBlock(block);
+      if(nullptr == data)
+      {
+        return getErrorCode();
+      }
+      source = data->data() + (index - blockFirst) * m_PatternSize;
+    }
+    EbsdLib::PatternBinning::binPatterns(source, copyLast - index, rows, cols, factor, mode, patterns + (index - first) * binnedSize);
+    index = copyLast;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5PatternAccessor::readBinnedRegion(size_t scanColumns, size_t x0, size_t y0, size_t width, size_t height, size_t factor, EbsdLib::PatternBinning::Mode mode, uint8_t* patterns)
+{
+  std::vector<size_t> binnedDims = getBinnedPatternDims(factor);
+  const size_t binnedSize = binnedDims.empty() ? 0 : binnedDims[0] * binnedDims[1];
+  if(x0 + width > scanColumns)
+  {
+    setErrorCode(-2);
+    setErrorMessage(QString("The region columns %1 to %2 are not all inside the %3 columns of the scan").arg(x0).arg(x0 + width).arg(scanColumns));
+    return getErrorCode();
+  }
+  // Each row of the region is a consecutive range of patterns
+  for(size_t y = 0; y < height; y++)
+  {
+    int err = readBinnedPatterns((y0 + y) * scanColumns + x0, width, factor, mode, patterns + y * width * binnedSize);
+    if(err < 0)
+    {
+      return err;
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5PatternAccessor::clearCache()
+{
+  m_Cache.clear();
+  m_LruBlocks.clear();
+  m_CachedBytes = 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t H5PatternAccessor::getCachedBytes() const
+{
+  return m_CachedBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t H5PatternAccessor::getNumberOfBlockReads() const
+{
+  return m_NumberOfBlockReads;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const std::vector<uint8_t>* H5PatternAccessor::getBlock(size_t block)
+{
+  auto iter = m_Cache.find(block);
+  if(iter != m_Cache.end())
+  {
+    // Move the block to the front of the list as it is now the most recently used one
+    m_LruBlocks.splice(m_LruBlocks.begin(), m_LruBlocks, iter->second.lruPosition);
+    return &(iter->second.data);
+  }
+
+  size_t first = block * m_PatternsPerBlock;
+  size_t count = std::min(m_PatternsPerBlock, getNumberOfPatterns() - first);
+  std::vector<uint8_t> data(count * m_PatternSize);
+  if(readFromFile(first, count, data.data()) < 0)
+  {
+    return nullptr;
+  }
+
+  // Make room for the new block by dropping the least recently used ones
+  while(!m_LruBlocks.empty() && m_CachedBytes + data.size() > m_CacheSize)
+  {
+    auto oldest = m_Cache.find(m_LruBlocks.back());
+    m_CachedBytes -= oldest->second.data.size();
+    m_Cache.erase(oldest);
+    m_LruBlocks.pop_back();
+  }
+
+  m_LruBlocks.push_front(block);
+  CacheEntry& entry = m_Cache[block];
+  entry.data = std::move(data);
+  entry.lruPosition = m_LruBlocks.begin();
+  m_CachedBytes += entry.data.size();
+  return &(entry.data);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5PatternAccessor::readFromFile(size_t first, size_t count, uint8_t* patterns)
+{
+  std::vector<hsize_t> start(m_Dims.size(), 0);
+  std::vector<hsize_t> counts(m_Dims);
+  start[0] = static_cast<hsize_t>(first);
+  counts[0] = static_cast<hsize_t>(count);
+
+  hid_t fileSpaceId = H5Dget_space(m_DatasetId);
+  herr_t err = H5Sselect_hyperslab(fileSpaceId, H5S_SELECT_SET, start.data(), nullptr, counts.data(), nullptr);
+  if(err >= 0)
+  {
+    hid_t memSpaceId = H5Screate_simple(static_cast<int>(counts.size()), counts.data(), nullptr);
+    err = H5Dread(m_DatasetId, H5T_NATIVE_UINT8, memSpaceId, fileSpaceId, H5P_DEFAULT, patterns);
+    H5Sclose(memSpaceId);
+  }
+  H5Sclose(fileSpaceId);
+  m_NumberOfBlockReads++;
+
+  if(err < 0)
+  {
+    setErrorCode(-3);
+    setErrorMessage(QString("Could not read the patterns %1 to %2 from the file").arg(first).arg(first + count - 1));
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5PatternAccessor::checkRange(size_t first, size_t count)
+{
+  if(!isOpen())
+  {
+    setErrorCode(-1);
+    setErrorMessage("The pattern accessor is not open");
+    return getErrorCode();
+  }
+  if(first > getNumberOfPatterns() || count > getNumberOfPatterns() - first)
+  {
+    setErrorCode(-2);
+    setErrorMessage(QString("The patterns %1 to %2 are not all inside the %3 patterns of the dataset").arg(first).arg(first + count).arg(getNumberOfPatterns()));
+    return getErrorCode();
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+H5PatternAccessor::Pointer H5PatternAccessor::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+H5PatternAccessor::Pointer H5PatternAccessor::New()
+{
+  Pointer sharedPtr(new(H5PatternAccessor));
+  return sharedPtr;
+}
+
+// -----------------------------------------------------------------------------
+QString H5PatternAccessor::getNameOfClass() const
+{
+  return QString("H5PatternAccessor");
+}
+
+// -----------------------------------------------------------------------------
+QString H5PatternAccessor::ClassName()
+{
+  return QString("H5PatternAccessor");
+}
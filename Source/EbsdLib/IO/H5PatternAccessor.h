@@ -0,0 +1,270 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <hdf5.h>
+
+#include <QtCore/QString>
+
+#include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/Core/EbsdSetGetMacros.h"
+#include "EbsdLib/IO/EbsdPatternBinning.hpp"
+
+/**
+ * @class H5PatternAccessor H5PatternAccessor.h EbsdLib/IO/H5PatternAccessor.h
+ * @brief Gives random access to the EBSD patterns stored in a vendor HDF5 file (The PatternData dataset
+ * of an EDAX OIM file or the RawPatterns dataset of a Bruker Esprit file) without loading the complete
+ * dataset into memory. The first dimension of the dataset is the scan point, the remaining dimensions
+ * are the rows and columns of a pattern.
+ *
+ * Patterns are read in blocks that line up with the HDF5 chunks of the dataset, so every chunk is only
+ * decoded once while its block stays in the cache. The decoded blocks are kept in a least recently used
+ * cache that holds at most getCacheSize() bytes. Contiguous datasets are read in blocks of about 1 MB.
+ *
+ * Error codes:
+ * @li -1 The accessor is not open
+ * @li -2 A pattern index is past the end of the dataset
+ * @li -3 The patterns could not be read from the file
+ * @li -4 The patterns can not be binned by the requested factor
+ * @li -10 The HDF5 file could not be opened
+ * @li -11 The pattern dataset could not be opened
+ * @li -12 The pattern dataset does not have at least 2 dimensions
+ *
+ * This class is not thread safe.
+ */
+class EbsdLib_EXPORT H5PatternAccessor
+{
+public:
+  using Self = H5PatternAccessor;
+  using Pointer = std::shared_ptr<Self>;
+  using ConstPointer = std::shared_ptr<const Self>;
+  using WeakPointer = std::weak_ptr<Self>;
+  using ConstWeakPointer = std::weak_ptr<const Self>;
+  static Pointer NullPointer();
+
+  static Pointer New();
+
+  /**
+   * @brief Returns the name of the class for H5PatternAccessor
+   */
+  QString getNameOfClass() const;
+  /**
+   * @brief Returns the name of the class for H5PatternAccessor
+   */
+  static QString ClassName();
+
+  ~H5PatternAccessor();
+
+  /**
+   * @brief The largest number of bytes of decoded patterns that are kept in the cache. The most
+   * recently used block is always kept even if it is larger. The default is 256 MB.
+   */
+  EBSD_INSTANCE_PROPERTY(size_t, CacheSize)
+
+  /**
+   * @brief These get filled out if there are errors. Negative values are error codes
+   */
+  EBSD_INSTANCE_PROPERTY(int, ErrorCode)
+
+  EBSD_INSTANCE_STRING_PROPERTY(ErrorMessage)
+
+  /**
+   * @brief Opens the file read only and the pattern dataset in it. Any previously opened dataset is
+   * closed and the cache is cleared.
+   * @param filePath The HDF5 file
+   * @param datasetPath The full path of the pattern dataset inside the file
+   * @return Zero on success or a negative error code
+   */
+  int open(const QString& filePath, const QString& datasetPath);
+
+  /**
+   * @brief Closes the dataset and the file and clears the cache.
+   */
+  void close();
+
+  /**
+   * @brief Returns true if a pattern dataset is open
+   */
+  bool isOpen() const;
+
+  /**
+   * @brief Returns the number of patterns in the dataset
+   */
+  size_t getNumberOfPatterns() const;
+
+  /**
+   * @brief Returns the dimensions of a single pattern, which are all the dimensions of the dataset
+   * except the first one. For a 2D pattern this is the number of rows followed by the number of columns.
+   */
+  std::vector<size_t> getPatternDims() const;
+
+  /**
+   * @brief Returns the number of bytes in a single pattern
+   */
+  size_t getPatternSize() const;
+
+  /**
+   * @brief Returns the number of patterns that are read and cached together
+   */
+  size_t getPatternsPerBlock() const;
+
+  /**
+   * @brief Copies a single pattern into the destination.
+   * @param index The scan point index of the pattern
+   * @param pattern Output: Room for getPatternSize() bytes
+   * @return Zero on success or a negative error code
+   */
+  int readPattern(size_t index, uint8_t* pattern);
+
+  /**
+   * @brief Copies the patterns [first, first + count) into the destination. When the range spans more
+   * than one block, the blocks that are completely covered by it and not cached yet are read straight
+   * into the destination without going through the cache so a large batch does not evict the blocks
+   * that are in use.
+   * @param first The scan point index of the first pattern
+   * @param count The number of patterns
+   * @param patterns Output: Room for count * getPatternSize() bytes
+   * @return Zero on success or a negative error code
+   */
+  int readPatterns(size_t first, size_t count, uint8_t* patterns);
+
+  /**
+   * @brief Copies the patterns at the given scan point indices into the destination, in the order of
+   * the indices.
+   * @param indices The scan point indices
+   * @param patterns Output: Room for indices.size() * getPatternSize() bytes
+   * @return Zero on success or a negative error code
+   */
+  int readPatterns(const std::vector<size_t>& indices, uint8_t* patterns);
+
+  /**
+   * @brief Returns the dimensions of a single pattern after binning it by the factor. Only 2D patterns
+   * can be binned, for any other pattern this returns an empty vector.
+   */
+  std::vector<size_t> getBinnedPatternDims(size_t factor) const;
+
+  /**
+   * @brief Reads the patterns [first, first + count) and bins them into the destination one block at a
+   * time. Blocks that the range covers completely and that are not cached are read into a scratch buffer
+   * that does not go into the cache. Partly covered blocks go through the cache like readPattern(), so
+   * the rows of a region that share a chunk only decode it once.
+   * @param first The scan point index of the first pattern
+   * @param count The number of patterns
+   * @param factor The number of pattern pixels along each side of a binned pixel
+   * @param mode How the pixels are combined
+   * @param patterns Output: Room for count binned patterns (See getBinnedPatternDims())
+   * @return Zero on success or a negative error code
+   */
+  int readBinnedPatterns(size_t first, size_t count, size_t factor, EbsdLib::PatternBinning::Mode mode, uint8_t* patterns);
+
+  /**
+   * @brief Reads the patterns of a rectangular region of the scan and bins them like readBinnedPatterns().
+   * The binned patterns are stored row by row of the region.
+   * @param scanColumns The number of columns of the scan
+   * @param x0 The first column of the region
+   * @param y0 The first row of the region
+   * @param width The number of columns in the region
+   * @param height The number of rows in the region
+   * @param factor The number of pattern pixels along each side of a binned pixel
+   * @param mode How the pixels are combined
+   * @param patterns Output: Room for width * height binned patterns
+   * @return Zero on success or a negative error code
+   */
+  int readBinnedRegion(size_t scanColumns, size_t x0, size_t y0, size_t width, size_t height, size_t factor, EbsdLib::PatternBinning::Mode mode, uint8_t* patterns);
+
+  /**
+   * @brief Removes all blocks from the cache
+   */
+  void clearCache();
+
+  /**
+   * @brief Returns the number of bytes of patterns currently held in the cache
+   */
+  size_t getCachedBytes() const;
+
+  /**
+   * @brief Returns the number of blocks that were read from the file since the dataset was opened
+   */
+  size_t getNumberOfBlockReads() const;
+
+protected:
+  H5PatternAccessor();
+
+  /**
+   * @brief Returns the cached block with the given index, reading it from the file if needed.
+   * @return The block or nullptr if it could not be read
+   */
+  const std::vector<uint8_t>* getBlock(size_t block);
+
+  /**
+   * @brief Reads the patterns [first, first + count) from the file with a hyperslab selection.
+   */
+  herr_t readFromFile(size_t first, size_t count, uint8_t* patterns);
+
+  /**
+   * @brief Checks that the accessor is open and that [first, first + count) lies inside the dataset
+   */
+  int checkRange(size_t first, size_t count);
+
+private:
+  struct CacheEntry
+  {
+    std::vector<uint8_t> data;
+    std::list<size_t>::iterator lruPosition;
+  };
+
+  hid_t m_FileId = -1;
+  hid_t m_DatasetId = -1;
+  std::vector<hsize_t> m_Dims;
+  size_t m_PatternSize = 0;
+  size_t m_PatternsPerBlock = 1;
+  size_t m_NumberOfBlockReads = 0;
+  size_t m_CachedBytes = 0;
+  std::list<size_t> m_LruBlocks;
+  std::unordered_map<size_t, CacheEntry> m_Cache;
+  std::vector<uint8_t> m_BinningBlock;
+
+public:
+  H5PatternAccessor(const H5PatternAccessor&) = delete;            // Copy Constructor Not Implemented
+  H5PatternAccessor(H5PatternAccessor&&) = delete;                 // Move Constructor Not Implemented
+  H5PatternAccessor& operator=(const H5PatternAccessor&) = delete; // Copy Assignment Not Implemented
+  H5PatternAccessor& operator=(H5PatternAccessor&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,586 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "H5ScanCatalog.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+#include "H5Support/H5ScopedSentinel.h"
+#include "H5Support/H5Utilities.h"
+#include "H5Support/QH5Lite.h"
+#include "H5Support/QH5Utilities.h"
+
+#include "EbsdLib/IO/BrukerNano/EspritConstants.h"
+#include "EbsdLib/IO/H5ScanRegion.hpp"
+#include "EbsdLib/IO/TSL/AngConstants.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+namespace
+{
+/* Phase values below this are counted in a table, any others in a map */
+const int32_t k_MaxTablePhase = 256;
+
+/**
+ * @brief The names of the groups and datasets that differ between the two vendor layouts
+ */
+struct VendorLayout
+{
+  QString ebsd;
+  QString header;
+  QString phases;
+  QString data;
+  QString numColumns;
+  QString numRows;
+  QString xStep;
+  QString yStep;
+  QString grid;
+  QString phaseName;
+  QString phaseFormula;
+  QString quality;
+  QString phase;
+  QString patterns;
+};
+
+VendorLayout GetLayout(H5ScanCatalog::Format format)
+{
+  VendorLayout layout;
+  if(format == H5ScanCatalog::Format::BrukerEsprit)
+  {
+    layout.ebsd = EbsdLib::H5Esprit::EBSD;
+    layout.header = EbsdLib::H5Esprit::Header;
+    layout.phases = EbsdLib::H5Esprit::Phases;
+    layout.data = EbsdLib::H5Esprit::Data;
+    layout.numColumns = EbsdLib::H5Esprit::NCOLS;
+    layout.numRows = EbsdLib::H5Esprit::NROWS;
+    layout.xStep = EbsdLib::H5Esprit::XSTEP;
+    layout.yStep = EbsdLib::H5Esprit::YSTEP;
+    layout.grid = EbsdLib::H5Esprit::GridType;
+    layout.phaseName = EbsdLib::H5Esprit::Name;
+    layout.phaseFormula = EbsdLib::H5Esprit::Formula;
+    layout.quality = EbsdLib::H5Esprit::MAD;
+    layout.phase = EbsdLib::H5Esprit::Phase;
+    layout.patterns = EbsdLib::H5Esprit::RawPatterns;
+  }
+  else
+  {
+    layout.ebsd = EbsdLib::H5OIM::EBSD;
+    layout.header = EbsdLib::H5OIM::Header;
+    layout.phases = EbsdLib::H5OIM::Phase;
+    layout.data = EbsdLib::H5OIM::Data;
+    layout.numColumns = EbsdLib::Ang::nColumns;
+    layout.numRows = EbsdLib::Ang::nRows;
+    layout.xStep = EbsdLib::Ang::StepX;
+    layout.yStep = EbsdLib::Ang::StepY;
+    layout.grid = EbsdLib::Ang::GridType;
+    layout.phaseName = EbsdLib::Ang::MaterialName;
+    layout.phaseFormula = EbsdLib::Ang::Formula;
+    layout.quality = EbsdLib::Ang::CI;
+    layout.phase = EbsdLib::Ang::Phase;
+    layout.patterns = EbsdLib::Ang::PatternData;
+  }
+  return layout;
+}
+
+/**
+ * @brief Reads a scalar header value if the dataset exists, converting it to the type of 'value'
+ */
+template <typename T>
+void ReadOptionalScalar(hid_t gid, const QString& name, T& value)
+{
+  if(QH5Lite::datasetExists(gid, name))
+  {
+    QH5Lite::readScalarDataset(gid, name, value);
+  }
+}
+
+/**
+ * @brief Reads a string header value if the dataset exists
+ */
+void ReadOptionalString(hid_t gid, const QString& name, QString& value)
+{
+  if(QH5Lite::datasetExists(gid, name))
+  {
+    QH5Lite::readStringDataset(gid, name, value);
+  }
+}
+
+/**
+ * @brief Tells the vendor layout apart by the manufacturer dataset at the root of the file. Files
+ * without one are recognized by the header group of their first scan.
+ */
+H5ScanCatalog::Format DetectFormat(hid_t fileId, const QStringList& scanNames)
+{
+  HDF_ERROR_HANDLER_OFF
+  H5ScanCatalog::Format format = H5ScanCatalog::Format::Unknown;
+  QString manufacturer;
+  ReadOptionalString(fileId, EbsdLib::H5Esprit::Manufacturer, manufacturer);
+  if(manufacturer.isEmpty())
+  {
+    ReadOptionalString(fileId, EbsdLib::H5OIM::Manufacturer, manufacturer);
+  }
+  if(manufacturer.contains(EbsdLib::H5Esprit::BrukerNano, Qt::CaseInsensitive))
+  {
+    format = H5ScanCatalog::Format::BrukerEsprit;
+  }
+  else if(manufacturer.contains(EbsdLib::H5OIM::EDAX, Qt::CaseInsensitive))
+  {
+    format = H5ScanCatalog::Format::EdaxOIM;
+  }
+  else if(!scanNames.empty())
+  {
+    QString headerPath = QString("%1/%2/%3/").arg(scanNames.front(), EbsdLib::H5OIM::EBSD, EbsdLib::H5OIM::Header);
+    if(QH5Lite::datasetExists(fileId, headerPath + EbsdLib::H5Esprit::NCOLS))
+    {
+      format = H5ScanCatalog::Format::BrukerEsprit;
+    }
+    else if(QH5Lite::datasetExists(fileId, headerPath + EbsdLib::Ang::nColumns))
+    {
+      format = H5ScanCatalog::Format::EdaxOIM;
+    }
+  }
+  HDF_ERROR_HANDLER_ON
+  return format;
+}
+
+/**
+ * @brief Computes the summary values of a wave of scans from their quality and phase columns. The
+ * scans do not share any state so they can be summarized in any order.
+ */
+class SummarizeScansImpl
+{
+  std::vector<H5ScanCatalog::ScanInfo*>* m_Scans;
+  std::vector<std::vector<float>>* m_Quality;
+  std::vector<std::vector<int32_t>>* m_Phases;
+
+public:
+  SummarizeScansImpl(std::vector<H5ScanCatalog::ScanInfo*>* scans, std::vector<std::vector<float>>* quality, std::vector<std::vector<int32_t>>* phases)
+  : m_Scans(scans)
+  , m_Quality(quality)
+  , m_Phases(phases)
+  {
+  }
+
+  void generate(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      H5ScanCatalog::ScanInfo& scan = *(*m_Scans)[i];
+      const std::vector<float>& quality = (*m_Quality)[i];
+      const std::vector<int32_t>& phases = (*m_Phases)[i];
+      const size_t numPoints = quality.size();
+
+      double sum = 0.0;
+      std::vector<size_t> tableCounts(k_MaxTablePhase, 0);
+      std::map<int32_t, size_t> counts;
+      for(size_t p = 0; p < numPoints; p++)
+      {
+        sum += quality[p];
+        int32_t phase = phases[p];
+        if(phase >= 0 && phase < k_MaxTablePhase)
+        {
+          tableCounts[phase]++;
+        }
+        else
+        {
+          counts[phase]++;
+        }
+      }
+      for(int32_t phase = 0; phase < k_MaxTablePhase; phase++)
+      {
+        if(tableCounts[phase] > 0)
+        {
+          counts[phase] = tableCounts[phase];
+        }
+      }
+
+      scan.numPoints = numPoints;
+      scan.meanQuality = (numPoints > 0) ? sum / static_cast<double>(numPoints) : 0.0;
+      scan.phaseFractions.clear();
+      for(const auto& count : counts)
+      {
+        scan.phaseFractions[count.first] = static_cast<double>(count.second) / static_cast<double>(numPoints);
+      }
+      scan.hasSummary = true;
+    }
+  }
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    generate(r.begin(), r.end());
+  }
+#endif
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5ScanCatalog::H5ScanCatalog()
+: m_ErrorCode(0)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5ScanCatalog::~H5ScanCatalog()
+{
+  close();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5ScanCatalog::open(const QString& filePath)
+{
+  close();
+  setErrorCode(0);
+  setErrorMessage("");
+
+  m_FileId = QH5Utilities::openFile(filePath, true);
+  if(m_FileId < 0)
+  {
+    setErrorCode(-1);
+    setErrorMessage(QString("Could not open the HDF5 file '%1'").arg(filePath));
+    return getErrorCode();
+  }
+
+  QStringList names;
+  QH5Utilities::getGroupObjects(m_FileId, H5Utilities::CustomHDFDataTypes::Group, names);
+  m_Format = DetectFormat(m_FileId, names);
+  if(m_Format == Format::Unknown)
+  {
+    close();
+    setErrorCode(-2);
+    setErrorMessage(QString("The HDF5 file '%1' is neither an EDAX OIM nor a Bruker Esprit file").arg(filePath));
+    return getErrorCode();
+  }
+
+  const VendorLayout layout = GetLayout(m_Format);
+  m_Scans.reserve(static_cast<size_t>(names.size()));
+  for(const auto& name : names)
+  {
+    hid_t scanGid = H5Gopen(m_FileId, name.toLatin1().data(), H5P_DEFAULT);
+    if(scanGid < 0)
+    {
+      continue;
+    }
+    H5ScopedGroupSentinel sentinel(&scanGid, false);
+    // Other top level groups of the vendor files are not scans
+    if(H5Lexists(scanGid, layout.ebsd.toLatin1().data(), H5P_DEFAULT) <= 0)
+    {
+      continue;
+    }
+    ScanInfo scan;
+    scan.name = name;
+    readScanInfo(scanGid, scan);
+    m_Scans.push_back(scan);
+  }
+  return getErrorCode();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5ScanCatalog::readScanInfo(hid_t scanGid, ScanInfo& scan) const
+{
+  const VendorLayout layout = GetLayout(m_Format);
+  HDF_ERROR_HANDLER_OFF
+  hid_t ebsdGid = H5Gopen(scanGid, layout.ebsd.toLatin1().data(), H5P_DEFAULT);
+  hid_t headerGid = (ebsdGid >= 0) ? H5Gopen(ebsdGid, layout.header.toLatin1().data(), H5P_DEFAULT) : -1;
+  H5ScopedGroupSentinel sentinel(&ebsdGid, false);
+  sentinel.addGroupId(&headerGid);
+  if(headerGid < 0)
+  {
+    HDF_ERROR_HANDLER_ON
+    scan.errorCode = -10;
+    scan.errorMessage = QString("Scan '%1' has no %2/%3 group").arg(scan.name, layout.ebsd, layout.header);
+    return;
+  }
+
+  ReadOptionalScalar(headerGid, layout.numColumns, scan.numColumns);
+  ReadOptionalScalar(headerGid, layout.numRows, scan.numRows);
+  ReadOptionalScalar(headerGid, layout.xStep, scan.xStep);
+  ReadOptionalScalar(headerGid, layout.yStep, scan.yStep);
+  ReadOptionalString(headerGid, layout.grid, scan.grid);
+
+  hid_t phasesGid = H5Gopen(headerGid, layout.phases.toLatin1().data(), H5P_DEFAULT);
+  sentinel.addGroupId(&phasesGid);
+  if(phasesGid >= 0)
+  {
+    QStringList phaseNames;
+    QH5Utilities::getGroupObjects(phasesGid, H5Utilities::CustomHDFDataTypes::Group, phaseNames);
+    for(const auto& phaseName : phaseNames)
+    {
+      hid_t pid = H5Gopen(phasesGid, phaseName.toLatin1().data(), H5P_DEFAULT);
+      if(pid < 0)
+      {
+        continue;
+      }
+      PhaseInfo phase;
+      phase.index = phaseName.toInt();
+      ReadOptionalString(pid, layout.phaseName, phase.name);
+      ReadOptionalString(pid, layout.phaseFormula, phase.formula);
+      H5Gclose(pid);
+      scan.phases.push_back(phase);
+    }
+  }
+
+  hid_t dataGid = H5Gopen(ebsdGid, layout.data.toLatin1().data(), H5P_DEFAULT);
+  sentinel.addGroupId(&dataGid);
+  if(dataGid < 0)
+  {
+    HDF_ERROR_HANDLER_ON
+    scan.errorCode = -11;
+    scan.errorMessage = QString("Scan '%1' has no %2/%3 group").arg(scan.name, layout.ebsd, layout.data);
+    return;
+  }
+  QH5Utilities::getGroupObjects(dataGid, H5Utilities::CustomHDFDataTypes::Dataset, scan.columns);
+  if(scan.columns.contains(layout.patterns))
+  {
+    QVector<hsize_t> dims;
+    H5T_class_t typeClass;
+    size_t typeSize = 0;
+    if(QH5Lite::getDatasetInfo(dataGid, layout.patterns, dims, typeClass, typeSize) >= 0)
+    {
+      for(int i = 1; i < dims.size(); i++)
+      {
+        scan.patternDims.push_back(static_cast<size_t>(dims[i]));
+      }
+    }
+  }
+  HDF_ERROR_HANDLER_ON
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5ScanCatalog::readSummaryColumns(ScanInfo& scan, std::vector<float>& quality, std::vector<int32_t>& phases) const
+{
+  const VendorLayout layout = GetLayout(m_Format);
+  scan.qualityName = layout.quality;
+  if(!scan.columns.contains(layout.quality) || !scan.columns.contains(layout.phase))
+  {
+    scan.errorCode = -20;
+    scan.errorMessage = QString("Scan '%1' does not have both a %2 and a %3 column").arg(scan.name, layout.quality, layout.phase);
+    return scan.errorCode;
+  }
+
+  QString dataPath = QString("%1/%2/%3").arg(scan.name, layout.ebsd, layout.data);
+  hid_t dataGid = H5Gopen(m_FileId, dataPath.toLatin1().data(), H5P_DEFAULT);
+  if(dataGid < 0)
+  {
+    scan.errorCode = -11;
+    scan.errorMessage = QString("Scan '%1' has no %2/%3 group").arg(scan.name, layout.ebsd, layout.data);
+    return scan.errorCode;
+  }
+  H5ScopedGroupSentinel sentinel(&dataGid, false);
+
+  // Both columns have to hold exactly one value per point of the scan
+  QVector<hsize_t> qualityDims;
+  QVector<hsize_t> phaseDims;
+  H5T_class_t typeClass;
+  size_t typeSize = 0;
+  herr_t err = QH5Lite::getDatasetInfo(dataGid, layout.quality, qualityDims, typeClass, typeSize);
+  err = std::min(err, QH5Lite::getDatasetInfo(dataGid, layout.phase, phaseDims, typeClass, typeSize));
+  if(err < 0 || qualityDims.empty() || qualityDims != phaseDims || static_cast<int>(std::count(qualityDims.begin() + 1, qualityDims.end(), 1)) != qualityDims.size() - 1)
+  {
+    scan.errorCode = -21;
+    scan.errorMessage = QString("The %2 and %3 columns of scan '%1' do not hold one value per scan point").arg(scan.name, layout.quality, layout.phase);
+    return scan.errorCode;
+  }
+
+  const size_t numPoints = static_cast<size_t>(qualityDims[0]);
+  quality.resize(numPoints);
+  phases.resize(numPoints);
+  err = EbsdLib::H5ScanRegion::readAllPoints(dataGid, layout.quality, numPoints, quality.data());
+  err = std::min(err, EbsdLib::H5ScanRegion::readAllPoints(dataGid, layout.phase, numPoints, phases.data()));
+  if(err < 0)
+  {
+    scan.errorCode = -22;
+    scan.errorMessage = QString("The %2 and %3 columns of scan '%1' could not be read").arg(scan.name, layout.quality, layout.phase);
+    return scan.errorCode;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5ScanCatalog::summarize()
+{
+  if(m_FileId < 0)
+  {
+    setErrorCode(-3);
+    setErrorMessage("The catalog is not open");
+    return getErrorCode();
+  }
+
+  std::vector<ScanInfo*> scans;
+  for(auto& scan : m_Scans)
+  {
+    if(scan.errorCode >= 0)
+    {
+      scans.push_back(&scan);
+    }
+  }
+
+  // HDF5 is only called from this thread. The columns of a few scans per thread are read before they
+  // are summarized in parallel, which bounds the memory use to the columns of one wave of scans.
+  size_t scansPerWave = 2 * static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1U));
+  std::vector<ScanInfo*> wave;
+  std::vector<std::vector<float>> quality(scansPerWave);
+  std::vector<std::vector<int32_t>> phases(scansPerWave);
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  bool doParallel = true;
+#endif
+
+  for(size_t first = 0; first < scans.size(); first += scansPerWave)
+  {
+    wave.clear();
+    size_t last = std::min(first + scansPerWave, scans.size());
+    for(size_t s = first; s < last; s++)
+    {
+      size_t slot = wave.size();
+      if(readSummaryColumns(*scans[s], quality[slot], phases[slot]) >= 0)
+      {
+        wave.push_back(scans[s]);
+      }
+    }
+
+    SummarizeScansImpl summarizeScans(&wave, &quality, &phases);
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+    if(doParallel)
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, wave.size(), 1), summarizeScans, tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      summarizeScans.generate(0, wave.size());
+    }
+  }
+  return getErrorCode();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5ScanCatalog::close()
+{
+  if(m_FileId >= 0)
+  {
+    QH5Utilities::closeFile(m_FileId);
+    m_FileId = -1;
+  }
+  m_Format = Format::Unknown;
+  m_Scans.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5ScanCatalog::isOpen() const
+{
+  return m_FileId >= 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5ScanCatalog::Format H5ScanCatalog::getFormat() const
+{
+  return m_Format;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const std::vector<H5ScanCatalog::ScanInfo>& H5ScanCatalog::getScans() const
+{
+  return m_Scans;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const H5ScanCatalog::ScanInfo* H5ScanCatalog::getScan(const QString& name) const
+{
+  for(const auto& scan : m_Scans)
+  {
+    if(scan.name == name)
+    {
+      return &scan;
+    }
+  }
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+H5ScanCatalog::Pointer H5ScanCatalog::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+H5ScanCatalog::Pointer H5ScanCatalog::New()
+{
+  Pointer sharedPtr(new(H5ScanCatalog));
+  return sharedPtr;
+}
+
+// -----------------------------------------------------------------------------
+QString H5ScanCatalog::getNameOfClass() const
+{
+  return QString("H5ScanCatalog");
+}
+
+// -----------------------------------------------------------------------------
+QString H5ScanCatalog::ClassName()
+{
+  return QString("H5ScanCatalog");
+}
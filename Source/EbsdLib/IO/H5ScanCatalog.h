@@ -0,0 +1,208 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <hdf5.h>
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/Core/EbsdSetGetMacros.h"
+
+/**
+ * @class H5ScanCatalog H5ScanCatalog.h EbsdLib/IO/H5ScanCatalog.h
+ * @brief Lists every scan in an EDAX OIM or a Bruker Esprit HDF5 file. open() reads the file once and
+ * only touches the header values, the phase groups and the dataset descriptions of each scan, none of
+ * the scan data is read. summarize() then reads the quality column (CI for OIM, MAD for Esprit) and the
+ * phase column of every scan and computes the mean quality and the phase fractions of each scan. The
+ * columns are read on the calling thread and the scans are summarized in parallel.
+ *
+ * The H5OIMReader and H5EspritReader still read the complete data of a single scan.
+ *
+ * Error codes of the catalog:
+ * @li -1 The HDF5 file could not be opened
+ * @li -2 The file is neither an EDAX OIM nor a Bruker Esprit file
+ * @li -3 The catalog is not open
+ *
+ * Error codes of a single scan (See ScanInfo::errorCode):
+ * @li -10 The EBSD group or its Header group is missing
+ * @li -11 The Data group is missing
+ * @li -20 The quality or phase column is missing
+ * @li -21 The quality or phase column does not hold one value per scan point
+ * @li -22 The quality or phase column could not be read
+ *
+ * This class is not thread safe.
+ */
+class EbsdLib_EXPORT H5ScanCatalog
+{
+public:
+  using Self = H5ScanCatalog;
+  using Pointer = std::shared_ptr<Self>;
+  using ConstPointer = std::shared_ptr<const Self>;
+  using WeakPointer = std::weak_ptr<Self>;
+  using ConstWeakPointer = std::weak_ptr<const Self>;
+  static Pointer NullPointer();
+
+  static Pointer New();
+
+  /**
+   * @brief Returns the name of the class for H5ScanCatalog
+   */
+  QString getNameOfClass() const;
+  /**
+   * @brief Returns the name of the class for H5ScanCatalog
+   */
+  static QString ClassName();
+
+  ~H5ScanCatalog();
+
+  enum class Format : int
+  {
+    Unknown = 0,
+    EdaxOIM = 1,
+    BrukerEsprit = 2
+  };
+
+  struct PhaseInfo
+  {
+    int index = 0;
+    QString name;
+    QString formula;
+  };
+
+  struct ScanInfo
+  {
+    QString name;
+    int numColumns = 0;
+    int numRows = 0;
+    float xStep = 0.0f;
+    float yStep = 0.0f;
+    QString grid;
+    std::vector<PhaseInfo> phases;
+    /* The names of the datasets in the Data group of the scan */
+    QStringList columns;
+    /* The dimensions of a single pattern or empty if the scan has no patterns */
+    std::vector<size_t> patternDims;
+    int errorCode = 0;
+    QString errorMessage;
+
+    /* The values below are only set by summarize() */
+    bool hasSummary = false;
+    QString qualityName;
+    size_t numPoints = 0;
+    double meanQuality = 0.0;
+    /* The fraction of the scan points with each value of the phase column */
+    std::map<int32_t, double> phaseFractions;
+  };
+
+  /**
+   * @brief These get filled out if there are errors. Negative values are error codes
+   */
+  EBSD_INSTANCE_PROPERTY(int, ErrorCode)
+
+  EBSD_INSTANCE_STRING_PROPERTY(ErrorMessage)
+
+  /**
+   * @brief Opens the file read only and lists its scans. A scan whose metadata can not be read is still
+   * listed with a negative errorCode. The file stays open for summarize() until close() is called.
+   * @param filePath The HDF5 file
+   * @return Zero on success or a negative error code
+   */
+  int open(const QString& filePath);
+
+  /**
+   * @brief Closes the file and clears the list of scans
+   */
+  void close();
+
+  /**
+   * @brief Returns true if a file is open
+   */
+  bool isOpen() const;
+
+  /**
+   * @brief Returns the vendor layout of the open file
+   */
+  Format getFormat() const;
+
+  /**
+   * @brief Returns the scans of the open file in the order HDF5 lists their groups
+   */
+  const std::vector<ScanInfo>& getScans() const;
+
+  /**
+   * @brief Returns the scan with the given name or nullptr if the file has no such scan
+   */
+  const ScanInfo* getScan(const QString& name) const;
+
+  /**
+   * @brief Reads the quality and phase columns of every scan that was listed without an error and
+   * fills in the summary values of the scan. A scan whose columns can not be read gets a negative
+   * errorCode and no summary. Only a few scans per thread are held in memory at once.
+   * @return Zero on success, -3 if the catalog is not open
+   */
+  int summarize();
+
+protected:
+  H5ScanCatalog();
+
+  /**
+   * @brief Reads the header values, phases and dataset descriptions of one scan
+   */
+  void readScanInfo(hid_t scanGid, ScanInfo& scan) const;
+
+  /**
+   * @brief Reads the quality and phase columns of a scan
+   * @return Zero on success or the error code of the scan
+   */
+  int readSummaryColumns(ScanInfo& scan, std::vector<float>& quality, std::vector<int32_t>& phases) const;
+
+private:
+  hid_t m_FileId = -1;
+  Format m_Format = Format::Unknown;
+  std::vector<ScanInfo> m_Scans;
+
+public:
+  H5ScanCatalog(const H5ScanCatalog&) = delete;            // Copy Constructor Not Implemented
+  H5ScanCatalog(H5ScanCatalog&&) = delete;                 // Move Constructor Not Implemented
+  H5ScanCatalog& operator=(const H5ScanCatalog&) = delete; // Copy Assignment Not Implemented
+  H5ScanCatalog& operator=(H5ScanCatalog&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,208 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <vector>
+
+#include <hdf5.h>
+
+#include <QtCore/QString>
+
+#include "H5Support/QH5Lite.h"
+
+#include "EbsdLib/EbsdLib.h"
+
+namespace EbsdLib
+{
+/**
+ * @brief Reads rectangular regions of the per scan point datasets of the vendor HDF5 files. Those
+ * datasets store the scan in row major order so scan point (x, y) is found at index y * numColumns + x
+ * of the first dimension of the dataset. Any further dimensions (the rows and columns of a pattern)
+ * are read in full.
+ */
+namespace H5ScanRegion
+{
+/**
+ * @brief Returns true if the region lies inside a scan of numColumns x numRows points.
+ */
+inline bool fitsInScan(int x0, int y0, int width, int height, size_t numColumns, size_t numRows)
+{
+  return x0 >= 0 && y0 >= 0 && width > 0 && height > 0 && static_cast<size_t>(x0) + static_cast<size_t>(width) <= numColumns &&
+         static_cast<size_t>(y0) + static_cast<size_t>(height) <= numRows;
+}
+
+/**
+ * @brief Creates the memory dataspace for reading 'numPoints' scan points. With a stride of 1 the
+ * values are packed, otherwise the value of scan point i is placed at index i * memStride of the
+ * destination. Strided destinations are only supported for datasets with a single value per scan point.
+ * @param pointDims The dimensions of the dataset with the first dimension set to the number of points read
+ * @return The dataspace or a negative value if the stride can not be used with the dataset
+ */
+inline hid_t createMemorySpace(const std::vector<hsize_t>& pointDims, size_t memStride)
+{
+  if(memStride <= 1)
+  {
+    return H5Screate_simple(static_cast<int>(pointDims.size()), pointDims.data(), nullptr);
+  }
+  hsize_t numPoints = pointDims[0];
+  for(size_t i = 1; i < pointDims.size(); i++)
+  {
+    if(pointDims[i] != 1)
+    {
+      return -1;
+    }
+  }
+  hsize_t memDims = (numPoints == 0) ? 1 : (numPoints - 1) * memStride + 1;
+  hid_t memSpaceId = H5Screate_simple(1, &memDims, nullptr);
+  hsize_t start = 0;
+  hsize_t stride = memStride;
+  hsize_t block = 1;
+  if(numPoints > 0 && H5Sselect_hyperslab(memSpaceId, H5S_SELECT_SET, &start, &stride, &numPoints, &block) < 0)
+  {
+    H5Sclose(memSpaceId);
+    return -1;
+  }
+  return memSpaceId;
+}
+
+/**
+ * @brief Reads the rows [y0, y0 + height) and columns [x0, x0 + width) of the scan with a single
+ * strided hyperslab selection so only the region is transferred from the file. The values are
+ * stored in row major order and converted to the type of the destination by HDF5.
+ * @param locId The HDF5 group holding the dataset
+ * @param datasetName The name of the dataset
+ * @param numColumns The number of columns of the complete scan
+ * @param x0 The first column of the region
+ * @param y0 The first row of the region
+ * @param width The number of columns in the region
+ * @param height The number of rows in the region
+ * @param data Output: Room for width * height points times the size of the other dimensions of the dataset
+ * @param memStride The number of elements between two consecutive points in 'data'
+ * @return Negative if the dataset could not be read or is too small for the region
+ */
+template <typename T>
+herr_t readDataset(hid_t locId, const QString& datasetName, size_t numColumns, int x0, int y0, int width, int height, T* data, size_t memStride = 1)
+{
+  hid_t datasetId = H5Dopen(locId, datasetName.toLatin1().data(), H5P_DEFAULT);
+  if(datasetId < 0)
+  {
+    return -1;
+  }
+  hid_t fileSpaceId = H5Dget_space(datasetId);
+  int rank = H5Sget_simple_extent_ndims(fileSpaceId);
+  if(rank < 1)
+  {
+    H5Sclose(fileSpaceId);
+    H5Dclose(datasetId);
+    return -1;
+  }
+  std::vector<hsize_t> dims(static_cast<size_t>(rank), 0);
+  H5Sget_simple_extent_dims(fileSpaceId, dims.data(), nullptr);
+
+  // The first dimension is the scan point, each selected block is one row of the region
+  std::vector<hsize_t> start(dims.size(), 0);
+  std::vector<hsize_t> stride(dims.size(), 1);
+  std::vector<hsize_t> count(dims.size(), 1);
+  std::vector<hsize_t> block(dims);
+  start[0] = static_cast<hsize_t>(y0) * numColumns + static_cast<hsize_t>(x0);
+  stride[0] = static_cast<hsize_t>(numColumns);
+  count[0] = static_cast<hsize_t>(height);
+  block[0] = static_cast<hsize_t>(width);
+
+  herr_t err = -1;
+  if(start[0] + (count[0] - 1) * stride[0] + block[0] <= dims[0])
+  {
+    err = H5Sselect_hyperslab(fileSpaceId, H5S_SELECT_SET, start.data(), stride.data(), count.data(), block.data());
+  }
+  if(err >= 0)
+  {
+    std::vector<hsize_t> memDims(block);
+    memDims[0] = count[0] * block[0];
+    hid_t memSpaceId = createMemorySpace(memDims, memStride);
+    err = -1;
+    if(memSpaceId >= 0)
+    {
+      T value = 0x0;
+      hid_t memTypeId = QH5Lite::HDFTypeForPrimitive(value);
+      err = H5Dread(datasetId, memTypeId, memSpaceId, fileSpaceId, H5P_DEFAULT, data);
+      H5Sclose(memSpaceId);
+    }
+  }
+  H5Sclose(fileSpaceId);
+  H5Dclose(datasetId);
+  return err;
+}
+
+/**
+ * @brief Reads every scan point of the dataset into a destination that holds at most 'numPoints'
+ * points. Unlike QH5Lite::readPointerDataset() the size of the dataset is checked against the
+ * destination first, which matters when the destination is memory provided by the caller.
+ * @param locId The HDF5 group holding the dataset
+ * @param datasetName The name of the dataset
+ * @param numPoints The number of scan points that 'data' can hold
+ * @param data Output: The values of the dataset
+ * @param memStride The number of elements between two consecutive points in 'data'
+ * @return Negative if the dataset could not be read or does not fit into the destination
+ */
+template <typename T>
+herr_t readAllPoints(hid_t locId, const QString& datasetName, size_t numPoints, T* data, size_t memStride = 1)
+{
+  hid_t datasetId = H5Dopen(locId, datasetName.toLatin1().data(), H5P_DEFAULT);
+  if(datasetId < 0)
+  {
+    return -1;
+  }
+  hid_t fileSpaceId = H5Dget_space(datasetId);
+  int rank = H5Sget_simple_extent_ndims(fileSpaceId);
+  herr_t err = -1;
+  if(rank >= 1)
+  {
+    std::vector<hsize_t> dims(static_cast<size_t>(rank), 0);
+    H5Sget_simple_extent_dims(fileSpaceId, dims.data(), nullptr);
+    hid_t memSpaceId = (dims[0] <= numPoints) ? createMemorySpace(dims, memStride) : -1;
+    if(memSpaceId >= 0)
+    {
+      T value = 0x0;
+      hid_t memTypeId = QH5Lite::HDFTypeForPrimitive(value);
+      err = H5Dread(datasetId, memTypeId, memSpaceId, H5S_ALL, H5P_DEFAULT, data);
+      H5Sclose(memSpaceId);
+    }
+  }
+  H5Sclose(fileSpaceId);
+  H5Dclose(datasetId);
+  return err;
+}
+} // namespace H5ScanRegion
+} // namespace EbsdLib
@@ -39,11 +39,214 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
 
 #include "CtfPhase.h"
 #include "EbsdLib/Core/EbsdMacros.h"
+#include "EbsdLib/IO/EbsdTextWriter.h"
+#include "EbsdLib/IO/EbsdTokenParser.hpp"
 #include "EbsdLib/Math/EbsdLibMath.h"
 
+namespace TokenParser = EbsdLib::TokenParser;
+
+namespace
+{
+/* Chunks of the data section smaller than this are not worth handing to another thread */
+const size_t k_MinimumChunkBytes = 64 * 1024;
+const size_t k_NoError = std::numeric_limits<size_t>::max();
+
+/**
+ * @brief A line aligned byte range of the data section of a .ctf file along with the
+ * bookkeeping needed to place its rows into the column arrays.
+ */
+struct CtfDataChunk
+{
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  size_t startLine = 0;
+  size_t numLines = 0;
+  size_t parsedLines = 0;
+  size_t errorLine = k_NoError;
+  int errorTokenCount = 0;
+};
+
+// -----------------------------------------------------------------------------
+QString columnCountErrorMessage(int numTokens, int numColumns, size_t row)
+{
+  QString msg;
+  QTextStream ss(&msg);
+  ss << "The number of tab delimited data columns (" << numTokens << ") does not match the number of tab delimited header columns (";
+  ss << numColumns << "). Please check the CTF file for mistakes.";
+  ss << "The error occurred at data row " << row << " which is " << row << " past ";
+  ss << "the column header row.";
+  ss << "\nThe CTF Reader will now abort reading any further in the file.";
+  return msg;
+}
+
+// -----------------------------------------------------------------------------
+// Splits [begin, end) into ranges that always start at the beginning of a line
+// -----------------------------------------------------------------------------
+std::vector<CtfDataChunk> createDataChunks(const char* begin, const char* end)
+{
+  const size_t numBytes = static_cast<size_t>(end - begin);
+  size_t numChunks = 1;
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  size_t numThreads = std::max(1U, std::thread::hardware_concurrency());
+  numChunks = std::max(static_cast<size_t>(1), std::min(numThreads * 4, numBytes / k_MinimumChunkBytes));
+#endif
+
+  std::vector<CtfDataChunk> chunks;
+  chunks.reserve(numChunks);
+  const char* chunkBegin = begin;
+  for(size_t i = 1; i <= numChunks && chunkBegin < end; i++)
+  {
+    const char* chunkEnd = (i == numChunks) ? end : begin + (numBytes * i) / numChunks;
+    chunkEnd = std::max(chunkEnd, chunkBegin);
+    if(chunkEnd < end && (chunkEnd == begin || *(chunkEnd - 1) != '\n'))
+    {
+      const char* eol = static_cast<const char*>(::memchr(chunkEnd, '\n', static_cast<size_t>(end - chunkEnd)));
+      chunkEnd = (nullptr == eol) ? end : eol + 1;
+    }
+    CtfDataChunk chunk;
+    chunk.begin = chunkBegin;
+    chunk.end = chunkEnd;
+    chunks.push_back(chunk);
+    chunkBegin = chunkEnd;
+  }
+  return chunks;
+}
+
+/**
+ * @brief Counts the lines in each chunk. A final line without a newline is also counted.
+ */
+class CountCtfLinesImpl
+{
+  std::vector<CtfDataChunk>* m_Chunks;
+  const char* m_FileEnd;
+
+public:
+  CountCtfLinesImpl(std::vector<CtfDataChunk>* chunks, const char* fileEnd)
+  : m_Chunks(chunks)
+  , m_FileEnd(fileEnd)
+  {
+  }
+
+  void generate(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      CtfDataChunk& chunk = (*m_Chunks)[i];
+      chunk.numLines = static_cast<size_t>(std::count(chunk.begin, chunk.end, '\n'));
+      if(chunk.end == m_FileEnd && chunk.end > chunk.begin && *(chunk.end - 1) != '\n')
+      {
+        chunk.numLines++;
+      }
+    }
+  }
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    generate(r.begin(), r.end());
+  }
+#endif
+};
+
+/**
+ * @brief Parses the lines of each chunk that fall in [firstLine, lastLine). The row index of
+ * each line is known from the line counts so every chunk writes into its own part of the column
+ * arrays and no locking is needed. The behavior for each line matches CtfReader::parseDataLine().
+ */
+class ParseCtfLinesImpl
+{
+  std::vector<CtfDataChunk>* m_Chunks;
+  QVector<DataParser::Pointer> m_Parsers;
+  int m_NumColumns;
+  size_t m_FirstLine;
+  size_t m_LastLine;
+  size_t m_TotalLines;
+
+public:
+  ParseCtfLinesImpl(std::vector<CtfDataChunk>* chunks, QVector<DataParser::Pointer> parsers, int numColumns, size_t firstLine, size_t lastLine, size_t totalLines)
+  : m_Chunks(chunks)
+  , m_Parsers(std::move(parsers))
+  , m_NumColumns(numColumns)
+  , m_FirstLine(firstLine)
+  , m_LastLine(lastLine)
+  , m_TotalLines(totalLines)
+  {
+  }
+
+  void generate(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      parseChunk((*m_Chunks)[i]);
+    }
+  }
+
+  void parseChunk(CtfDataChunk& chunk) const
+  {
+    if(chunk.startLine + chunk.numLines <= m_FirstLine || chunk.startLine >= m_LastLine)
+    {
+      return;
+    }
+    const int numColumns = m_NumColumns;
+    std::vector<TokenParser::Token> tokens(static_cast<size_t>(numColumns));
+    size_t lineIndex = chunk.startLine;
+    const char* cursor = chunk.begin;
+    while(cursor < chunk.end && lineIndex < m_LastLine)
+    {
+      const char* eol = TokenParser::findLineEnd(cursor, chunk.end);
+      if(lineIndex >= m_FirstLine)
+      {
+        const char* first = cursor;
+        const char* last = eol;
+        TokenParser::trim(first, last);
+        // An empty last line marks the end of the file
+        if(first == last && lineIndex == m_TotalLines - 1)
+        {
+          break;
+        }
+        // European comma style decimals are handled by the parsers themselves
+        int numTokens = TokenParser::split(first, last, '\t', tokens.data(), numColumns);
+        if(numTokens != numColumns)
+        {
+          chunk.errorLine = lineIndex;
+          chunk.errorTokenCount = numTokens;
+          break;
+        }
+        // Only the requested columns have a parser, the other tokens are never converted
+        for(const auto& dparser : m_Parsers)
+        {
+          const TokenParser::Token& token = tokens[static_cast<size_t>(dparser->getColumnIndex())];
+          dparser->parse(token.first, token.last, lineIndex - m_FirstLine);
+        }
+        chunk.parsedLines++;
+      }
+      cursor = (eol < chunk.end) ? eol + 1 : chunk.end;
+      ++lineIndex;
+    }
+  }
+
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    generate(r.begin(), r.end());
+  }
+#endif
+};
+} // namespace
+
 //#define PI_OVER_2f       90.0f
 //#define THREE_PI_OVER_2f 270.0f
 //#define TWO_PIf          360.0f
@@ -54,6 +257,7 @@
 // -----------------------------------------------------------------------------
 CtfReader::CtfReader() :
   EbsdReader(),
+  m_UseSidecarIndex(false),
   m_SingleSliceRead(-1)
 {
 
@@ -353,16 +557,26 @@ DataParser::Pointer CtfReader::getParser(const QString& featureName, void* ptr,
 int CtfReader::readHeaderOnly()
 {
   int err = 1;
+  EbsdFileStamp stamp = EbsdFileStamp::Create(getFileName());
+  if(stamp.isValid() && stamp == m_HeaderStamp)
+  {
+    // The header of this file was already parsed and the file has not changed since then
+    return m_HeaderStampResult;
+  }
+  m_HeaderStamp = EbsdFileStamp();
+
   QByteArray buf;
-  QFile in(getFileName());
   setHeaderIsComplete(false);
-  if (!in.open(QIODevice::ReadOnly | QIODevice::Text))
+  QString openError;
+  std::unique_ptr<QIODevice> device = EbsdCompressedFileDevice::OpenForReading(getFileName(), QIODevice::ReadOnly | QIODevice::Text, openError);
+  if(nullptr == device)
   {
-    QString msg = QString("Ctf file could not be opened: ") + getFileName();
+    QString msg = QString("Ctf file could not be opened: ") + getFileName() + "\n" + openError;
     setErrorCode(-100);
     setErrorMessage(msg);
     return -100;
   }
+  QIODevice& in = *device;
 
   QString origHeader;
   setOriginalHeader(origHeader);
@@ -372,6 +586,11 @@ int CtfReader::readHeaderOnly()
   QList<QByteArray> headerLines;
   err = getHeaderLines(in, headerLines);
   err = parseHeaderLines(headerLines);
+  if(err >= 0)
+  {
+    m_HeaderStamp = stamp;
+    m_HeaderStampResult = err;
+  }
   return err;
 }
 
@@ -384,22 +603,38 @@ int CtfReader::readFile()
   setErrorCode(0);
   setErrorMessage("");
   QByteArray buf;
-  QFile in(getFileName());
   setHeaderIsComplete(false);
-  if (!in.open(QIODevice::ReadOnly | QIODevice::Text))
+  m_HeaderStamp = EbsdFileStamp();
+  QString openError;
+  std::unique_ptr<QIODevice> device = EbsdCompressedFileDevice::OpenForReading(getFileName(), QIODevice::ReadOnly | QIODevice::Text, openError);
+  if(nullptr == device)
   {
-    QString msg = QString("Ctf file could not be opened: ") + getFileName();
+    QString msg = QString("Ctf file could not be opened: ") + getFileName() + "\n" + openError;
     setErrorCode(-100);
     setErrorMessage(msg);
     return -100;
   }
+  QIODevice& in = *device;
+  err = readHeaderSection(in);
+  if (err < 0) { return err;}
+
+  err = readData(in);
+
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int CtfReader::readHeaderSection(QIODevice& in)
+{
   QString origHeader;
   setOriginalHeader(origHeader);
   m_PhaseVector.clear();
 
   // Parse the header
   QList<QByteArray> headerLines;
-  err = getHeaderLines(in, headerLines);
+  int err = getHeaderLines(in, headerLines);
   if (err < 0) { return err;}
   err = parseHeaderLines(headerLines);
   if (err < 0) { return err;}
@@ -416,10 +651,164 @@ int CtfReader::readFile()
     setErrorMessage("Either the X Cells or Y Cells was Zero (0) which is NOT allowed. Please update the CTF file header with appropriate values.");
     return -103;
   }
+  return 0;
+}
 
-  err = readData(in);
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int CtfReader::readFileInBatches(size_t batchSize, const EbsdRowBatchCallback& callback)
+{
+  setErrorCode(0);
+  setErrorMessage("");
+  setHeaderIsComplete(false);
+  m_HeaderStamp = EbsdFileStamp();
 
-  return err;
+  if(batchSize == 0 || !callback)
+  {
+    setErrorCode(-120);
+    setErrorMessage("The batch size must be larger than zero and a callback must be set to read the file in batches.");
+    return -120;
+  }
+
+  QString openError;
+  std::unique_ptr<QIODevice> device = EbsdCompressedFileDevice::OpenForReading(getFileName(), QIODevice::ReadOnly | QIODevice::Text, openError);
+  if(nullptr == device)
+  {
+    QString msg = QString("Ctf file could not be opened: ") + getFileName() + "\n" + openError;
+    setErrorCode(-100);
+    setErrorMessage(msg);
+    return -100;
+  }
+  QIODevice& in = *device;
+
+  int err = readHeaderSection(in);
+  if (err < 0) { return err;}
+
+  if(getXCells() < 0 || getYCells() < 0)
+  {
+    setErrorCode(-110);
+    setErrorMessage("The number of X Cells or Y Cells was reported as a negative value. Please update the CTF file header with appropriate values.");
+    return -110;
+  }
+  size_t xCells = static_cast<size_t>(getXCells());
+  size_t yCells = static_cast<size_t>(getYCells());
+  int32_t zCells = getZCells();
+  if(zCells < 0 || m_SingleSliceRead >= 0)
+  {
+    zCells = 1;
+  }
+  size_t totalScanPoints = xCells * yCells * static_cast<size_t>(zCells);
+  size_t skipLines = (m_SingleSliceRead >= 0) ? static_cast<size_t>(m_SingleSliceRead) * xCells * yCells : 0;
+  setNumberOfElements(totalScanPoints);
+
+  // The parsers only ever hold a single batch and are reused for every batch
+  m_NamePointerMap.clear();
+  size_t batchCapacity = std::max(static_cast<size_t>(1), std::min(batchSize, totalScanPoints));
+  err = initParsers(in, batchCapacity, false);
+  if(err < 0)
+  {
+    m_NamePointerMap.clear();
+    return err;
+  }
+
+  EbsdRowBatch batch;
+  for(const auto& dparser : m_NamePointerMap)
+  {
+    batch.addColumn(dparser->getColumnName(), getPointerType(dparser->getColumnName()), dparser->getVoidPointer());
+  }
+
+  QByteArray buf;
+  size_t lineIndex = 0;
+  size_t counter = 0;
+  size_t batchStart = 0;
+  size_t batchPoints = 0;
+  bool stopped = false;
+  while(counter < totalScanPoints && !in.atEnd())
+  {
+    buf = in.readLine(); // Read the line into a QByteArray including the newline
+    buf = buf.trimmed(); // Remove leading and trailing whitespace
+    if(lineIndex++ < skipLines)
+    {
+      continue;
+    }
+    if(in.atEnd() && buf.isEmpty())
+    {
+      break;
+    }
+    err = parseDataLine(buf, (counter / xCells) % yCells, counter % xCells, batchPoints, xCells, yCells);
+    if(err < 0)
+    {
+      break;
+    }
+    ++counter;
+    ++batchPoints;
+    if(batchPoints == batchCapacity)
+    {
+      batch.setStartIndex(batchStart);
+      batch.setNumberOfPoints(batchPoints);
+      if(!callback(batch))
+      {
+        stopped = true;
+        batchPoints = 0;
+        break;
+      }
+      batchStart += batchPoints;
+      batchPoints = 0;
+    }
+  }
+
+  // Hand over whatever is left, even if the file ended early
+  if(err >= 0 && batchPoints > 0)
+  {
+    batch.setStartIndex(batchStart);
+    batch.setNumberOfPoints(batchPoints);
+    callback(batch);
+  }
+  m_NamePointerMap.clear();
+
+  if(err < 0)
+  {
+    return err;
+  }
+  if(!stopped && counter != totalScanPoints && in.atEnd())
+  {
+    QString msg;
+    QTextStream ss(&msg);
+    ss << "Premature End Of File reached.\n" << getFileName() << "\nNumRows=" << getNumberOfElements() << "\ncounter=" << counter
+       << "\nTotal Data Points Read=" << counter << "\n";
+    setErrorMessage(msg);
+    setErrorCode(-105);
+    return -105;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CtfReader::setArraysToRead(const QSet<QString>& names)
+{
+  m_ArrayNames = names;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CtfReader::readAllArrays(bool b)
+{
+  m_ReadAllArrays = b;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CtfReader::setRegionOfInterest(int x0, int y0, int width, int height)
+{
+  m_RoiX0 = x0;
+  m_RoiY0 = y0;
+  m_RoiWidth = width;
+  m_RoiHeight = height;
 }
 
 // -----------------------------------------------------------------------------
@@ -433,7 +822,7 @@ void CtfReader::readOnlySliceIndex(int slice)
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-int CtfReader::readData(QFile& in)
+int CtfReader::readData(QIODevice& in)
 {
   QString sBuf;
   QTextStream ss(&sBuf);
@@ -470,13 +859,146 @@ int CtfReader::readData(QFile& in)
     zCells = 1;
   }
   size_t totalScanPoints = static_cast<size_t>(yCells * xCells * zCells);
+  // Compressed files are decompressed as a stream so they can not be memory mapped
+  QFile* file = qobject_cast<QFile*>(&in);
+  bool readRegion = (m_RoiWidth > 0 && m_RoiHeight > 0);
+  if(readRegion && nullptr == file)
+  {
+    setErrorCode(-132);
+    setErrorMessage("Region of interest reads are not supported for compressed Ctf files.");
+    return -132;
+  }
+  if(readRegion)
+  {
+    if(m_RoiX0 < 0 || m_RoiY0 < 0 || m_RoiX0 + m_RoiWidth > xCells || m_RoiY0 + m_RoiHeight > yCells)
+    {
+      QString msg;
+      QTextStream ss(&msg);
+      ss << "The region of interest X=" << m_RoiX0 << " Y=" << m_RoiY0 << " Width=" << m_RoiWidth << " Height=" << m_RoiHeight << " does not fit inside the scan of " << xCells << " x " << yCells
+         << " points.";
+      setErrorCode(-131);
+      setErrorMessage(msg);
+      return -131;
+    }
+    totalScanPoints = static_cast<size_t>(m_RoiWidth) * static_cast<size_t>(m_RoiHeight);
+  }
 
   setNumberOfElements(totalScanPoints);
 
+  qint64 headerLength = in.pos();
+  int err = initParsers(in, totalScanPoints, true);
+  if(err < 0)
+  {
+    return err;
+  }
+
+  if(readRegion)
+  {
+    uchar* mapped = (file->size() > 0) ? file->map(0, file->size()) : nullptr;
+    if(nullptr == mapped)
+    {
+      QString msg = QString("Ctf file could not be memory mapped for the region of interest read: ") + getFileName();
+      setErrorCode(-101);
+      setErrorMessage(msg);
+      return -101;
+    }
+    const char* fileBegin = reinterpret_cast<const char*>(mapped);
+    size_t skipLines = (m_SingleSliceRead >= 0) ? static_cast<size_t>(m_SingleSliceRead) * xCells * yCells : 0;
+    err = readMappedRegion(fileBegin, fileBegin + file->size(), headerLength, file->pos(), skipLines);
+    file->unmap(mapped);
+    return err;
+  }
+
+  // Map the file so the data section can be split into chunks and parsed in parallel. If the
+  // file can not be mapped we fall back to reading the data line by line.
+  qint64 dataOffset = in.pos();
+  if(nullptr != file && file->size() > dataOffset)
+  {
+    uchar* mapped = file->map(0, file->size());
+    if(nullptr != mapped)
+    {
+      const char* fileBegin = reinterpret_cast<const char*>(mapped);
+      size_t skipLines = (m_SingleSliceRead >= 0) ? static_cast<size_t>(m_SingleSliceRead) * xCells * yCells : 0;
+      err = readMappedData(fileBegin + dataOffset, fileBegin + file->size(), skipLines);
+      file->unmap(mapped);
+      return err;
+    }
+  }
+
+  // Now start reading the data line by line
   QByteArray buf;
+  size_t counter = 0;
+  for (int slice = zStart; slice < zEnd; ++slice)
+  {
+    for (size_t row = 0; row < yCells; ++row)
+    {
+      for (size_t col = 0; col < xCells; ++col)
+      {
+        buf = in.readLine(); // Read the line into a QByteArray including the newline
+        buf = buf.trimmed(); // Remove leading and trailing whitespace
+
+        if ( (m_SingleSliceRead < 0) || (m_SingleSliceRead >= 0 && slice == m_SingleSliceRead) )
+        {
+
+          if(in.atEnd() && buf.isEmpty()) // We have to have read to the end of the file AND the buffer is empty
+                                          // otherwise we read EXACTLY the last line and we still need to parse the line.
+          {
+            //  ++counter; // We need to make sure this gets incremented before leaving
+            break;
+          }
+          err = parseDataLine(buf, row, col, counter, xCells, yCells);
+          if (err < 0) { return err; }
+          ++counter;
+        }
+
+      }
+      if(in.atEnd())
+      {
+        break;
+      }
+    }
+    //   std::cout << ".ctf Z Slice " << slice << " Reading complete." << std::endl;
+    if(m_SingleSliceRead >= 0 && slice == m_SingleSliceRead)
+    {
+      break;
+    }
+  }
+
+  if(counter != getNumberOfElements() && in.atEnd())
+  {
+    sBuf.clear();
+    ss << "Premature End Of File reached.\n" << getFileName() << "\nNumRows=" << getNumberOfElements() << "\ncounter=" << counter
+       << "\nTotal Data Points Read=" << counter << "\n";
+    setErrorMessage(sBuf);
+    setErrorCode(-105);
+    return -105;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int CtfReader::initParsers(QIODevice& in, size_t numElements, bool useDestinationBuffers)
+{
+  QString sBuf;
+  QTextStream ss(&sBuf);
+
+  m_NamePointerMap.clear();
+  m_NumColumns = 0;
+  if(m_ArrayNames.empty() && !m_ReadAllArrays)
+  {
+    setErrorCode(-121);
+    setErrorMessage("CtfReader Error: ReadAllArrays was FALSE and no other arrays were requested to be read.");
+    return -121;
+  }
+  if(useDestinationBuffers && checkDestinationBuffers(numElements) < 0)
+  {
+    return getErrorCode();
+  }
 
   // Read the column Headers and allocate the necessary arrays
-  buf = in.readLine();
+  QByteArray buf = in.readLine();
   QString originalHeader = getOriginalHeader();
   originalHeader = originalHeader + buf;
   setOriginalHeader(originalHeader);
@@ -486,30 +1008,57 @@ int CtfReader::readData(QFile& in)
 
   EbsdLib::NumericTypes::Type pType = EbsdLib::NumericTypes::Type::UnknownNumType;
   qint32 size = tokens.size();
+  m_NumColumns = size;
+  // Every data line is split into this buffer so it is only allocated once per file
+  m_LineTokens.resize(static_cast<size_t>(size));
   bool didAllocate = false;
   for (qint32 i = 0; i < size; ++i)
   {
     QString name = QString::fromLatin1(tokens[i]);
     pType = getPointerType(name);
+    bool requested = m_ReadAllArrays || m_ArrayNames.contains(name);
+    if(!requested && EbsdLib::NumericTypes::Type::UnknownNumType != pType)
+    {
+      // Columns that were not requested get no parser so they are never allocated or converted
+      continue;
+    }
+    // The caller owns the memory of a destination buffer so the parser writes into it without allocating or freeing it
+    DestinationBuffer buffer = useDestinationBuffers ? getDestinationBuffer(name) : DestinationBuffer();
+    DataParser::Pointer borrowed = DataParser::NullPointer();
+    if(nullptr != buffer.data && EbsdLib::NumericTypes::Type::Int32 == pType)
+    {
+      borrowed = Int32Parser::New(static_cast<int32_t*>(buffer.data), numElements, name, i);
+    }
+    else if(nullptr != buffer.data && EbsdLib::NumericTypes::Type::Float == pType)
+    {
+      borrowed = FloatParser::New(static_cast<float*>(buffer.data), numElements, name, i);
+    }
+    if(nullptr != borrowed.get())
+    {
+      borrowed->setManageMemory(false);
+      borrowed->setStride(buffer.stride);
+      m_NamePointerMap.insert(name, borrowed);
+      continue;
+    }
     if(EbsdLib::NumericTypes::Type::Int32 == pType)
     {
-      Int32Parser::Pointer dparser = Int32Parser::New(nullptr, totalScanPoints, name, i);
-      didAllocate = dparser->allocateArray(totalScanPoints);
+      Int32Parser::Pointer dparser = Int32Parser::New(nullptr, numElements, name, i);
+      didAllocate = dparser->allocateArray(numElements);
       //Q_ASSERT_X(dparser->getVoidPointer() != nullptr, __FILE__, "Could not allocate memory for Integer data in CTF File.");
       if(didAllocate)
       {
-        ::memset(dparser->getVoidPointer(), 0xAB, sizeof(int32_t) * totalScanPoints);
+        ::memset(dparser->getVoidPointer(), 0xAB, sizeof(int32_t) * numElements);
         m_NamePointerMap.insert(name, dparser);
       }
     }
     else if(EbsdLib::NumericTypes::Type::Float == pType)
     {
-      FloatParser::Pointer dparser = FloatParser::New(nullptr, totalScanPoints, name, i);
-      didAllocate = dparser->allocateArray(totalScanPoints);
+      FloatParser::Pointer dparser = FloatParser::New(nullptr, numElements, name, i);
+      didAllocate = dparser->allocateArray(numElements);
       //Q_ASSERT_X(dparser->getVoidPointer() != nullptr, __FILE__, "Could not allocate memory for Integer data in CTF File.");
       if(didAllocate)
       {
-        ::memset(dparser->getVoidPointer(), 0xAB, sizeof(float) * totalScanPoints);
+        ::memset(dparser->getVoidPointer(), 0xAB, sizeof(float) * numElements);
         m_NamePointerMap.insert(name, dparser);
       }
     }
@@ -530,58 +1079,139 @@ int CtfReader::readData(QFile& in)
       ss << "\n X Cells: " << getXCells();
       ss << "\n Y Cells: " << getYCells();
       ss << "\n Z Cells: " << getZCells();
-      ss << "\n Total Scan Points: " << totalScanPoints;
+      ss << "\n Total Scan Points: " << numElements;
       setErrorMessage(msg);
       return -106; // Could not allocate the memory
     }
 
   }
+  return 0;
+}
 
-  // Now start reading the data line by line
-  int err = 0;
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int CtfReader::readMappedData(const char* begin, const char* end, size_t skipLines)
+{
+  size_t totalScanPoints = getNumberOfElements();
+  std::vector<CtfDataChunk> chunks = createDataChunks(begin, end);
+
+  // Count the lines in each chunk so that every chunk knows the row index of its first line
+  CountCtfLinesImpl countLines(&chunks, end);
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  bool doParallel = true;
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size()), countLines, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    countLines.generate(0, chunks.size());
+  }
+
+  size_t totalLines = 0;
+  for(auto& chunk : chunks)
+  {
+    chunk.startLine = totalLines;
+    totalLines += chunk.numLines;
+  }
+
+  ParseCtfLinesImpl parseLines(&chunks, m_NamePointerMap.values().toVector(), m_NumColumns, skipLines, skipLines + totalScanPoints, totalLines);
+#ifdef EbsdLib_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size()), parseLines, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    parseLines.generate(0, chunks.size());
+  }
+
+  // Report the first error in file order, just like the line by line parser would
+  size_t xCells = static_cast<size_t>(getXCells());
+  size_t yCells = static_cast<size_t>(getYCells());
   size_t counter = 0;
-  for (int slice = zStart; slice < zEnd; ++slice)
+  for(const auto& chunk : chunks)
   {
-    for (size_t row = 0; row < yCells; ++row)
+    if(chunk.errorLine != k_NoError)
     {
-      for (size_t col = 0; col < xCells; ++col)
-      {
-        buf = in.readLine(); // Read the line into a QByteArray including the newline
-        buf = buf.trimmed(); // Remove leading and trailing whitespace
-
-        if ( (m_SingleSliceRead < 0) || (m_SingleSliceRead >= 0 && slice == m_SingleSliceRead) )
-        {
+      size_t row = (chunk.errorLine / xCells) % yCells;
+      setErrorCode(-107);
+      setErrorMessage(columnCountErrorMessage(chunk.errorTokenCount, m_NumColumns, row));
+      return -106;
+    }
+    counter += chunk.parsedLines;
+  }
 
-          if(in.atEnd() && buf.isEmpty()) // We have to have read to the end of the file AND the buffer is empty
-                                          // otherwise we read EXACTLY the last line and we still need to parse the line.
-          {
-            //  ++counter; // We need to make sure this gets incremented before leaving
-            break;
-          }
-          err = parseDataLine(buf, row, col, counter, xCells, yCells);
-          if (err < 0) { return err; }
-          ++counter;
-        }
+  if(counter != totalScanPoints)
+  {
+    QString msg;
+    QTextStream ss(&msg);
+    ss << "Premature End Of File reached.\n" << getFileName() << "\nNumRows=" << getNumberOfElements() << "\ncounter=" << counter << "\nTotal Data Points Read=" << counter << "\n";
+    setErrorMessage(msg);
+    setErrorCode(-105);
+    return -105;
+  }
+  return 0;
+}
 
-      }
-      if(in.atEnd())
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int CtfReader::readMappedRegion(const char* begin, const char* end, qint64 headerLength, qint64 dataStart, size_t skipLines)
+{
+  // The index holds the offset of the first line of every row of the scan
+  size_t xCells = static_cast<size_t>(getXCells());
+  size_t yCells = static_cast<size_t>(getYCells());
+  if(!m_RowIndex.isValidFor(getFileName()) || m_RowIndex.getDataStartOffset() != dataStart || m_RowIndex.getLineStride() != xCells)
+  {
+    bool loaded = m_UseSidecarIndex && m_RowIndex.readSidecarFile(getFileName(), skipLines + xCells * yCells) && m_RowIndex.getDataStartOffset() == dataStart && m_RowIndex.getLineStride() == xCells;
+    if(!loaded)
+    {
+      m_RowIndex.build(getFileName(), begin, end, headerLength, dataStart, xCells);
+      if(m_UseSidecarIndex)
       {
-        break;
+        m_RowIndex.writeSidecarFile();
       }
     }
-    //   std::cout << ".ctf Z Slice " << slice << " Reading complete." << std::endl;
-    if(m_SingleSliceRead >= 0 && slice == m_SingleSliceRead)
+  }
+
+  size_t counter = 0;
+  for(int y = 0; y < m_RoiHeight; y++)
+  {
+    size_t row = static_cast<size_t>(m_RoiY0 + y);
+    size_t linesToSkip = 0;
+    qint64 offset = m_RowIndex.getLineOffset(skipLines + row * xCells + static_cast<size_t>(m_RoiX0), linesToSkip);
+    const char* cursor = (offset < 0 || offset > end - begin) ? end : begin + offset;
+    for(size_t i = 0; i < linesToSkip && cursor < end; i++)
     {
-      break;
+      const char* lineEnd = TokenParser::findLineEnd(cursor, end);
+      cursor = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+    for(int x = 0; x < m_RoiWidth && cursor < end; x++)
+    {
+      const char* first = cursor;
+      const char* last = TokenParser::findLineEnd(cursor, end);
+      cursor = (last < end) ? last + 1 : end;
+      TokenParser::trim(first, last);
+      QByteArray line = QByteArray::fromRawData(first, static_cast<int>(last - first));
+      int err = parseDataLine(line, row, static_cast<size_t>(m_RoiX0 + x), counter, xCells, yCells);
+      if(err < 0)
+      {
+        return err;
+      }
+      ++counter;
     }
   }
 
-  if(counter != getNumberOfElements() && in.atEnd())
+  if(counter != getNumberOfElements())
   {
-    sBuf.clear();
-    ss << "Premature End Of File reached.\n" << getFileName() << "\nNumRows=" << getNumberOfElements() << "\ncounter=" << counter
-       << "\nTotal Data Points Read=" << counter << "\n";
-    setErrorMessage(sBuf);
+    QString msg;
+    QTextStream ss(&msg);
+    ss << "Premature End Of File reached.\n" << getFileName() << "\nRegion Data Points=" << getNumberOfElements() << "\nTotal Data Points Read=" << counter << "\n";
+    setErrorMessage(msg);
     setErrorCode(-105);
     return -105;
   }
@@ -720,30 +1350,13 @@ int CtfReader::parseDataLine(QByteArray& line, size_t row, size_t col, size_t of
   //  int phase, bCount, error, bc, bs;
   //  size_t offset = i;
 
-  // Filter the line to convert European command style decimals to US/UK style points
-  //  QVector<char> cLine(line.size()+1);
-  //  ::memcpy( &(cLine.front()), line.c_str(), line.size() + 1);
-  for (int c = 0; c < line.size(); ++c)
-  {
-    if(line.at(c) == ',')
-    {
-      line[c] = '.';
-    }
-  }
-
-  QList<QByteArray> tokens = line.split('\t');
-  if(tokens.size() != m_NamePointerMap.size())
+  // European comma style decimals are handled by the parsers so the line is split in place
+  const int numColumns = m_NumColumns;
+  int numTokens = TokenParser::split(line.constData(), line.constData() + line.size(), '\t', m_LineTokens.data(), numColumns);
+  if(numTokens != numColumns)
   {
     setErrorCode(-107);
-    QString msg;
-    QTextStream ss(&msg);
-    ss << "The number of tab delimited data columns (" << tokens.size() << ") does not match the number of tab delimited header columns (";
-    ss << m_NamePointerMap.size() << "). Please check the CTF file for mistakes.";
-    ss << "The error occurred at data row " << row << " which is " << row << " past ";
-    ss << "the column header row.";
-    ss << "\nThe CTF Reader will now abort reading any further in the file.";
-
-    setErrorMessage(msg);
+    setErrorMessage(columnCountErrorMessage(numTokens, numColumns, row));
     return -106; // Could not allocate the memory
   }
   QMapIterator<QString, DataParser::Pointer> iter(m_NamePointerMap);
@@ -752,7 +1365,8 @@ int CtfReader::parseDataLine(QByteArray& line, size_t row, size_t col, size_t of
     iter.next();
 
     DataParser::Pointer dparser = iter.value();
-    dparser->parse(tokens[dparser->getColumnIndex()], offset);
+    const TokenParser::Token& token = m_LineTokens[static_cast<size_t>(dparser->getColumnIndex())];
+    dparser->parse(token.first, token.last, offset);
   }
   return 0;
 }
@@ -786,7 +1400,7 @@ QVector<QString> CtfReader::tokenize(char* buf, char delimiter)
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-int CtfReader::getHeaderLines(QFile& reader, QList<QByteArray>& headerLines)
+int CtfReader::getHeaderLines(QIODevice& reader, QList<QByteArray>& headerLines)
 {
   int err = 0;
   QByteArray buf;
@@ -933,8 +1547,6 @@ void CtfReader::printHeader(std::ostream& out)
 // -----------------------------------------------------------------------------
 int CtfReader::writeFile(const QString& filepath)
 {
-  int error = 0;
-
   FILE* f = fopen(filepath.toLatin1().data(), "wb");
   if(nullptr == f)
   {
@@ -942,88 +1554,47 @@ int CtfReader::writeFile(const QString& filepath)
   }
 
   QByteArray header = getOriginalHeader().toLatin1();
-  fwrite(header.data(), 1, header.count(), f);
-  int zStart = 0;
-  int zEnd = getZCells();
-  int yCells = getYCells();
-  int xCells = getXCells();
-
-  QList<QString> colNames = getColumnNames();
-
-  using ColInfoType = struct
+  // After a region of interest read only the region of a single slice is written so the header has to describe it
+  if(m_RoiWidth > 0 && m_RoiHeight > 0)
   {
-    QString colName;
-    void* ptr;
-    int aType;
-  };
+    header = replaceHeaderValue(header, EbsdLib::Ctf::XCells, m_RoiWidth);
+    header = replaceHeaderValue(header, EbsdLib::Ctf::YCells, m_RoiHeight);
+    header = replaceHeaderValue(header, EbsdLib::Ctf::ZCells, 1);
+  }
+  fwrite(header.data(), 1, header.count(), f);
 
-  std::vector<ColInfoType> colInfos(colNames.count());
+  // The last line of the header holds the column names in file order. Columns that were not read
+  // (See setArraysToRead()) are written as zeros so the file keeps the layout of its header.
+  QList<QByteArray> lines = header.trimmed().split('\n');
+  QList<QByteArray> columnNames = lines.isEmpty() ? QList<QByteArray>() : lines.last().trimmed().split('\t');
 
-  QListIterator<QString> iter(colNames);
-  while (iter.hasNext())
+  EbsdTextWriter writer;
+  for(const auto& columnName : columnNames)
   {
-
-    ColInfoType colInfo;
-    QString name = iter.next();
-
-    colInfo.colName = name;
-
-    DataParser::Pointer dparser = m_NamePointerMap[name];
-
-    colInfo.ptr = dparser->getVoidPointer();
-
-    colInfo.aType = 2; // undefined value
-
-    if(1 == dparser->IsA())
+    QString name = QString::fromLatin1(columnName);
+    DataParser::Pointer dparser = m_NamePointerMap.value(name, DataParser::NullPointer());
+    EbsdLib::NumericTypes::Type pType = getPointerType(name);
+    if(nullptr != dparser.get())
     {
-      colInfo.aType = 0;
+      pType = (1 == dparser->IsA()) ? EbsdLib::NumericTypes::Type::Int32 : EbsdLib::NumericTypes::Type::Float;
     }
-
-    if(2 == dparser->IsA())
+    void* ptr = (nullptr != dparser.get()) ? dparser->getVoidPointer() : nullptr;
+    size_t stride = (nullptr != dparser.get()) ? dparser->getStride() : 1;
+    if(EbsdLib::NumericTypes::Type::Float == pType)
     {
-      colInfo.aType = 1;
+      writer.addFloatColumn(reinterpret_cast<float*>(ptr), 0, 4, '\t', stride);
     }
-
-    colInfos[dparser->getColumnIndex()] = colInfo;
-  }
-
-  size_t counter = 0;
-  for (int slice = zStart; slice < zEnd; ++slice)
-  {
-    for (int row = 0; row < yCells; ++row)
+    else
     {
-      for (int col = 0; col < xCells; ++col)
-      {
-
-        for(size_t n = 0; n < colInfos.size(); n++)
-        {
-          ColInfoType& colInfo = colInfos[n];
-          if(0 == colInfo.aType) // int32 pointer
-          {
-            int32_t* i32Ptr = reinterpret_cast<int32_t*>(colInfo.ptr);
-            fprintf(f, "%d\t", i32Ptr[counter]);
-          }
-          else if(1 == colInfo.aType) // float pointer
-          {
-            float* f32Ptr = reinterpret_cast<float*>(colInfo.ptr);
-            fprintf(f, "%0.4f\t", f32Ptr[counter]);
-          }
-          else
-          {
-            Q_ASSERT_X(false, __FILE__, "DataParser type not known;");
-          }
-        }
-        counter++;
-        fprintf(f, "\n");
-
-      }
+      writer.addInt32Column(reinterpret_cast<int32_t*>(ptr), 0, '\t', stride);
     }
   }
 
+  int error = writer.writeRows(f, getNumberOfElements());
+
   fclose(f);
   f = nullptr;
 
-
   return error;
 }
 
@@ -35,8 +35,11 @@
 
 #pragma once
 
+#include <vector>
+
 #include <QtCore/QFile>
 #include <QtCore/QMap>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QVector>
 #include <QtCore/QtDebug>
@@ -47,7 +50,10 @@
 #include "DataParser.hpp"
 #include "EbsdLib/Core/EbsdLibConstants.h"
 #include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/IO/EbsdCompressedFileDevice.h"
 #include "EbsdLib/IO/EbsdReader.h"
+#include "EbsdLib/IO/EbsdTextFileIndex.h"
+#include "EbsdLib/IO/EbsdTokenParser.hpp"
 #include "EbsdLib/Core/EbsdSetGetMacros.h"
 
 #define CTF_READER_PTR_PROP(name, var, type)                                                                                                                                                           \
@@ -102,6 +108,14 @@ public:
   EBSDHEADER_INSTANCE_PROPERTY(CtfHeaderEntry<int>, int, NumPhases, EbsdLib::Ctf::NumPhases)
   EBSD_INSTANCE_PROPERTY(QVector<CtfPhase::Pointer>, PhaseVector)
 
+  /**
+   * @brief When true, region of interest reads store the row offset index of the file in a
+   * sidecar file next to it (See EbsdTextFileIndex) and reuse it on later reads, as long as the
+   * size and modification time of the .ctf file are unchanged. Defaults to false, in which case
+   * the index is only kept in memory by this reader.
+   */
+  EBSD_INSTANCE_PROPERTY(bool, UseSidecarIndex)
+
   CTF_READER_PTR_PROP(Phase, Phase, int)
   CTF_READER_PTR_PROP(X, X, float)
   CTF_READER_PTR_PROP(Y, Y, float)
@@ -140,19 +154,60 @@ public:
   QList<QString> getColumnNames();
 
   /**
-   * @brief Reads the complete HKL .ctf file.
+   * @brief Reads the complete HKL .ctf file. gzip and zstd compressed files are detected and
+   * decompressed as a stream on a second thread (See EbsdCompressedFileDevice).
    * @return 1 on success
    */
   int readFile() override;
 
   /**
-   * @brief Reads ONLY the header portion of the HKL .ctf file
+   * @brief Reads ONLY the header portion of the HKL .ctf file. Calling this again for the same,
+   * unchanged file reuses the header that was already parsed.
    * @return 1 on success
    */
   int readHeaderOnly() override;
 
+  /**
+   * @brief Reads the HKL .ctf file in batches of at most 'batchSize' scan points. The column
+   * arrays of this reader only ever hold a single batch and are released once the read is
+   * complete, so getPointerByName() returns nullptr afterwards. A slice selected with
+   * readOnlySliceIndex() is honored.
+   * @param batchSize The maximum number of scan points in each batch
+   * @param callback Receives each batch in file order. Returning false stops the read.
+   * @return 0 on success or a negative error code.
+   */
+  int readFileInBatches(size_t batchSize, const EbsdRowBatchCallback& callback) override;
+
   void readOnlySliceIndex(int slice);
 
+  /**
+   * @brief Sets the names of the arrays to read out of the file. Columns that are not requested get
+   * no parser, so they are neither allocated nor converted and getPointerByName() returns nullptr
+   * for them.
+   * @param names
+   */
+  void setArraysToRead(const QSet<QString>& names);
+
+  /**
+   * @brief Over rides the setArraysToReads to tell the reader to load ALL the data from the file. If the
+   * ArrayNames to read is empty and this is true then all arrays will be read.
+   * @param b
+   */
+  void readAllArrays(bool b);
+
+  /**
+   * @brief Restricts readFile() to a rectangular region of the scan (Of the slice selected with
+   * readOnlySliceIndex() or the first slice). Only the rows of the region are visited, using a row
+   * offset index of the file to seek straight to them. The column arrays hold width * height points
+   * in row major order and getNumberOfElements() returns that count, while the header values still
+   * describe the complete scan. Passing a width or height of zero reads the complete scan again.
+   * @param x0 The first column of the region
+   * @param y0 The first row of the region
+   * @param width The number of columns in the region
+   * @param height The number of rows in the region
+   */
+  void setRegionOfInterest(int x0, int y0, int width, int height);
+
   int getXDimension() override;
   void setXDimension(int xdim) override;
   int getYDimension() override;
@@ -161,8 +216,11 @@ public:
   void printHeader(std::ostream& out);
 
   /**
-   * @brief writeFile
+   * @brief Writes the original header and the data that was read to a .ctf file. Columns that were
+   * not read are written as zeros. After a region of interest read the XCells, YCells and ZCells entries of the
+   * header are set to the size of the region.
    * @param filepath
+   * @return Zero on success, -1 if the file could not be written
    */
   int writeFile(const QString& filepath);
 
@@ -170,6 +228,17 @@ protected:
 private:
   int m_SingleSliceRead;
   QMap<QString, DataParser::Pointer> m_NamePointerMap;
+  int m_NumColumns = 0;
+  std::vector<EbsdLib::TokenParser::Token> m_LineTokens;
+  QSet<QString> m_ArrayNames;
+  bool m_ReadAllArrays = true;
+  int m_RoiX0 = 0;
+  int m_RoiY0 = 0;
+  int m_RoiWidth = 0;
+  int m_RoiHeight = 0;
+  EbsdTextFileIndex m_RowIndex;
+  EbsdFileStamp m_HeaderStamp;
+  int m_HeaderStampResult = 0;
 
   /**
    * @brief
@@ -177,7 +246,7 @@ private:
    * @param headerLines
    * @return
    */
-  int getHeaderLines(QFile& reader, QList<QByteArray>& headerLines);
+  int getHeaderLines(QIODevice& reader, QList<QByteArray>& headerLines);
 
   /**
    * Checks that the line is the header of the columns for the data.
@@ -194,11 +263,49 @@ private:
    */
   int parseHeaderLines(QList<QByteArray>& headerLines);
 
+  /**
+   * @brief Reads and parses the header section of the file and verifies the header values.
+   * @param in The open .ctf file
+   * @return Zero on success or a negative error code.
+   */
+  int readHeaderSection(QIODevice& in);
+
+  /**
+   * @brief Reads the column header line and creates a DataParser for every column.
+   * @param in The open .ctf file positioned at the column header line
+   * @param numElements The number of values each parser can hold
+   * @param useDestinationBuffers Parse into the buffers registered with setDestinationBuffer()
+   * @return Zero on success or a negative error code.
+   */
+  int initParsers(QIODevice& in, size_t numElements, bool useDestinationBuffers);
+
   /**
    * @brief
    * @param in The input file stream to read from
    */
-  int readData(QFile& in);
+  int readData(QIODevice& in);
+
+  /**
+   * @brief Parses the data section from a memory mapped view of the file. The data section is
+   * split into line aligned chunks that are parsed in parallel, each chunk writing directly into
+   * the column arrays starting at its own row index.
+   * @param begin Start of the first line of data
+   * @param end One past the last byte of the file
+   * @param skipLines The number of data lines to skip before parsing starts (Single slice reads)
+   * @return Zero on success or a negative error code.
+   */
+  int readMappedData(const char* begin, const char* end, size_t skipLines);
+
+  /**
+   * @brief Parses only the lines of the region of interest from a memory mapped view of the file.
+   * @param begin First byte of the file
+   * @param end One past the last byte of the file
+   * @param headerLength The number of bytes in the header section (Before the column header line)
+   * @param dataStart The byte offset of the first line of data
+   * @param skipLines The number of data lines to skip before the selected slice starts
+   * @return Zero on success or a negative error code.
+   */
+  int readMappedRegion(const char* begin, const char* end, qint64 headerLength, qint64 dataStart, size_t skipLines);
 
   /**
    * @brief Reads a line of Data from the ASCII based file
@@ -35,9 +35,11 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QString>
 
 #include "EbsdLib/Core/EbsdSetGetMacros.h"
+#include "EbsdLib/IO/EbsdTokenParser.hpp"
 
 class DataParser
 {
@@ -95,8 +97,22 @@ public:
   EBSD_INSTANCE_PROPERTY(size_t, Size)
   EBSD_INSTANCE_STRING_PROPERTY(ColumnName)
   EBSD_INSTANCE_PROPERTY(int, ColumnIndex)
+  /** @brief The number of elements between the values of two consecutive scan points */
+  EBSD_INSTANCE_PROPERTY(size_t, Stride)
 
   virtual void parse(const QByteArray& token, size_t index)
+  {
+    parse(token.constData(), token.constData() + token.size(), index);
+  }
+
+  /**
+   * @brief Parses the value from a token that is still inside of a larger buffer. Both '.' and ','
+   * are accepted as the decimal separator so European style files can be parsed as is.
+   * @param first Start of the token
+   * @param last End of the token
+   * @param index The index into the array where the value is stored
+   */
+  virtual void parse(const char* first, const char* last, size_t index)
   {
   }
 
@@ -106,6 +122,7 @@ protected:
   , m_Size(0)
   , m_ColumnName("")
   , m_ColumnIndex(0)
+  , m_Stride(1)
   {
   }
 
@@ -204,11 +221,12 @@ public:
     return m_Ptr + offset;
   }
 
-  void parse(const QByteArray& token, size_t index) override
+  using DataParser::parse;
+  void parse(const char* first, const char* last, size_t index) override
   {
     Q_ASSERT(index < getSize());
     bool ok = false;
-    m_Ptr[index] = token.toInt(&ok, 10);
+    m_Ptr[index * getStride()] = EbsdLib::TokenParser::toInt32(first, last, &ok);
   }
 
 protected:
@@ -319,10 +337,11 @@ public:
     return m_Ptr + offset;
   }
 
-  void parse(const QByteArray& token, size_t index) override
+  using DataParser::parse;
+  void parse(const char* first, const char* last, size_t index) override
   {
     bool ok = false;
-    m_Ptr[index] = token.toFloat(&ok);
+    m_Ptr[index * getStride()] = EbsdLib::TokenParser::toFloat(first, last, &ok, EbsdLib::TokenParser::DecimalSeparator::PointOrComma);
   }
 
 protected:
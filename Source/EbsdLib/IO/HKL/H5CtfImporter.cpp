@@ -35,6 +35,7 @@
 
 #include "H5CtfImporter.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "H5Support/QH5Lite.h"
@@ -42,6 +43,8 @@
 
 #include "EbsdLib/Core/EbsdLibConstants.h"
 #include "EbsdLib/EbsdLibVersion.h"
+#include "EbsdLib/IO/H5ChunkedLayout.hpp"
+#include "EbsdLib/IO/EbsdSliceImportPipeline.hpp"
 
 #if defined (H5Support_NAMESPACE)
 using namespace H5Support_NAMESPACE;
@@ -53,6 +56,18 @@ using namespace H5Support_NAMESPACE;
   if (m_Cancel == true){\
     break; }
 
+namespace
+{
+/**
+ * @brief A parsed .ctf file and the error code of the parse that the batch import hands from the
+ * parsing threads to the writing thread
+ */
+struct CtfSlice
+{
+  CtfReader reader;
+  int err = 0;
+};
+} // namespace
 
 #define WRITE_EBSD_HEADER_DATA(reader, m_msgType, prpty, key)\
   {\
@@ -85,7 +100,7 @@ using namespace H5Support_NAMESPACE;
   {                                                                                                                                                                                                    \
     if(nullptr != dataPtr)                                                                                                                                                                             \
     {                                                                                                                                                                                                  \
-      err = QH5Lite::writePointerDataset(gid, key, rank, dims, dataPtr);                                                                                                                               \
+      err = EbsdLib::H5ChunkedLayout::writeDataset(gid, key, rank, dims, static_cast<size_t>(xDim), getChunkRows(), getCompressionLevel(), dataPtr);                                                   \
       if(err < 0)                                                                                                                                                                                      \
       {                                                                                                                                                                                                \
         QString ss = QObject::tr("H5CtfImporter Error: Could not write Ctf Data array for '%1' to the HDF5 file with data set name '%2'\n").arg(key, key);                                             \
@@ -153,76 +168,136 @@ int H5CtfImporter::importFile(hid_t fileId, int64_t z, const QString& ctfFile)
   // Check for errors
   if (err < 0)
   {
+    reportReadError(reader, err);
+    return -1;
+  }
 
-    QString ss;
-    if (err == -200)
-    {
-      ss = "H5CtfImporter Error: There was no data in the file.";
-    }
-    else if (err == -100)
-    {
-      ss = "H5CtfImporter Error: The Ctf file could not be opened.";
-    }
-    else if (reader.getXStep() == 0.0f)
-    {
-      ss = "H5CtfImporter Error: X Step value equals 0.0. This is bad. Please check the validity of the CTF file.";
-    }
-    else if(reader.getYStep() == 0.0f)
-    {
-      ss = "H5CtfImporter Error: Y Step value equals 0.0. This is bad. Please check the validity of the CTF file.";
-    }
-    else
-    {
-      ss = reader.getErrorMessage();
-    }
-    //  setPipelineMessage(ss);
-    setErrorCode(err);
-    progressMessage(ss, 100);
+  err = writeFileVersion(fileId);
 
+  int zSlices = reader.getZCells();
 
-    return -1;
+  // This scheme is going to fail if the user has multiple HKL 3D files where each
+  // file as multiple slices. We really need to keep track of what slice we are
+  // on at the next level up that this level.
+  m_NumSlicesImported = 0;
+  for(int slice = 0; slice < zSlices; ++slice)
+  {
+    writeSliceData(fileId, reader, static_cast<int>(z) + slice, slice);
+    ++m_NumSlicesImported;
   }
+  return err;
+}
 
-  // Write the fileversion attribute if it does not exist
-  {
-    QVector<hsize_t> dims;
-    H5T_class_t type_class;
-    size_t type_size = 0;
-    hid_t attr_type = -1;
-    err = QH5Lite::getAttributeInfo(fileId, "/", EbsdLib::H5Aztec::FileVersionStr, dims, type_class, type_size, attr_type);
-    if (attr_type < 0) // The attr_type variable was never set which means the attribute was NOT there
-    {
-      // The file version does not exist so write it to the file
-      err = QH5Lite::writeScalarAttribute(fileId, QString("/"), EbsdLib::H5Aztec::FileVersionStr, m_FileVersion);
-    }
-    else
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5CtfImporter::importFiles(hid_t fileId, int64_t z, const QStringList& ctfFiles)
+{
+  setCancel(false);
+  setErrorCode(0);
+  m_NumSlicesImported = 0;
+
+  // The files are parsed on the worker threads of the pipeline, all HDF5 calls stay on this thread
+  auto parse = [&ctfFiles](size_t index) {
+    std::unique_ptr<CtfSlice> slice(new CtfSlice);
+    slice->reader.setFileName(ctfFiles[static_cast<int>(index)]);
+    slice->err = slice->reader.readFile();
+    return slice;
+  };
+
+  // A 3D file holds several slices, so the Z index of a file is only known once every file before it was written
+  int64_t nextZ = z;
+  auto write = [this, fileId, &nextZ, &ctfFiles](size_t index, CtfSlice& slice) {
+    if(slice.err < 0)
     {
-      H5Aclose(attr_type);
+      reportReadError(slice.reader, slice.err);
+      return -1;
     }
-
-    err = QH5Lite::getAttributeInfo(fileId, "/", EbsdLib::H5Aztec::EbsdLibVersionStr, dims, type_class, type_size, attr_type);
-    if (attr_type < 0) // The attr_type variable was never set which means the attribute was NOT there
+    if(0 == index)
     {
-      // The file version does not exist so write it to the file
-      err = QH5Lite::writeStringAttribute(fileId, QString("/"), EbsdLib::H5Aztec::EbsdLibVersionStr, EbsdLib::Version::Complete());
+      writeFileVersion(fileId);
     }
-    else
+    int zSlices = slice.reader.getZCells();
+    for(int zSlice = 0; zSlice < zSlices; ++zSlice)
     {
-      H5Aclose(attr_type);
+      int err = writeSliceData(fileId, slice.reader, static_cast<int>(nextZ), zSlice);
+      if(err < 0)
+      {
+        return err;
+      }
+      ++nextZ;
+      ++m_NumSlicesImported;
     }
-  }
+    progressMessage(QObject::tr("Imported %1 of %2 files").arg(index + 1).arg(ctfFiles.size()), static_cast<int>(100 * (index + 1) / ctfFiles.size()));
+    return 0;
+  };
 
+  EbsdSliceImportPipeline<CtfSlice> pipeline(static_cast<size_t>(ctfFiles.size()), static_cast<size_t>(std::max(getNumberOfParseThreads(), 0)),
+                                              static_cast<size_t>(std::max(getMaxQueuedFiles(), 1)));
+  return pipeline.run(parse, write, [this]() { return getCancel(); });
+}
 
-  int zSlices = reader.getZCells();
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5CtfImporter::reportReadError(CtfReader& reader, int err)
+{
+  QString ss;
+  if (err == -200)
+  {
+    ss = "H5CtfImporter Error: There was no data in the file.";
+  }
+  else if (err == -100)
+  {
+    ss = "H5CtfImporter Error: The Ctf file could not be opened.";
+  }
+  else if (reader.getXStep() == 0.0f)
+  {
+    ss = "H5CtfImporter Error: X Step value equals 0.0. This is bad. Please check the validity of the CTF file.";
+  }
+  else if(reader.getYStep() == 0.0f)
+  {
+    ss = "H5CtfImporter Error: Y Step value equals 0.0. This is bad. Please check the validity of the CTF file.";
+  }
+  else
+  {
+    ss = reader.getErrorMessage();
+  }
+  //  setPipelineMessage(ss);
+  setErrorCode(err);
+  progressMessage(ss, 100);
+}
 
-  // This scheme is going to fail if the user has multiple HKL 3D files where each
-  // file as multiple slices. We really need to keep track of what slice we are
-  // on at the next level up that this level.
-  m_NumSlicesImported = 0;
-  for(int slice = 0; slice < zSlices; ++slice)
+// -----------------------------------------------------------------------------
+// Write the fileversion attribute if it does not exist
+// -----------------------------------------------------------------------------
+int H5CtfImporter::writeFileVersion(hid_t fileId)
+{
+  herr_t err = 0;
+  QVector<hsize_t> dims;
+  H5T_class_t type_class;
+  size_t type_size = 0;
+  hid_t attr_type = -1;
+  err = QH5Lite::getAttributeInfo(fileId, "/", EbsdLib::H5Aztec::FileVersionStr, dims, type_class, type_size, attr_type);
+  if (attr_type < 0) // The attr_type variable was never set which means the attribute was NOT there
   {
-    writeSliceData(fileId, reader, static_cast<int>(z) + slice, slice);
-    ++m_NumSlicesImported;
+    // The file version does not exist so write it to the file
+    err = QH5Lite::writeScalarAttribute(fileId, QString("/"), EbsdLib::H5Aztec::FileVersionStr, m_FileVersion);
+  }
+  else
+  {
+    H5Aclose(attr_type);
+  }
+
+  err = QH5Lite::getAttributeInfo(fileId, "/", EbsdLib::H5Aztec::EbsdLibVersionStr, dims, type_class, type_size, attr_type);
+  if (attr_type < 0) // The attr_type variable was never set which means the attribute was NOT there
+  {
+    // The file version does not exist so write it to the file
+    err = QH5Lite::writeStringAttribute(fileId, QString("/"), EbsdLib::H5Aztec::EbsdLibVersionStr, EbsdLib::Version::Complete());
+  }
+  else
+  {
+    H5Aclose(attr_type);
   }
   return err;
 }
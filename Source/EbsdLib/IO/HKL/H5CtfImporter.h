@@ -86,6 +86,19 @@ class EbsdLib_EXPORT H5CtfImporter : public EbsdImporter
      */
     int importFile(hid_t fileId, int64_t z, const QString& ctfFile) override;
 
+    /**
+     * @brief Imports a stack of .ctf files into the HDF5 file. The files are parsed concurrently on
+     * NumberOfParseThreads worker threads while this thread writes the parsed files in order. The
+     * slices of each file are stored after the slices of the file before it, starting at z. At most
+     * MaxQueuedFiles parsed files are held in memory at once.
+     * @param fileId The valid HDF5 file Id for an already open HDF5 file
+     * @param z The slice index for the first slice of the first file
+     * @param ctfFiles The absolute paths to the input .ctf files in slice order
+     * @return Zero on success, negative if a file could not be read or written. No files after the
+     * failed file are imported.
+     */
+    int importFiles(hid_t fileId, int64_t z, const QStringList& ctfFiles) override;
+
     /**
      * @brief Writes the phase data into the HDF5 file
      * @param reader Valid AngReader instance
@@ -126,6 +139,16 @@ class EbsdLib_EXPORT H5CtfImporter : public EbsdImporter
 
     int writeSliceData(hid_t fileId, CtfReader& reader, int z, int actualSlice);
 
+    /**
+     * @brief Reports the error of a failed read through progressMessage() and the ErrorCode
+     */
+    void reportReadError(CtfReader& reader, int err);
+
+    /**
+     * @brief Writes the file version attributes if the file does not have them yet
+     */
+    int writeFileVersion(hid_t fileId);
+
   private:
 
 
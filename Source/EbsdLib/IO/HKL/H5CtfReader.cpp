@@ -43,6 +43,7 @@
 
 #include "EbsdLib/Core/EbsdLibConstants.h"
 #include "EbsdLib/Core/EbsdMacros.h"
+#include "EbsdLib/IO/H5ScanRegion.hpp"
 #include "EbsdLib/IO/HKL/CtfConstants.h"
 
 #if defined (H5Support_NAMESPACE)
@@ -156,6 +157,18 @@ int H5CtfReader::readHeaderOnly()
     return -1;
   }
 
+  if(nullptr != m_H5EbsdFile)
+  {
+    // The group belongs to the shared file and stays open for the next reader of the slice
+    hid_t gid = m_H5EbsdFile->getGroup(m_HDF5Path);
+    if(gid < 0)
+    {
+      qDebug() << "H5CtfReader Error: Could not open path '" << m_HDF5Path << "'";
+      return -1;
+    }
+    return readHeader(gid);
+  }
+
   hid_t fileId = QH5Utilities::openFile(getFileName(), true);
   if (fileId < 0)
   {
@@ -191,6 +204,20 @@ int H5CtfReader::readFile()
     return -1;
   }
 
+  if(nullptr != m_H5EbsdFile)
+  {
+    // The group belongs to the shared file and stays open for the next reader of the slice
+    hid_t gid = m_H5EbsdFile->getGroup(m_HDF5Path);
+    if(gid < 0)
+    {
+      qDebug() << "H5CtfReader Error: Could not open path '" << m_HDF5Path << "'";
+      return -1;
+    }
+    err = readHeader(gid);
+    err = readData(gid);
+    return err;
+  }
+
   hid_t fileId = QH5Utilities::openFile(getFileName(), true);
   if (fileId < 0)
   {
@@ -325,6 +352,28 @@ int H5CtfReader::readData(hid_t parId)
     return -1;
   }
 
+  // Only the rows and columns of the region of interest are read when one was set
+  if(m_RoiWidth > 0 && m_RoiHeight > 0)
+  {
+    if(!EbsdLib::H5ScanRegion::fitsInScan(m_RoiX0, m_RoiY0, m_RoiWidth, m_RoiHeight, xCells, yCells))
+    {
+      QString msg;
+      QTextStream ss(&msg);
+      ss << "The region of interest X=" << m_RoiX0 << " Y=" << m_RoiY0 << " Width=" << m_RoiWidth << " Height=" << m_RoiHeight << " does not fit inside the slice of " << xCells << " x " << yCells
+         << " points.";
+      setErrorCode(-90302);
+      setErrorMessage(msg);
+      return -302;
+    }
+    totalDataRows = static_cast<size_t>(m_RoiWidth) * static_cast<size_t>(m_RoiHeight);
+  }
+
+  // Buffers the caller registered must hold every scan point before HDF5 writes into them
+  if(checkDestinationBuffers(totalDataRows) < 0)
+  {
+    return getErrorCode();
+  }
+
   hid_t gid = H5Gopen(parId, EbsdLib::H5Aztec::Data.toLatin1(), H5P_DEFAULT);
   if (gid < 0)
   {
@@ -347,6 +396,7 @@ int H5CtfReader::readData(hid_t parId)
     return err;
   }
 
+  size_t nColumns = xCells;
   ANG_READER_ALLOCATE_AND_READ(Phase, EbsdLib::Ctf::Phase, int);
   ANG_READER_ALLOCATE_AND_READ(BandCount, EbsdLib::Ctf::Bands, int);
   ANG_READER_ALLOCATE_AND_READ(Error, EbsdLib::Ctf::Error, int);
@@ -382,6 +432,25 @@ void H5CtfReader::readAllArrays(bool b)
   m_ReadAllArrays = b;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5CtfReader::setH5EbsdFile(const H5EbsdFile::Pointer& file)
+{
+  m_H5EbsdFile = file;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5CtfReader::setRegionOfInterest(int x0, int y0, int width, int height)
+{
+  m_RoiX0 = x0;
+  m_RoiY0 = y0;
+  m_RoiWidth = width;
+  m_RoiHeight = height;
+}
+
 // -----------------------------------------------------------------------------
 H5CtfReader::Pointer H5CtfReader::NullPointer()
 {
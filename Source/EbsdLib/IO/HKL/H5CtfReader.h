@@ -42,6 +42,7 @@
 
 #include "EbsdLib/EbsdLib.h"
 #include "EbsdLib/Core/EbsdSetGetMacros.h"
+#include "EbsdLib/IO/H5EbsdFile.h"
 #include "EbsdLib/IO/HKL/CtfReader.h"
 #include "EbsdLib/IO/HKL/CtfPhase.h"
 
@@ -165,6 +166,27 @@ class EbsdLib_EXPORT H5CtfReader : public CtfReader
      */
     void readAllArrays(bool b);
 
+    /**
+     * @brief Restricts readFile() to a rectangular region of the slice. Every requested dataset is read
+     * with a strided HDF5 hyperslab selection so only the region is transferred from the file. The arrays
+     * hold width * height points in row major order and getNumberOfElements() returns that count, while
+     * the header values still describe the complete slice. Passing a width or height of zero reads the
+     * complete slice again.
+     * @param x0 The first column of the region
+     * @param y0 The first row of the region
+     * @param width The number of columns in the region
+     * @param height The number of rows in the region
+     */
+    void setRegionOfInterest(int x0, int y0, int width, int height);
+
+    /**
+     * @brief Makes readFile() and readHeaderOnly() find the slice group in a file that is already open
+     * instead of opening the file again. The volume readers hand the file they share to every slice.
+     * Passing nullptr makes the reader open the file named by getFileName() again.
+     * @param file The open .h5ebsd file that holds the slice
+     */
+    void setH5EbsdFile(const H5EbsdFile::Pointer& file);
+
   protected:
     H5CtfReader();
 
@@ -183,6 +205,11 @@ class EbsdLib_EXPORT H5CtfReader : public CtfReader
     QVector<CtfPhase::Pointer> m_Phases;
     QSet<QString> m_ArrayNames;
     bool                  m_ReadAllArrays;
+    int m_RoiX0 = 0;
+    int m_RoiY0 = 0;
+    int m_RoiWidth = 0;
+    int m_RoiHeight = 0;
+    H5EbsdFile::Pointer m_H5EbsdFile;
 
   public:
     H5CtfReader(const H5CtfReader&) = delete;    // Copy Constructor Not Implemented
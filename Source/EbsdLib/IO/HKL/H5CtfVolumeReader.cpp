@@ -35,18 +35,38 @@
 
 #include "H5CtfVolumeReader.h"
 
+#include <array>
 #include <cmath>
+#include <iostream>
+#include <memory>
 
 #include "H5Support/QH5Lite.h"
 #include "H5Support/QH5Utilities.h"
 
 #include "EbsdLib/Core/EbsdLibConstants.h"
+#include "EbsdLib/IO/EbsdSliceCopier.hpp"
+#include "EbsdLib/IO/EbsdSliceImportPipeline.hpp"
 #include "EbsdLib/IO/HKL/H5CtfReader.h"
 
 #if defined (H5Support_NAMESPACE)
 using namespace H5Support_NAMESPACE;
 #endif
 
+namespace
+{
+/**
+ * @brief A slice that was read by the loading thread of H5CtfVolumeReader::loadData
+ */
+struct CtfVolumeSlice
+{
+  H5CtfReader::Pointer reader;
+  int err = 0;
+  // The part of the slice that lies inside the box being loaded
+  EbsdSliceCopier::Placement placement;
+  bool overlapsBox = true;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -227,28 +247,34 @@ QVector<CtfPhase::Pointer> H5CtfVolumeReader::getPhases()
   QString index = QString::number(getZStart());
 
   // Open the hdf5 file and read the data
-  hid_t fileId = QH5Utilities::openFile(getFileName(), true);
-  if (fileId < 0)
+  H5EbsdFile::Pointer h5File = getH5EbsdFile();
+  if(nullptr == h5File)
   {
     std::cout << "Error" << std::endl;
     return m_Phases;
   }
-  herr_t err = 0;
 
-  hid_t gid = H5Gopen(fileId, index.toLatin1().data(), H5P_DEFAULT);
+  // The phases are only read once for every reader of the same file
+  QString cacheKey = QString("H5CtfVolumeReader/Phases/%1").arg(index);
+  std::shared_ptr<QVector<CtfPhase::Pointer>> phases = h5File->getCachedValue<QVector<CtfPhase::Pointer>>(cacheKey);
+  if(nullptr != phases)
+  {
+    m_Phases = *phases;
+    return m_Phases;
+  }
+
+  herr_t err = 0;
+  hid_t gid = h5File->getGroup(index);
   H5CtfReader::Pointer reader = H5CtfReader::New();
   reader->setHDF5Path(index);
   err = reader->readHeader(gid);
   if (err < 0)
   {
     std::cout  << "Error reading the header information from the .h5ebsd file" << std::endl;
-    err = H5Gclose(gid);
-    err = QH5Utilities::closeFile(fileId);
     return m_Phases;
   }
   m_Phases = reader->getPhases();
-  err = H5Gclose(gid);
-  err = QH5Utilities::closeFile(fileId);
+  h5File->setCachedValue(cacheKey, std::make_shared<QVector<CtfPhase::Pointer>>(m_Phases));
   return m_Phases;
 }
 
@@ -260,106 +286,134 @@ int H5CtfVolumeReader::loadData(int64_t xpoints,
                                 int64_t zpoints,
                                 uint32_t ZDir)
 {
-  int index = 0;
   int err = -1;
-// Initialize all the pointers
-  initPointers(xpoints * ypoints * zpoints);
-
-  int readerIndex = 0;
-  int64_t xpointsslice = 0;
-  int64_t ypointsslice = 0;
-  int64_t xpointstemp = 0;
-  int64_t ypointstemp = 0;
-  int zval = 0;
-
+  std::array<int64_t, 3> boxOrigin = {{0, 0, 0}};
+  std::array<int64_t, 3> boxSize = {{0, 0, 0}};
+  if(!getLoadBox(xpoints, ypoints, zpoints, boxOrigin, boxSize))
+  {
+    std::cout << "H5CtfVolumeReader Error: The sub volume does not fit inside the volume of " << xpoints << " x " << ypoints << " x " << zpoints << " points." << std::endl;
+    return -77002;
+  }
+  bool subVolume = hasSubVolume();
 
-  int xstartspot = 0;
-  int ystartspot = 0;
+// Initialize all the pointers
+  initPointers(boxSize[0] * boxSize[1] * boxSize[2]);
 
   err = readVolumeInfo();
 
-  for (int slice = 0; slice < zpoints; ++slice)
+  // If no stacking order preference was passed, read it from the file and use that value
+  if(ZDir == EbsdLib::RefFrameZDir::UnknownRefFrameZDirection)
+  {
+    ZDir = getStackingOrder();
+  }
+
+  // Only the slices that land inside the box once they are stacked according to ZDir are read
+  int64_t firstSlice = boxOrigin[2];
+  if(ZDir == 1)
   {
-    H5CtfReader::Pointer reader = H5CtfReader::New();
-    reader->setFileName(getFileName());
-    reader->setHDF5Path(QString::number(slice + getSliceStart()));
-    reader->setUserZDir(getStackingOrder());
-    reader->setSampleTransformationAngle(getSampleTransformationAngle());
-    reader->setSampleTransformationAxis(getSampleTransformationAxis());
-    reader->setEulerTransformationAngle(getEulerTransformationAngle());
-    reader->setEulerTransformationAxis(getEulerTransformationAxis());
-    reader->readAllArrays(getReadAllArrays());
-    reader->setArraysToRead(getArraysToRead());
-
-    err = reader->readFile();
-    if (err < 0)
+    firstSlice = zpoints - boxOrigin[2] - boxSize[2];
+  }
+
+  // Gather everything the slice readers need up front so the reading thread never touches this object
+  QString fileName = getFileName();
+  int sliceStart = getSliceStart();
+  uint32_t stackingOrder = getStackingOrder();
+  float sampleTransAngle = getSampleTransformationAngle();
+  std::array<float, 3> sampleTransAxis = getSampleTransformationAxis();
+  float eulerTransAngle = getEulerTransformationAngle();
+  std::array<float, 3> eulerTransAxis = getEulerTransformationAxis();
+  bool readAll = getReadAllArrays();
+  QSet<QString> arrayNames = getArraysToRead();
+  // Every slice reader finds its group in the file that is already open
+  H5EbsdFile::Pointer h5File = getH5EbsdFile();
+
+  // A single thread reads the next slice from the file while this thread places the current one
+  // into the volume. HDF5 is only ever called from the reading thread.
+  EbsdSliceImportPipeline<CtfVolumeSlice> pipeline(static_cast<size_t>(boxSize[2]), 1, 2);
+  auto readSlice = [&](size_t index) {
+    size_t slice = static_cast<size_t>(firstSlice) + index;
+    auto loaded = std::make_unique<CtfVolumeSlice>();
+    loaded->reader = H5CtfReader::New();
+    loaded->reader->setFileName(fileName);
+    loaded->reader->setH5EbsdFile(h5File);
+    loaded->reader->setHDF5Path(QString::number(static_cast<int>(slice) + sliceStart));
+    loaded->reader->setUserZDir(stackingOrder);
+    loaded->reader->setSampleTransformationAngle(sampleTransAngle);
+    loaded->reader->setSampleTransformationAxis(sampleTransAxis);
+    loaded->reader->setEulerTransformationAngle(eulerTransAngle);
+    loaded->reader->setEulerTransformationAxis(eulerTransAxis);
+    loaded->reader->readAllArrays(readAll);
+    loaded->reader->setArraysToRead(arrayNames);
+    if(subVolume)
+    {
+      // The size of the slice decides where it is centered in the volume and so which of its rows
+      // and columns fall inside the box
+      loaded->err = loaded->reader->readHeaderOnly();
+      if(loaded->err < 0)
+      {
+        return loaded;
+      }
+      loaded->overlapsBox = EbsdSliceCopier::ClipToBox(static_cast<size_t>(loaded->reader->getXCells()), static_cast<size_t>(loaded->reader->getYCells()), static_cast<size_t>(xpoints),
+                                                       static_cast<size_t>(ypoints), static_cast<size_t>(boxOrigin[0]), static_cast<size_t>(boxOrigin[1]), static_cast<size_t>(boxSize[0]),
+                                                       static_cast<size_t>(boxSize[1]), loaded->placement);
+      if(!loaded->overlapsBox)
+      {
+        return loaded;
+      }
+      const EbsdSliceCopier::Placement& placement = loaded->placement;
+      loaded->reader->setRegionOfInterest(static_cast<int>(placement.sliceX0), static_cast<int>(placement.sliceY0), static_cast<int>(placement.width), static_cast<int>(placement.height));
+    }
+    loaded->err = loaded->reader->readFile();
+    return loaded;
+  };
+
+  auto placeSlice = [&](size_t index, CtfVolumeSlice& loaded) {
+    size_t slice = static_cast<size_t>(firstSlice) + index;
+    H5CtfReader::Pointer reader = loaded.reader;
+    if (loaded.err < 0)
     {
       std::cout << "H5CtfVolumeReader Error: There was an issue loading the data from the hdf5 file." << std::endl;
       return -77000;
     }
-    readerIndex = 0;
-    xpointsslice = reader->getXCells();
-    ypointsslice = reader->getYCells();
-    int* phasePtr = reader->getPhasePointer();
-    float* xPtr = reader->getXPointer();
-    float* yPtr = reader->getYPointer();
-    int* bandPtr = reader->getBandCountPointer();
-    int* errorPtr = reader->getErrorPointer();
-    float* euler1Ptr = reader->getEuler1Pointer();
-    float* euler2Ptr = reader->getEuler2Pointer();
-    float* euler3Ptr = reader->getEuler3Pointer();
-    float* madPtr = reader->getMeanAngularDeviationPointer();
-    int* bcPtr = reader->getBandContrastPointer();
-    int* bsPtr = reader->getBandSlopePointer();
-
-    xpointstemp = xpoints;
-    ypointstemp = ypoints;
-    xstartspot = static_cast<int>( (xpointstemp - xpointsslice) / 2 );
-    ystartspot = static_cast<int>( (ypointstemp - ypointsslice) / 2 );
-
-    // If no stacking order preference was passed, read it from the file and use that value
-    if(ZDir == EbsdLib::RefFrameZDir::UnknownRefFrameZDirection)
+    size_t xpointsslice = static_cast<size_t>(reader->getXCells());
+    size_t ypointsslice = static_cast<size_t>(reader->getYCells());
+    if(!EbsdSliceCopier::FitsInVolume(xpointsslice, ypointsslice, static_cast<size_t>(xpoints), static_cast<size_t>(ypoints)))
     {
-      ZDir = getStackingOrder();
+      std::cout << "H5CtfVolumeReader Error: Slice " << static_cast<int>(slice) + sliceStart << " does not fit into the volume." << std::endl;
+      return -77001;
     }
-    if (ZDir == 0) { zval = slice; }
-    if (ZDir == 1) { zval = static_cast<int>( (zpoints - 1) - slice ); }
-
-    // Copy the data from the current storage into the Storage Location
-    for (int j = 0; j < ypointsslice; j++)
+    if(!loaded.overlapsBox)
     {
-      for (int i = 0; i < xpointsslice; i++)
-      {
-        index = static_cast<int>( (zval * xpointstemp * ypointstemp) + ((j + ystartspot) * xpointstemp) + (i + xstartspot) );
-        if (nullptr != phasePtr) {m_Phase[index] = phasePtr[readerIndex];}
-        if (nullptr != xPtr) {m_X[index] = xPtr[readerIndex];}
-        if (nullptr != yPtr) {m_Y[index] = yPtr[readerIndex];}
-        if (nullptr != bandPtr) {m_Bands[index] = bandPtr[readerIndex];}
-        if (nullptr != errorPtr) {m_Error[index] = errorPtr[readerIndex];}
-        if (nullptr != euler1Ptr) {m_Euler1[index] = euler1Ptr[readerIndex];}
-        if (nullptr != euler2Ptr) {m_Euler2[index] = euler2Ptr[readerIndex];}
-        if (nullptr != euler3Ptr) {m_Euler3[index] = euler3Ptr[readerIndex];}
-        if (nullptr != madPtr) {m_MAD[index] = madPtr[readerIndex];}
-        if (nullptr != bcPtr) {m_BC[index] = bcPtr[readerIndex];}
-        if (nullptr != bsPtr) {m_BS[index] = bsPtr[readerIndex];}
-
-        /* For HKL OIM Files if there is a single phase then the value of the phase
-         * data is one (1). If there are 2 or more phases then the lowest value
-         * of phase is also one (1). However, if there are "zero solutions" in the data
-         * then those points are assigned a phase of zero.  Since those points can be identified
-         * by other methods, the phase of these points should be changed to one since in the rest
-         * of the reconstruction code we follow the convention that the lowest value is One (1)
-         * even if there is only a single phase. The next if statement converts all zeros to ones
-         * if there is a single phase in the OIM data.
-         */
-//        if(nullptr != phasePtr && m_Phase[index] < 1)
-//        {
-//          m_Phase[index] = 1;
-//        }
-
-        ++readerIndex;
-      }
+      return 0;
     }
+
+    size_t zval = slice;
+    if (ZDir == 1) { zval = static_cast<size_t>(zpoints - 1) - slice; }
+
+    // Copy the data from the current storage into the Storage Location
+    const EbsdSliceCopier::Placement& placement = loaded.placement;
+    EbsdSliceCopier copier = subVolume ? EbsdSliceCopier(placement.width, placement.height, static_cast<size_t>(boxSize[0]), static_cast<size_t>(boxSize[1]),
+                                                         zval - static_cast<size_t>(boxOrigin[2]), placement.boxX0, placement.boxY0)
+                                       : EbsdSliceCopier(xpointsslice, ypointsslice, static_cast<size_t>(xpoints), static_cast<size_t>(ypoints), zval);
+    copier.addArray(m_Phase, reader->getPhasePointer());
+    copier.addArray(m_X, reader->getXPointer());
+    copier.addArray(m_Y, reader->getYPointer());
+    copier.addArray(m_Bands, reader->getBandCountPointer());
+    copier.addArray(m_Error, reader->getErrorPointer());
+    copier.addArray(m_Euler1, reader->getEuler1Pointer());
+    copier.addArray(m_Euler2, reader->getEuler2Pointer());
+    copier.addArray(m_Euler3, reader->getEuler3Pointer());
+    copier.addArray(m_MAD, reader->getMeanAngularDeviationPointer());
+    copier.addArray(m_BC, reader->getBandContrastPointer());
+    copier.addArray(m_BS, reader->getBandSlopePointer());
+    copier.copy();
+    return 0;
+  };
+
+  int pipelineErr = pipeline.run(readSlice, placeSlice);
+  if(boxSize[2] > 0)
+  {
+    err = pipelineErr;
   }
   return err;
 
@@ -7,11 +7,23 @@ set(EbsdLib_${DIR_NAME}_HDRS
   ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdReader.h         
   ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdImporter.h       
   ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdHeaderEntry.h    
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdRowBatch.h
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdTextFileIndex.h
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdCompressedFileDevice.h
   ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/AngleFileLoader.h
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdTokenParser.hpp
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdNumberFormatter.hpp
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdPatternBinning.hpp
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdTextWriter.h
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdSliceImportPipeline.hpp
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdSliceCopier.hpp
 )
 
 set(EbsdLib_${DIR_NAME}_SRCS
   ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdReader.cpp
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdTextFileIndex.cpp
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdCompressedFileDevice.cpp
+  ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/EbsdTextWriter.cpp
   ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/AngleFileLoader.cpp
   )
 
@@ -21,11 +33,20 @@ if(EbsdLib_ENABLE_HDF5)
       ${EbsdLib_${DIR_NAME}_HDRS}
       ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5EbsdVolumeReader.h
       ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5EbsdVolumeInfo.h
+      ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5EbsdFile.h
+      ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5ScanRegion.hpp
+      ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5ChunkedLayout.hpp
+      ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5ContiguousDataset.hpp
+      ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5PatternAccessor.h
+      ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5ScanCatalog.h
   )
   set(EbsdLib_${DIR_NAME}_SRCS
       ${EbsdLib_${DIR_NAME}_SRCS}
       ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5EbsdVolumeInfo.cpp
+      ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5EbsdFile.cpp
       ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5EbsdVolumeReader.cpp
+      ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5PatternAccessor.cpp
+      ${EbsdLibProj_SOURCE_DIR}/Source/EbsdLib/${DIR_NAME}/H5ScanCatalog.cpp
   )
 endif()
 
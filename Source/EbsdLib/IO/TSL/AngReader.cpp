@@ -38,13 +38,35 @@
 #include <algorithm>
 
 #include <QtCore/QFile>
+#include <QtCore/QIODevice>
 #include <QtCore/QObject>
 #include <QtCore/QTextStream>
 
 #include "AngConstants.h"
 #include "EbsdLib/Core/EbsdMacros.h"
+#include "EbsdLib/IO/EbsdTextWriter.h"
+#include "EbsdLib/IO/EbsdTokenParser.hpp"
 #include "EbsdLib/Math/EbsdLibMath.h"
 
+namespace TokenParser = EbsdLib::TokenParser;
+
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns the line the same way QFile::readLine() does when the file is opened in Text mode
+// -----------------------------------------------------------------------------
+QByteArray textModeLine(const char* first, const char* last)
+{
+  QByteArray buf(first, static_cast<int>(last - first));
+  if(buf.endsWith("\r\n"))
+  {
+    buf.chop(2);
+    buf.append('\n');
+  }
+  return buf;
+}
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -65,6 +87,8 @@ AngReader::AngReader()
   setNumFeatures(10);
 
   m_ReadHexGrid = false;
+  m_UseMemoryMappedFile = true;
+  m_UseSidecarIndex = false;
 
   // Initialize the map of header key to header value
   m_HeaderMap[EbsdLib::Ang::TEMPIXPerUM] = AngHeaderEntry<float>::NewEbsdHeaderEntry(EbsdLib::Ang::TEMPIXPerUM);
@@ -252,16 +276,26 @@ EbsdLib::NumericTypes::Type AngReader::getPointerType(const QString& featureName
 int AngReader::readHeaderOnly()
 {
   int err = 1;
+  EbsdFileStamp stamp = EbsdFileStamp::Create(getFileName());
+  if(stamp.isValid() && stamp == m_HeaderStamp)
+  {
+    // The header of this file was already parsed and the file has not changed since then
+    return err;
+  }
+  m_HeaderStamp = EbsdFileStamp();
+
   QByteArray buf;
-  QFile in(getFileName());
   setHeaderIsComplete(false);
-  if(!in.open(QIODevice::ReadOnly | QIODevice::Text))
+  QString openError;
+  std::unique_ptr<QIODevice> device = EbsdCompressedFileDevice::OpenForReading(getFileName(), QIODevice::ReadOnly | QIODevice::Text, openError);
+  if(nullptr == device)
   {
-    QString msg = QString("Ang file could not be opened: ") + getFileName();
+    QString msg = QString("Ang file could not be opened: ") + getFileName() + "\n" + openError;
     setErrorCode(-100);
     setErrorMessage(msg);
     return -100;
   }
+  QIODevice& in = *device;
   QString origHeader;
   setOriginalHeader(origHeader);
   QTextStream ostr(&origHeader);
@@ -278,6 +312,11 @@ int AngReader::readHeaderOnly()
   }
   // Update the Original Header variable
   setOriginalHeader(origHeader);
+  // Only a header that ran up to the data and parsed cleanly is reused, anything else is parsed again
+  if(getHeaderIsComplete() && getErrorCode() >= 0 && !m_PhaseVector.empty())
+  {
+    m_HeaderStamp = stamp;
+  }
   return err;
 }
 
@@ -290,16 +329,65 @@ int AngReader::readFile()
   setErrorMessage("");
   QByteArray buf;
   setHeaderIsComplete(false);
+  m_HeaderStamp = EbsdFileStamp();
 
-  QFile in(getFileName());
-  if(!in.open(QIODevice::ReadOnly | QIODevice::Text))
+  QString openError;
+  std::unique_ptr<QIODevice> device = EbsdCompressedFileDevice::OpenForReading(getFileName(), QIODevice::ReadOnly | QIODevice::Text, openError);
+  if(nullptr == device)
   {
-    QString msg = QObject::tr("Ang file could not be opened: %1").arg(getFileName());
+    QString msg = QObject::tr("Ang file could not be opened: %1\n%2").arg(getFileName(), openError);
     setErrorCode(-100);
     setErrorMessage(msg);
     return -100;
   }
+  QIODevice& in = *device;
+
+  // Compressed files are decompressed as a stream so they can not be memory mapped
+  QFile* file = qobject_cast<QFile*>(device.get());
+  if(m_RoiWidth > 0 && m_RoiHeight > 0)
+  {
+    if(nullptr == file)
+    {
+      setErrorCode(-132);
+      setErrorMessage("Region of interest reads are not supported for compressed Ang files.");
+      return -132;
+    }
+    return readRegionOfInterest(*file);
+  }
+
+  if(m_UseMemoryMappedFile && nullptr != file && file->size() > 0)
+  {
+    uchar* mapped = file->map(0, file->size());
+    if(nullptr != mapped)
+    {
+      const char* begin = reinterpret_cast<const char*>(mapped);
+      int err = readMappedFile(begin, begin + file->size());
+      file->unmap(mapped);
+      return err;
+    }
+  }
+
+  int err = readHeaderSection(in, buf);
+  if(err < 0)
+  {
+    return err;
+  }
 
+  // We need to pass in the buffer because it has the first line of data
+  readData(in, buf);
+  if(getErrorCode() < 0)
+  {
+    return getErrorCode();
+  }
+
+  return getErrorCode();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::readHeaderSection(QIODevice& in, QByteArray& buf)
+{
   QString origHeader;
   setOriginalHeader(origHeader);
   m_PhaseVector.clear();
@@ -319,6 +407,147 @@ int AngReader::readFile()
   }
   // Update the Original Header variable
   setOriginalHeader(origHeader);
+  return checkHeaderValues();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::readFileInBatches(size_t batchSize, const EbsdRowBatchCallback& callback)
+{
+  setErrorCode(0);
+  setErrorMessage("");
+  QByteArray buf;
+  setHeaderIsComplete(false);
+  m_HeaderStamp = EbsdFileStamp();
+
+  if(batchSize == 0 || !callback)
+  {
+    setErrorCode(-120);
+    setErrorMessage("The batch size must be larger than zero and a callback must be set to read the file in batches.");
+    return -120;
+  }
+
+  QString openError;
+  std::unique_ptr<QIODevice> device = EbsdCompressedFileDevice::OpenForReading(getFileName(), QIODevice::ReadOnly | QIODevice::Text, openError);
+  if(nullptr == device)
+  {
+    QString msg = QObject::tr("Ang file could not be opened: %1\n%2").arg(getFileName(), openError);
+    setErrorCode(-100);
+    setErrorMessage(msg);
+    return -100;
+  }
+  QIODevice& in = *device;
+
+  int err = readHeaderSection(in, buf);
+  if(err < 0)
+  {
+    return err;
+  }
+
+  size_t totalDataPoints = 0;
+  err = calculateTotalDataPoints(totalDataPoints);
+  if(err < 0)
+  {
+    return err;
+  }
+  setNumberOfElements(totalDataPoints);
+
+  // The column arrays only ever hold a single batch and are reused for every batch
+  freeColumns();
+  size_t batchCapacity = std::max(static_cast<size_t>(1), std::min(batchSize, totalDataPoints));
+  err = allocateColumns(batchCapacity, false);
+  if(err < 0)
+  {
+    freeColumns();
+    return err;
+  }
+
+  EbsdRowBatch batch;
+  for(const auto& name : {EbsdLib::Ang::Phi1, EbsdLib::Ang::Phi, EbsdLib::Ang::Phi2, EbsdLib::Ang::XPosition, EbsdLib::Ang::YPosition, EbsdLib::Ang::ImageQuality, EbsdLib::Ang::ConfidenceIndex,
+                          EbsdLib::Ang::PhaseData, EbsdLib::Ang::SEMSignal, EbsdLib::Ang::Fit})
+  {
+    void* ptr = getPointerByName(name);
+    if(nullptr == ptr || (name == EbsdLib::Ang::SEMSignal && getNumFeatures() < 9) || (name == EbsdLib::Ang::Fit && getNumFeatures() < 10))
+    {
+      continue;
+    }
+    batch.addColumn(name, getPointerType(name), ptr);
+  }
+
+  size_t counter = 1; // Because we are on the first line now.
+  size_t batchStart = 0;
+  size_t batchPoints = 0;
+  bool stopped = false;
+  for(size_t i = 0; i < totalDataPoints; ++i)
+  {
+    if(i > 0)
+    {
+      buf = in.readLine();
+      ++counter;
+    }
+    parseDataLine(buf, batchPoints);
+    if(getErrorCode() < 0)
+    {
+      QString msg;
+      QTextStream ss(&msg);
+      ss << "Error parsing the data line (Numeric conversion). Error code is " << getErrorCode() << " and occurred at data column " << m_ErrorColumn << " (Zero Based)\n"
+         << buf << "\n*** Header information ***\nRows=" << getNumRows() << " EvenCols=" << getNumEvenCols() << " OddCols=" << getNumOddCols()
+         << "  Calculated Data Points: " << totalDataPoints << "\n***Parsing Position ***\nCurrent Data Point Count: " << counter << "\n";
+      setErrorMessage(msg);
+      break;
+    }
+    ++batchPoints;
+    if(batchPoints == batchCapacity)
+    {
+      batch.setStartIndex(batchStart);
+      batch.setNumberOfPoints(batchPoints);
+      if(!callback(batch))
+      {
+        stopped = true;
+        batchPoints = 0;
+        break;
+      }
+      batchStart += batchPoints;
+      batchPoints = 0;
+    }
+    if(in.atEnd())
+    {
+      break;
+    }
+  }
+
+  // Hand over whatever is left, even if the file ended early
+  if(getErrorCode() >= 0 && batchPoints > 0)
+  {
+    batch.setStartIndex(batchStart);
+    batch.setNumberOfPoints(batchPoints);
+    callback(batch);
+  }
+  freeColumns();
+
+  if(getErrorCode() < 0)
+  {
+    return getErrorCode();
+  }
+  if(!stopped && counter != totalDataPoints && in.atEnd())
+  {
+    QString msg;
+    QTextStream ss(&msg);
+    ss << "End of ANG file reached before all data was parsed.\n"
+       << getFileName() << "\n*** Header information ***\nRows=" << getNumRows() << " EvenCols=" << getNumEvenCols() << " OddCols=" << getNumOddCols()
+       << "  Calculated Data Points: " << totalDataPoints << "\n***Parsing Position ***\nCurrent Data Point Count: " << counter << "\n";
+    setErrorMessage(msg);
+    setErrorCode(-600);
+  }
+  return getErrorCode();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::checkHeaderValues()
+{
   if(getErrorCode() < 0)
   {
     return getErrorCode();
@@ -337,25 +566,213 @@ int AngReader::readFile()
     setErrorMessage("No phase was parsed in the header portion of the file. This possibly means that part of the header is missing.");
     return -150;
   }
-  // We need to pass in the buffer because it has the first line of data
-  readData(in, buf);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::readMappedFile(const char* begin, const char* end)
+{
+  const char* lineBegin = begin;
+  const char* lineEnd = begin;
+  int err = readMappedHeader(begin, end, lineBegin, lineEnd);
+  if(err < 0)
+  {
+    return err;
+  }
+
+  // The current line is the first line of data
+  readMappedData(lineBegin, lineEnd, end);
+  return getErrorCode();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::readMappedHeader(const char* begin, const char* end, const char*& lineBegin, const char*& lineEnd)
+{
+  QString origHeader;
+  setOriginalHeader(origHeader);
+  m_PhaseVector.clear();
+
+  const char* cursor = begin;
+  lineBegin = begin;
+  lineEnd = begin;
+  while(cursor < end && !getHeaderIsComplete())
+  {
+    lineBegin = cursor;
+    lineEnd = TokenParser::findLineEnd(cursor, end);
+    cursor = (lineEnd < end) ? lineEnd + 1 : end;
+    if(*lineBegin != '#')
+    {
+      setHeaderIsComplete(true);
+    }
+    else
+    {
+      QByteArray buf = textModeLine(lineBegin, cursor);
+      origHeader.append(buf);
+      parseHeaderLine(buf);
+    }
+  }
+  // Update the Original Header variable
+  setOriginalHeader(origHeader);
+  return checkHeaderValues();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::readRegionOfInterest(QFile& in)
+{
+  uchar* mapped = (in.size() > 0) ? in.map(0, in.size()) : nullptr;
+  if(nullptr == mapped)
+  {
+    QString msg = QObject::tr("Ang file could not be memory mapped for the region of interest read: %1").arg(getFileName());
+    setErrorCode(-101);
+    setErrorMessage(msg);
+    return -101;
+  }
+  const char* begin = reinterpret_cast<const char*>(mapped);
+  const char* end = begin + in.size();
+  const char* lineBegin = begin;
+  const char* lineEnd = begin;
+  int err = readMappedHeader(begin, end, lineBegin, lineEnd);
+  if(err >= 0)
+  {
+    err = readMappedRegion(begin, lineBegin, end);
+  }
+  in.unmap(mapped);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::readMappedRegion(const char* begin, const char* dataBegin, const char* end)
+{
+  if(!getGrid().startsWith(EbsdLib::Ang::SquareGrid))
+  {
+    setErrorCode(-130);
+    setErrorMessage("Region of interest reads are only supported for Ang files with a square grid.");
+    return -130;
+  }
+  int numRows = getNumRows();
+  int numCols = (getNumOddCols() > 0) ? getNumOddCols() : getNumEvenCols();
+  if(m_RoiX0 < 0 || m_RoiY0 < 0 || numCols < 1 || m_RoiX0 + m_RoiWidth > numCols || m_RoiY0 + m_RoiHeight > numRows)
+  {
+    QString msg;
+    QTextStream ss(&msg);
+    ss << "The region of interest X=" << m_RoiX0 << " Y=" << m_RoiY0 << " Width=" << m_RoiWidth << " Height=" << m_RoiHeight << " does not fit inside the scan of " << numCols << " x " << numRows
+       << " points.";
+    setErrorCode(-131);
+    setErrorMessage(msg);
+    return -131;
+  }
+
+  // The index holds the offset of the first line of every row of the scan
+  qint64 dataStart = static_cast<qint64>(dataBegin - begin);
+  size_t stride = static_cast<size_t>(numCols);
+  if(!m_RowIndex.isValidFor(getFileName()) || m_RowIndex.getDataStartOffset() != dataStart || m_RowIndex.getLineStride() != stride)
+  {
+    bool loaded = m_UseSidecarIndex && m_RowIndex.readSidecarFile(getFileName(), stride * static_cast<size_t>(numRows)) && m_RowIndex.getDataStartOffset() == dataStart && m_RowIndex.getLineStride() == stride;
+    if(!loaded)
+    {
+      m_RowIndex.build(getFileName(), begin, end, dataStart, dataStart, stride);
+      if(m_UseSidecarIndex)
+      {
+        m_RowIndex.writeSidecarFile();
+      }
+    }
+  }
+
+  size_t numPoints = static_cast<size_t>(m_RoiWidth) * static_cast<size_t>(m_RoiHeight);
+  freeColumns();
+  setNumberOfElements(numPoints);
+  int err = allocateColumns(numPoints, true);
+  if(err < 0)
+  {
+    return err;
+  }
+
+  size_t counter = 0;
+  for(int y = 0; y < m_RoiHeight && getErrorCode() >= 0; y++)
+  {
+    size_t linesToSkip = 0;
+    size_t line = static_cast<size_t>(m_RoiY0 + y) * stride + static_cast<size_t>(m_RoiX0);
+    qint64 offset = m_RowIndex.getLineOffset(line, linesToSkip);
+    const char* cursor = (offset < 0 || offset > end - begin) ? end : begin + offset;
+    for(size_t i = 0; i < linesToSkip && cursor < end; i++)
+    {
+      const char* lineEnd = TokenParser::findLineEnd(cursor, end);
+      cursor = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+    for(int x = 0; x < m_RoiWidth && cursor < end; x++)
+    {
+      const char* lineBegin = cursor;
+      const char* lineEnd = TokenParser::findLineEnd(cursor, end);
+      cursor = (lineEnd < end) ? lineEnd + 1 : end;
+      parseDataLine(lineBegin, lineEnd, counter);
+      if(getErrorCode() < 0)
+      {
+        QString msg;
+        QTextStream ss(&msg);
+        ss << "Error parsing the data line (Numeric conversion). Error code is " << getErrorCode() << " and occurred at data column " << m_ErrorColumn << " (Zero Based)\n"
+           << textModeLine(lineBegin, cursor) << "\n***Parsing Position ***\nCurrent Row: " << (m_RoiY0 + y) << "  Current Column Index: " << (m_RoiX0 + x) << "\n";
+        setErrorMessage(msg);
+        break;
+      }
+      ++counter;
+    }
+  }
+
+  if(getNumFeatures() < 10)
+  {
+    deallocateArrayData<float>(m_Fit);
+  }
+  if(getNumFeatures() < 9)
+  {
+    deallocateArrayData<float>(m_SEMSignal);
+  }
   if(getErrorCode() < 0)
   {
     return getErrorCode();
   }
-
+  if(counter != numPoints)
+  {
+    QString msg;
+    QTextStream ss(&msg);
+    ss << "End of ANG file reached before all data in the region of interest was parsed.\n"
+       << getFileName() << "\n*** Header information ***\nRows=" << numRows << " Cols=" << numCols << "  Region Data Points: " << numPoints << "\n***Parsing Position ***\nCurrent Data Point Count: " << counter
+       << "\n";
+    setErrorMessage(msg);
+    setErrorCode(-600);
+  }
   return getErrorCode();
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void AngReader::readData(QFile& in, QByteArray& buf)
+int AngReader::initPointers(size_t& totalDataPoints)
 {
-  QString streamBuf;
-  QTextStream ss(&streamBuf);
+  int err = calculateTotalDataPoints(totalDataPoints);
+  if(err < 0)
+  {
+    return err;
+  }
 
-  size_t totalDataPoints = 0;
+  // Initialize all the pointers and allocate memory
+  setNumberOfElements(totalDataPoints);
+  return allocateColumns(totalDataPoints, true);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::calculateTotalDataPoints(size_t& totalDataPoints)
+{
+  totalDataPoints = 0;
 
   QString grid = getGrid();
 
@@ -367,7 +784,7 @@ void AngReader::readData(QFile& in, QByteArray& buf)
   {
     setErrorCode(-200);
     setErrorMessage("NumRows Sanity Check not correct. Check the entry for NROWS in the .ang file");
-    return;
+    return -200;
   }
   if(grid.startsWith(EbsdLib::Ang::SquareGrid))
   {
@@ -388,7 +805,7 @@ void AngReader::readData(QFile& in, QByteArray& buf)
   {
     setErrorCode(-400);
     setErrorMessage("Ang Files with Hex Grids Are NOT currently supported - Try converting them to Square Grid with the Hex2Sqr Converter filter.");
-    return;
+    return -400;
   }
   else if(grid.startsWith(EbsdLib::Ang::HexGrid) && m_ReadHexGrid)
   {
@@ -412,50 +829,96 @@ void AngReader::readData(QFile& in, QByteArray& buf)
   {
     setErrorMessage("Ang file is missing the 'GRID' header entry.");
     setErrorCode(-300);
-    return;
+    return -300;
   }
+  return 0;
+}
 
-  // Initialize all the pointers and allocate memory
-  setNumberOfElements(totalDataPoints);
-  size_t numBytes = totalDataPoints * sizeof(float);
-  m_Phi1 = allocateArray<float>(totalDataPoints);
-  m_Phi = allocateArray<float>(totalDataPoints);
-  m_Phi2 = allocateArray<float>(totalDataPoints);
-  m_Iq = allocateArray<float>(totalDataPoints);
-  m_Ci = allocateArray<float>(totalDataPoints);
-  m_PhaseData = allocateArray<int>(totalDataPoints);
-  m_X = allocateArray<float>(totalDataPoints);
-  m_Y = allocateArray<float>(totalDataPoints);
-  m_SEMSignal = allocateArray<float>(totalDataPoints);
-  m_Fit = allocateArray<float>(totalDataPoints);
-
-  ::memset(m_Phi1, 0, numBytes);
-  ::memset(m_Phi, 0, numBytes);
-  ::memset(m_Phi2, 0, numBytes);
-  ::memset(m_Iq, 0, numBytes);
-  ::memset(m_Ci, 0, numBytes);
-  ::memset(m_PhaseData, 0, numBytes);
-  ::memset(m_X, 0, numBytes);
-  ::memset(m_Y, 0, numBytes);
-  ::memset(m_SEMSignal, 0, numBytes);
-  ::memset(m_Fit, 0, numBytes);
-
-  if(nullptr == m_Phi1 || nullptr == m_Phi || nullptr == m_Phi2 || nullptr == m_Iq || nullptr == m_SEMSignal || nullptr == m_Ci || nullptr == m_PhaseData || m_X == nullptr || m_Y == nullptr)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::allocateColumns(size_t numElements, bool useDestinationBuffers)
+{
+  if(m_ArrayNames.empty() && !m_ReadAllArrays)
   {
-    ss.string()->clear();
+    setErrorCode(-121);
+    setErrorMessage("AngReader Error: ReadAllArrays was FALSE and no other arrays were requested to be read.");
+    return -121;
+  }
+  if(useDestinationBuffers && checkDestinationBuffers(numElements) < 0)
+  {
+    return getErrorCode();
+  }
+
+  // Columns that were not requested stay nullptr and are skipped when the data is parsed. The
+  // strides are kept in the order the columns appear in the file.
+  bool allocated = true;
+  m_Phi1 = allocateColumn<float>(EbsdLib::Ang::Phi1, numElements, useDestinationBuffers, m_ColumnStrides[0], allocated);
+  m_Phi = allocateColumn<float>(EbsdLib::Ang::Phi, numElements, useDestinationBuffers, m_ColumnStrides[1], allocated);
+  m_Phi2 = allocateColumn<float>(EbsdLib::Ang::Phi2, numElements, useDestinationBuffers, m_ColumnStrides[2], allocated);
+  m_X = allocateColumn<float>(EbsdLib::Ang::XPosition, numElements, useDestinationBuffers, m_ColumnStrides[3], allocated);
+  m_Y = allocateColumn<float>(EbsdLib::Ang::YPosition, numElements, useDestinationBuffers, m_ColumnStrides[4], allocated);
+  m_Iq = allocateColumn<float>(EbsdLib::Ang::ImageQuality, numElements, useDestinationBuffers, m_ColumnStrides[5], allocated);
+  m_Ci = allocateColumn<float>(EbsdLib::Ang::ConfidenceIndex, numElements, useDestinationBuffers, m_ColumnStrides[6], allocated);
+  m_PhaseData = allocateColumn<int>(EbsdLib::Ang::PhaseData, numElements, useDestinationBuffers, m_ColumnStrides[7], allocated);
+  m_SEMSignal = allocateColumn<float>(EbsdLib::Ang::SEMSignal, numElements, useDestinationBuffers, m_ColumnStrides[8], allocated);
+  m_Fit = allocateColumn<float>(EbsdLib::Ang::Fit, numElements, useDestinationBuffers, m_ColumnStrides[9], allocated);
+
+  if(!allocated)
+  {
+    QString msg;
+    QTextStream ss(&msg);
     ss << "Internal pointers were nullptr at " << __FILE__ << "(" << __LINE__ << ")\n";
-    setErrorMessage(*(ss.string()));
+    setErrorMessage(msg);
     setErrorCode(-2500);
+    return -2500;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AngReader::freeColumns()
+{
+  deallocateArrayData<float>(m_Phi1);
+  deallocateArrayData<float>(m_Phi);
+  deallocateArrayData<float>(m_Phi2);
+  deallocateArrayData<float>(m_Iq);
+  deallocateArrayData<float>(m_Ci);
+  deallocateArrayData<int32_t>(m_PhaseData);
+  deallocateArrayData<float>(m_X);
+  deallocateArrayData<float>(m_Y);
+  deallocateArrayData<float>(m_SEMSignal);
+  deallocateArrayData<float>(m_Fit);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AngReader::readData(QIODevice& in, QByteArray& buf)
+{
+  QString streamBuf;
+  QTextStream ss(&streamBuf);
+
+  size_t totalDataPoints = 0;
+  if(initPointers(totalDataPoints) < 0)
+  {
     return;
   }
 
+  int nOddCols = getNumOddCols();
+  int nEvenCols = getNumEvenCols();
+  int numRows = getNumRows();
+
   size_t counter = 1; // Because we are on the first line now.
 
   bool onEvenRow = false;
   int col = 0;
 
   int yChange = 0;
-  float oldY = m_Y[0];
+  const size_t yStride = m_ColumnStrides[4];
+  float oldY = (nullptr != m_Y) ? m_Y[0] : 0.0f;
   int nxOdd = 0;
   int nxEven = 0;
   // int nRows = 0;
@@ -480,10 +943,10 @@ void AngReader::readData(QFile& in, QByteArray& buf)
       break;
     }
 
-    if(fabs(m_Y[i] - oldY) > 1e-6)
+    if(nullptr != m_Y && fabs(m_Y[i * yStride] - oldY) > 1e-6)
     {
       ++yChange;
-      oldY = m_Y[i];
+      oldY = m_Y[i * yStride];
       onEvenRow = !onEvenRow;
       col = 0;
     }
@@ -537,6 +1000,95 @@ void AngReader::readData(QFile& in, QByteArray& buf)
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AngReader::readMappedData(const char* lineBegin, const char* lineEnd, const char* end)
+{
+  size_t totalDataPoints = 0;
+  if(initPointers(totalDataPoints) < 0)
+  {
+    return;
+  }
+
+  int nOddCols = getNumOddCols();
+  int nEvenCols = getNumEvenCols();
+  int numRows = getNumRows();
+
+  const char* cursor = (lineEnd < end) ? lineEnd + 1 : end;
+  size_t counter = 1; // Because we are on the first line now.
+
+  bool onEvenRow = false;
+  int col = 0;
+
+  int yChange = 0;
+  const size_t yStride = m_ColumnStrides[4];
+  float oldY = (nullptr != m_Y) ? m_Y[0] : 0.0f;
+
+  for(size_t i = 0; i < totalDataPoints; ++i)
+  {
+    if(i > 0)
+    {
+      lineBegin = cursor;
+      lineEnd = TokenParser::findLineEnd(cursor, end);
+      cursor = (lineEnd < end) ? lineEnd + 1 : end;
+      ++counter;
+    }
+    parseDataLine(lineBegin, lineEnd, i);
+    if(getErrorCode() < 0)
+    {
+      QString msg;
+      QTextStream ss(&msg);
+      ss << "Error parsing the data line (Numeric conversion). Error code is " << getErrorCode() << " and occurred at data column " << m_ErrorColumn << " (Zero Based)\n"
+         << textModeLine(lineBegin, cursor) << "\n*** Header information ***\nRows=" << numRows << " EvenCols=" << nEvenCols << " OddCols=" << nOddCols
+         << "  Calculated Data Points: " << totalDataPoints << "\n***Parsing Position ***\nCurrent Row: " << yChange << "  Current Column Index: " << col
+         << "  Current Data Point Count: " << counter << "\n";
+      setErrorMessage(msg);
+      break;
+    }
+
+    if(nullptr != m_Y && fabs(m_Y[i * yStride] - oldY) > 1e-6)
+    {
+      ++yChange;
+      oldY = m_Y[i * yStride];
+      onEvenRow = !onEvenRow;
+      col = 0;
+    }
+    else
+    {
+      col++;
+    }
+    if(cursor >= end)
+    {
+      break;
+    }
+  }
+
+  if(getNumFeatures() < 10)
+  {
+    deallocateArrayData<float>(m_Fit);
+  }
+  if(getNumFeatures() < 9)
+  {
+    deallocateArrayData<float>(m_SEMSignal);
+  }
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  if(counter != totalDataPoints && cursor >= end)
+  {
+    QString msg;
+    QTextStream ss(&msg);
+    ss << "End of ANG file reached before all data was parsed.\n"
+       << getFileName() << "\n*** Header information ***\nRows=" << numRows << " EvenCols=" << nEvenCols << " OddCols=" << nOddCols << "  Calculated Data Points: " << totalDataPoints
+       << "\n***Parsing Position ***\nCurrent Row: " << yChange << "  Current Column Index: " << col << "  Current Data Point Count: " << counter << "\n";
+    setErrorMessage(msg);
+    setErrorCode(-600);
+  }
+}
+
 // -----------------------------------------------------------------------------
 //  Read the Header part of the ANG file
 // -----------------------------------------------------------------------------
@@ -685,136 +1237,95 @@ void AngReader::parseDataLine(QByteArray& line, size_t i)
    * Some TSL ang files do NOT have all 10 columns. Assume these are lacking the last
    * 2 columns and all the other columns are the same as above.
    */
+  parseDataLine(line.constData(), line.constData() + line.size(), i);
+}
+
+// -----------------------------------------------------------------------------
+//  Read the data part of the ANG file directly from the memory of the line
+// -----------------------------------------------------------------------------
+void AngReader::parseDataLine(const char* first, const char* last, size_t i)
+{
+  /* The columns are the same as the QByteArray version of this function. The line is
+   * tokenized in place on white space, which gives the same tokens as
+   * line.trimmed().simplified().split(' ') without any allocations.
+   */
+  const int k_MaxTokens = 10;
+  TokenParser::Token tokens[k_MaxTokens];
+  int numTokens = std::min(TokenParser::splitOnWhiteSpace(first, last, tokens, k_MaxTokens), k_MaxTokens);
+
   m_ErrorColumn = 0;
-  float p1 = 0.0f;
-  float p = 0.0f;
-  float p2 = 0.0f;
-  float x = -1.0f;
-  float y = -1.0f;
-  float iqual = -1.0f;
-  float conf = -1.0f;
-  float semSignal = -1.0f;
-  float fit = -1.0f;
-  int ph = 0;
-  size_t offset = 0;
-  QList<QByteArray> tokens = line.trimmed().simplified().split(' ');
   bool ok = true;
-  offset = i;
-  if(!tokens.empty())
+  float* const floatColumns[k_MaxTokens] = {m_Phi1, m_Phi, m_Phi2, m_X, m_Y, m_Iq, m_Ci, nullptr, m_SEMSignal, m_Fit};
+  for(int t = 0; t < numTokens; t++)
   {
-    p1 = tokens[0].toFloat(&ok);
-    if(!ok)
+    if(t == 7)
     {
-      setErrorCode(-2501);
-      m_ErrorColumn = 0;
-    }
-    m_Phi1[offset] = p1;
-  }
-  if(tokens.size() >= 2)
-  {
-    p = tokens[1].toFloat(&ok);
-    if(!ok)
-    {
-      setErrorCode(-2502);
-      m_ErrorColumn = 1;
-    }
-    m_Phi[offset] = p;
-  }
-  if(tokens.size() >= 3)
-  {
-    p2 = tokens[2].toFloat(&ok);
-    if(!ok)
-    {
-      setErrorCode(-2503);
-      m_ErrorColumn = 2;
-    }
-    m_Phi2[offset] = p2;
-  }
-  if(tokens.size() >= 4)
-  {
-    x = tokens[3].toFloat(&ok);
-    if(!ok)
-    {
-      setErrorCode(-2504);
-      m_ErrorColumn = 3;
-    }
-    m_X[offset] = x;
-  }
-  if(tokens.size() >= 5)
-  {
-    y = tokens[4].toFloat(&ok);
-    if(!ok)
-    {
-      setErrorCode(-2505);
-      m_ErrorColumn = 4;
-    }
-    m_Y[offset] = y;
-  }
-  if(tokens.size() >= 6)
-  {
-    iqual = tokens[5].toFloat(&ok);
-    if(!ok)
-    {
-      setErrorCode(-2506);
-      m_ErrorColumn = 5;
-    }
-    m_Iq[offset] = iqual;
-  }
-  if(tokens.size() >= 7)
-  {
-    conf = tokens[6].toFloat(&ok);
-    if(!ok)
-    {
-      setErrorCode(-2507);
-      m_ErrorColumn = 6;
-    }
-    m_Ci[offset] = conf;
-  }
-  if(tokens.size() >= 8)
-  {
-    ph = tokens[7].toInt(&ok);
-    if(!ok)
-    { 
-      setErrorCode(-2508);
-      m_ErrorColumn = 7;
-      // Some have floats instead of integers so lets try that.
-      float f = tokens[7].toFloat(&ok);
-      if(!ok)
+      if(nullptr == m_PhaseData)
       {
-        setErrorCode(-2588);
-        m_ErrorColumn = 7;
+        continue;
       }
-      else
+      int32_t ph = TokenParser::toInt32(tokens[t].first, tokens[t].last, &ok);
+      if(!ok)
       {
-        setErrorCode(0);
-        ph = static_cast<int32_t>(f);
+        setErrorCode(-2508);
+        m_ErrorColumn = 7;
+        // Some have floats instead of integers so lets try that.
+        float f = TokenParser::toFloat(tokens[t].first, tokens[t].last, &ok);
+        if(!ok)
+        {
+          setErrorCode(-2588);
+          m_ErrorColumn = 7;
+        }
+        else
+        {
+          setErrorCode(0);
+          ph = static_cast<int32_t>(f);
+        }
       }
+      m_PhaseData[i * m_ColumnStrides[7]] = ph;
+      continue;
     }
-    m_PhaseData[offset] = ph;
-  }
-
-  if(tokens.size() >= 9)
-  {
-    semSignal = tokens[8].toFloat(&ok);
-    if(!ok)
+    if(nullptr == floatColumns[t])
     {
-      setErrorCode(-2509);
-      m_ErrorColumn = 8;
+      continue;
     }
-    m_SEMSignal[offset] = semSignal;
-  }
-  if(tokens.size() >= 10)
-  {
-    fit = tokens[9].toFloat(&ok);
+    float value = TokenParser::toFloat(tokens[t].first, tokens[t].last, &ok);
     if(!ok)
     {
-      setErrorCode(-2510);
-      m_ErrorColumn = 9;
+      setErrorCode(-2501 - t);
+      m_ErrorColumn = t;
     }
-    m_Fit[offset] = fit;
+    floatColumns[t][i * m_ColumnStrides[t]] = value;
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AngReader::setArraysToRead(const QSet<QString>& names)
+{
+  m_ArrayNames = names;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AngReader::readAllArrays(bool b)
+{
+  m_ReadAllArrays = b;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AngReader::setRegionOfInterest(int x0, int y0, int width, int height)
+{
+  m_RoiX0 = x0;
+  m_RoiY0 = y0;
+  m_RoiWidth = width;
+  m_RoiHeight = height;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -847,3 +1358,56 @@ void AngReader::setYDimension(int ydim)
 {
   setNumRows(ydim);
 }
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int AngReader::writeFile(const QString& filepath)
+{
+  FILE* f = fopen(filepath.toLatin1().data(), "wb");
+  if(nullptr == f)
+  {
+    return -1;
+  }
+
+  QByteArray header = getOriginalHeader().toLatin1();
+  // After a region of interest read only the region is written so the header has to describe it
+  if(m_RoiWidth > 0 && m_RoiHeight > 0)
+  {
+    header = replaceHeaderValue(header, EbsdLib::Ang::NColsOdd, m_RoiWidth);
+    header = replaceHeaderValue(header, EbsdLib::Ang::NColsEven, m_RoiWidth);
+    header = replaceHeaderValue(header, EbsdLib::Ang::NRows, m_RoiHeight);
+  }
+  if(!header.isEmpty() && !header.endsWith('\n'))
+  {
+    header.append('\n');
+  }
+  fwrite(header.data(), 1, header.count(), f);
+
+  // The column widths match the files that the TSL software writes. Arrays that were not read
+  // (See setArraysToRead()) are written as zeros.
+  EbsdTextWriter writer;
+  writer.addFloatColumn(getPhi1Pointer(), 9, 5, ' ', getArrayStride(getPhi1Pointer()));
+  writer.addFloatColumn(getPhiPointer(), 9, 5, ' ', getArrayStride(getPhiPointer()));
+  writer.addFloatColumn(getPhi2Pointer(), 9, 5, ' ', getArrayStride(getPhi2Pointer()));
+  writer.addFloatColumn(getXPositionPointer(), 12, 5, ' ', getArrayStride(getXPositionPointer()));
+  writer.addFloatColumn(getYPositionPointer(), 12, 5, ' ', getArrayStride(getYPositionPointer()));
+  writer.addFloatColumn(getImageQualityPointer(), 6, 1, ' ', getArrayStride(getImageQualityPointer()));
+  writer.addFloatColumn(getConfidenceIndexPointer(), 6, 3, ' ', getArrayStride(getConfidenceIndexPointer()));
+  writer.addInt32Column(getPhaseDataPointer(), 2, ' ', getArrayStride(getPhaseDataPointer()));
+  if(getNumFeatures() >= 9)
+  {
+    writer.addFloatColumn(getSEMSignalPointer(), 6, 0, ' ', getArrayStride(getSEMSignalPointer()));
+  }
+  if(getNumFeatures() >= 10)
+  {
+    writer.addFloatColumn(getFitPointer(), 6, 3, ' ', getArrayStride(getFitPointer()));
+  }
+
+  int error = writer.writeRows(f, getNumberOfElements());
+
+  fclose(f);
+  f = nullptr;
+
+  return error;
+}
@@ -37,8 +37,11 @@
 
 #include <QtCore/QByteArray>
 #include <QtCore/QFile>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 
+#include <array>
+#include <cstring>
 #include <map>
 
 #include "AngConstants.h"
@@ -47,7 +50,9 @@
 
 #include "EbsdLib/Core/EbsdLibConstants.h"
 #include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/IO/EbsdCompressedFileDevice.h"
 #include "EbsdLib/IO/EbsdReader.h"
+#include "EbsdLib/IO/EbsdTextFileIndex.h"
 #include "EbsdLib/Core/EbsdSetGetMacros.h"
 
 /**
@@ -98,6 +103,22 @@ public:
 
   EBSD_INSTANCE_PROPERTY(bool, ReadHexGrid)
 
+  /**
+   * @brief When true (the default) the .ang file is memory mapped and the data section is
+   * tokenized in place, writing straight into the column arrays without any per line or
+   * per token heap allocations. If the file can not be mapped the reader silently falls
+   * back to reading the file line by line.
+   */
+  EBSD_INSTANCE_PROPERTY(bool, UseMemoryMappedFile)
+
+  /**
+   * @brief When true, region of interest reads store the row offset index of the file in a
+   * sidecar file next to it (See EbsdTextFileIndex) and reuse it on later reads, as long as the
+   * size and modification time of the .ang file are unchanged. Defaults to false, in which case
+   * the index is only kept in memory by this reader.
+   */
+  EBSD_INSTANCE_PROPERTY(bool, UseSidecarIndex)
+
   /**
    * @brief These methods allow the developer to set/get the raw pointer for a given array, release ownership of the memory
    * and forcibly release the memory for a given array.
@@ -146,27 +167,199 @@ public:
   EbsdLib::NumericTypes::Type getPointerType(const QString& featureName) override;
 
   /**
-   * @brief Reads the complete TSL .ang file.
+   * @brief Reads the complete TSL .ang file. gzip and zstd compressed files are detected and
+   * decompressed as a stream on a second thread (See EbsdCompressedFileDevice).
    * @return 1 on success
    */
   int readFile() override;
 
   /**
-   * @brief Reads ONLY the header portion of the TSL .ang file
+   * @brief Reads ONLY the header portion of the TSL .ang file. Calling this again for the same,
+   * unchanged file reuses the header that was already parsed.
    * @return 1 on success
    */
   int readHeaderOnly() override;
 
+  /**
+   * @brief Reads the TSL .ang file in batches of at most 'batchSize' scan points. The column
+   * arrays of this reader only ever hold a single batch and are released once the read is
+   * complete, so get[NAME]Pointer() returns nullptr afterwards.
+   * @param batchSize The maximum number of scan points in each batch
+   * @param callback Receives each batch in file order. Returning false stops the read.
+   * @return 0 on success or a negative error code.
+   */
+  int readFileInBatches(size_t batchSize, const EbsdRowBatchCallback& callback) override;
+
+  /**
+   * @brief Sets the names of the arrays to read out of the file. Columns that are not requested are
+   * neither allocated nor converted and their pointers stay nullptr. The names are the same names
+   * that getPointerByName() uses.
+   * @param names
+   */
+  void setArraysToRead(const QSet<QString>& names);
+
+  /**
+   * @brief Over rides the setArraysToReads to tell the reader to load ALL the data from the file. If the
+   * ArrayNames to read is empty and this is true then all arrays will be read.
+   * @param b
+   */
+  void readAllArrays(bool b);
+
+  /**
+   * @brief Restricts readFile() to a rectangular region of the scan. Only the rows of the region are
+   * visited, using a row offset index of the file to seek straight to them. The column arrays hold
+   * width * height points in row major order and getNumberOfElements() returns that count, while the
+   * header values still describe the complete scan. Only square grid files are supported. Passing a
+   * width or height of zero reads the complete scan again.
+   * @param x0 The first column of the region
+   * @param y0 The first row of the region
+   * @param width The number of columns in the region
+   * @param height The number of rows in the region
+   */
+  void setRegionOfInterest(int x0, int y0, int width, int height);
+
   int getXDimension() override;
   void setXDimension(int xdim) override;
   int getYDimension() override;
   void setYDimension(int ydim) override;
 
+  /**
+   * @brief Writes the original header and the data that was read to a .ang file. Arrays that were
+   * not read are written as zeros. After a region of interest read the NCOLS_ODD, NCOLS_EVEN and NROWS entries of the
+   * header are set to the size of the region.
+   * @param filepath
+   * @return Zero on success, -1 if the file could not be written
+   */
+  int writeFile(const QString& filepath);
+
 private:
   AngPhase::Pointer m_CurrentPhase;
   int m_ErrorColumn = 0;
+  std::array<size_t, 10> m_ColumnStrides = {{1, 1, 1, 1, 1, 1, 1, 1, 1, 1}};
+  QSet<QString> m_ArrayNames;
+  bool m_ReadAllArrays = true;
+  int m_RoiX0 = 0;
+  int m_RoiY0 = 0;
+  int m_RoiWidth = 0;
+  int m_RoiHeight = 0;
+  EbsdTextFileIndex m_RowIndex;
+  EbsdFileStamp m_HeaderStamp;
 
-  void readData(QFile& in, QByteArray& buf);
+  /**
+   * @brief Allocates and zeros a single column array if the column was requested.
+   * @param name The name of the column
+   * @param numElements The number of values in the column
+   * @param useDestinationBuffers Use the buffer the caller registered for the column if there is one
+   * @param stride Output: The number of elements between the values of two consecutive scan points
+   * @param allocated Output: Set to false if the memory could not be allocated
+   * @return The array or nullptr if the column was not requested or could not be allocated
+   */
+  template <typename T>
+  T* allocateColumn(const QString& name, size_t numElements, bool useDestinationBuffers, size_t& stride, bool& allocated)
+  {
+    stride = 1;
+    if(!m_ReadAllArrays && !m_ArrayNames.contains(name))
+    {
+      return nullptr;
+    }
+    T* ptr = useDestinationBuffers ? allocateColumnArray<T>(name, numElements, stride) : allocateArray<T>(numElements);
+    if(nullptr == ptr)
+    {
+      allocated = false;
+      return nullptr;
+    }
+    // A strided destination buffer is interleaved with other values that are not ours to clear
+    if(stride == 1)
+    {
+      ::memset(ptr, 0, numElements * sizeof(T));
+    }
+    return ptr;
+  }
+
+  /**
+   * @brief Computes the number of scan points from the header values and allocates all the
+   * column arrays.
+   * @param totalDataPoints Output: The number of scan points in the file
+   * @return Zero on success or a negative error code.
+   */
+  int initPointers(size_t& totalDataPoints);
+
+  /**
+   * @brief Computes the number of scan points from the grid type, number of rows and columns in the header.
+   * @param totalDataPoints Output: The number of scan points in the file
+   * @return Zero on success or a negative error code.
+   */
+  int calculateTotalDataPoints(size_t& totalDataPoints);
+
+  /**
+   * @brief Allocates and zeros every requested column array so that it can hold 'numElements' values.
+   * @param useDestinationBuffers Parse into the buffers registered with setDestinationBuffer()
+   * @return Zero on success or a negative error code.
+   */
+  int allocateColumns(size_t numElements, bool useDestinationBuffers);
+
+  /**
+   * @brief Frees every column array that this reader owns.
+   */
+  void freeColumns();
+
+  /**
+   * @brief Reads the header section of the file and verifies the header values.
+   * @param in The open .ang file (Either a QFile or an EbsdCompressedFileDevice)
+   * @param buf Output: The first line of data that follows the header
+   * @return Zero on success or a negative error code.
+   */
+  int readHeaderSection(QIODevice& in, QByteArray& buf);
+
+  /**
+   * @brief Verifies the header values that are needed to parse the data section.
+   * @return Zero on success or a negative error code.
+   */
+  int checkHeaderValues();
+
+  void readData(QIODevice& in, QByteArray& buf);
+
+  /**
+   * @brief Reads the complete .ang file from a memory mapped view of the file.
+   * @param begin First byte of the file
+   * @param end One past the last byte of the file
+   * @return Zero on success or a negative error code.
+   */
+  int readMappedFile(const char* begin, const char* end);
+
+  /**
+   * @brief Parses the header section from a memory mapped view of the file and verifies the header values.
+   * @param begin First byte of the file
+   * @param end One past the last byte of the file
+   * @param lineBegin Output: Start of the first data line
+   * @param lineEnd Output: End of the first data line
+   * @return Zero on success or a negative error code.
+   */
+  int readMappedHeader(const char* begin, const char* end, const char*& lineBegin, const char*& lineEnd);
+
+  /**
+   * @brief Reads the header and the region of interest of the .ang file.
+   * @param in The open .ang file
+   * @return Zero on success or a negative error code.
+   */
+  int readRegionOfInterest(QFile& in);
+
+  /**
+   * @brief Parses only the lines of the region of interest from a memory mapped view of the file.
+   * @param begin First byte of the file
+   * @param dataBegin Start of the first data line
+   * @param end One past the last byte of the file
+   * @return Zero on success or a negative error code.
+   */
+  int readMappedRegion(const char* begin, const char* dataBegin, const char* end);
+
+  /**
+   * @brief Parses the data section from a memory mapped view of the file.
+   * @param lineBegin Start of the first data line
+   * @param lineEnd End of the first data line (Either the newline or the end of the file)
+   * @param end One past the last byte of the file
+   */
+  void readMappedData(const char* lineBegin, const char* lineEnd, const char* end);
 
   /** @brief Parses the value from a single line of the header section of the TSL .ang file
    * @param line The line to parse
@@ -178,6 +371,13 @@ private:
    */
   void parseDataLine(QByteArray& line, size_t i);
 
+  /** @brief Parses the data from a line of data from the TSL .ang file without making any copies of the line
+   * @param first Start of the line
+   * @param last End of the line
+   * @param i The index of the scan point
+   */
+  void parseDataLine(const char* first, const char* last, size_t i);
+
 public:
   AngReader(const AngReader&) = delete;            // Copy Constructor Not Implemented
   AngReader(AngReader&&) = delete;                 // Move Constructor Not Implemented
@@ -35,11 +35,15 @@
 
 #include "H5AngImporter.h"
 
+#include <algorithm>
+
 #include "H5Support/QH5Lite.h"
 #include "H5Support/QH5Utilities.h"
 
 #include "EbsdLib/Core/EbsdLibConstants.h"
 #include "EbsdLib/EbsdLibVersion.h"
+#include "EbsdLib/IO/H5ChunkedLayout.hpp"
+#include "EbsdLib/IO/EbsdSliceImportPipeline.hpp"
 
 
 #if defined (H5Support_NAMESPACE)
@@ -52,6 +56,18 @@ using namespace H5Support_NAMESPACE;
   if (m_Cancel == true){\
     break; }
 
+namespace
+{
+/**
+ * @brief A parsed .ang file and the error code of the parse that the batch import hands from the
+ * parsing threads to the writing thread
+ */
+struct AngSlice
+{
+  AngReader reader;
+  int err = 0;
+};
+} // namespace
 
 // -----------------------------------------------------------------------------
 //
@@ -62,6 +78,7 @@ H5AngImporter::H5AngImporter()
 , xRes(0)
 , yRes(0)
 , m_FileVersion(EbsdLib::H5OIM::FileVersion)
+, m_NumSlicesImported(1)
 {
 }
 
@@ -100,7 +117,7 @@ H5AngImporter::~H5AngImporter() = default;
   {\
     m_msgType* dataPtr = reader.get##prpty##Pointer();\
     if (nullptr != dataPtr) {\
-      err = QH5Lite::writePointerDataset(gid, key, rank, dims, dataPtr);\
+      err = EbsdLib::H5ChunkedLayout::writeDataset(gid, key, rank, dims, static_cast<size_t>(xDim), getChunkRows(), getCompressionLevel(), dataPtr);\
       if (err < 0) {\
         ss.string()->clear();\
         ss << "H5AngImporter Error: Could not write Ang Data array for '" << key\
@@ -134,7 +151,7 @@ void H5AngImporter::getSpacing(float& x, float& y)
 // -----------------------------------------------------------------------------
 int H5AngImporter::numberOfSlicesImported()
 {
-  return 1;
+  return m_NumSlicesImported;
 }
 
 
@@ -146,9 +163,8 @@ int H5AngImporter::importFile(hid_t fileId, int64_t z, const QString& angFile)
   herr_t err = -1;
   setCancel(false);
   setErrorCode(0);
+  m_NumSlicesImported = 1;
   //setPipelineMessage("");
-  QString streamBuf;
-  QTextStream ss(&streamBuf);
 
   //  std::cout << "H5AngImporter: Importing " << angFile;
   AngReader reader;
@@ -160,71 +176,139 @@ int H5AngImporter::importFile(hid_t fileId, int64_t z, const QString& angFile)
   // Check for errors
   if (err < 0)
   {
-    if (err == -400)
-    {
-      ss << "H5AngImporter Error: HexGrid Files are not currently supported.";
-    }
-    else if (err == -300)
-    {
-      ss << "H5AngImporter Error: Grid was NOT set in the header.";
-    }
-    else if (err == -200)
-    {
-      ss << "H5AngImporter Error: There was no data in the file.";
-    }
-    else if (err == -100)
-    {
-      ss << "H5AngImporter Error: The Ang file could not be opened.'" << angFile << "'";
-    }
-    else if (reader.getXStep() == 0.0f)
-    {
-      ss << "H5AngImporter Error: X Step value equals 0.0. This is bad. Please check the validity of the ANG file.";
-    }
-    else if(reader.getYStep() == 0.0f)
-    {
-      ss << "H5AngImporter Error: Y Step value equals 0.0. This is bad. Please check the validity of the ANG file.";
-    }
-    else
-    {
-      ss << "H5AngImporter Error: Unknown error [" << err << "]";
-    }
-    // setPipelineMessage( *(ss.string()));
-
-    setErrorCode(err);
-    progressMessage(*(ss.string()), 100);
+    reportReadError(reader, err, angFile);
     return -1;
   }
 
-  // Write the file Version number to the file
-  {
-    QVector<hsize_t> dims;
-    H5T_class_t type_class;
-    size_t type_size = 0;
-    hid_t attr_type = -1;
-    err = QH5Lite::getAttributeInfo(fileId, "/", EbsdLib::H5OIM::FileVersionStr, dims, type_class, type_size, attr_type);
-    if (attr_type < 0) // The attr_type variable was never set which means the attribute was NOT there
-    {
-      // The file version does not exist so write it to the file
-      err = QH5Lite::writeScalarAttribute(fileId, QString("/"), EbsdLib::H5OIM::FileVersionStr, m_FileVersion);
-    }
-    else
+  writeFileVersion(fileId);
+
+  return writeSliceData(fileId, z, reader, angFile);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5AngImporter::importFiles(hid_t fileId, int64_t z, const QStringList& angFiles)
+{
+  setCancel(false);
+  setErrorCode(0);
+  m_NumSlicesImported = 0;
+
+  // The files are parsed on the worker threads of the pipeline, all HDF5 calls stay on this thread
+  auto parse = [&angFiles](size_t index) {
+    std::unique_ptr<AngSlice> slice(new AngSlice);
+    slice->reader.setFileName(angFiles[static_cast<int>(index)]);
+    slice->err = slice->reader.readFile();
+    return slice;
+  };
+
+  auto write = [this, fileId, z, &angFiles](size_t index, AngSlice& slice) {
+    const QString& angFile = angFiles[static_cast<int>(index)];
+    if(slice.err < 0)
     {
-      H5Aclose(attr_type);
+      reportReadError(slice.reader, slice.err, angFile);
+      return -1;
     }
-
-    err = QH5Lite::getAttributeInfo(fileId, "/", EbsdLib::H5OIM::EbsdLibVersionStr, dims, type_class, type_size, attr_type);
-    if (attr_type < 0) // The attr_type variable was never set which means the attribute was NOT there
+    if(0 == index)
     {
-      // The file version does not exist so write it to the file
-      err = QH5Lite::writeStringAttribute(fileId, QString("/"), EbsdLib::H5OIM::EbsdLibVersionStr, EbsdLib::Version::Complete());
+      writeFileVersion(fileId);
     }
-    else
+    int err = writeSliceData(fileId, z + static_cast<int64_t>(index), slice.reader, angFile);
+    if(err >= 0)
     {
-      H5Aclose(attr_type);
+      ++m_NumSlicesImported;
+      progressMessage(QString("Imported %1 of %2 files").arg(index + 1).arg(angFiles.size()), static_cast<int>(100 * (index + 1) / angFiles.size()));
     }
+    return err;
+  };
+
+  EbsdSliceImportPipeline<AngSlice> pipeline(static_cast<size_t>(angFiles.size()), static_cast<size_t>(std::max(getNumberOfParseThreads(), 0)),
+                                              static_cast<size_t>(std::max(getMaxQueuedFiles(), 1)));
+  return pipeline.run(parse, write, [this]() { return getCancel(); });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5AngImporter::reportReadError(AngReader& reader, int err, const QString& angFile)
+{
+  QString streamBuf;
+  QTextStream ss(&streamBuf);
+  if (err == -400)
+  {
+    ss << "H5AngImporter Error: HexGrid Files are not currently supported.";
+  }
+  else if (err == -300)
+  {
+    ss << "H5AngImporter Error: Grid was NOT set in the header.";
+  }
+  else if (err == -200)
+  {
+    ss << "H5AngImporter Error: There was no data in the file.";
+  }
+  else if (err == -100)
+  {
+    ss << "H5AngImporter Error: The Ang file could not be opened.'" << angFile << "'";
+  }
+  else if (reader.getXStep() == 0.0f)
+  {
+    ss << "H5AngImporter Error: X Step value equals 0.0. This is bad. Please check the validity of the ANG file.";
+  }
+  else if(reader.getYStep() == 0.0f)
+  {
+    ss << "H5AngImporter Error: Y Step value equals 0.0. This is bad. Please check the validity of the ANG file.";
+  }
+  else
+  {
+    ss << "H5AngImporter Error: Unknown error [" << err << "]";
+  }
+  // setPipelineMessage( *(ss.string()));
+  setErrorCode(err);
+  progressMessage(*(ss.string()), 100);
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5AngImporter::writeFileVersion(hid_t fileId)
+{
+  herr_t err = 0;
+  QVector<hsize_t> dims;
+  H5T_class_t type_class;
+  size_t type_size = 0;
+  hid_t attr_type = -1;
+  err = QH5Lite::getAttributeInfo(fileId, "/", EbsdLib::H5OIM::FileVersionStr, dims, type_class, type_size, attr_type);
+  if (attr_type < 0) // The attr_type variable was never set which means the attribute was NOT there
+  {
+    // The file version does not exist so write it to the file
+    err = QH5Lite::writeScalarAttribute(fileId, QString("/"), EbsdLib::H5OIM::FileVersionStr, m_FileVersion);
+  }
+  else
+  {
+    H5Aclose(attr_type);
+  }
 
+  err = QH5Lite::getAttributeInfo(fileId, "/", EbsdLib::H5OIM::EbsdLibVersionStr, dims, type_class, type_size, attr_type);
+  if (attr_type < 0) // The attr_type variable was never set which means the attribute was NOT there
+  {
+    // The file version does not exist so write it to the file
+    err = QH5Lite::writeStringAttribute(fileId, QString("/"), EbsdLib::H5OIM::EbsdLibVersionStr, EbsdLib::Version::Complete());
+  }
+  else
+  {
+    H5Aclose(attr_type);
   }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5AngImporter::writeSliceData(hid_t fileId, int64_t z, AngReader& reader, const QString& angFile)
+{
+  herr_t err = 0;
+  QString streamBuf;
+  QTextStream ss(&streamBuf);
 
   // Start creating the HDF5 group structures for this file
   hid_t angGroup = QH5Utilities::createGroup(fileId, QString::number(z));
@@ -318,7 +402,6 @@ int H5AngImporter::importFile(hid_t fileId, int64_t z, const QString& angFile)
   return err;
 }
 
-
 #define WRITE_PHASE_HEADER_DATA(reader, m_msgType, prpty, key)\
   {\
     m_msgType t = reader->get##prpty();\
@@ -89,6 +89,19 @@ class EbsdLib_EXPORT H5AngImporter : public EbsdImporter
      */
     int importFile(hid_t fileId, int64_t z, const QString& angFile) override;
 
+    /**
+     * @brief Imports a stack of .ang files into the HDF5 file. The files are parsed concurrently on
+     * NumberOfParseThreads worker threads while this thread writes the parsed files in order, so file i
+     * is always stored in the group for slice z + i. At most MaxQueuedFiles parsed files are held in
+     * memory at once.
+     * @param fileId The valid HDF5 file Id for an already open HDF5 file
+     * @param z The slice index for the first file
+     * @param angFiles The absolute paths to the input .ang files in slice order
+     * @return Zero on success, negative if a file could not be read or written. No files after the
+     * failed file are imported.
+     */
+    int importFiles(hid_t fileId, int64_t z, const QStringList& angFiles) override;
+
     /**
      * @brief Writes the phase data into the HDF5 file
      * @param reader Valid AngReader instance
@@ -135,6 +148,21 @@ class EbsdLib_EXPORT H5AngImporter : public EbsdImporter
   protected:
     H5AngImporter();
 
+    /**
+     * @brief Reports the error of a failed read through progressMessage() and the ErrorCode
+     */
+    void reportReadError(AngReader& reader, int err, const QString& angFile);
+
+    /**
+     * @brief Writes the file version attributes if the file does not have them yet
+     */
+    int writeFileVersion(hid_t fileId);
+
+    /**
+     * @brief Writes the header and the data of a parsed file into the group for slice z
+     */
+    int writeSliceData(hid_t fileId, int64_t z, AngReader& reader, const QString& angFile);
+
 
   private:
 
@@ -144,6 +172,7 @@ class EbsdLib_EXPORT H5AngImporter : public EbsdImporter
     float xRes;
     float yRes;
     int   m_FileVersion;
+    int   m_NumSlicesImported;
 
   public:
     H5AngImporter(const H5AngImporter&) = delete;  // Copy Constructor Not Implemented
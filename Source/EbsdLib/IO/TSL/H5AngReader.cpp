@@ -49,6 +49,7 @@
 
 #include "EbsdLib/Core/EbsdLibConstants.h"
 #include "EbsdLib/Core/EbsdMacros.h"
+#include "EbsdLib/IO/H5ScanRegion.hpp"
 
 #if defined (H5Support_NAMESPACE)
 using namespace H5Support_NAMESPACE;
@@ -79,6 +80,30 @@ int H5AngReader::readFile()
     return err;
   }
 
+  if(nullptr != m_H5EbsdFile)
+  {
+    // The group belongs to the shared file and stays open for the next reader of the slice
+    hid_t gid = m_H5EbsdFile->getGroup(m_HDF5Path);
+    if(gid < 0)
+    {
+      qDebug() << "H5AngReader Error: Could not open path '" << m_HDF5Path << "'";
+      return -1;
+    }
+    err = readHeader(gid);
+    if(err < 0)
+    {
+      qDebug() << "H5AngReader Error: could not read header";
+      return err;
+    }
+    err = readData(gid);
+    if(err < 0)
+    {
+      qDebug() << "H5AngReader Error: could not read data";
+      return err;
+    }
+    return getErrorCode();
+  }
+
   hid_t fileId = QH5Utilities::openFile(getFileName(), true);
   if (fileId < 0)
   {
@@ -143,6 +168,18 @@ int H5AngReader::readHeaderOnly()
     return -1;
   }
 
+  if(nullptr != m_H5EbsdFile)
+  {
+    // The group belongs to the shared file and stays open for the next reader of the slice
+    hid_t gid = m_H5EbsdFile->getGroup(m_HDF5Path);
+    if(gid < 0)
+    {
+      qDebug() << "H5AngReader Error: Could not open path '" << m_HDF5Path << "'";
+      return -1;
+    }
+    return readHeader(gid);
+  }
+
   hid_t fileId = QH5Utilities::openFile(getFileName().toLatin1().data(), true);
   if (fileId < 0)
   {
@@ -318,6 +355,8 @@ int H5AngReader::readData(hid_t parId)
   size_t nOddCols = getNumOddCols();
   size_t nEvenCols = getNumEvenCols();
   size_t nRows = getNumRows();
+  // The number of columns that the data arrays were written with
+  size_t nColumns = (nOddCols > 0) ? nOddCols : nEvenCols;
 
   if (nRows < 1)
   {
@@ -355,6 +394,28 @@ int H5AngReader::readData(hid_t parId)
     return -300;
   }
 
+  // Only the rows and columns of the region of interest are read when one was set
+  if(m_RoiWidth > 0 && m_RoiHeight > 0)
+  {
+    if(!EbsdLib::H5ScanRegion::fitsInScan(m_RoiX0, m_RoiY0, m_RoiWidth, m_RoiHeight, nColumns, nRows))
+    {
+      QString msg;
+      QTextStream ss(&msg);
+      ss << "The region of interest X=" << m_RoiX0 << " Y=" << m_RoiY0 << " Width=" << m_RoiWidth << " Height=" << m_RoiHeight << " does not fit inside the slice of " << nColumns << " x " << nRows
+         << " points.";
+      setErrorCode(-90302);
+      setErrorMessage(msg);
+      return -302;
+    }
+    totalDataRows = static_cast<size_t>(m_RoiWidth) * static_cast<size_t>(m_RoiHeight);
+  }
+
+  // Buffers the caller registered must hold every scan point before HDF5 writes into them
+  if(checkDestinationBuffers(totalDataRows) < 0)
+  {
+    return getErrorCode();
+  }
+
   hid_t gid = H5Gopen(parId, EbsdLib::H5OIM::Data.toLatin1().data(), H5P_DEFAULT);
   if (gid < 0)
   {
@@ -419,6 +480,25 @@ void H5AngReader::readAllArrays(bool b)
   m_ReadAllArrays = b;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5AngReader::setH5EbsdFile(const H5EbsdFile::Pointer& file)
+{
+  m_H5EbsdFile = file;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5AngReader::setRegionOfInterest(int x0, int y0, int width, int height)
+{
+  m_RoiX0 = x0;
+  m_RoiY0 = y0;
+  m_RoiWidth = width;
+  m_RoiHeight = height;
+}
+
 // -----------------------------------------------------------------------------
 H5AngReader::Pointer H5AngReader::NullPointer()
 {
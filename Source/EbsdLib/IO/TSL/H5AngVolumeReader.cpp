@@ -36,7 +36,9 @@
 
 #include "H5AngVolumeReader.h"
 
+#include <array>
 #include <cmath>
+#include <memory>
 
 #include <QtCore/QString>
 
@@ -44,12 +46,29 @@
 #include "H5Support/QH5Utilities.h"
 
 #include "EbsdLib/Core/EbsdLibConstants.h"
+#include "EbsdLib/IO/EbsdSliceCopier.hpp"
+#include "EbsdLib/IO/EbsdSliceImportPipeline.hpp"
 #include "EbsdLib/IO/TSL/H5AngReader.h"
 
 #if defined (H5Support_NAMESPACE)
 using namespace H5Support_NAMESPACE;
 #endif
 
+namespace
+{
+/**
+ * @brief A slice that was read by the loading thread of H5AngVolumeReader::loadData
+ */
+struct AngVolumeSlice
+{
+  H5AngReader::Pointer reader;
+  int err = 0;
+  // The part of the slice that lies inside the box being loaded
+  EbsdSliceCopier::Placement placement;
+  bool overlapsBox = true;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -234,16 +253,25 @@ QVector<AngPhase::Pointer> H5AngVolumeReader::getPhases()
   QString index = QString::number(getZStart());
 
   // Open the hdf5 file and read the data
-  hid_t fileId = QH5Utilities::openFile(getFileName(), true);
-  if(fileId < 0)
+  H5EbsdFile::Pointer h5File = getH5EbsdFile();
+  if(nullptr == h5File)
   {
     setErrorMessage("Error: Could not open .h5ebsd file for reading.");
     setErrorCode(-90000);
     return m_Phases;
   }
-  herr_t err = 0;
 
-  hid_t gid = H5Gopen(fileId, index.toLatin1().data(), H5P_DEFAULT);
+  // The phases are only read once for every reader of the same file
+  QString cacheKey = QString("H5AngVolumeReader/Phases/%1").arg(index);
+  std::shared_ptr<QVector<AngPhase::Pointer>> phases = h5File->getCachedValue<QVector<AngPhase::Pointer>>(cacheKey);
+  if(nullptr != phases)
+  {
+    m_Phases = *phases;
+    return m_Phases;
+  }
+
+  herr_t err = 0;
+  hid_t gid = h5File->getGroup(index);
   H5AngReader::Pointer reader = H5AngReader::New();
   reader->setHDF5Path(index);
   err = reader->readHeader(gid);
@@ -251,13 +279,10 @@ QVector<AngPhase::Pointer> H5AngVolumeReader::getPhases()
   {
     setErrorMessage(reader->getErrorMessage());
     setErrorCode(reader->getErrorCode());
-    err = H5Gclose(gid);
-    err = QH5Utilities::closeFile(fileId);
     return m_Phases;
   }
   m_Phases = reader->getPhases();
-  err = H5Gclose(gid);
-  err = QH5Utilities::closeFile(fileId);
+  h5File->setCachedValue(cacheKey, std::make_shared<QVector<AngPhase::Pointer>>(m_Phases));
   return m_Phases;
 }
 
@@ -271,112 +296,161 @@ int H5AngVolumeReader::loadData(int64_t xpoints,
                                 int64_t zpoints,
                                 uint32_t ZDir )
 {
-  int index = 0;
   int err = -1;
-  // Initialize all the pointers
-  initPointers(xpoints * ypoints * zpoints);
-
+  std::array<int64_t, 3> boxOrigin = {{0, 0, 0}};
+  std::array<int64_t, 3> boxSize = {{0, 0, 0}};
+  if(!getLoadBox(xpoints, ypoints, zpoints, boxOrigin, boxSize))
+  {
+    setErrorCode(-99092);
+    setErrorMessage(QString("The sub volume X=%1 Y=%2 Z=%3 Width=%4 Height=%5 Depth=%6 does not fit inside the volume of %7 x %8 x %9 points")
+                        .arg(boxOrigin[0]).arg(boxOrigin[1]).arg(boxOrigin[2]).arg(boxSize[0]).arg(boxSize[1]).arg(boxSize[2]).arg(xpoints).arg(ypoints).arg(zpoints));
+    return getErrorCode();
+  }
+  bool subVolume = hasSubVolume();
 
-  int readerIndex = 0;
-  int xpointsslice = 0;
-  int ypointsslice = 0;
-  int xpointstemp = 0;
-  int ypointstemp = 0;
-  int xstop = 0;
-  int ystop = 0;
-  int zval = 0;
+  // Initialize all the pointers
+  initPointers(boxSize[0] * boxSize[1] * boxSize[2]);
 
-  int xstartspot = 0;
-  int ystartspot = 0;
   int numPhases = getNumPhases();
   err = readVolumeInfo();
-  for (int slice = 0; slice < zpoints; ++slice)
+
+  // If no stacking order preference was passed, read it from the file and use that value
+  if(ZDir == EbsdLib::RefFrameZDir::UnknownRefFrameZDirection)
+  {
+    ZDir = getStackingOrder();
+  }
+
+  // Only the slices that land inside the box once they are stacked according to ZDir are read
+  int64_t firstSlice = boxOrigin[2];
+  if(ZDir == EbsdLib::RefFrameZDir::HightoLow)
   {
-    H5AngReader::Pointer reader = H5AngReader::New();
-    reader->setFileName(getFileName());
-    reader->setHDF5Path(QString::number(slice + getSliceStart()));
-    reader->setUserZDir(getStackingOrder());
-    reader->setSampleTransformationAngle(getSampleTransformationAngle());
-    reader->setSampleTransformationAxis(getSampleTransformationAxis());
-    reader->setEulerTransformationAngle(getEulerTransformationAngle());
-    reader->setEulerTransformationAxis(getEulerTransformationAxis());
-    reader->readAllArrays(getReadAllArrays());
-    reader->setArraysToRead(getArraysToRead());
-    err = reader->readFile();
-    if(err < 0)
+    firstSlice = zpoints - boxOrigin[2] - boxSize[2];
+  }
+
+  // Gather everything the slice readers need up front so the reading thread never touches this object
+  QString fileName = getFileName();
+  int sliceStart = getSliceStart();
+  uint32_t stackingOrder = getStackingOrder();
+  float sampleTransAngle = getSampleTransformationAngle();
+  std::array<float, 3> sampleTransAxis = getSampleTransformationAxis();
+  float eulerTransAngle = getEulerTransformationAngle();
+  std::array<float, 3> eulerTransAxis = getEulerTransformationAxis();
+  bool readAll = getReadAllArrays();
+  QSet<QString> arrayNames = getArraysToRead();
+  // Every slice reader finds its group in the file that is already open
+  H5EbsdFile::Pointer h5File = getH5EbsdFile();
+
+  // A single thread reads the next slice from the file while this thread places the current one
+  // into the volume. HDF5 is only ever called from the reading thread.
+  EbsdSliceImportPipeline<AngVolumeSlice> pipeline(static_cast<size_t>(boxSize[2]), 1, 2);
+  auto readSlice = [&](size_t index) {
+    size_t slice = static_cast<size_t>(firstSlice) + index;
+    auto loaded = std::make_unique<AngVolumeSlice>();
+    loaded->reader = H5AngReader::New();
+    loaded->reader->setFileName(fileName);
+    loaded->reader->setH5EbsdFile(h5File);
+    loaded->reader->setHDF5Path(QString::number(static_cast<int>(slice) + sliceStart));
+    loaded->reader->setUserZDir(stackingOrder);
+    loaded->reader->setSampleTransformationAngle(sampleTransAngle);
+    loaded->reader->setSampleTransformationAxis(sampleTransAxis);
+    loaded->reader->setEulerTransformationAngle(eulerTransAngle);
+    loaded->reader->setEulerTransformationAxis(eulerTransAxis);
+    loaded->reader->readAllArrays(readAll);
+    loaded->reader->setArraysToRead(arrayNames);
+    if(subVolume)
+    {
+      // The size of the slice decides where it is centered in the volume and so which of its rows
+      // and columns fall inside the box
+      loaded->err = loaded->reader->readHeaderOnly();
+      if(loaded->err < 0)
+      {
+        return loaded;
+      }
+      loaded->overlapsBox = EbsdSliceCopier::ClipToBox(static_cast<size_t>(loaded->reader->getNumEvenCols()), static_cast<size_t>(loaded->reader->getNumRows()), static_cast<size_t>(xpoints),
+                                                       static_cast<size_t>(ypoints), static_cast<size_t>(boxOrigin[0]), static_cast<size_t>(boxOrigin[1]), static_cast<size_t>(boxSize[0]),
+                                                       static_cast<size_t>(boxSize[1]), loaded->placement);
+      if(!loaded->overlapsBox)
+      {
+        return loaded;
+      }
+      const EbsdSliceCopier::Placement& placement = loaded->placement;
+      loaded->reader->setRegionOfInterest(static_cast<int>(placement.sliceX0), static_cast<int>(placement.sliceY0), static_cast<int>(placement.width), static_cast<int>(placement.height));
+    }
+    loaded->err = loaded->reader->readFile();
+    return loaded;
+  };
+
+  auto placeSlice = [&](size_t index, AngVolumeSlice& loaded) {
+    size_t slice = static_cast<size_t>(firstSlice) + index;
+    H5AngReader::Pointer reader = loaded.reader;
+    if(loaded.err < 0)
     {
       setErrorCode(reader->getErrorCode());
       setErrorMessage(reader->getErrorMessage());
+      return (getErrorCode() < 0) ? getErrorCode() : loaded.err;
+    }
+    size_t xpointsslice = static_cast<size_t>(reader->getNumEvenCols());
+    size_t ypointsslice = static_cast<size_t>(reader->getNumRows());
+    if(!EbsdSliceCopier::FitsInVolume(xpointsslice, ypointsslice, static_cast<size_t>(xpoints), static_cast<size_t>(ypoints)))
+    {
+      setErrorCode(-99091);
+      setErrorMessage(QString("Slice %1 has %2 x %3 points which does not fit into the volume of %4 x %5 points")
+                          .arg(static_cast<int>(slice) + sliceStart).arg(xpointsslice).arg(ypointsslice).arg(xpoints).arg(ypoints));
       return getErrorCode();
     }
-    readerIndex = 0;
-    xpointsslice = reader->getNumEvenCols();
-    ypointsslice = reader->getNumRows();
+    if(!loaded.overlapsBox)
+    {
+      return 0;
+    }
     float* euler1Ptr = reader->getPhi1Pointer();
     if (nullptr == euler1Ptr) { setErrorCode(-99090); setErrorMessage("Euler1 Pointer was nullptr from Reader"); return getErrorCode(); }
-    float* euler2Ptr = reader->getPhiPointer();
-    float* euler3Ptr = reader->getPhi2Pointer();
-    float* xPtr = reader->getXPositionPointer();
-    float* yPtr = reader->getYPositionPointer();
-    float* iqPtr = reader->getImageQualityPointer();
-    float* ciPtr = reader->getConfidenceIndexPointer();
     int* phasePtr = reader->getPhaseDataPointer();
-    float* sigPtr = reader->getSEMSignalPointer();
-    float* fitPtr = reader->getFitPointer();
-
-    xpointstemp = static_cast<int>(xpoints);
-    ypointstemp = static_cast<int>(ypoints);
-    xstartspot = (xpointstemp - xpointsslice) / 2;
-    ystartspot = (ypointstemp - ypointsslice) / 2;
-    xstop = xpointsslice;
-    ystop = ypointsslice;
-
-    // If no stacking order preference was passed, read it from the file and use that value
-    if(ZDir == EbsdLib::RefFrameZDir::UnknownRefFrameZDirection)
-    {
-      ZDir = getStackingOrder();
-    }
-    if(ZDir == EbsdLib::RefFrameZDir::LowtoHigh)
+
+    /* For TSL OIM Files if there is a single phase then the value of the phase
+     * data is zero (0). If there are 2 or more phases then the lowest value
+     * of phase is one (1). In the rest of the reconstruction code we follow the
+     * convention that the lowest value is One (1) even if there is only a single
+     * phase. The next if statement converts all zeros to ones if there is a single
+     * phase in the OIM data.
+     */
+    if (numPhases == 1 && nullptr != phasePtr)
     {
-      zval = slice;
+      size_t numPoints = reader->getNumberOfElements();
+      for(size_t i = 0; i < numPoints; i++)
+      {
+        if(phasePtr[i] < 1) { phasePtr[i] = 1; }
+      }
     }
+
+    size_t zval = slice;
     if(ZDir == EbsdLib::RefFrameZDir::HightoLow)
     {
-      zval = static_cast<int>((zpoints - 1) - slice);
+      zval = static_cast<size_t>(zpoints - 1) - slice;
     }
 
     // Copy the data from the current storage into the new memory Location
-    for (int j = 0; j < ystop; j++)
-    {
-      for (int i = 0; i < xstop; i++)
-      {
-        index = (zval * xpointstemp * ypointstemp) + ((j + ystartspot) * xpointstemp) + (i + xstartspot);
-        if (nullptr != euler1Ptr) {m_Phi1[index] = euler1Ptr[readerIndex];}
-        if (nullptr != euler2Ptr) {m_Phi[index] = euler2Ptr[readerIndex];}
-        if (nullptr != euler3Ptr) {m_Phi2[index] = euler3Ptr[readerIndex];}
-        if (nullptr != xPtr) {m_X[index] = xPtr[readerIndex];}
-        if (nullptr != yPtr) {m_Y[index] = yPtr[readerIndex];}
-        if (nullptr != iqPtr) {m_Iq[index] = iqPtr[readerIndex];}
-        if (nullptr != ciPtr) {m_Ci[index] = ciPtr[readerIndex];}
-        if (nullptr != phasePtr) {m_PhaseData[index] = phasePtr[readerIndex];} // Phase
-        if (nullptr != sigPtr) {m_SEMSignal[index] = sigPtr[readerIndex];}
-        if (nullptr != fitPtr) {m_Fit[index] = fitPtr[readerIndex];}
-
-        /* For TSL OIM Files if there is a single phase then the value of the phase
-         * data is zero (0). If there are 2 or more phases then the lowest value
-         * of phase is one (1). In the rest of the reconstruction code we follow the
-         * convention that the lowest value is One (1) even if there is only a single
-         * phase. The next if statement converts all zeros to ones if there is a single
-         * phase in the OIM data.
-         */
-        if (numPhases == 1 && nullptr != phasePtr && m_PhaseData[index] < 1)
-        {
-          m_PhaseData[index] = 1;
-        }
-
-        ++readerIndex;
-      }
-    }
+    const EbsdSliceCopier::Placement& placement = loaded.placement;
+    EbsdSliceCopier copier = subVolume ? EbsdSliceCopier(placement.width, placement.height, static_cast<size_t>(boxSize[0]), static_cast<size_t>(boxSize[1]),
+                                                         zval - static_cast<size_t>(boxOrigin[2]), placement.boxX0, placement.boxY0)
+                                       : EbsdSliceCopier(xpointsslice, ypointsslice, static_cast<size_t>(xpoints), static_cast<size_t>(ypoints), zval);
+    copier.addArray(m_Phi1, euler1Ptr);
+    copier.addArray(m_Phi, reader->getPhiPointer());
+    copier.addArray(m_Phi2, reader->getPhi2Pointer());
+    copier.addArray(m_X, reader->getXPositionPointer());
+    copier.addArray(m_Y, reader->getYPositionPointer());
+    copier.addArray(m_Iq, reader->getImageQualityPointer());
+    copier.addArray(m_Ci, reader->getConfidenceIndexPointer());
+    copier.addArray(m_PhaseData, phasePtr);
+    copier.addArray(m_SEMSignal, reader->getSEMSignalPointer());
+    copier.addArray(m_Fit, reader->getFitPointer());
+    copier.copy();
+    return 0;
+  };
+
+  int pipelineErr = pipeline.run(readSlice, placeSlice);
+  if(boxSize[2] > 0)
+  {
+    err = pipelineErr;
   }
   return err;
 }
@@ -0,0 +1,526 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "QuaternionBatchMath.h"
+
+#include <cmath>
+
+#if(defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#define EBSD_BATCH_HAS_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define EBSD_AVX2_TARGET
+#else
+#define EBSD_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#else
+#define EBSD_BATCH_HAS_AVX2 0
+#endif
+
+namespace
+{
+template <typename T>
+using QuatArrays = QuaternionBatchMath::QuatArrays<T>;
+
+// -----------------------------------------------------------------------------
+// Wraps a single quaternion as a QuatArrays so the fixed operand of Pre/PostMultiply goes through the same kernels
+template <typename T>
+struct FixedQuat
+{
+  explicit FixedQuat(const Quaternion<T>& q)
+  : values{q.x(), q.y(), q.z(), q.w()}
+  {
+    arrays.x = values + 0;
+    arrays.y = values + 1;
+    arrays.z = values + 2;
+    arrays.w = values + 3;
+  }
+
+  T values[4];
+  QuatArrays<T> arrays;
+};
+
+// -----------------------------------------------------------------------------
+// The scalar kernels use the same expressions in the same order as Quaternion<T> so both give identical results.
+// Inputs are read into locals before anything is written which allows the output to alias an input.
+// -----------------------------------------------------------------------------
+template <typename T, bool FixedA, bool FixedB>
+void multiplyScalar(const QuatArrays<T>& a, const QuatArrays<T>& b, const QuatArrays<T>& out, size_t start, size_t count)
+{
+  for(size_t i = start; i < count; i++)
+  {
+    const size_t ia = FixedA ? 0 : i;
+    const size_t ib = FixedB ? 0 : i;
+    const T ax = a.x[ia], ay = a.y[ia], az = a.z[ia], aw = a.w[ia];
+    const T bx = b.x[ib], by = b.y[ib], bz = b.z[ib], bw = b.w[ib];
+    out.x[i] = bx * aw + bw * ax + bz * ay - by * az;
+    out.y[i] = by * aw + bw * ay + bx * az - bz * ax;
+    out.z[i] = bz * aw + bw * az + by * ax - bx * ay;
+    out.w[i] = bw * aw - bx * ax - by * ay - bz * az;
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void conjugateScalar(const QuatArrays<T>& in, const QuatArrays<T>& out, size_t start, size_t count)
+{
+  for(size_t i = start; i < count; i++)
+  {
+    out.x[i] = in.x[i] * static_cast<T>(-1.0);
+    out.y[i] = in.y[i] * static_cast<T>(-1.0);
+    out.z[i] = in.z[i] * static_cast<T>(-1.0);
+    out.w[i] = in.w[i];
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void normalizeScalar(const QuatArrays<T>& in, const QuatArrays<T>& out, size_t start, size_t count)
+{
+  for(size_t i = start; i < count; i++)
+  {
+    const T x = in.x[i], y = in.y[i], z = in.z[i], w = in.w[i];
+    const T l = std::sqrt(x * x + y * y + z * z + w * w);
+    out.x[i] = x / l;
+    out.y[i] = y / l;
+    out.z[i] = z / l;
+    out.w[i] = w / l;
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void positiveHemisphereScalar(const QuatArrays<T>& in, const QuatArrays<T>& out, size_t start, size_t count)
+{
+  for(size_t i = start; i < count; i++)
+  {
+    const T sign = (in.w[i] < 0) ? static_cast<T>(-1.0) : static_cast<T>(1.0);
+    out.x[i] = in.x[i] * sign;
+    out.y[i] = in.y[i] * sign;
+    out.z[i] = in.z[i] * sign;
+    out.w[i] = in.w[i] * sign;
+  }
+}
+
+#if EBSD_BATCH_HAS_AVX2
+// -----------------------------------------------------------------------------
+// Thin wrappers around the AVX intrinsics so that each kernel is written once for float and double.
+// The kernels deliberately do not use FMA so they round exactly like the scalar code.
+// -----------------------------------------------------------------------------
+template <typename T>
+struct Avx2;
+
+template <>
+struct Avx2<float>
+{
+  using Vec = __m256;
+  static const size_t k_Width = 8;
+
+  EBSD_AVX2_TARGET static inline Vec load(const float* ptr)
+  {
+    return _mm256_loadu_ps(ptr);
+  }
+  EBSD_AVX2_TARGET static inline void store(float* ptr, Vec v)
+  {
+    _mm256_storeu_ps(ptr, v);
+  }
+  EBSD_AVX2_TARGET static inline Vec set1(float v)
+  {
+    return _mm256_set1_ps(v);
+  }
+  EBSD_AVX2_TARGET static inline Vec add(Vec a, Vec b)
+  {
+    return _mm256_add_ps(a, b);
+  }
+  EBSD_AVX2_TARGET static inline Vec sub(Vec a, Vec b)
+  {
+    return _mm256_sub_ps(a, b);
+  }
+  EBSD_AVX2_TARGET static inline Vec mul(Vec a, Vec b)
+  {
+    return _mm256_mul_ps(a, b);
+  }
+  EBSD_AVX2_TARGET static inline Vec div(Vec a, Vec b)
+  {
+    return _mm256_div_ps(a, b);
+  }
+  EBSD_AVX2_TARGET static inline Vec sqrt(Vec a)
+  {
+    return _mm256_sqrt_ps(a);
+  }
+  EBSD_AVX2_TARGET static inline Vec flipSign(Vec a, Vec signMask)
+  {
+    return _mm256_xor_ps(a, signMask);
+  }
+  /** @brief Returns -0.0 in every lane where a < 0 and +0.0 everywhere else */
+  EBSD_AVX2_TARGET static inline Vec negativeMask(Vec a)
+  {
+    return _mm256_and_ps(_mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_set1_ps(-0.0f));
+  }
+};
+
+template <>
+struct Avx2<double>
+{
+  using Vec = __m256d;
+  static const size_t k_Width = 4;
+
+  EBSD_AVX2_TARGET static inline Vec load(const double* ptr)
+  {
+    return _mm256_loadu_pd(ptr);
+  }
+  EBSD_AVX2_TARGET static inline void store(double* ptr, Vec v)
+  {
+    _mm256_storeu_pd(ptr, v);
+  }
+  EBSD_AVX2_TARGET static inline Vec set1(double v)
+  {
+    return _mm256_set1_pd(v);
+  }
+  EBSD_AVX2_TARGET static inline Vec add(Vec a, Vec b)
+  {
+    return _mm256_add_pd(a, b);
+  }
+  EBSD_AVX2_TARGET static inline Vec sub(Vec a, Vec b)
+  {
+    return _mm256_sub_pd(a, b);
+  }
+  EBSD_AVX2_TARGET static inline Vec mul(Vec a, Vec b)
+  {
+    return _mm256_mul_pd(a, b);
+  }
+  EBSD_AVX2_TARGET static inline Vec div(Vec a, Vec b)
+  {
+    return _mm256_div_pd(a, b);
+  }
+  EBSD_AVX2_TARGET static inline Vec sqrt(Vec a)
+  {
+    return _mm256_sqrt_pd(a);
+  }
+  EBSD_AVX2_TARGET static inline Vec flipSign(Vec a, Vec signMask)
+  {
+    return _mm256_xor_pd(a, signMask);
+  }
+  /** @brief Returns -0.0 in every lane where a < 0 and +0.0 everywhere else */
+  EBSD_AVX2_TARGET static inline Vec negativeMask(Vec a)
+  {
+    return _mm256_and_pd(_mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_LT_OQ), _mm256_set1_pd(-0.0));
+  }
+};
+
+// -----------------------------------------------------------------------------
+// Loads lane i..i+width of a component array, or broadcasts the single value of a fixed operand
+template <typename T, bool Fixed>
+EBSD_AVX2_TARGET inline typename Avx2<T>::Vec fetch(const T* ptr, size_t i)
+{
+  return Fixed ? Avx2<T>::set1(ptr[0]) : Avx2<T>::load(ptr + i);
+}
+
+// -----------------------------------------------------------------------------
+// Each AVX2 kernel processes whole registers and returns how many quaternions it handled. The caller finishes the rest with the scalar kernel.
+// -----------------------------------------------------------------------------
+template <typename T, bool FixedA, bool FixedB>
+EBSD_AVX2_TARGET size_t multiplyAVX2(const QuatArrays<T>& a, const QuatArrays<T>& b, const QuatArrays<T>& out, size_t count)
+{
+  using V = Avx2<T>;
+  const size_t end = count - (count % V::k_Width);
+  for(size_t i = 0; i < end; i += V::k_Width)
+  {
+    const typename V::Vec ax = fetch<T, FixedA>(a.x, i), ay = fetch<T, FixedA>(a.y, i), az = fetch<T, FixedA>(a.z, i), aw = fetch<T, FixedA>(a.w, i);
+    const typename V::Vec bx = fetch<T, FixedB>(b.x, i), by = fetch<T, FixedB>(b.y, i), bz = fetch<T, FixedB>(b.z, i), bw = fetch<T, FixedB>(b.w, i);
+    V::store(out.x + i, V::sub(V::add(V::add(V::mul(bx, aw), V::mul(bw, ax)), V::mul(bz, ay)), V::mul(by, az)));
+    V::store(out.y + i, V::sub(V::add(V::add(V::mul(by, aw), V::mul(bw, ay)), V::mul(bx, az)), V::mul(bz, ax)));
+    V::store(out.z + i, V::sub(V::add(V::add(V::mul(bz, aw), V::mul(bw, az)), V::mul(by, ax)), V::mul(bx, ay)));
+    V::store(out.w + i, V::sub(V::sub(V::sub(V::mul(bw, aw), V::mul(bx, ax)), V::mul(by, ay)), V::mul(bz, az)));
+  }
+  return end;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+EBSD_AVX2_TARGET size_t conjugateAVX2(const QuatArrays<T>& in, const QuatArrays<T>& out, size_t count)
+{
+  using V = Avx2<T>;
+  const typename V::Vec signMask = V::set1(static_cast<T>(-0.0));
+  const size_t end = count - (count % V::k_Width);
+  for(size_t i = 0; i < end; i += V::k_Width)
+  {
+    V::store(out.x + i, V::flipSign(V::load(in.x + i), signMask));
+    V::store(out.y + i, V::flipSign(V::load(in.y + i), signMask));
+    V::store(out.z + i, V::flipSign(V::load(in.z + i), signMask));
+    V::store(out.w + i, V::load(in.w + i));
+  }
+  return end;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+EBSD_AVX2_TARGET size_t normalizeAVX2(const QuatArrays<T>& in, const QuatArrays<T>& out, size_t count)
+{
+  using V = Avx2<T>;
+  const size_t end = count - (count % V::k_Width);
+  for(size_t i = 0; i < end; i += V::k_Width)
+  {
+    const typename V::Vec x = V::load(in.x + i), y = V::load(in.y + i), z = V::load(in.z + i), w = V::load(in.w + i);
+    const typename V::Vec l = V::sqrt(V::add(V::add(V::add(V::mul(x, x), V::mul(y, y)), V::mul(z, z)), V::mul(w, w)));
+    V::store(out.x + i, V::div(x, l));
+    V::store(out.y + i, V::div(y, l));
+    V::store(out.z + i, V::div(z, l));
+    V::store(out.w + i, V::div(w, l));
+  }
+  return end;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+EBSD_AVX2_TARGET size_t positiveHemisphereAVX2(const QuatArrays<T>& in, const QuatArrays<T>& out, size_t count)
+{
+  using V = Avx2<T>;
+  const size_t end = count - (count % V::k_Width);
+  for(size_t i = 0; i < end; i += V::k_Width)
+  {
+    const typename V::Vec w = V::load(in.w + i);
+    const typename V::Vec signMask = V::negativeMask(w);
+    V::store(out.x + i, V::flipSign(V::load(in.x + i), signMask));
+    V::store(out.y + i, V::flipSign(V::load(in.y + i), signMask));
+    V::store(out.z + i, V::flipSign(V::load(in.z + i), signMask));
+    V::store(out.w + i, V::flipSign(w, signMask));
+  }
+  return end;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+bool detectAVX2()
+{
+#if EBSD_BATCH_HAS_AVX2
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4] = {0, 0, 0, 0};
+  __cpuid(info, 0);
+  if(info[0] < 7)
+  {
+    return false;
+  }
+  __cpuid(info, 1);
+  const bool osSavesYmm = ((info[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 0x6) == 0x6);
+  const bool hasAvx = (info[2] & (1 << 28)) != 0;
+  __cpuidex(info, 7, 0);
+  const bool hasAvx2 = (info[1] & (1 << 5)) != 0;
+  return osSavesYmm && hasAvx && hasAvx2;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+#else
+  return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+bool useAVX2(QuaternionBatchMath::Implementation impl)
+{
+  return impl != QuaternionBatchMath::Implementation::Scalar && QuaternionBatchMath::IsAVX2Supported();
+}
+
+// -----------------------------------------------------------------------------
+template <typename T, bool FixedA, bool FixedB>
+void multiply(const QuatArrays<T>& a, const QuatArrays<T>& b, const QuatArrays<T>& out, size_t count, QuaternionBatchMath::Implementation impl)
+{
+  size_t done = 0;
+  if(useAVX2(impl))
+  {
+#if EBSD_BATCH_HAS_AVX2
+    done = multiplyAVX2<T, FixedA, FixedB>(a, b, out, count);
+#endif
+  }
+  multiplyScalar<T, FixedA, FixedB>(a, b, out, done, count);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void conjugate(const QuatArrays<T>& in, const QuatArrays<T>& out, size_t count, QuaternionBatchMath::Implementation impl)
+{
+  size_t done = 0;
+  if(useAVX2(impl))
+  {
+#if EBSD_BATCH_HAS_AVX2
+    done = conjugateAVX2<T>(in, out, count);
+#endif
+  }
+  conjugateScalar<T>(in, out, done, count);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void normalize(const QuatArrays<T>& in, const QuatArrays<T>& out, size_t count, QuaternionBatchMath::Implementation impl)
+{
+  size_t done = 0;
+  if(useAVX2(impl))
+  {
+#if EBSD_BATCH_HAS_AVX2
+    done = normalizeAVX2<T>(in, out, count);
+#endif
+  }
+  normalizeScalar<T>(in, out, done, count);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void positiveHemisphere(const QuatArrays<T>& in, const QuatArrays<T>& out, size_t count, QuaternionBatchMath::Implementation impl)
+{
+  size_t done = 0;
+  if(useAVX2(impl))
+  {
+#if EBSD_BATCH_HAS_AVX2
+    done = positiveHemisphereAVX2<T>(in, out, count);
+#endif
+  }
+  positiveHemisphereScalar<T>(in, out, done, count);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+QuaternionBatchMath::QuaternionBatchMath() = default;
+
+// -----------------------------------------------------------------------------
+QuaternionBatchMath::~QuaternionBatchMath() = default;
+
+// -----------------------------------------------------------------------------
+QuaternionBatchMath::Pointer QuaternionBatchMath::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+QString QuaternionBatchMath::getNameOfClass() const
+{
+  return QString("QuaternionBatchMath");
+}
+
+// -----------------------------------------------------------------------------
+QString QuaternionBatchMath::ClassName()
+{
+  return QString("QuaternionBatchMath");
+}
+
+// -----------------------------------------------------------------------------
+bool QuaternionBatchMath::IsAVX2Supported()
+{
+  static const bool supported = detectAVX2();
+  return supported;
+}
+
+// -----------------------------------------------------------------------------
+QuaternionBatchMath::Implementation QuaternionBatchMath::GetActiveImplementation()
+{
+  return IsAVX2Supported() ? Implementation::AVX2 : Implementation::Scalar;
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::PreMultiply(const QuatF& q, const QuatArraysF& in, const QuatArraysF& out, size_t count, Implementation impl)
+{
+  FixedQuat<float> fixed(q);
+  multiply<float, true, false>(fixed.arrays, in, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::PreMultiply(const QuatType& q, const QuatArraysD& in, const QuatArraysD& out, size_t count, Implementation impl)
+{
+  FixedQuat<double> fixed(q);
+  multiply<double, true, false>(fixed.arrays, in, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::PostMultiply(const QuatArraysF& in, const QuatF& q, const QuatArraysF& out, size_t count, Implementation impl)
+{
+  FixedQuat<float> fixed(q);
+  multiply<float, false, true>(in, fixed.arrays, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::PostMultiply(const QuatArraysD& in, const QuatType& q, const QuatArraysD& out, size_t count, Implementation impl)
+{
+  FixedQuat<double> fixed(q);
+  multiply<double, false, true>(in, fixed.arrays, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::Multiply(const QuatArraysF& a, const QuatArraysF& b, const QuatArraysF& out, size_t count, Implementation impl)
+{
+  multiply<float, false, false>(a, b, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::Multiply(const QuatArraysD& a, const QuatArraysD& b, const QuatArraysD& out, size_t count, Implementation impl)
+{
+  multiply<double, false, false>(a, b, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::Conjugate(const QuatArraysF& in, const QuatArraysF& out, size_t count, Implementation impl)
+{
+  conjugate<float>(in, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::Conjugate(const QuatArraysD& in, const QuatArraysD& out, size_t count, Implementation impl)
+{
+  conjugate<double>(in, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::Normalize(const QuatArraysF& in, const QuatArraysF& out, size_t count, Implementation impl)
+{
+  normalize<float>(in, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::Normalize(const QuatArraysD& in, const QuatArraysD& out, size_t count, Implementation impl)
+{
+  normalize<double>(in, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::ToPositiveHemisphere(const QuatArraysF& in, const QuatArraysF& out, size_t count, Implementation impl)
+{
+  positiveHemisphere<float>(in, out, count, impl);
+}
+
+// -----------------------------------------------------------------------------
+void QuaternionBatchMath::ToPositiveHemisphere(const QuatArraysD& in, const QuatArraysD& out, size_t count, Implementation impl)
+{
+  positiveHemisphere<double>(in, out, count, impl);
+}
@@ -0,0 +1,157 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <QtCore/QString>
+
+#include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/Core/Quaternion.hpp"
+
+/**
+ * @class QuaternionBatchMath QuaternionBatchMath.h EbsdLib/Math/QuaternionBatchMath.h
+ * @brief Applies the quaternion math of Quaternion<T> to whole arrays of quaternions at once. The
+ * quaternions are stored as a structure of arrays, i.e. one array each for the x, y, z and w components,
+ * so that consecutive quaternions can be processed in SIMD registers.
+ *
+ * On x86 processors that support AVX2 the functions process 8 (float) or 4 (double) quaternions per
+ * instruction. The instruction set is detected at runtime and every function falls back to a scalar
+ * loop that uses the same arithmetic as Quaternion<T>. Output arrays may be the same as the input arrays.
+ */
+class EbsdLib_EXPORT QuaternionBatchMath
+{
+public:
+  using Self = QuaternionBatchMath;
+  using Pointer = std::shared_ptr<Self>;
+  using ConstPointer = std::shared_ptr<const Self>;
+  using WeakPointer = std::weak_ptr<Self>;
+  using ConstWeakPointer = std::weak_ptr<const Self>;
+  static Pointer NullPointer();
+
+  /**
+   * @brief Returns the name of the class for QuaternionBatchMath
+   */
+  QString getNameOfClass() const;
+  /**
+   * @brief Returns the name of the class for QuaternionBatchMath
+   */
+  static QString ClassName();
+
+  virtual ~QuaternionBatchMath();
+
+  /**
+   * @brief The code path that is used by the batch functions. Auto selects the fastest one that the
+   * processor supports. Requesting AVX2 on a processor without it uses the Scalar path.
+   */
+  enum class Implementation : int
+  {
+    Auto = 0,
+    Scalar = 1,
+    AVX2 = 2
+  };
+
+  /**
+   * @brief Points to the 4 component arrays of a batch of quaternions.
+   */
+  template <typename T>
+  struct QuatArrays
+  {
+    T* x = nullptr;
+    T* y = nullptr;
+    T* z = nullptr;
+    T* w = nullptr;
+  };
+
+  using QuatArraysF = QuatArrays<float>;
+  using QuatArraysD = QuatArrays<double>;
+
+  /**
+   * @brief Returns true if the processor and operating system support AVX2.
+   */
+  static bool IsAVX2Supported();
+
+  /**
+   * @brief Returns the code path that Implementation::Auto resolves to on this machine.
+   */
+  static Implementation GetActiveImplementation();
+
+  /**
+   * @brief Computes out[i] = q * in[i] for count quaternions.
+   */
+  static void PreMultiply(const QuatF& q, const QuatArraysF& in, const QuatArraysF& out, size_t count, Implementation impl = Implementation::Auto);
+  static void PreMultiply(const QuatType& q, const QuatArraysD& in, const QuatArraysD& out, size_t count, Implementation impl = Implementation::Auto);
+
+  /**
+   * @brief Computes out[i] = in[i] * q for count quaternions.
+   */
+  static void PostMultiply(const QuatArraysF& in, const QuatF& q, const QuatArraysF& out, size_t count, Implementation impl = Implementation::Auto);
+  static void PostMultiply(const QuatArraysD& in, const QuatType& q, const QuatArraysD& out, size_t count, Implementation impl = Implementation::Auto);
+
+  /**
+   * @brief Computes out[i] = a[i] * b[i] for count quaternions.
+   */
+  static void Multiply(const QuatArraysF& a, const QuatArraysF& b, const QuatArraysF& out, size_t count, Implementation impl = Implementation::Auto);
+  static void Multiply(const QuatArraysD& a, const QuatArraysD& b, const QuatArraysD& out, size_t count, Implementation impl = Implementation::Auto);
+
+  /**
+   * @brief Computes the conjugate (-x, -y, -z, w) of count quaternions.
+   */
+  static void Conjugate(const QuatArraysF& in, const QuatArraysF& out, size_t count, Implementation impl = Implementation::Auto);
+  static void Conjugate(const QuatArraysD& in, const QuatArraysD& out, size_t count, Implementation impl = Implementation::Auto);
+
+  /**
+   * @brief Divides each of count quaternions by its length. See Quaternion<T>::unitQuaternion().
+   */
+  static void Normalize(const QuatArraysF& in, const QuatArraysF& out, size_t count, Implementation impl = Implementation::Auto);
+  static void Normalize(const QuatArraysD& in, const QuatArraysD& out, size_t count, Implementation impl = Implementation::Auto);
+
+  /**
+   * @brief Negates every quaternion whose w component is negative so that all count quaternions
+   * end up in the w >= 0 hemisphere.
+   */
+  static void ToPositiveHemisphere(const QuatArraysF& in, const QuatArraysF& out, size_t count, Implementation impl = Implementation::Auto);
+  static void ToPositiveHemisphere(const QuatArraysD& in, const QuatArraysD& out, size_t count, Implementation impl = Implementation::Auto);
+
+protected:
+  QuaternionBatchMath();
+
+public:
+  QuaternionBatchMath(const QuaternionBatchMath&) = delete;            // Copy Constructor Not Implemented
+  QuaternionBatchMath(QuaternionBatchMath&&) = delete;                 // Move Constructor Not Implemented
+  QuaternionBatchMath& operator=(const QuaternionBatchMath&) = delete; // Copy Assignment Not Implemented
+  QuaternionBatchMath& operator=(QuaternionBatchMath&&) = delete;      // Move Assignment Not Implemented
+};
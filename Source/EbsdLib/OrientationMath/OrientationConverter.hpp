@@ -437,8 +437,14 @@ class ConvertRepresentation
   int inStride = input->getNumberOfComponents();                                                                                                                                                       \
   size_t outStride = OUTSTRIDE;                                                                                                                                                                        \
   std::vector<size_t> cDims = {outStride};                                                                                                                                                             \
-  DataArrayPointerType output = DataArrayType::CreateArray(nTuples, cDims, #OUT_ARRAY_NAME, true);                                                                                                     \
-  output->initializeWithZeros(); /* Intialize the array with Zeros */                                                                                                                                  \
+  /* Created from the input so the output is stored the same way, e.g. in a memory mapped file */                                                                                                      \
+  DataArrayPointerType output = std::dynamic_pointer_cast<DataArrayType>(input->createNewArray(nTuples, cDims, #OUT_ARRAY_NAME, true));                                                                \
+  if(nullptr == output)                                                                                                                                                                                \
+  {                                                                                                                                                                                                    \
+    /* The output can not be allocated, e.g. the memory mapped file can not be created */                                                                                                              \
+    this->setOutputData(output);                                                                                                                                                                       \
+    return;                                                                                                                                                                                            \
+  }                                                                                                                                                                                                    \
   T* outPtr = output->getPointer(0);                                                                                                                                                                   \
   tbb::parallel_for(tbb::blocked_range<size_t>(0, nTuples), ConvertRepresentation<T, Convertors::FUNCTOR<T>>(inPtr, outPtr, inStride, outStride), tbb::auto_partitioner());                            \
   this->setOutputData(output);
@@ -453,8 +459,14 @@ class ConvertRepresentation
   int inStride = input->getNumberOfComponents();                                                                                                                                                       \
   size_t outStride = OUTSTRIDE;                                                                                                                                                                        \
   std::vector<size_t> cDims = {outStride}; /* Create the n component (nx1) based array.*/                                                                                                              \
-  DataArrayPointerType output = DataArrayType::CreateArray(nTuples, cDims, #OUT_ARRAY_NAME, true);                                                                                                     \
-  output->initializeWithZeros(); /* Intialize the array with Zeros */                                                                                                                                  \
+  /* Created from the input so the output is stored the same way, e.g. in a memory mapped file */                                                                                                      \
+  DataArrayPointerType output = std::dynamic_pointer_cast<DataArrayType>(input->createNewArray(nTuples, cDims, #OUT_ARRAY_NAME, true));                                                                \
+  if(nullptr == output)                                                                                                                                                                                \
+  {                                                                                                                                                                                                    \
+    /* The output can not be allocated, e.g. the memory mapped file can not be created */                                                                                                              \
+    this->setOutputData(output);                                                                                                                                                                       \
+    return;                                                                                                                                                                                            \
+  }                                                                                                                                                                                                    \
   T* outPtr = output->getPointer(0);                                                                                                                                                                   \
   ConvertRepresentation<T, Convertors::FUNCTOR<T>> serial(inPtr, outPtr, inStride, outStride);                                                                                                         \
   serial.convert(0, nTuples);                                                                                                                                                                          \
@@ -185,6 +185,18 @@ if(EbsdLib_USE_PARALLEL_ALGORITHMS)
   target_link_libraries(${PROJECT_NAME} TBB::tbb TBB::tbbmalloc)
 endif()
 
+if(EbsdLib_USE_ZLIB)
+  target_link_libraries(${PROJECT_NAME} ZLIB::ZLIB)
+endif()
+
+if(EbsdLib_USE_ZSTD)
+  if(TARGET zstd::libzstd_shared)
+    target_link_libraries(${PROJECT_NAME} zstd::libzstd_shared)
+  else()
+    target_link_libraries(${PROJECT_NAME} zstd::libzstd_static)
+  endif()
+endif()
+
 # --------------------------------------------------------------------
 # Setup the install rules for the various platforms
 set(install_dir "bin")
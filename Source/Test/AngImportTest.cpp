@@ -33,7 +33,11 @@
 *
 * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <memory>
+#include <vector>
 
 #include <QtCore/QDebug>
 #include <QtCore/QFile>
@@ -41,10 +45,22 @@
 #include "EbsdLib/EbsdLib.h"
 #include "EbsdLib/IO/TSL/AngReader.h"
 
+#ifdef EbsdLib_USE_ZLIB
+#include <zlib.h>
+#endif
+
 #ifdef EbsdLib_ENABLE_HDF5
+#include "EbsdLib/IO/H5EbsdFile.h"
 #include "EbsdLib/IO/TSL/H5AngImporter.h"
+#include "EbsdLib/IO/TSL/H5AngReader.h"
+#include "EbsdLib/IO/TSL/H5AngVolumeReader.h"
 #include "H5Support/H5Lite.h"
 #include "H5Support/H5Utilities.h"
+#include "H5Support/QH5Lite.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
 #endif
 
 #include "UnitTestSupport.hpp"
@@ -57,6 +73,34 @@ public:
   AngImportTest() = default;
   virtual ~AngImportTest() = default;
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  QString RegionOfInterestFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("Ang_RegionOfInterest_test.ang");
+  }
+
+  QString CompressedFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("Ang_Compressed_test.ang.gz");
+  }
+
+  QString WriteFileOutput()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("Ang_WriteFile_test.ang");
+  }
+
+  QString ChunkedOutputFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("Ang_Chunked_test.h5ebsd");
+  }
+
+  QString VolumeOutputFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("Ang_Volume_test.h5ebsd");
+  }
+
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
@@ -64,6 +108,12 @@ public:
   {
 #if REMOVE_TEST_FILES
     QFile::remove(UnitTest::AngImportTest::H5EbsdOutputFile);
+    QFile::remove(RegionOfInterestFile());
+    QFile::remove(EbsdTextFileIndex::GetSidecarFilePath(RegionOfInterestFile()));
+    QFile::remove(CompressedFile());
+    QFile::remove(WriteFileOutput());
+    QFile::remove(ChunkedOutputFile());
+    QFile::remove(VolumeOutputFile());
 #endif
   }
 
@@ -164,6 +214,932 @@ public:
     DREAM3D_REQUIRED(ptr[159], ==, 12.56637f)
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  void CompareColumn(T* mapped, T* streamed, size_t numElements)
+  {
+    DREAM3D_REQUIRE_VALID_POINTER(mapped)
+    DREAM3D_REQUIRE_VALID_POINTER(streamed)
+    DREAM3D_REQUIRE_EQUAL(::memcmp(mapped, streamed, numElements * sizeof(T)), 0)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestMemoryMappedFile()
+  {
+    // The memory mapped parser must produce results that are bit identical to the QFile based parser
+    QStringList files = {UnitTest::AngImportTest::TestFile1, UnitTest::AngImportTest::TestFile2, UnitTest::AngImportTest::TestFile3, UnitTest::AngImportTest::ShortFile};
+    for(const auto& file : files)
+    {
+      AngReader mappedReader;
+      mappedReader.setFileName(file);
+      DREAM3D_REQUIRE_EQUAL(mappedReader.getUseMemoryMappedFile(), true)
+      int mappedErr = mappedReader.readFile();
+
+      AngReader streamReader;
+      streamReader.setFileName(file);
+      streamReader.setUseMemoryMappedFile(false);
+      int streamErr = streamReader.readFile();
+
+      DREAM3D_REQUIRE_EQUAL(mappedErr, streamErr)
+      DREAM3D_REQUIRE(mappedReader.getOriginalHeader() == streamReader.getOriginalHeader())
+      DREAM3D_REQUIRE_EQUAL(mappedReader.getPhaseVector().size(), streamReader.getPhaseVector().size())
+      if(streamErr < 0)
+      {
+        continue;
+      }
+
+      size_t numElements = streamReader.getNumberOfElements();
+      DREAM3D_REQUIRE_EQUAL(mappedReader.getNumberOfElements(), numElements)
+      CompareColumn(mappedReader.getPhi1Pointer(), streamReader.getPhi1Pointer(), numElements);
+      CompareColumn(mappedReader.getPhiPointer(), streamReader.getPhiPointer(), numElements);
+      CompareColumn(mappedReader.getPhi2Pointer(), streamReader.getPhi2Pointer(), numElements);
+      CompareColumn(mappedReader.getXPositionPointer(), streamReader.getXPositionPointer(), numElements);
+      CompareColumn(mappedReader.getYPositionPointer(), streamReader.getYPositionPointer(), numElements);
+      CompareColumn(mappedReader.getImageQualityPointer(), streamReader.getImageQualityPointer(), numElements);
+      CompareColumn(mappedReader.getConfidenceIndexPointer(), streamReader.getConfidenceIndexPointer(), numElements);
+      CompareColumn(mappedReader.getPhaseDataPointer(), streamReader.getPhaseDataPointer(), numElements);
+      CompareColumn(mappedReader.getSEMSignalPointer(), streamReader.getSEMSignalPointer(), numElements);
+      CompareColumn(mappedReader.getFitPointer(), streamReader.getFitPointer(), numElements);
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestReadFileInBatches()
+  {
+    // Reading in batches must give the same values as reading the complete file
+    QStringList files = {UnitTest::AngImportTest::TestFile1, UnitTest::AngImportTest::TestFile2, UnitTest::AngImportTest::ShortFile};
+    const QStringList floatNames = {EbsdLib::Ang::Phi1, EbsdLib::Ang::Phi, EbsdLib::Ang::Phi2, EbsdLib::Ang::XPosition, EbsdLib::Ang::YPosition, EbsdLib::Ang::ImageQuality, EbsdLib::Ang::ConfidenceIndex};
+    for(const auto& file : files)
+    {
+      AngReader reader;
+      reader.setFileName(file);
+      int err = reader.readFile();
+
+      AngReader batchReader;
+      batchReader.setFileName(file);
+      size_t numBatches = 0;
+      size_t numPoints = 0;
+      std::vector<std::vector<float>> floatColumns(floatNames.size());
+      std::vector<int32_t> phases;
+      int batchErr = batchReader.readFileInBatches(1000, [&](const EbsdRowBatch& batch) {
+        DREAM3D_REQUIRE(batch.getNumberOfPoints() <= 1000)
+        DREAM3D_REQUIRE_EQUAL(batch.getStartIndex(), numPoints)
+        for(int c = 0; c < floatNames.size(); c++)
+        {
+          float* values = batch.getPointer<float>(floatNames[c]);
+          DREAM3D_REQUIRE_VALID_POINTER(values)
+          floatColumns[c].insert(floatColumns[c].end(), values, values + batch.getNumberOfPoints());
+        }
+        int32_t* phaseValues = batch.getPointer<int32_t>(EbsdLib::Ang::PhaseData);
+        DREAM3D_REQUIRE_VALID_POINTER(phaseValues)
+        phases.insert(phases.end(), phaseValues, phaseValues + batch.getNumberOfPoints());
+        numPoints += batch.getNumberOfPoints();
+        numBatches++;
+        return true;
+      });
+
+      DREAM3D_REQUIRE_EQUAL(batchErr, err)
+      DREAM3D_REQUIRE(batchReader.getOriginalHeader() == reader.getOriginalHeader())
+      DREAM3D_REQUIRE_EQUAL(batchReader.getNumberOfElements(), reader.getNumberOfElements())
+      DREAM3D_REQUIRE(batchReader.getPhi1Pointer() == nullptr)
+      if(err < 0)
+      {
+        continue;
+      }
+      DREAM3D_REQUIRE_EQUAL(numPoints, reader.getNumberOfElements())
+      DREAM3D_REQUIRE_EQUAL(numBatches, (numPoints + 999) / 1000)
+      for(int c = 0; c < floatNames.size(); c++)
+      {
+        CompareColumn(floatColumns[c].data(), static_cast<float*>(reader.getPointerByName(floatNames[c])), numPoints);
+      }
+      CompareColumn(phases.data(), reader.getPhaseDataPointer(), numPoints);
+
+      // Returning false from the callback stops the read after the first batch
+      numBatches = 0;
+      batchErr = batchReader.readFileInBatches(10, [&](const EbsdRowBatch&) {
+        numBatches++;
+        return false;
+      });
+      DREAM3D_REQUIRE_EQUAL(batchErr, 0)
+      DREAM3D_REQUIRE_EQUAL(numBatches, 1)
+    }
+  }
+
+  void TestArraysToRead()
+  {
+    AngReader reader;
+    reader.setFileName(UnitTest::AngImportTest::TestFile1);
+    int err = reader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+
+    // Only the requested columns are allocated
+    AngReader projReader;
+    projReader.setFileName(UnitTest::AngImportTest::TestFile1);
+    QSet<QString> names = {EbsdLib::Ang::Phi1, EbsdLib::Ang::Phi, EbsdLib::Ang::Phi2, EbsdLib::Ang::PhaseData};
+    projReader.setArraysToRead(names);
+    projReader.readAllArrays(false);
+    err = projReader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRE_EQUAL(projReader.getNumberOfElements(), reader.getNumberOfElements())
+    DREAM3D_REQUIRE(projReader.getXPositionPointer() == nullptr)
+    DREAM3D_REQUIRE(projReader.getYPositionPointer() == nullptr)
+    DREAM3D_REQUIRE(projReader.getImageQualityPointer() == nullptr)
+    DREAM3D_REQUIRE(projReader.getConfidenceIndexPointer() == nullptr)
+    DREAM3D_REQUIRE(projReader.getSEMSignalPointer() == nullptr)
+    DREAM3D_REQUIRE(projReader.getFitPointer() == nullptr)
+    size_t numPoints = reader.getNumberOfElements();
+    CompareColumn(projReader.getPhi1Pointer(), reader.getPhi1Pointer(), numPoints);
+    CompareColumn(projReader.getPhiPointer(), reader.getPhiPointer(), numPoints);
+    CompareColumn(projReader.getPhi2Pointer(), reader.getPhi2Pointer(), numPoints);
+    CompareColumn(projReader.getPhaseDataPointer(), reader.getPhaseDataPointer(), numPoints);
+
+    // Asking for nothing is an error
+    AngReader emptyReader;
+    emptyReader.setFileName(UnitTest::AngImportTest::TestFile1);
+    emptyReader.setArraysToRead(QSet<QString>());
+    emptyReader.readAllArrays(false);
+    err = emptyReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, -121)
+  }
+
+  void TestRegionOfInterest()
+  {
+    AngReader reader;
+    reader.setFileName(UnitTest::AngImportTest::TestFile1);
+    int err = reader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    int numCols = reader.getNumOddCols();
+    int numRows = reader.getNumRows();
+    int x0 = 1;
+    int y0 = 2;
+    int width = numCols - 2;
+    int height = numRows - 3;
+
+    // Work on a copy so the sidecar index is not written next to the test data
+    QString filePath = RegionOfInterestFile();
+    QString sidecarPath = EbsdTextFileIndex::GetSidecarFilePath(filePath);
+    QFile::remove(filePath);
+    QFile::remove(sidecarPath);
+    DREAM3D_REQUIRE(QFile::copy(UnitTest::AngImportTest::TestFile1, filePath))
+
+    // The first read builds and writes the sidecar index, the second read loads it
+    for(int pass = 0; pass < 2; pass++)
+    {
+      AngReader roiReader;
+      roiReader.setFileName(filePath);
+      roiReader.setUseSidecarIndex(true);
+      roiReader.setRegionOfInterest(x0, y0, width, height);
+      err = roiReader.readFile();
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+      DREAM3D_REQUIRE(QFile::exists(sidecarPath))
+      DREAM3D_REQUIRE_EQUAL(roiReader.getNumberOfElements(), static_cast<size_t>(width * height))
+      for(int y = 0; y < height; y++)
+      {
+        for(int x = 0; x < width; x++)
+        {
+          size_t roiIndex = static_cast<size_t>(y * width + x);
+          size_t index = static_cast<size_t>((y0 + y) * numCols + x0 + x);
+          DREAM3D_REQUIRE_EQUAL(roiReader.getPhi1Pointer()[roiIndex], reader.getPhi1Pointer()[index])
+          DREAM3D_REQUIRE_EQUAL(roiReader.getXPositionPointer()[roiIndex], reader.getXPositionPointer()[index])
+          DREAM3D_REQUIRE_EQUAL(roiReader.getYPositionPointer()[roiIndex], reader.getYPositionPointer()[index])
+          DREAM3D_REQUIRE_EQUAL(roiReader.getPhaseDataPointer()[roiIndex], reader.getPhaseDataPointer()[index])
+        }
+      }
+    }
+
+    // A corrupt sidecar index that still matches the data file is rebuilt instead of used. The values
+    // are stored big endian, the number of lines starts at byte 48 and the row offsets at byte 64.
+    QFile sidecar(sidecarPath);
+    DREAM3D_REQUIRE(sidecar.open(QIODevice::ReadOnly))
+    QByteArray sidecarBytes = sidecar.readAll();
+    sidecar.close();
+    DREAM3D_REQUIRE(sidecarBytes.size() > 80)
+    for(int corruption = 0; corruption < 2; corruption++)
+    {
+      QByteArray corrupt = sidecarBytes;
+      int position = (corruption == 0) ? 48 : 72;
+      for(int i = 0; i < 8; i++)
+      {
+        corrupt[position + i] = static_cast<char>(i == 0 ? 0x7F : 0xFF);
+      }
+      DREAM3D_REQUIRE(sidecar.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      sidecar.write(corrupt);
+      sidecar.close();
+
+      AngReader corruptReader;
+      corruptReader.setFileName(filePath);
+      corruptReader.setUseSidecarIndex(true);
+      corruptReader.setRegionOfInterest(x0, y0, width, height);
+      err = corruptReader.readFile();
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+      size_t last = static_cast<size_t>(width * height - 1);
+      DREAM3D_REQUIRE_EQUAL(corruptReader.getPhi1Pointer()[last], reader.getPhi1Pointer()[static_cast<size_t>((y0 + height - 1) * numCols + x0 + width - 1)])
+    }
+
+    // A region that does not fit inside the scan is an error
+    AngReader badReader;
+    badReader.setFileName(filePath);
+    badReader.setRegionOfInterest(numCols - 1, 0, 2, 1);
+    err = badReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, -131)
+
+    // Reading the header again reuses the parsed header
+    AngReader headerReader;
+    headerReader.setFileName(filePath);
+    err = headerReader.readHeaderOnly();
+    QString header = headerReader.getOriginalHeader();
+    DREAM3D_REQUIRE_EQUAL(headerReader.readHeaderOnly(), err)
+    DREAM3D_REQUIRE(headerReader.getOriginalHeader() == header)
+    DREAM3D_REQUIRE_EQUAL(headerReader.getNumRows(), numRows)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestDestinationBuffers()
+  {
+    AngReader reader;
+    reader.setFileName(UnitTest::AngImportTest::TestFile1);
+    int err = reader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    size_t numPoints = reader.getNumberOfElements();
+
+    // The Euler angles go into one interleaved array, the phases into a packed one
+    std::vector<float> eulers(numPoints * 3, -1.0f);
+    std::vector<int32_t> phases(numPoints, -1);
+    AngReader bufferReader;
+    bufferReader.setFileName(UnitTest::AngImportTest::TestFile1);
+    DREAM3D_REQUIRE_EQUAL(bufferReader.setDestinationBuffer(EbsdLib::Ang::Phi1, eulers.data(), eulers.size(), 3), 0)
+    DREAM3D_REQUIRE_EQUAL(bufferReader.setDestinationBuffer(EbsdLib::Ang::Phi, eulers.data() + 1, eulers.size() - 1, 3), 0)
+    DREAM3D_REQUIRE_EQUAL(bufferReader.setDestinationBuffer(EbsdLib::Ang::Phi2, eulers.data() + 2, eulers.size() - 2, 3), 0)
+    DREAM3D_REQUIRE_EQUAL(bufferReader.setDestinationBuffer(EbsdLib::Ang::PhaseData, phases.data(), phases.size()), 0)
+    err = bufferReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    DREAM3D_REQUIRE(bufferReader.getPhi1Pointer() == eulers.data())
+    DREAM3D_REQUIRE(bufferReader.getPhaseDataPointer() == phases.data())
+    DREAM3D_REQUIRE_EQUAL(bufferReader.getArrayStride(bufferReader.getPhiPointer()), static_cast<size_t>(3))
+    for(size_t i = 0; i < numPoints; i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(eulers[i * 3], reader.getPhi1Pointer()[i])
+      DREAM3D_REQUIRE_EQUAL(eulers[i * 3 + 1], reader.getPhiPointer()[i])
+      DREAM3D_REQUIRE_EQUAL(eulers[i * 3 + 2], reader.getPhi2Pointer()[i])
+      DREAM3D_REQUIRE_EQUAL(phases[i], reader.getPhaseDataPointer()[i])
+    }
+    CompareColumn(bufferReader.getImageQualityPointer(), reader.getImageQualityPointer(), numPoints);
+
+    // Reading again writes into the same buffers instead of freeing them
+    err = bufferReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    DREAM3D_REQUIRE(bufferReader.getPhi2Pointer() == eulers.data() + 2)
+
+    // A buffer that can not hold every scan point is an error
+    AngReader smallReader;
+    smallReader.setFileName(UnitTest::AngImportTest::TestFile1);
+    DREAM3D_REQUIRE_EQUAL(smallReader.setDestinationBuffer(EbsdLib::Ang::Phi1, eulers.data(), numPoints, 3), 0)
+    err = smallReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, -95001)
+    DREAM3D_REQUIRED(smallReader.setDestinationBuffer(EbsdLib::Ang::Phi1, nullptr, numPoints), <, 0)
+  }
+
+  void TestCompressedFile()
+  {
+    QString filePath = CompressedFile();
+    QFile::remove(filePath);
+
+#ifdef EbsdLib_USE_ZLIB
+    // Compress the test file and read it back through a small block size so the lines span blocks
+    QFile plainFile(UnitTest::AngImportTest::TestFile1);
+    DREAM3D_REQUIRE(plainFile.open(QIODevice::ReadOnly))
+    QByteArray contents = plainFile.readAll();
+    gzFile gz = gzopen(filePath.toLocal8Bit().constData(), "wb");
+    DREAM3D_REQUIRE_VALID_POINTER(gz)
+    DREAM3D_REQUIRE_EQUAL(gzwrite(gz, contents.constData(), static_cast<unsigned>(contents.size())), contents.size())
+    gzclose(gz);
+    DREAM3D_REQUIRE(EbsdCompressedFileDevice::DetectCompression(filePath) == EbsdCompressedFileDevice::Compression::Gzip)
+
+    EbsdCompressedFileDevice device(filePath, 100);
+    DREAM3D_REQUIRE(device.open(QIODevice::ReadOnly))
+    DREAM3D_REQUIRE(device.readAll() == contents)
+    device.close();
+
+    AngReader reader;
+    reader.setFileName(UnitTest::AngImportTest::TestFile1);
+    int err = reader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+
+    AngReader gzReader;
+    gzReader.setFileName(filePath);
+    err = gzReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    DREAM3D_REQUIRE(gzReader.getOriginalHeader() == reader.getOriginalHeader())
+    DREAM3D_REQUIRE_EQUAL(gzReader.getNumberOfElements(), reader.getNumberOfElements())
+    size_t numPoints = reader.getNumberOfElements();
+    CompareColumn(gzReader.getPhi1Pointer(), reader.getPhi1Pointer(), numPoints);
+    CompareColumn(gzReader.getXPositionPointer(), reader.getXPositionPointer(), numPoints);
+    CompareColumn(gzReader.getPhaseDataPointer(), reader.getPhaseDataPointer(), numPoints);
+
+    err = gzReader.readHeaderOnly();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRE_EQUAL(gzReader.getNumRows(), reader.getNumRows())
+
+    // Region of interest reads need a file that can be memory mapped
+    gzReader.setRegionOfInterest(0, 0, 1, 1);
+    err = gzReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, -132)
+#else
+    // Without zlib a gzip file is detected and rejected with an error instead of being parsed as text
+    QFile gzFile(filePath);
+    DREAM3D_REQUIRE(gzFile.open(QIODevice::WriteOnly))
+    const char magic[] = {'\x1F', '\x8B', '\x08', '\x00'};
+    gzFile.write(magic, sizeof(magic));
+    gzFile.close();
+    DREAM3D_REQUIRE(EbsdCompressedFileDevice::DetectCompression(filePath) == EbsdCompressedFileDevice::Compression::Gzip)
+    DREAM3D_REQUIRE(!EbsdCompressedFileDevice::IsSupported(EbsdCompressedFileDevice::Compression::Gzip))
+
+    AngReader gzReader;
+    gzReader.setFileName(filePath);
+    int err = gzReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, -100)
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestWriteFile()
+  {
+    // The test files use the same column layout as the writer so the round trip is byte identical
+    QStringList files = {UnitTest::AngImportTest::TestFile1, UnitTest::AngImportTest::TestFile2, UnitTest::AngImportTest::TestFile3};
+    for(const auto& file : files)
+    {
+      AngReader reader;
+      reader.setFileName(file);
+      int err = reader.readFile();
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+
+      QString filePath = WriteFileOutput();
+      err = reader.writeFile(filePath);
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+
+      QFile original(file);
+      DREAM3D_REQUIRE(original.open(QIODevice::ReadOnly))
+      QFile written(filePath);
+      DREAM3D_REQUIRE(written.open(QIODevice::ReadOnly))
+      DREAM3D_REQUIRE(written.readAll() == original.readAll())
+      written.close();
+
+      AngReader writtenReader;
+      writtenReader.setFileName(filePath);
+      err = writtenReader.readFile();
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+      size_t numPoints = reader.getNumberOfElements();
+      DREAM3D_REQUIRE_EQUAL(writtenReader.getNumberOfElements(), numPoints)
+      CompareColumn(writtenReader.getPhi1Pointer(), reader.getPhi1Pointer(), numPoints);
+      CompareColumn(writtenReader.getFitPointer(), reader.getFitPointer(), numPoints);
+    }
+
+    // Arrays that were not read are written as zeros
+    AngReader reader;
+    reader.setFileName(UnitTest::AngImportTest::TestFile1);
+    reader.setArraysToRead({EbsdLib::Ang::Phi1});
+    reader.readAllArrays(false);
+    int err = reader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    err = reader.writeFile(WriteFileOutput());
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+
+    AngReader writtenReader;
+    writtenReader.setFileName(WriteFileOutput());
+    err = writtenReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    size_t numPoints = reader.getNumberOfElements();
+    DREAM3D_REQUIRE_EQUAL(writtenReader.getNumberOfElements(), numPoints)
+    CompareColumn(writtenReader.getPhi1Pointer(), reader.getPhi1Pointer(), numPoints);
+    float* iq = writtenReader.getImageQualityPointer();
+    DREAM3D_REQUIRE_VALID_POINTER(iq)
+    for(size_t i = 0; i < numPoints; i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(iq[i], 0.0f)
+    }
+
+    // After a region of interest read the header describes the region that is written
+    AngReader roiReader;
+    roiReader.setFileName(UnitTest::AngImportTest::TestFile1);
+    roiReader.setRegionOfInterest(1, 1, 5, 2);
+    err = roiReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    err = roiReader.writeFile(WriteFileOutput());
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    AngReader roiWritten;
+    roiWritten.setFileName(WriteFileOutput());
+    err = roiWritten.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    DREAM3D_REQUIRE_EQUAL(roiWritten.getNumOddCols(), 5)
+    DREAM3D_REQUIRE_EQUAL(roiWritten.getNumEvenCols(), 5)
+    DREAM3D_REQUIRE_EQUAL(roiWritten.getNumRows(), 2)
+    DREAM3D_REQUIRE_EQUAL(roiWritten.getNumberOfElements(), static_cast<size_t>(10))
+    CompareColumn(roiWritten.getPhi1Pointer(), roiReader.getPhi1Pointer(), 10);
+
+    err = reader.writeFile(UnitTest::TestTempDir + "/NonExistentDirectory/Ang_WriteFile_test.ang");
+    DREAM3D_REQUIRE_EQUAL(err, -1)
+  }
+
+#ifdef EbsdLib_ENABLE_HDF5
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestBatchImport()
+  {
+    // More files than queue slots so the workers have to wait for the writer
+    QStringList files = {UnitTest::AngImportTest::TestFile1, UnitTest::AngImportTest::TestFile2, UnitTest::AngImportTest::TestFile3, UnitTest::AngImportTest::TestFile2,
+                         UnitTest::AngImportTest::TestFile1};
+    const int64_t zStart = 5;
+    QFile::remove(UnitTest::AngImportTest::H5EbsdOutputFile);
+    hid_t fileId = H5Utilities::createFile(UnitTest::AngImportTest::H5EbsdOutputFile.toStdString());
+    DREAM3D_REQUIRED(fileId, >, 0)
+
+    H5AngImporter::Pointer importer = H5AngImporter::New();
+    importer->setNumberOfParseThreads(3);
+    importer->setMaxQueuedFiles(2);
+    int err = importer->importFiles(fileId, zStart, files);
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    DREAM3D_REQUIRE_EQUAL(importer->numberOfSlicesImported(), files.size())
+
+    // Every file must land in its own slice group, in order
+    for(int i = 0; i < files.size(); i++)
+    {
+      AngReader reader;
+      reader.setFileName(files[i]);
+      err = reader.readFile();
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+
+      QString path = QString("/%1/%2/%3").arg(zStart + i).arg(EbsdLib::H5OIM::Data).arg(EbsdLib::Ang::Phi1);
+      std::vector<float> phi1;
+      err = H5Lite::readVectorDataset(fileId, path.toStdString(), phi1);
+      DREAM3D_REQUIRED(err, >=, 0)
+      DREAM3D_REQUIRE_EQUAL(phi1.size(), reader.getNumberOfElements())
+      CompareColumn(phi1.data(), reader.getPhi1Pointer(), phi1.size());
+
+      path = QString("/%1/%2/%3").arg(zStart + i).arg(EbsdLib::H5OIM::Header).arg(EbsdLib::H5OIM::OriginalFile);
+      std::string originalFile;
+      err = H5Lite::readStringDataset(fileId, path.toStdString(), originalFile);
+      DREAM3D_REQUIRED(err, >=, 0)
+      DREAM3D_REQUIRE(QString::fromStdString(originalFile) == files[i])
+    }
+
+    // A file that can not be read stops the import after the files before it were written
+    files = {UnitTest::AngImportTest::TestFile1, UnitTest::AngImportTest::TestFile1 + ".missing", UnitTest::AngImportTest::TestFile2};
+    err = importer->importFiles(fileId, 20, files);
+    DREAM3D_REQUIRE_EQUAL(err, -1)
+    DREAM3D_REQUIRE_EQUAL(importer->getErrorCode(), -100)
+    DREAM3D_REQUIRE_EQUAL(importer->numberOfSlicesImported(), 1)
+    DREAM3D_REQUIRE_EQUAL(H5Lite::datasetExists(fileId, "/21"), false)
+
+    H5Utilities::closeFile(fileId);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestChunkedImport()
+  {
+    AngReader reader;
+    reader.setFileName(UnitTest::AngImportTest::TestFile1);
+    int err = reader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    hsize_t rowLength = static_cast<hsize_t>(reader.getNumEvenCols());
+    hsize_t numPoints = static_cast<hsize_t>(reader.getNumberOfElements());
+
+    QFile::remove(ChunkedOutputFile());
+    hid_t fileId = H5Utilities::createFile(ChunkedOutputFile().toStdString());
+    DREAM3D_REQUIRED(fileId, >, 0)
+
+    // Slice 0 is contiguous, slice 1 is chunked by 2 rows and compressed, slice 2 asks for more rows than the scan has
+    H5AngImporter::Pointer importer = H5AngImporter::New();
+    DREAM3D_REQUIRE_EQUAL(importer->getChunkRows(), 0)
+    err = importer->importFile(fileId, 0, UnitTest::AngImportTest::TestFile1);
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    importer->setChunkRows(2);
+    importer->setCompressionLevel(6);
+    err = importer->importFile(fileId, 1, UnitTest::AngImportTest::TestFile1);
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    importer->setChunkRows(1000000);
+    err = importer->importFile(fileId, 2, UnitTest::AngImportTest::TestFile1);
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+
+    const hsize_t expectedChunks[3] = {0, 2 * rowLength, numPoints};
+    for(int z = 0; z < 3; z++)
+    {
+      QString path = QString("/%1/%2/%3").arg(z).arg(EbsdLib::H5OIM::Data).arg(EbsdLib::Ang::Phi1);
+      hid_t datasetId = H5Dopen(fileId, path.toLatin1().data(), H5P_DEFAULT);
+      DREAM3D_REQUIRED(datasetId, >, 0)
+      hid_t dcplId = H5Dget_create_plist(datasetId);
+      if(z == 0)
+      {
+        DREAM3D_REQUIRE(H5Pget_layout(dcplId) == H5D_CONTIGUOUS)
+      }
+      else
+      {
+        DREAM3D_REQUIRE(H5Pget_layout(dcplId) == H5D_CHUNKED)
+        hsize_t chunkDims[1] = {0};
+        DREAM3D_REQUIRE_EQUAL(H5Pget_chunk(dcplId, 1, chunkDims), 1)
+        DREAM3D_REQUIRE_EQUAL(chunkDims[0], expectedChunks[z])
+        DREAM3D_REQUIRE_EQUAL(H5Pget_nfilters(dcplId), 2)
+      }
+      H5Pclose(dcplId);
+      H5Dclose(datasetId);
+
+      std::vector<float> phi1;
+      err = H5Lite::readVectorDataset(fileId, path.toStdString(), phi1);
+      DREAM3D_REQUIRED(err, >=, 0)
+      DREAM3D_REQUIRE_EQUAL(phi1.size(), numPoints)
+      CompareColumn(phi1.data(), reader.getPhi1Pointer(), phi1.size());
+
+      path = QString("/%1/%2/%3").arg(z).arg(EbsdLib::H5OIM::Data).arg(EbsdLib::Ang::PhaseData);
+      std::vector<int32_t> phases;
+      err = H5Lite::readVectorDataset(fileId, path.toStdString(), phases);
+      DREAM3D_REQUIRED(err, >=, 0)
+      DREAM3D_REQUIRE_EQUAL(phases.size(), numPoints)
+      CompareColumn(phases.data(), reader.getPhaseDataPointer(), phases.size());
+    }
+
+    H5Utilities::closeFile(fileId);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestMappedDatasets()
+  {
+    AngReader reader;
+    reader.setFileName(UnitTest::AngImportTest::TestFile1);
+    DREAM3D_REQUIRE_EQUAL(reader.readFile(), 0)
+    size_t numPoints = reader.getNumberOfElements();
+
+    // Slice 0 is contiguous and can be mapped, slice 1 is chunked and compressed and has to be read
+    QFile::remove(ChunkedOutputFile());
+    hid_t fileId = H5Utilities::createFile(ChunkedOutputFile().toStdString());
+    DREAM3D_REQUIRED(fileId, >, 0)
+    H5AngImporter::Pointer importer = H5AngImporter::New();
+    DREAM3D_REQUIRE_EQUAL(importer->importFile(fileId, 0, UnitTest::AngImportTest::TestFile1), 0)
+    importer->setChunkRows(2);
+    importer->setCompressionLevel(6);
+    DREAM3D_REQUIRE_EQUAL(importer->importFile(fileId, 1, UnitTest::AngImportTest::TestFile1), 0)
+    H5Utilities::closeFile(fileId);
+
+    EbsdLib::FloatArrayType::Pointer phi1;
+    {
+      H5EbsdFile::Pointer h5File = H5EbsdFile::Open(ChunkedOutputFile());
+      DREAM3D_REQUIRE_VALID_POINTER(h5File.get())
+      QString dataPath = QString("0/%1").arg(EbsdLib::H5OIM::Data);
+      phi1 = h5File->mapDataset<float>(dataPath, EbsdLib::Ang::Phi1);
+      DREAM3D_REQUIRE_VALID_POINTER(phi1.get())
+      DREAM3D_REQUIRE_EQUAL(phi1->getNumberOfTuples(), numPoints)
+      EbsdLib::Int32ArrayType::Pointer phases = h5File->mapDataset<int32_t>(dataPath, EbsdLib::Ang::PhaseData);
+      DREAM3D_REQUIRE_VALID_POINTER(phases.get())
+      CompareColumn(phases->data(), reader.getPhaseDataPointer(), numPoints);
+      // The stored type has to match and chunked datasets are never mapped
+      DREAM3D_REQUIRE(h5File->mapDataset<double>(dataPath, EbsdLib::Ang::Phi1) == nullptr)
+      DREAM3D_REQUIRE(h5File->mapDataset<float>(QString("1/%1").arg(EbsdLib::H5OIM::Data), EbsdLib::Ang::Phi1) == nullptr)
+    }
+    // The view keeps the file mapped after the file object is gone
+    CompareColumn(phi1->data(), reader.getPhi1Pointer(), numPoints);
+
+    for(int slice = 0; slice < 2; slice++)
+    {
+      H5AngReader::Pointer h5Reader = H5AngReader::New();
+      h5Reader->setFileName(ChunkedOutputFile());
+      h5Reader->setHDF5Path(QString::number(slice));
+      h5Reader->setMapContiguousDatasets(true);
+      DREAM3D_REQUIRED(h5Reader->readFile(), >=, 0)
+      EbsdLib::FloatArrayType::Pointer mapped = h5Reader->getMappedArray<float>(EbsdLib::Ang::Phi1);
+      DREAM3D_REQUIRE_EQUAL(mapped != nullptr, slice == 0)
+      if(nullptr != mapped)
+      {
+        DREAM3D_REQUIRE(mapped->data() == h5Reader->getPhi1Pointer())
+      }
+      CompareColumn(h5Reader->getPhi1Pointer(), reader.getPhi1Pointer(), numPoints);
+      CompareColumn(h5Reader->getConfidenceIndexPointer(), reader.getConfidenceIndexPointer(), numPoints);
+      CompareColumn(h5Reader->getPhaseDataPointer(), reader.getPhaseDataPointer(), numPoints);
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void WriteVolumeHeader(hid_t fileId, int zStart, int zEnd, int xPoints, int yPoints, uint32_t stackingOrder)
+  {
+    float res = 0.5f;
+    float angle = 0.0f;
+    std::array<float, 3> axis = {{0.0f, 0.0f, 1.0f}};
+    int32_t rank = 1;
+    hsize_t dims[1] = {3};
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::ZStartIndex, zStart), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::ZEndIndex, zEnd), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::XPoints, xPoints), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::YPoints, yPoints), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::XResolution, res), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::YResolution, res), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::ZResolution, res), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::StackingOrder, stackingOrder), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::SampleTransformationAngle, angle), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writePointerDataset(fileId, EbsdLib::H5Ebsd::SampleTransformationAxis, rank, dims, axis.data()), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::EulerTransformationAngle, angle), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writePointerDataset(fileId, EbsdLib::H5Ebsd::EulerTransformationAxis, rank, dims, axis.data()), >=, 0)
+    DREAM3D_REQUIRED(QH5Lite::writeStringDataset(fileId, EbsdLib::H5Ebsd::Manufacturer, EbsdLib::Ang::Manufacturer), >=, 0)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void WriteVolumeFile(const QStringList& files, int64_t& sliceWidth, int64_t& sliceHeight)
+  {
+    QFile::remove(VolumeOutputFile());
+    hid_t fileId = H5Utilities::createFile(VolumeOutputFile().toStdString());
+    DREAM3D_REQUIRED(fileId, >, 0)
+    H5AngImporter::Pointer importer = H5AngImporter::New();
+    int err = importer->importFiles(fileId, 0, files);
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    importer->getDims(sliceWidth, sliceHeight);
+    WriteVolumeHeader(fileId, 0, files.size() - 1, static_cast<int>(sliceWidth), static_cast<int>(sliceHeight), EbsdLib::RefFrameZDir::LowtoHigh);
+    H5Utilities::closeFile(fileId);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestVolumeReader()
+  {
+    QStringList files = {UnitTest::AngImportTest::TestFile1, UnitTest::AngImportTest::TestFile2, UnitTest::AngImportTest::TestFile3};
+    int64_t sliceWidth = 0;
+    int64_t sliceHeight = 0;
+    WriteVolumeFile(files, sliceWidth, sliceHeight);
+    int64_t numSlices = files.size();
+    int err = 0;
+
+    std::vector<std::unique_ptr<AngReader>> readers;
+    for(const auto& file : files)
+    {
+      auto reader = std::make_unique<AngReader>();
+      reader->setFileName(file);
+      DREAM3D_REQUIRED(reader->readFile(), >=, 0)
+      DREAM3D_REQUIRE_EQUAL(reader->getNumEvenCols(), sliceWidth)
+      DREAM3D_REQUIRE_EQUAL(reader->getNumRows(), sliceHeight)
+      readers.push_back(std::move(reader));
+    }
+
+    // Slices as wide as the volume, slices centered in a larger volume and the reversed stacking order
+    struct VolumeCase
+    {
+      int64_t xPoints;
+      int64_t yPoints;
+      uint32_t zDir;
+    };
+    const std::vector<VolumeCase> cases = {{sliceWidth, sliceHeight, EbsdLib::RefFrameZDir::UnknownRefFrameZDirection},
+                                           {sliceWidth, sliceHeight + 3, EbsdLib::RefFrameZDir::LowtoHigh},
+                                           {sliceWidth + 5, sliceHeight + 2, EbsdLib::RefFrameZDir::HightoLow}};
+    for(const auto& volumeCase : cases)
+    {
+      H5AngVolumeReader::Pointer volumeReader = H5AngVolumeReader::New();
+      volumeReader->setFileName(VolumeOutputFile());
+      volumeReader->readAllArrays(true);
+      err = volumeReader->loadData(volumeCase.xPoints, volumeCase.yPoints, numSlices, volumeCase.zDir);
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+
+      float* phi1 = volumeReader->getPhi1Pointer();
+      int* phases = volumeReader->getPhaseDataPointer();
+      float* fit = volumeReader->getFitPointer();
+      DREAM3D_REQUIRE_VALID_POINTER(phi1)
+      DREAM3D_REQUIRE_VALID_POINTER(phases)
+      DREAM3D_REQUIRE_VALID_POINTER(fit)
+      int64_t xStart = (volumeCase.xPoints - sliceWidth) / 2;
+      int64_t yStart = (volumeCase.yPoints - sliceHeight) / 2;
+      for(int64_t slice = 0; slice < numSlices; slice++)
+      {
+        int64_t z = (volumeCase.zDir == EbsdLib::RefFrameZDir::HightoLow) ? (numSlices - 1 - slice) : slice;
+        AngReader* reader = readers[slice].get();
+        for(int64_t y = 0; y < volumeCase.yPoints; y++)
+        {
+          for(int64_t x = 0; x < volumeCase.xPoints; x++)
+          {
+            size_t index = static_cast<size_t>((z * volumeCase.yPoints + y) * volumeCase.xPoints + x);
+            bool inSlice = x >= xStart && x < xStart + sliceWidth && y >= yStart && y < yStart + sliceHeight;
+            if(!inSlice)
+            {
+              DREAM3D_REQUIRE_EQUAL(phi1[index], 0.0f)
+              continue;
+            }
+            size_t sliceIndex = static_cast<size_t>((y - yStart) * sliceWidth + (x - xStart));
+            DREAM3D_REQUIRE_EQUAL(phi1[index], reader->getPhi1Pointer()[sliceIndex])
+            DREAM3D_REQUIRE_EQUAL(fit[index], reader->getFitPointer()[sliceIndex])
+            DREAM3D_REQUIRED(phases[index], >=, reader->getPhaseDataPointer()[sliceIndex])
+          }
+        }
+      }
+    }
+
+    // A volume that is smaller than the slices can not hold them
+    H5AngVolumeReader::Pointer volumeReader = H5AngVolumeReader::New();
+    volumeReader->setFileName(VolumeOutputFile());
+    err = volumeReader->loadData(sliceWidth - 1, sliceHeight, numSlices, EbsdLib::RefFrameZDir::LowtoHigh);
+    DREAM3D_REQUIRE_EQUAL(err, -99091)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestSubVolumeReader()
+  {
+    QStringList files = {UnitTest::AngImportTest::TestFile1, UnitTest::AngImportTest::TestFile2, UnitTest::AngImportTest::TestFile3};
+    int64_t sliceWidth = 0;
+    int64_t sliceHeight = 0;
+    WriteVolumeFile(files, sliceWidth, sliceHeight);
+    int64_t numSlices = files.size();
+
+    // Boxes inside the slices, boxes reaching into the empty border of a larger volume and the reversed stacking order
+    struct SubVolumeCase
+    {
+      int64_t xPoints;
+      int64_t yPoints;
+      uint32_t zDir;
+      std::array<int64_t, 3> origin;
+      std::array<int64_t, 3> size;
+    };
+    const std::vector<SubVolumeCase> cases = {
+        {sliceWidth, sliceHeight, EbsdLib::RefFrameZDir::LowtoHigh, {{1, 2, 0}}, {{sliceWidth / 2, sliceHeight / 2, numSlices}}},
+        {sliceWidth, sliceHeight, EbsdLib::RefFrameZDir::HightoLow, {{0, 1, 1}}, {{sliceWidth, sliceHeight - 2, 2}}},
+        {sliceWidth + 6, sliceHeight + 4, EbsdLib::RefFrameZDir::HightoLow, {{0, 0, 0}}, {{sliceWidth / 2, 4, 2}}},
+        {sliceWidth + 6, sliceHeight + 4, EbsdLib::RefFrameZDir::LowtoHigh, {{sliceWidth + 4, 0, 2}}, {{2, sliceHeight + 4, 1}}},
+    };
+    for(const auto& subCase : cases)
+    {
+      H5AngVolumeReader::Pointer fullReader = H5AngVolumeReader::New();
+      fullReader->setFileName(VolumeOutputFile());
+      fullReader->readAllArrays(true);
+      int err = fullReader->loadData(subCase.xPoints, subCase.yPoints, numSlices, subCase.zDir);
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+
+      H5AngVolumeReader::Pointer subReader = H5AngVolumeReader::New();
+      subReader->setFileName(VolumeOutputFile());
+      subReader->readAllArrays(true);
+      subReader->setSubVolume(subCase.origin[0], subCase.origin[1], subCase.origin[2], subCase.size[0], subCase.size[1], subCase.size[2]);
+      DREAM3D_REQUIRE_EQUAL(subReader->hasSubVolume(), true)
+      err = subReader->loadData(subCase.xPoints, subCase.yPoints, numSlices, subCase.zDir);
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+      DREAM3D_REQUIRE_EQUAL(subReader->getNumberOfElements(), static_cast<size_t>(subCase.size[0] * subCase.size[1] * subCase.size[2]))
+
+      float* fullPhi1 = fullReader->getPhi1Pointer();
+      int* fullPhases = fullReader->getPhaseDataPointer();
+      float* subPhi1 = subReader->getPhi1Pointer();
+      int* subPhases = subReader->getPhaseDataPointer();
+      DREAM3D_REQUIRE_VALID_POINTER(subPhi1)
+      DREAM3D_REQUIRE_VALID_POINTER(subPhases)
+      for(int64_t z = 0; z < subCase.size[2]; z++)
+      {
+        for(int64_t y = 0; y < subCase.size[1]; y++)
+        {
+          for(int64_t x = 0; x < subCase.size[0]; x++)
+          {
+            size_t subIndex = static_cast<size_t>((z * subCase.size[1] + y) * subCase.size[0] + x);
+            size_t fullIndex = static_cast<size_t>(((z + subCase.origin[2]) * subCase.yPoints + y + subCase.origin[1]) * subCase.xPoints + x + subCase.origin[0]);
+            DREAM3D_REQUIRE_EQUAL(subPhi1[subIndex], fullPhi1[fullIndex])
+            DREAM3D_REQUIRE_EQUAL(subPhases[subIndex], fullPhases[fullIndex])
+          }
+        }
+      }
+    }
+
+    // A box that reaches outside the volume is rejected before anything is read
+    H5AngVolumeReader::Pointer volumeReader = H5AngVolumeReader::New();
+    volumeReader->setFileName(VolumeOutputFile());
+    volumeReader->setSubVolume(0, 0, 1, sliceWidth, sliceHeight, numSlices);
+    int err = volumeReader->loadData(sliceWidth, sliceHeight, numSlices, EbsdLib::RefFrameZDir::LowtoHigh);
+    DREAM3D_REQUIRE_EQUAL(err, -99092)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestSharedH5EbsdFile()
+  {
+    QStringList files = {UnitTest::AngImportTest::TestFile1, UnitTest::AngImportTest::TestFile2, UnitTest::AngImportTest::TestFile3};
+    int64_t sliceWidth = 0;
+    int64_t sliceHeight = 0;
+    WriteVolumeFile(files, sliceWidth, sliceHeight);
+
+    // Every reader of the same file gets the same open file and the values the first one read
+    H5AngVolumeReader::Pointer first = H5AngVolumeReader::New();
+    first->setFileName(VolumeOutputFile());
+    DREAM3D_REQUIRE_EQUAL(first->readVolumeInfo(), 0)
+    H5AngVolumeReader::Pointer second = H5AngVolumeReader::New();
+    second->setFileName(VolumeOutputFile());
+    DREAM3D_REQUIRE_EQUAL(second->readVolumeInfo(), 0)
+    H5EbsdFile::Pointer h5File = first->getH5EbsdFile();
+    DREAM3D_REQUIRE_VALID_POINTER(h5File.get())
+    DREAM3D_REQUIRE(h5File == second->getH5EbsdFile())
+    DREAM3D_REQUIRE(h5File->isCurrent())
+
+    int64_t xDim = 0;
+    int64_t yDim = 0;
+    int64_t zDim = 0;
+    DREAM3D_REQUIRE_EQUAL(second->getDims(xDim, yDim, zDim), 0)
+    DREAM3D_REQUIRE_EQUAL(xDim, sliceWidth)
+    DREAM3D_REQUIRE_EQUAL(yDim, sliceHeight)
+    DREAM3D_REQUIRE_EQUAL(zDim, files.size())
+    DREAM3D_REQUIRE_EQUAL(second->getManufacturer(), EbsdLib::Ang::Manufacturer)
+
+    hid_t gid = h5File->getGroup("0");
+    DREAM3D_REQUIRED(gid, >=, 0)
+    DREAM3D_REQUIRE_EQUAL(h5File->getGroup("0"), gid)
+    DREAM3D_REQUIRED(h5File->getGroup("99"), <, 0)
+
+    QVector<AngPhase::Pointer> phases = first->getPhases();
+    DREAM3D_REQUIRED(phases.size(), >, 0)
+    DREAM3D_REQUIRE_EQUAL(second->getPhases().size(), phases.size())
+
+    second->readAllArrays(true);
+    DREAM3D_REQUIRE_EQUAL(second->loadData(sliceWidth, sliceHeight, zDim, EbsdLib::RefFrameZDir::LowtoHigh), 0)
+    DREAM3D_REQUIRE_VALID_POINTER(second->getPhi1Pointer())
+
+    // A file that changed on disk is opened again
+    QFile file(VolumeOutputFile());
+    DREAM3D_REQUIRE(file.open(QIODevice::Append))
+    file.write(QByteArray(1, '\0'));
+    file.close();
+    DREAM3D_REQUIRE(!h5File->isCurrent())
+    H5EbsdFile::Pointer reopened = first->getH5EbsdFile();
+    DREAM3D_REQUIRE_VALID_POINTER(reopened.get())
+    DREAM3D_REQUIRE(reopened != h5File)
+    DREAM3D_REQUIRE(reopened->isCurrent())
+
+    // The readers only hold on to the values they read, so the file can be opened for writing once
+    // nobody else uses it
+    h5File.reset();
+    reopened.reset();
+    second.reset();
+    DREAM3D_REQUIRE_EQUAL(first->getDims(xDim, yDim, zDim), 0)
+    hid_t fileId = H5Utilities::openFile(VolumeOutputFile().toStdString(), false);
+    DREAM3D_REQUIRED(fileId, >, 0)
+    H5Utilities::closeFile(fileId);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestH5DestinationBuffers()
+  {
+    QStringList files = {UnitTest::AngImportTest::TestFile1};
+    int64_t sliceWidth = 0;
+    int64_t sliceHeight = 0;
+    WriteVolumeFile(files, sliceWidth, sliceHeight);
+
+    H5AngReader::Pointer reader = H5AngReader::New();
+    reader->setFileName(VolumeOutputFile());
+    reader->setHDF5Path("0");
+    DREAM3D_REQUIRED(reader->readFile(), >=, 0)
+    size_t numPoints = reader->getNumberOfElements();
+
+    // HDF5 scatters the values straight into the interleaved array
+    std::vector<float> eulers(numPoints * 3, -1.0f);
+    H5AngReader::Pointer bufferReader = H5AngReader::New();
+    bufferReader->setFileName(VolumeOutputFile());
+    bufferReader->setHDF5Path("0");
+    DREAM3D_REQUIRE_EQUAL(bufferReader->setDestinationBuffer(EbsdLib::Ang::Phi1, eulers.data(), eulers.size(), 3), 0)
+    DREAM3D_REQUIRE_EQUAL(bufferReader->setDestinationBuffer(EbsdLib::Ang::Phi, eulers.data() + 1, eulers.size() - 1, 3), 0)
+    DREAM3D_REQUIRE_EQUAL(bufferReader->setDestinationBuffer(EbsdLib::Ang::Phi2, eulers.data() + 2, eulers.size() - 2, 3), 0)
+    DREAM3D_REQUIRED(bufferReader->readFile(), >=, 0)
+    DREAM3D_REQUIRE(bufferReader->getPhi1Pointer() == eulers.data())
+    for(size_t i = 0; i < numPoints; i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(eulers[i * 3], reader->getPhi1Pointer()[i])
+      DREAM3D_REQUIRE_EQUAL(eulers[i * 3 + 1], reader->getPhiPointer()[i])
+      DREAM3D_REQUIRE_EQUAL(eulers[i * 3 + 2], reader->getPhi2Pointer()[i])
+    }
+
+    // The region of interest read honours the stride as well
+    std::fill(eulers.begin(), eulers.end(), -1.0f);
+    bufferReader->setRegionOfInterest(1, 1, static_cast<int>(sliceWidth) - 2, static_cast<int>(sliceHeight) - 1);
+    DREAM3D_REQUIRED(bufferReader->readFile(), >=, 0)
+    size_t roiIndex = 0;
+    for(int64_t y = 1; y < sliceHeight; y++)
+    {
+      for(int64_t x = 1; x < sliceWidth - 1; x++)
+      {
+        size_t index = static_cast<size_t>(y * sliceWidth + x);
+        DREAM3D_REQUIRE_EQUAL(eulers[roiIndex * 3 + 1], reader->getPhiPointer()[index])
+        roiIndex++;
+      }
+    }
+    DREAM3D_REQUIRE_EQUAL(eulers[roiIndex * 3 + 1], -1.0f)
+  }
+#endif
+
   void operator()()
   {
     int err = EXIT_SUCCESS;
@@ -175,6 +1151,22 @@ public:
     DREAM3D_REGISTER_TEST(TestMissingGrid())
     DREAM3D_REGISTER_TEST(TestShortFile())
     DREAM3D_REGISTER_TEST(TestNormalFile())
+    DREAM3D_REGISTER_TEST(TestMemoryMappedFile())
+    DREAM3D_REGISTER_TEST(TestReadFileInBatches())
+    DREAM3D_REGISTER_TEST(TestArraysToRead())
+    DREAM3D_REGISTER_TEST(TestRegionOfInterest())
+    DREAM3D_REGISTER_TEST(TestDestinationBuffers())
+    DREAM3D_REGISTER_TEST(TestCompressedFile())
+    DREAM3D_REGISTER_TEST(TestWriteFile())
+#ifdef EbsdLib_ENABLE_HDF5
+    DREAM3D_REGISTER_TEST(TestBatchImport())
+    DREAM3D_REGISTER_TEST(TestChunkedImport())
+    DREAM3D_REGISTER_TEST(TestMappedDatasets())
+    DREAM3D_REGISTER_TEST(TestVolumeReader())
+    DREAM3D_REGISTER_TEST(TestSubVolumeReader())
+    DREAM3D_REGISTER_TEST(TestSharedH5EbsdFile())
+    DREAM3D_REGISTER_TEST(TestH5DestinationBuffers())
+#endif
     DREAM3D_REGISTER_TEST(RemoveTestFiles())
   }
 
@@ -33,146 +33,260 @@
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-#include <stdlib.h>
+#include <cstdio>
+#include <vector>
 
-#include <stdio.h>
-
-#include <iostream>
-#include <string>
-
-#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QStringList>
 
+#include "EbsdLib/Core/OrientationTransformation.hpp"
+#include "EbsdLib/Core/Quaternion.hpp"
 #include "EbsdLib/EbsdLib.h"
-#include "EbsdLib/Utilities/IO/AngleFileLoader.h"
+#include "EbsdLib/IO/AngleFileLoader.h"
+#include "EbsdLib/Math/EbsdLibMath.h"
 
 #include "UnitTestSupport.hpp"
 
-#include "TestFileLocations.h"
+#include "EbsdLib/Test/EbsdLibTestFileLocations.h"
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void RemoveTestFiles()
+class AngleFileLoaderTest
 {
+public:
+  AngleFileLoaderTest() = default;
+  virtual ~AngleFileLoaderTest() = default;
+
+  QString OutputFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("AngleFileLoader_test.txt");
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
 #if REMOVE_TEST_FILES
-  QFile::remove(UnitTest::AngleFileLoaderTest::OutputFile);
+    QFile::remove(OutputFile());
 #endif
-}
+  }
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void makeTestFile(const QString delim, const QString& outputFile)
-{
-  int count = 1000;
-  float e0, e1, e2;
+  // -----------------------------------------------------------------------------
+  // Every value is a multiple of 1/8 so it survives the round trip through the text exactly
+  // -----------------------------------------------------------------------------
+  float angleValue(int i, int component)
+  {
+    return static_cast<float>((i * (component + 1)) % 2880) * 0.125f;
+  }
 
-  FILE* f = fopen(outputFile.toLatin1().data(), "wb");
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void makeTestFile(const QString& delim, int count, int numValues)
+  {
+    FILE* f = fopen(OutputFile().toLatin1().data(), "wb");
+    fprintf(f, "# Angle file written by the AngleFileLoaderTest\n");
+    fprintf(f, "Angle Count:%d\n", count);
+    for(int i = 0; i < count; ++i)
+    {
+      for(int c = 0; c < numValues; c++)
+      {
+        fprintf(f, "%0.6f%s", angleValue(i, c), (c < numValues - 1) ? delim.toLatin1().data() : "\n");
+      }
+    }
+    fclose(f);
+  }
 
-  fprintf(f, "%d\n", count);
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void writeTestFile(const QByteArray& contents)
+  {
+    QFile file(OutputFile());
+    file.open(QIODevice::WriteOnly);
+    file.write(contents);
+    file.close();
+  }
 
-  for(int i = 0; i < count; ++i)
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void checkEulerAngles(const EbsdLib::FloatArrayType::Pointer& angles, int count, double unitConversion)
   {
-    e0 = static_cast<float>(i) * 0.1;
-    e1 = static_cast<float>(i) * 0.25;
-    e2 = static_cast<float>(i) * 0.58;
-    fprintf(f, "%0.6f%s%0.6f%s%0.6f\n", e0, delim.toLatin1().data(), e1, delim.toLatin1().data(), e2);
+    DREAM3D_REQUIRE_VALID_POINTER(angles.get())
+    DREAM3D_REQUIRE_EQUAL(angles->getNumberOfTuples(), static_cast<size_t>(count))
+    DREAM3D_REQUIRE_EQUAL(angles->getNumberOfComponents(), 5)
+    for(int i = 0; i < count; i++)
+    {
+      for(int c = 0; c < 3; c++)
+      {
+        float expected = static_cast<float>(angleValue(i, c) * unitConversion);
+        DREAM3D_REQUIRE_EQUAL(angles->getComponent(i, c), expected)
+      }
+      DREAM3D_REQUIRE_EQUAL(angles->getComponent(i, 3), angleValue(i, 3))
+      DREAM3D_REQUIRE_EQUAL(angles->getComponent(i, 4), angleValue(i, 4))
+    }
   }
-  fclose(f);
-}
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void TestLoadingSpaceDelimited()
-{
-  // Create a Teset File
-  makeTestFile(" ", UnitTest::AngleFileLoaderTest::OutputFile);
-
-  AngleFileLoader::Pointer reader = AngleFileLoader::New();
-  reader->setInputFile(UnitTest::AngleFileLoaderTest::OutputFile);
-  reader->setDelimiter(" ");
-  reader->setAngleRepresentation(AngleFileLoader::EulerAngles);
-  reader->loadData();
-  int err = reader->getErrorCode();
-  DREAM3D_REQUIRE_EQUAL(err, 0)
-}
-
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void TestLoadingCommaDelimited()
-{
-  // Create a Teset File
-  makeTestFile(", ", UnitTest::AngleFileLoaderTest::OutputFile);
-
-  AngleFileLoader::Pointer reader = AngleFileLoader::New();
-  reader->setInputFile(UnitTest::AngleFileLoaderTest::OutputFile);
-  reader->setDelimiter(",");
-  reader->setAngleRepresentation(AngleFileLoader::EulerAngles);
-  reader->loadData();
-  int err = reader->getErrorCode();
-  DREAM3D_REQUIRE_EQUAL(err, 0)
-}
-
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void TestLoadingSemiColonDelimited()
-{
-  // Create a Teset File
-  makeTestFile(";", UnitTest::AngleFileLoaderTest::OutputFile);
-
-  AngleFileLoader::Pointer reader = AngleFileLoader::New();
-  reader->setInputFile(UnitTest::AngleFileLoaderTest::OutputFile);
-  reader->setDelimiter(";");
-  reader->setAngleRepresentation(AngleFileLoader::EulerAngles);
-  reader->loadData();
-  int err = reader->getErrorCode();
-  DREAM3D_REQUIRE_EQUAL(err, 0)
-}
-
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void TestLoadingTabDelimited()
-{
-  // Create a Teset File
-  makeTestFile("\t", UnitTest::AngleFileLoaderTest::OutputFile);
-
-  AngleFileLoader::Pointer reader = AngleFileLoader::New();
-  reader->setInputFile(UnitTest::AngleFileLoaderTest::OutputFile);
-  reader->setDelimiter("\t");
-  reader->setAngleRepresentation(AngleFileLoader::EulerAngles);
-  reader->loadData();
-  int err = reader->getErrorCode();
-  DREAM3D_REQUIRE_EQUAL(err, 0)
-}
-
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-int main(int argc, char* argv[])
-{
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestLoadingDelimiters()
+  {
+    const int count = 1000;
+    QStringList delimiters = {" ", ",", ";", "\t"};
+    QStringList separators = {"   ", ", ", ";", "\t"};
+    for(int d = 0; d < delimiters.size(); d++)
+    {
+      makeTestFile(separators[d], count, 5);
 
-  int err = EXIT_SUCCESS;
-  QDir dir(UnitTest::AngleFileLoaderTest::TestDir);
-  dir.mkpath(".");
+      AngleFileLoader::Pointer reader = AngleFileLoader::New();
+      reader->setInputFile(OutputFile());
+      reader->setDelimiter(delimiters[d]);
+      reader->setAngleRepresentation(AngleFileLoader::EulerAngles);
+      EbsdLib::FloatArrayType::Pointer angles = reader->loadData();
+      DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), 0)
+      checkEulerAngles(angles, count, 1.0);
+    }
 
-#if !REMOVE_TEST_FILES
-  DREAM3D_REGISTER_TEST(RemoveTestFiles())
-#endif
+    // Runs of spaces are only collapsed when asked to, otherwise they separate empty values
+    makeTestFile("  ", count, 5);
+    AngleFileLoader::Pointer reader = AngleFileLoader::New();
+    reader->setInputFile(OutputFile());
+    reader->setDelimiter(" ");
+    reader->setIgnoreMultipleDelimiters(false);
+    reader->setAngleRepresentation(AngleFileLoader::EulerAngles);
+    EbsdLib::FloatArrayType::Pointer angles = reader->loadData();
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), 0)
+    DREAM3D_REQUIRE_VALID_POINTER(angles.get())
+    DREAM3D_REQUIRE_EQUAL(angles->getComponent(1, 0), angleValue(1, 0))
+    DREAM3D_REQUIRE_EQUAL(angles->getComponent(1, 1), 0.0f)
+    DREAM3D_REQUIRE_EQUAL(angles->getComponent(1, 2), angleValue(1, 1))
+  }
 
-  DREAM3D_REGISTER_TEST(TestLoadingSpaceDelimited())
-  DREAM3D_REGISTER_TEST(TestLoadingCommaDelimited())
-  DREAM3D_REGISTER_TEST(TestLoadingSemiColonDelimited())
-  DREAM3D_REGISTER_TEST(TestLoadingTabDelimited())
+  // -----------------------------------------------------------------------------
+  // Large enough that the data is split into several chunks that are parsed in parallel
+  // -----------------------------------------------------------------------------
+  void TestUnitConversion()
+  {
+    const int count = 200000;
+    makeTestFile(" ", count, 5);
 
-#if REMOVE_TEST_FILES
-  DREAM3D_REGISTER_TEST(RemoveTestFiles())
-#endif
+    AngleFileLoader::Pointer reader = AngleFileLoader::New();
+    reader->setInputFile(OutputFile());
+    reader->setDelimiter(" ");
+    reader->setAngleRepresentation(AngleFileLoader::EulerAngles);
+    reader->setFileAnglesInDegrees(true);
+    reader->setOutputAnglesInDegrees(false);
+    EbsdLib::FloatArrayType::Pointer angles = reader->loadData();
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), 0)
+    checkEulerAngles(angles, count, EbsdLib::Constants::k_DegToRad);
+
+    reader->setFileAnglesInDegrees(false);
+    reader->setOutputAnglesInDegrees(true);
+    angles = reader->loadData();
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), 0)
+    checkEulerAngles(angles, count, EbsdLib::Constants::k_RadToDeg);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestQuaternions()
+  {
+    writeTestFile("Angle Count:2\n0.0 0.0 0.0 1.0 1.0 2.0\n0.5 0.5 0.5 0.5 3.0 4.0\n");
+
+    AngleFileLoader::Pointer reader = AngleFileLoader::New();
+    reader->setInputFile(OutputFile());
+    reader->setDelimiter(" ");
+    reader->setAngleRepresentation(AngleFileLoader::QuaternionAngles);
+    reader->setFileAnglesInDegrees(false);
+    reader->setOutputAnglesInDegrees(true);
+    EbsdLib::FloatArrayType::Pointer angles = reader->loadData();
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), 0)
+    DREAM3D_REQUIRE_VALID_POINTER(angles.get())
+
+    QuatF quats[2] = {QuatF(0.0f, 0.0f, 0.0f, 1.0f), QuatF(0.5f, 0.5f, 0.5f, 0.5f)};
+    for(int i = 0; i < 2; i++)
+    {
+      OrientationF euler = OrientationTransformation::qu2eu<QuatF, OrientationF>(quats[i]);
+      for(int c = 0; c < 3; c++)
+      {
+        float expected = static_cast<float>(euler[c] * EbsdLib::Constants::k_RadToDeg);
+        DREAM3D_REQUIRE_EQUAL(angles->getComponent(i, c), expected)
+      }
+      DREAM3D_REQUIRE_EQUAL(angles->getComponent(i, 3), static_cast<float>(i * 2 + 1))
+      DREAM3D_REQUIRE_EQUAL(angles->getComponent(i, 4), static_cast<float>(i * 2 + 2))
+    }
+
+    // A Quaternion needs 6 values on each line
+    writeTestFile("Angle Count:1\n0.0 0.0 0.0 1.0 1.0\n");
+    angles = reader->loadData();
+    DREAM3D_REQUIRE_NULL_POINTER(angles.get())
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), -103)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestMalformedFiles()
+  {
+    AngleFileLoader::Pointer reader = AngleFileLoader::New();
+    reader->setInputFile(OutputFile());
+    reader->setDelimiter(",");
+    reader->setAngleRepresentation(AngleFileLoader::EulerAngles);
+
+    // Comment lines in the data use up one of the angles which is left at zero
+    writeTestFile("# Comment\nAngle Count:3\n1,2,3,4,5\n# Comment\r\n6,7,8,9,10");
+    EbsdLib::FloatArrayType::Pointer angles = reader->loadData();
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), 0)
+    DREAM3D_REQUIRE_VALID_POINTER(angles.get())
+    DREAM3D_REQUIRE_EQUAL(angles->getComponent(0, 4), 5.0f)
+    DREAM3D_REQUIRE_EQUAL(angles->getComponent(1, 0), 0.0f)
+    DREAM3D_REQUIRE_EQUAL(angles->getComponent(2, 0), 6.0f)
+    DREAM3D_REQUIRE_EQUAL(angles->getComponent(2, 4), 10.0f)
+
+    writeTestFile("1000\n1,2,3,4,5\n");
+    angles = reader->loadData();
+    DREAM3D_REQUIRE_NULL_POINTER(angles.get())
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), -101)
+
+    writeTestFile("Angles:1\n1,2,3,4,5\n");
+    angles = reader->loadData();
+    DREAM3D_REQUIRE_NULL_POINTER(angles.get())
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), -102)
+
+    writeTestFile("Angle Count:3\n1,2,3,4,5\n1,2,3,4\n1,2,3\n");
+    angles = reader->loadData();
+    DREAM3D_REQUIRE_NULL_POINTER(angles.get())
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), -103)
+    DREAM3D_REQUIRE(reader->getErrorMessage().startsWith("Line 1 "))
+
+    // The file ends before all of the angles were read
+    writeTestFile("Angle Count:3\n1,2,3,4,5\n1,2,3,4,5\n");
+    angles = reader->loadData();
+    DREAM3D_REQUIRE_NULL_POINTER(angles.get())
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), -103)
+    DREAM3D_REQUIRE(reader->getErrorMessage().startsWith("Line 2 "))
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### AngleFileLoaderTest Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestLoadingDelimiters())
+    DREAM3D_REGISTER_TEST(TestUnitConversion())
+    DREAM3D_REGISTER_TEST(TestQuaternions())
+    DREAM3D_REGISTER_TEST(TestMalformedFiles())
+    DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  }
 
-  PRINT_TEST_SUMMARY();
-  return err;
-}
+public:
+  AngleFileLoaderTest(const AngleFileLoaderTest&) = delete;            // Copy Constructor Not Implemented
+  AngleFileLoaderTest(AngleFileLoaderTest&&) = delete;                 // Move Constructor Not Implemented
+  AngleFileLoaderTest& operator=(const AngleFileLoaderTest&) = delete; // Copy Assignment Not Implemented
+  AngleFileLoaderTest& operator=(AngleFileLoaderTest&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,242 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#include "EbsdLib/IO/TSL/H5AngImporter.h"
+#include "EbsdLib/IO/TSL/H5AngReader.h"
+#include "H5Support/H5Utilities.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+#include "UnitTestSupport.hpp"
+
+#include "EbsdLib/Test/EbsdLibTestFileLocations.h"
+
+class ChunkedImportBenchmark
+{
+public:
+  ChunkedImportBenchmark() = default;
+  virtual ~ChunkedImportBenchmark() = default;
+
+  QString SyntheticAngFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("ChunkedImportBenchmark.ang");
+  }
+
+  QString OutputFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("ChunkedImportBenchmark.h5ebsd");
+  }
+
+  // -----------------------------------------------------------------------------
+  // Writes a .ang file with the header of the test file and a synthetic grain structure. Every
+  // 50 x 50 block of points is a grain with its own orientation and the values carry some noise
+  // so the compressed layouts are not measured on unrealistically regular data.
+  // -----------------------------------------------------------------------------
+  void writeSyntheticScan(int numCols, int numRows)
+  {
+    const int k_GrainSize = 50;
+    std::mt19937_64 generator(5489);
+    std::uniform_real_distribution<float> angles(0.0f, 6.28318f);
+    std::normal_distribution<float> noise(0.0f, 0.005f);
+    std::uniform_real_distribution<float> quality(1000.0f, 5000.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    int grainCols = (numCols + k_GrainSize - 1) / k_GrainSize;
+    int grainRows = (numRows + k_GrainSize - 1) / k_GrainSize;
+    std::vector<float> grainEulers(static_cast<size_t>(grainCols * grainRows * 3));
+    for(auto& value : grainEulers)
+    {
+      value = angles(generator);
+    }
+
+    QFile source(UnitTest::AngImportTest::TestFile1);
+    DREAM3D_REQUIRE(source.open(QIODevice::ReadOnly))
+    QByteArray data;
+    data.reserve(numCols * numRows * 80);
+    while(!source.atEnd())
+    {
+      QByteArray line = source.readLine();
+      if(!line.startsWith('#'))
+      {
+        break;
+      }
+      if(line.startsWith("# NCOLS_ODD"))
+      {
+        line = "# NCOLS_ODD: " + QByteArray::number(numCols) + "\n";
+      }
+      else if(line.startsWith("# NCOLS_EVEN"))
+      {
+        line = "# NCOLS_EVEN: " + QByteArray::number(numCols) + "\n";
+      }
+      else if(line.startsWith("# NROWS"))
+      {
+        line = "# NROWS: " + QByteArray::number(numRows) + "\n";
+      }
+      data.append(line);
+    }
+
+    QByteArray line;
+    for(int y = 0; y < numRows; y++)
+    {
+      for(int x = 0; x < numCols; x++)
+      {
+        const float* euler = grainEulers.data() + ((y / k_GrainSize) * grainCols + (x / k_GrainSize)) * 3;
+        line.clear();
+        line.append(QByteArray::number(euler[0] + noise(generator), 'f', 5)).append(' ');
+        line.append(QByteArray::number(euler[1] + noise(generator), 'f', 5)).append(' ');
+        line.append(QByteArray::number(euler[2] + noise(generator), 'f', 5)).append(' ');
+        line.append(QByteArray::number(x * 0.25f, 'f', 5)).append(' ');
+        line.append(QByteArray::number(y * 0.25f, 'f', 5)).append(' ');
+        line.append(QByteArray::number(quality(generator), 'f', 1)).append(' ');
+        line.append(QByteArray::number(unit(generator), 'f', 3)).append(' ');
+        line.append("1 ");
+        line.append(QByteArray::number(static_cast<int>(quality(generator)) - 3000)).append(' ');
+        line.append(QByteArray::number(unit(generator), 'f', 3)).append('\n');
+        data.append(line);
+      }
+    }
+
+    QFile file(SyntheticAngFile());
+    DREAM3D_REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    DREAM3D_REQUIRE_EQUAL(file.write(data), data.size())
+    file.close();
+  }
+
+  // -----------------------------------------------------------------------------
+  // Returns the median time in seconds of k_NumRuns reads of slice 0 of the output file
+  // -----------------------------------------------------------------------------
+  double timeRead(int x0, int y0, int width, int height)
+  {
+    const int k_NumRuns = 9;
+    std::vector<double> times;
+    for(int run = 0; run < k_NumRuns; run++)
+    {
+      H5AngReader::Pointer reader = H5AngReader::New();
+      reader->setFileName(OutputFile());
+      reader->setHDF5Path("0");
+      if(width > 0 && height > 0)
+      {
+        reader->setRegionOfInterest(x0, y0, width, height);
+      }
+      auto startTime = std::chrono::steady_clock::now();
+      int err = reader->readFile();
+      times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+      DREAM3D_REQUIRED(err, >=, 0)
+      DREAM3D_REQUIRE_VALID_POINTER(reader->getPhi1Pointer())
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+  }
+
+  // -----------------------------------------------------------------------------
+  // Imports the same scan with the contiguous layout and with chunked layouts of several row
+  // counts and deflate levels, then reports the size of the file, the full read rate and the
+  // time to read a 200 x 32 region of interest. The page cache is warm for every read.
+  // -----------------------------------------------------------------------------
+  void BenchmarkChunkedLayouts()
+  {
+    const int k_NumCols = 1000;
+    const int k_NumRows = 1000;
+    const int k_NumColumns = 10;
+    writeSyntheticScan(k_NumCols, k_NumRows);
+
+    struct Layout
+    {
+      int chunkRows;
+      int compressionLevel;
+      const char* name;
+    };
+    const Layout layouts[] = {{0, 0, "contiguous                  "},
+                              {16, 0, "16 rows                     "},
+                              {16, 1, "16 rows, shuffle+deflate 1  "},
+                              {16, 6, "16 rows, shuffle+deflate 6  "},
+                              {64, 6, "64 rows, shuffle+deflate 6  "}};
+
+    double dataMB = static_cast<double>(k_NumCols) * k_NumRows * k_NumColumns * sizeof(float) / (1024.0 * 1024.0);
+    std::cout << "  " << k_NumCols << " x " << k_NumRows << " scan, median of 9 reads:" << std::endl;
+    std::cout << "  layout                      size (MB)  full read (MB/s)  200x32 ROI (ms)" << std::endl;
+    for(const auto& layout : layouts)
+    {
+      QFile::remove(OutputFile());
+      hid_t fileId = H5Utilities::createFile(OutputFile().toStdString());
+      DREAM3D_REQUIRED(fileId, >, 0)
+      H5AngImporter::Pointer importer = H5AngImporter::New();
+      importer->setChunkRows(layout.chunkRows);
+      importer->setCompressionLevel(layout.compressionLevel);
+      int err = importer->importFile(fileId, 0, SyntheticAngFile());
+      H5Utilities::closeFile(fileId);
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+
+      double fileMB = static_cast<double>(QFileInfo(OutputFile()).size()) / (1024.0 * 1024.0);
+      double fullTime = timeRead(0, 0, 0, 0);
+      double roiTime = timeRead(400, 484, 200, 32);
+      std::cout << "  " << layout.name << fileMB << "  " << dataMB / fullTime << "  " << roiTime * 1000.0 << std::endl;
+    }
+
+#if REMOVE_TEST_FILES
+    QFile::remove(SyntheticAngFile());
+    QFile::remove(OutputFile());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### ChunkedImportBenchmark Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(BenchmarkChunkedLayouts())
+  }
+
+public:
+  ChunkedImportBenchmark(const ChunkedImportBenchmark&) = delete;            // Copy Constructor Not Implemented
+  ChunkedImportBenchmark(ChunkedImportBenchmark&&) = delete;                 // Move Constructor Not Implemented
+  ChunkedImportBenchmark& operator=(const ChunkedImportBenchmark&) = delete; // Copy Assignment Not Implemented
+  ChunkedImportBenchmark& operator=(ChunkedImportBenchmark&&) = delete;      // Move Assignment Not Implemented
+};
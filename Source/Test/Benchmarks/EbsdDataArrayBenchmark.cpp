@@ -0,0 +1,107 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <chrono>
+#include <iostream>
+
+#include "EbsdLib/Core/EbsdArrayAllocator.h"
+#include "EbsdLib/Core/EbsdDataArray.hpp"
+
+#include "UnitTestSupport.hpp"
+
+class EbsdDataArrayBenchmark
+{
+public:
+  EbsdDataArrayBenchmark() = default;
+  virtual ~EbsdDataArrayBenchmark() = default;
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename CreateFunc>
+  double timeCreateAndFill(size_t numTuples, CreateFunc create)
+  {
+    auto startTime = std::chrono::steady_clock::now();
+    EbsdLib::FloatArrayType::Pointer array = create(numTuples);
+    DREAM3D_REQUIRE_VALID_POINTER(array.get())
+    float* ptr = array->getPointer(0);
+    size_t size = array->getSize();
+    for(size_t i = 0; i < size; i++)
+    {
+      ptr[i] = static_cast<float>(i & 0xFF);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void BenchmarkAllocation()
+  {
+    // 16M quaternions (256 MB) is large enough to show the cost of the extra passes over the pages
+    const size_t k_NumTuples = 16 * 1024 * 1024;
+    const EbsdLib::FloatArrayType::comp_dims_type cDims = {4};
+    EbsdAlignedAllocator::Pointer aligned = EbsdAlignedAllocator::New();
+    EbsdAlignedAllocator::Pointer hugePages = EbsdAlignedAllocator::New(EbsdAlignedAllocator::k_DefaultAlignment, true);
+
+    double defaultTime = timeCreateAndFill(k_NumTuples, [&](size_t numTuples) { return EbsdLib::FloatArrayType::CreateArray(numTuples, cDims, "Quats", true); });
+    double uninitTime = timeCreateAndFill(k_NumTuples, [&](size_t numTuples) { return EbsdLib::FloatArrayType::CreateUninitializedArray(numTuples, cDims, "Quats"); });
+    double alignedTime = timeCreateAndFill(k_NumTuples, [&](size_t numTuples) { return EbsdLib::FloatArrayType::CreateUninitializedArray(numTuples, cDims, "Quats", aligned); });
+    double hugePageTime = timeCreateAndFill(k_NumTuples, [&](size_t numTuples) { return EbsdLib::FloatArrayType::CreateUninitializedArray(numTuples, cDims, "Quats", hugePages); });
+
+    std::cout << "  Create and fill " << k_NumTuples << " quaternions:" << std::endl;
+    std::cout << "  CreateArray():                      " << defaultTime << " s" << std::endl;
+    std::cout << "  CreateUninitializedArray():         " << uninitTime << " s" << std::endl;
+    std::cout << "  CreateUninitializedArray(aligned):  " << alignedTime << " s" << std::endl;
+    std::cout << "  CreateUninitializedArray(huge):     " << hugePageTime << " s" << std::endl;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### EbsdDataArrayBenchmark Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(BenchmarkAllocation())
+  }
+
+public:
+  EbsdDataArrayBenchmark(const EbsdDataArrayBenchmark&) = delete;            // Copy Constructor Not Implemented
+  EbsdDataArrayBenchmark(EbsdDataArrayBenchmark&&) = delete;                 // Move Constructor Not Implemented
+  EbsdDataArrayBenchmark& operator=(const EbsdDataArrayBenchmark&) = delete; // Copy Assignment Not Implemented
+  EbsdDataArrayBenchmark& operator=(EbsdDataArrayBenchmark&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,163 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <QtCore/QFile>
+
+#include "EbsdLib/IO/EbsdTextWriter.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "EbsdLib/Test/EbsdLibTestFileLocations.h"
+
+class NumberFormatterBenchmark
+{
+public:
+  NumberFormatterBenchmark() = default;
+  virtual ~NumberFormatterBenchmark() = default;
+
+  QString WriterOutputFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("NumberFormatter_Writer_benchmark.txt");
+  }
+
+  QString PrintfOutputFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("NumberFormatter_Printf_benchmark.txt");
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    QFile::remove(WriterOutputFile());
+    QFile::remove(PrintfOutputFile());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  // Reports the rows/second for fprintf() and EbsdTextWriter writing the same .ctf style columns
+  // -----------------------------------------------------------------------------
+  void BenchmarkWriting()
+  {
+    const size_t k_NumRows = 1000000;
+    const size_t k_NumFloatColumns = 7;
+    std::vector<std::vector<float>> floats(k_NumFloatColumns, std::vector<float>(k_NumRows));
+    std::vector<std::vector<int32_t>> ints(4, std::vector<int32_t>(k_NumRows));
+    std::mt19937 generator(5489);
+    std::uniform_real_distribution<float> data(0.0f, 360.0f);
+    std::uniform_int_distribution<int32_t> counts(0, 200);
+    for(size_t i = 0; i < k_NumRows; i++)
+    {
+      for(auto& column : floats)
+      {
+        column[i] = data(generator);
+      }
+      for(auto& column : ints)
+      {
+        column[i] = counts(generator);
+      }
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    FILE* f = fopen(PrintfOutputFile().toLatin1().data(), "wb");
+    DREAM3D_REQUIRE_VALID_POINTER(f)
+    for(size_t i = 0; i < k_NumRows; i++)
+    {
+      fprintf(f, "%d\t", ints[0][i]);
+      for(const auto& column : floats)
+      {
+        fprintf(f, "%0.4f\t", column[i]);
+      }
+      for(size_t c = 1; c < ints.size(); c++)
+      {
+        fprintf(f, "%d\t", ints[c][i]);
+      }
+      fprintf(f, "\n");
+    }
+    fclose(f);
+    auto printfTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    startTime = std::chrono::steady_clock::now();
+    EbsdTextWriter writer;
+    writer.addInt32Column(ints[0].data(), 0, '\t');
+    for(const auto& column : floats)
+    {
+      writer.addFloatColumn(column.data(), 0, 4, '\t');
+    }
+    for(size_t c = 1; c < ints.size(); c++)
+    {
+      writer.addInt32Column(ints[c].data(), 0, '\t');
+    }
+    f = fopen(WriterOutputFile().toLatin1().data(), "wb");
+    DREAM3D_REQUIRE_VALID_POINTER(f)
+    int err = writer.writeRows(f, k_NumRows);
+    fclose(f);
+    auto writerTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+
+    QFile writerFile(WriterOutputFile());
+    QFile printfFile(PrintfOutputFile());
+    DREAM3D_REQUIRE_EQUAL(writerFile.size(), printfFile.size())
+
+    std::cout << "  fprintf():       " << static_cast<size_t>(k_NumRows / printfTime) << " rows/second" << std::endl;
+    std::cout << "  EbsdTextWriter:  " << static_cast<size_t>(k_NumRows / writerTime) << " rows/second" << std::endl;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### NumberFormatterBenchmark Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(BenchmarkWriting())
+    DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  }
+
+public:
+  NumberFormatterBenchmark(const NumberFormatterBenchmark&) = delete;            // Copy Constructor Not Implemented
+  NumberFormatterBenchmark(NumberFormatterBenchmark&&) = delete;                 // Move Constructor Not Implemented
+  NumberFormatterBenchmark& operator=(const NumberFormatterBenchmark&) = delete; // Copy Assignment Not Implemented
+  NumberFormatterBenchmark& operator=(NumberFormatterBenchmark&&) = delete;      // Move Assignment Not Implemented
+};
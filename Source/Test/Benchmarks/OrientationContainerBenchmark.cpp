@@ -0,0 +1,101 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "EbsdLib/Core/OrientationContainer.hpp"
+
+#include "UnitTestSupport.hpp"
+
+class OrientationContainerBenchmark
+{
+public:
+  OrientationContainerBenchmark() = default;
+  virtual ~OrientationContainerBenchmark() = default;
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void BenchmarkTranspose()
+  {
+    const size_t k_NumTuples = 16 * 1024 * 1024;
+    std::vector<std::vector<float>> planar(3, std::vector<float>(k_NumTuples, 1.0f));
+    std::vector<float> interleaved(k_NumTuples * 3);
+    std::vector<const float*> planarIn = {planar[0].data(), planar[1].data(), planar[2].data()};
+    std::vector<float*> planarOut = {planar[0].data(), planar[1].data(), planar[2].data()};
+
+    auto startTime = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < k_NumTuples; i++)
+    {
+      for(size_t c = 0; c < 3; c++)
+      {
+        interleaved[i * 3 + c] = planar[c][i];
+      }
+    }
+    double loopTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    startTime = std::chrono::steady_clock::now();
+    EbsdLib::FloatOrientationContainer::Interleave(planarIn, interleaved.data(), k_NumTuples);
+    double interleaveTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    startTime = std::chrono::steady_clock::now();
+    EbsdLib::FloatOrientationContainer::Deinterleave(interleaved.data(), planarOut, k_NumTuples);
+    double deinterleaveTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "  Transpose " << k_NumTuples << " Euler angles:" << std::endl;
+    std::cout << "  Plain interleave loop: " << loopTime << " s" << std::endl;
+    std::cout << "  Interleave():          " << interleaveTime << " s" << std::endl;
+    std::cout << "  Deinterleave():        " << deinterleaveTime << " s" << std::endl;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### OrientationContainerBenchmark Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(BenchmarkTranspose())
+  }
+
+public:
+  OrientationContainerBenchmark(const OrientationContainerBenchmark&) = delete;            // Copy Constructor Not Implemented
+  OrientationContainerBenchmark(OrientationContainerBenchmark&&) = delete;                 // Move Constructor Not Implemented
+  OrientationContainerBenchmark& operator=(const OrientationContainerBenchmark&) = delete; // Copy Assignment Not Implemented
+  OrientationContainerBenchmark& operator=(OrientationContainerBenchmark&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,176 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "EbsdLib/Core/Quaternion.hpp"
+#include "EbsdLib/Math/QuaternionBatchMath.h"
+
+#include "UnitTestSupport.hpp"
+
+class QuaternionBatchMathBenchmark
+{
+public:
+  QuaternionBatchMathBenchmark() = default;
+  virtual ~QuaternionBatchMathBenchmark() = default;
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  class BatchQuats
+  {
+  public:
+    explicit BatchQuats(size_t count)
+    : x(count)
+    , y(count)
+    , z(count)
+    , w(count)
+    {
+    }
+
+    QuaternionBatchMath::QuatArrays<T> arrays()
+    {
+      QuaternionBatchMath::QuatArrays<T> a;
+      a.x = x.data();
+      a.y = y.data();
+      a.z = z.data();
+      a.w = w.data();
+      return a;
+    }
+
+    Quaternion<T> get(size_t i) const
+    {
+      return Quaternion<T>(x[i], y[i], z[i], w[i]);
+    }
+
+    void set(size_t i, const Quaternion<T>& q)
+    {
+      x[i] = q.x();
+      y[i] = q.y();
+      z[i] = q.z();
+      w[i] = q.w();
+    }
+
+    std::vector<T> x;
+    std::vector<T> y;
+    std::vector<T> z;
+    std::vector<T> w;
+  };
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  BatchQuats<T> randomBatchQuats(size_t count, unsigned int seed)
+  {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<T> distribution(static_cast<T>(-1.0), static_cast<T>(1.0));
+    BatchQuats<T> quats(count);
+    for(size_t i = 0; i < count; i++)
+    {
+      quats.set(i, Quaternion<T>(distribution(generator), distribution(generator), distribution(generator), distribution(generator)).unitQuaternion());
+    }
+    return quats;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename Func>
+  double timeBatch(Func func)
+  {
+    auto startTime = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void BenchmarkQuaternionBatchMath()
+  {
+    const size_t k_Count = 4 * 1024 * 1024;
+    BatchQuats<float> a = randomBatchQuats<float>(k_Count, 5489);
+    BatchQuats<float> out(k_Count);
+    const QuatF q = QuatF(0.25f, -0.5f, 0.125f, 0.75f).unitQuaternion();
+
+    double quatTime = timeBatch([&]() {
+      for(size_t i = 0; i < k_Count; i++)
+      {
+        QuatF r = q * a.get(i);
+        if(r.w() < 0)
+        {
+          r.negate();
+        }
+        out.set(i, r);
+      }
+    });
+    double scalarTime = timeBatch([&]() {
+      QuaternionBatchMath::PreMultiply(q, a.arrays(), out.arrays(), k_Count, QuaternionBatchMath::Implementation::Scalar);
+      QuaternionBatchMath::ToPositiveHemisphere(out.arrays(), out.arrays(), k_Count, QuaternionBatchMath::Implementation::Scalar);
+    });
+    double autoTime = timeBatch([&]() {
+      QuaternionBatchMath::PreMultiply(q, a.arrays(), out.arrays(), k_Count);
+      QuaternionBatchMath::ToPositiveHemisphere(out.arrays(), out.arrays(), k_Count);
+    });
+
+    const bool avx2 = QuaternionBatchMath::GetActiveImplementation() == QuaternionBatchMath::Implementation::AVX2;
+    std::cout << "  Multiply and reduce " << k_Count << " quaternions:" << std::endl;
+    std::cout << "  Quaternion<float> loop:       " << quatTime << " s" << std::endl;
+    std::cout << "  QuaternionBatchMath (Scalar): " << scalarTime << " s" << std::endl;
+    std::cout << "  QuaternionBatchMath (" << (avx2 ? "AVX2" : "Scalar") << "):   " << autoTime << " s" << std::endl;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### QuaternionBatchMathBenchmark Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(BenchmarkQuaternionBatchMath())
+  }
+
+public:
+  QuaternionBatchMathBenchmark(const QuaternionBatchMathBenchmark&) = delete;            // Copy Constructor Not Implemented
+  QuaternionBatchMathBenchmark(QuaternionBatchMathBenchmark&&) = delete;                 // Move Constructor Not Implemented
+  QuaternionBatchMathBenchmark& operator=(const QuaternionBatchMathBenchmark&) = delete; // Copy Assignment Not Implemented
+  QuaternionBatchMathBenchmark& operator=(QuaternionBatchMathBenchmark&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,156 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+
+#include "EbsdLib/IO/EbsdTokenParser.hpp"
+
+#include "UnitTestSupport.hpp"
+
+class TokenParserBenchmark
+{
+public:
+  TokenParserBenchmark() = default;
+  virtual ~TokenParserBenchmark() = default;
+
+  // -----------------------------------------------------------------------------
+  // Builds a block of .ang style data lines with the same kinds of values a real file has
+  // -----------------------------------------------------------------------------
+  QByteArray generateDataLines(size_t numLines)
+  {
+    std::mt19937_64 generator(5489);
+    std::uniform_real_distribution<float> angles(0.0f, 6.28318f);
+    std::uniform_real_distribution<float> positions(0.0f, 500.0f);
+    std::uniform_real_distribution<float> quality(0.0f, 5000.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> phases(0, 3);
+
+    QByteArray data;
+    data.reserve(static_cast<int>(numLines * 96));
+    QByteArray line;
+    for(size_t i = 0; i < numLines; i++)
+    {
+      line.clear();
+      line.append(QByteArray::number(angles(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(angles(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(angles(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(positions(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(positions(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(quality(generator), 'f', 1)).append(' ');
+      line.append(QByteArray::number(unit(generator), 'f', 3)).append(' ');
+      line.append(QByteArray::number(phases(generator))).append(' ');
+      line.append(QByteArray::number(unit(generator), 'g', 9)).append(' ');
+      line.append(QByteArray::number(unit(generator) * 1.0E-7, 'e', 12)).append('\n');
+      data.append(line);
+    }
+    return data;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Reports the tokens/second for QByteArray::toFloat() and TokenParser::toFloat() over the
+  // same block of data lines. Both tokenize the lines the way the .ang reader does.
+  // -----------------------------------------------------------------------------
+  void BenchmarkFloatParsing()
+  {
+    const size_t k_NumLines = 250000;
+    QByteArray data = generateDataLines(k_NumLines);
+    const char* begin = data.constData();
+    const char* end = begin + data.size();
+
+    size_t qtTokens = 0;
+    double qtSum = 0.0;
+    auto startTime = std::chrono::steady_clock::now();
+    const char* cursor = begin;
+    while(cursor < end)
+    {
+      const char* eol = EbsdLib::TokenParser::findLineEnd(cursor, end);
+      QList<QByteArray> tokens = QByteArray(cursor, static_cast<int>(eol - cursor)).trimmed().simplified().split(' ');
+      for(const auto& token : tokens)
+      {
+        qtSum += token.toFloat();
+      }
+      qtTokens += tokens.size();
+      cursor = eol + 1;
+    }
+    auto qtTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    size_t numTokens = 0;
+    double sum = 0.0;
+    startTime = std::chrono::steady_clock::now();
+    cursor = begin;
+    EbsdLib::TokenParser::Token tokens[10];
+    while(cursor < end)
+    {
+      const char* eol = EbsdLib::TokenParser::findLineEnd(cursor, end);
+      int count = std::min(EbsdLib::TokenParser::splitOnWhiteSpace(cursor, eol, tokens, 10), 10);
+      for(int t = 0; t < count; t++)
+      {
+        sum += EbsdLib::TokenParser::toFloat(tokens[t].first, tokens[t].last);
+      }
+      numTokens += static_cast<size_t>(count);
+      cursor = eol + 1;
+    }
+    auto parserTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    DREAM3D_REQUIRE_EQUAL(numTokens, qtTokens)
+    DREAM3D_REQUIRE_EQUAL(sum, qtSum)
+
+    std::cout << "  QByteArray::toFloat():   " << static_cast<size_t>(qtTokens / qtTime) << " tokens/second" << std::endl;
+    std::cout << "  TokenParser::toFloat():  " << static_cast<size_t>(numTokens / parserTime) << " tokens/second" << std::endl;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### TokenParserBenchmark Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(BenchmarkFloatParsing())
+  }
+
+public:
+  TokenParserBenchmark(const TokenParserBenchmark&) = delete;            // Copy Constructor Not Implemented
+  TokenParserBenchmark(TokenParserBenchmark&&) = delete;                 // Move Constructor Not Implemented
+  TokenParserBenchmark& operator=(const TokenParserBenchmark&) = delete; // Copy Assignment Not Implemented
+  TokenParserBenchmark& operator=(TokenParserBenchmark&&) = delete;      // Move Assignment Not Implemented
+};
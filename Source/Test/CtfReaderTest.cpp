@@ -36,12 +36,18 @@
 *
 * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <cmath>
 #include <cstring>
+#include <vector>
 
 #include <QtCore/QFile>
 
 #include "EbsdLib/IO/HKL/CtfReader.h"
 
+#ifdef EbsdLib_USE_ZSTD
+#include <zstd.h>
+#endif
+
 #include "UnitTestSupport.hpp"
 
 #include "EbsdLib/Test/EbsdLibTestFileLocations.h"
@@ -212,11 +218,11 @@ public:
 
     // QString header = reader.getOriginalHeader();
 
+    size_t total = reader.getNumberOfElements();
     float* phi2Ptr = reinterpret_cast<float*>(reader.getPointerByName("Euler3"));
     if(nullptr != phi2Ptr)
     {
-      int total = reader.getXCells() * reader.getYCells() * reader.getZCells();
-      for(int i = 0; i < total; i++)
+      for(size_t i = 0; i < total; i++)
       {
         phi2Ptr[i] = phi2Ptr[i] + 30.0F;
       }
@@ -225,6 +231,36 @@ public:
     QString filePath = QString("%1/%2").arg(UnitTest::TestTempDir).arg("CTF_WriteFile_test.ctf");
     err = reader.writeFile(filePath);
     DREAM3D_REQUIRE(err == 0);
+
+    // Every value must survive the round trip within the 4 decimals the floats are written with
+    CtfReader writtenReader;
+    writtenReader.setFileName(filePath);
+    err = writtenReader.readFile();
+    DREAM3D_REQUIRED(err, ==, 0)
+    DREAM3D_REQUIRE_EQUAL(writtenReader.getNumberOfElements(), total)
+    DREAM3D_REQUIRE(writtenReader.getOriginalHeader() == reader.getOriginalHeader())
+    QList<QString> names = reader.getColumnNames();
+    for(const auto& name : names)
+    {
+      void* ptr = reader.getPointerByName(name);
+      void* writtenPtr = writtenReader.getPointerByName(name);
+      DREAM3D_REQUIRE_VALID_POINTER(ptr)
+      DREAM3D_REQUIRE_VALID_POINTER(writtenPtr)
+      if(reader.getPointerType(name) == EbsdLib::NumericTypes::Type::Float)
+      {
+        float* values = reinterpret_cast<float*>(ptr);
+        float* writtenValues = reinterpret_cast<float*>(writtenPtr);
+        for(size_t i = 0; i < total; i++)
+        {
+          DREAM3D_REQUIRED(std::fabs(values[i] - writtenValues[i]), <=, 5.0E-5f + std::fabs(values[i]) * 1.0E-6f)
+        }
+      }
+      else
+      {
+        DREAM3D_REQUIRE_EQUAL(::memcmp(ptr, writtenPtr, total * sizeof(int32_t)), 0)
+      }
+    }
+
     if(REMOVE_TEST_FILES == 1)
     {
       bool removed = QFile::remove(filePath);
@@ -232,6 +268,289 @@ public:
     }
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestParallelParsing()
+  {
+    // Build a large European style file by repeating the data section of a small one so the
+    // data section gets split into many chunks that are parsed in parallel.
+    const int k_Repeats = 500;
+    QFile inFile(UnitTest::CtfReaderTest::EuropeanInputFile1);
+    DREAM3D_REQUIRE(inFile.open(QIODevice::ReadOnly))
+    QList<QByteArray> lines = inFile.readAll().split('\n');
+    inFile.close();
+
+    QByteArray header;
+    QByteArray data;
+    bool inData = false;
+    for(const auto& line : lines)
+    {
+      if(inData)
+      {
+        if(!line.trimmed().isEmpty())
+        {
+          data.append(line).append('\n');
+        }
+        continue;
+      }
+      if(line.startsWith("YCells"))
+      {
+        header.append(QString("YCells\t%1\r\n").arg(5 * k_Repeats).toLatin1());
+        continue;
+      }
+      header.append(line).append('\n');
+      inData = line.startsWith("Phase\t");
+    }
+
+    QString filePath = QString("%1/%2").arg(UnitTest::TestTempDir).arg("CTF_ParallelParsing_test.ctf");
+    QFile outFile(filePath);
+    DREAM3D_REQUIRE(outFile.open(QIODevice::WriteOnly))
+    outFile.write(header);
+    for(int i = 0; i < k_Repeats; i++)
+    {
+      outFile.write(data);
+    }
+    outFile.write("\r\n");
+    outFile.close();
+
+    CtfReader smallReader;
+    smallReader.setFileName(UnitTest::CtfReaderTest::EuropeanInputFile1);
+    int err = smallReader.readFile();
+    DREAM3D_REQUIRED(err, ==, 0)
+
+    CtfReader largeReader;
+    largeReader.setFileName(filePath);
+    err = largeReader.readFile();
+    DREAM3D_REQUIRED(err, ==, 0)
+
+    size_t smallCount = smallReader.getNumberOfElements();
+    size_t largeCount = largeReader.getNumberOfElements();
+    DREAM3D_REQUIRE_EQUAL(largeCount, smallCount * k_Repeats)
+
+    QList<QString> columnNames = smallReader.getColumnNames();
+    DREAM3D_REQUIRE(columnNames == largeReader.getColumnNames())
+    for(const auto& name : columnNames)
+    {
+      // Int32 and Float columns are both 4 bytes wide
+      const int32_t* smallPtr = reinterpret_cast<const int32_t*>(smallReader.getPointerByName(name));
+      const int32_t* largePtr = reinterpret_cast<const int32_t*>(largeReader.getPointerByName(name));
+      DREAM3D_REQUIRE_VALID_POINTER(smallPtr)
+      DREAM3D_REQUIRE_VALID_POINTER(largePtr)
+      for(size_t i = 0; i < largeCount; i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(largePtr[i], smallPtr[i % smallCount])
+      }
+    }
+
+    if(REMOVE_TEST_FILES == 1)
+    {
+      bool removed = QFile::remove(filePath);
+      DREAM3D_REQUIRE(removed == true);
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestReadFileInBatches()
+  {
+    // Reading in batches must give the same values as reading the complete file
+    QStringList files = {UnitTest::CtfReaderTest::USInputFile1, UnitTest::CtfReaderTest::EuropeanInputFile2, UnitTest::CtfReaderTest::ShortFile};
+    for(const auto& file : files)
+    {
+      CtfReader reader;
+      reader.setFileName(file);
+      int err = reader.readFile();
+
+      CtfReader batchReader;
+      batchReader.setFileName(file);
+      size_t numPoints = 0;
+      QMap<QString, QVector<int32_t>> columns;
+      int batchErr = batchReader.readFileInBatches(3, [&](const EbsdRowBatch& batch) {
+        DREAM3D_REQUIRE(batch.getNumberOfPoints() <= 3)
+        DREAM3D_REQUIRE_EQUAL(batch.getStartIndex(), numPoints)
+        for(const auto& name : batch.getColumnNames())
+        {
+          // Int32 and Float columns are both 4 bytes wide
+          const int32_t* values = batch.getPointer<int32_t>(name);
+          DREAM3D_REQUIRE_VALID_POINTER(values)
+          for(size_t i = 0; i < batch.getNumberOfPoints(); i++)
+          {
+            columns[name].push_back(values[i]);
+          }
+        }
+        numPoints += batch.getNumberOfPoints();
+        return true;
+      });
+
+      DREAM3D_REQUIRE_EQUAL(batchErr, err)
+      DREAM3D_REQUIRE_EQUAL(batchReader.getNumberOfElements(), reader.getNumberOfElements())
+      DREAM3D_REQUIRE(batchReader.getColumnNames().isEmpty())
+      if(err < 0)
+      {
+        continue;
+      }
+      DREAM3D_REQUIRE_EQUAL(numPoints, reader.getNumberOfElements())
+      DREAM3D_REQUIRE(columns.keys() == reader.getColumnNames())
+      for(const auto& name : reader.getColumnNames())
+      {
+        const int32_t* values = reinterpret_cast<const int32_t*>(reader.getPointerByName(name));
+        DREAM3D_REQUIRE_EQUAL(::memcmp(columns[name].data(), values, numPoints * sizeof(int32_t)), 0)
+      }
+    }
+  }
+
+  void TestArraysToRead()
+  {
+    CtfReader reader;
+    reader.setFileName(UnitTest::CtfReaderTest::USInputFile1);
+    int err = reader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+
+    // Only the requested columns get a parser
+    CtfReader projReader;
+    projReader.setFileName(UnitTest::CtfReaderTest::USInputFile1);
+    QSet<QString> names = {EbsdLib::Ctf::Phase, EbsdLib::Ctf::Euler1, EbsdLib::Ctf::Euler2, EbsdLib::Ctf::Euler3};
+    projReader.setArraysToRead(names);
+    projReader.readAllArrays(false);
+    err = projReader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRE_EQUAL(projReader.getColumnNames().size(), 4)
+    DREAM3D_REQUIRE(projReader.getPointerByName(EbsdLib::Ctf::Bands) == nullptr)
+    DREAM3D_REQUIRE(projReader.getPointerByName(EbsdLib::Ctf::MAD) == nullptr)
+    size_t numPoints = reader.getNumberOfElements();
+    DREAM3D_REQUIRE_EQUAL(projReader.getNumberOfElements(), numPoints)
+    for(const auto& name : names)
+    {
+      void* values = projReader.getPointerByName(name);
+      DREAM3D_REQUIRE_VALID_POINTER(values)
+      DREAM3D_REQUIRE_EQUAL(::memcmp(values, reader.getPointerByName(name), numPoints * sizeof(int32_t)), 0)
+    }
+
+    // Asking for nothing is an error
+    CtfReader emptyReader;
+    emptyReader.setFileName(UnitTest::CtfReaderTest::USInputFile1);
+    emptyReader.readAllArrays(false);
+    err = emptyReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, -121)
+  }
+
+  void TestRegionOfInterest()
+  {
+    CtfReader reader;
+    reader.setFileName(UnitTest::CtfReaderTest::USInputFile1);
+    int err = reader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    int xCells = reader.getXCells();
+    int yCells = reader.getYCells();
+    int x0 = 1;
+    int y0 = 1;
+    int width = xCells - 2;
+    int height = yCells - 1;
+
+    CtfReader roiReader;
+    roiReader.setFileName(UnitTest::CtfReaderTest::USInputFile1);
+    roiReader.setRegionOfInterest(x0, y0, width, height);
+    err = roiReader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRE_EQUAL(roiReader.getNumberOfElements(), static_cast<size_t>(width * height))
+    for(int y = 0; y < height; y++)
+    {
+      for(int x = 0; x < width; x++)
+      {
+        size_t roiIndex = static_cast<size_t>(y * width + x);
+        size_t index = static_cast<size_t>((y0 + y) * xCells + x0 + x);
+        DREAM3D_REQUIRE_EQUAL(roiReader.getEuler1Pointer()[roiIndex], reader.getEuler1Pointer()[index])
+        DREAM3D_REQUIRE_EQUAL(roiReader.getXPointer()[roiIndex], reader.getXPointer()[index])
+        DREAM3D_REQUIRE_EQUAL(roiReader.getPhasePointer()[roiIndex], reader.getPhasePointer()[index])
+      }
+    }
+
+    // A region that does not fit inside the scan is an error
+    roiReader.setRegionOfInterest(0, yCells - 1, 1, 2);
+    err = roiReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, -131)
+  }
+
+  void TestDestinationBuffers()
+  {
+    CtfReader reader;
+    reader.setFileName(UnitTest::CtfReaderTest::USInputFile1);
+    int err = reader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    size_t numPoints = reader.getNumberOfElements();
+
+    // The Euler angles go into one interleaved array, the phases into a packed one
+    std::vector<float> eulers(numPoints * 3, -1.0f);
+    std::vector<int32_t> phases(numPoints, -1);
+    CtfReader bufferReader;
+    bufferReader.setFileName(UnitTest::CtfReaderTest::USInputFile1);
+    bufferReader.setDestinationBuffer(EbsdLib::Ctf::Euler1, eulers.data(), eulers.size(), 3);
+    bufferReader.setDestinationBuffer(EbsdLib::Ctf::Euler2, eulers.data() + 1, eulers.size() - 1, 3);
+    bufferReader.setDestinationBuffer(EbsdLib::Ctf::Euler3, eulers.data() + 2, eulers.size() - 2, 3);
+    bufferReader.setDestinationBuffer(EbsdLib::Ctf::Phase, phases.data(), phases.size());
+    err = bufferReader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRE(bufferReader.getEuler1Pointer() == eulers.data())
+    DREAM3D_REQUIRE(bufferReader.getPhasePointer() == phases.data())
+    for(size_t i = 0; i < numPoints; i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(eulers[i * 3], reader.getEuler1Pointer()[i])
+      DREAM3D_REQUIRE_EQUAL(eulers[i * 3 + 1], reader.getEuler2Pointer()[i])
+      DREAM3D_REQUIRE_EQUAL(eulers[i * 3 + 2], reader.getEuler3Pointer()[i])
+      DREAM3D_REQUIRE_EQUAL(phases[i], reader.getPhasePointer()[i])
+    }
+    DREAM3D_REQUIRE_EQUAL(::memcmp(bufferReader.getMeanAngularDeviationPointer(), reader.getMeanAngularDeviationPointer(), numPoints * sizeof(float)), 0)
+
+    // A buffer that can not hold every scan point is an error
+    CtfReader smallReader;
+    smallReader.setFileName(UnitTest::CtfReaderTest::USInputFile1);
+    smallReader.setDestinationBuffer(EbsdLib::Ctf::Phase, phases.data(), numPoints - 1);
+    err = smallReader.readFile();
+    DREAM3D_REQUIRE_EQUAL(err, -95001)
+  }
+
+  void TestCompressedFile()
+  {
+#ifdef EbsdLib_USE_ZSTD
+    QFile plainFile(UnitTest::CtfReaderTest::EuropeanInputFile1);
+    DREAM3D_REQUIRE(plainFile.open(QIODevice::ReadOnly))
+    QByteArray contents = plainFile.readAll();
+    QByteArray compressed(static_cast<int>(ZSTD_compressBound(static_cast<size_t>(contents.size()))), Qt::Uninitialized);
+    size_t compressedSize = ZSTD_compress(compressed.data(), static_cast<size_t>(compressed.size()), contents.constData(), static_cast<size_t>(contents.size()), 3);
+    DREAM3D_REQUIRE(ZSTD_isError(compressedSize) == 0)
+    compressed.resize(static_cast<int>(compressedSize));
+
+    QString filePath = QString("%1/%2").arg(UnitTest::TestTempDir).arg("CTF_Compressed_test.ctf.zst");
+    QFile zstFile(filePath);
+    DREAM3D_REQUIRE(zstFile.open(QIODevice::WriteOnly))
+    zstFile.write(compressed);
+    zstFile.close();
+
+    CtfReader reader;
+    reader.setFileName(UnitTest::CtfReaderTest::EuropeanInputFile1);
+    int err = reader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+
+    CtfReader zstReader;
+    zstReader.setFileName(filePath);
+    err = zstReader.readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRE_EQUAL(zstReader.getNumberOfElements(), reader.getNumberOfElements())
+    DREAM3D_REQUIRE(zstReader.getColumnNames() == reader.getColumnNames())
+    size_t numPoints = reader.getNumberOfElements();
+    for(const auto& name : reader.getColumnNames())
+    {
+      DREAM3D_REQUIRE_EQUAL(::memcmp(zstReader.getPointerByName(name), reader.getPointerByName(name), numPoints * sizeof(int32_t)), 0)
+    }
+    if(REMOVE_TEST_FILES == 1)
+    {
+      QFile::remove(filePath);
+    }
+#endif
+  }
+
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
@@ -247,6 +566,12 @@ public:
     DREAM3D_REGISTER_TEST(TestShortFile())
     DREAM3D_REGISTER_TEST(TestZeroXYCells())
     DREAM3D_REGISTER_TEST(TestWriteCtfFile());
+    DREAM3D_REGISTER_TEST(TestParallelParsing())
+    DREAM3D_REGISTER_TEST(TestReadFileInBatches())
+    DREAM3D_REGISTER_TEST(TestArraysToRead())
+    DREAM3D_REGISTER_TEST(TestRegionOfInterest())
+    DREAM3D_REGISTER_TEST(TestDestinationBuffers())
+    DREAM3D_REGISTER_TEST(TestCompressedFile())
   }
 
 public:
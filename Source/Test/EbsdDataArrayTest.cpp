@@ -0,0 +1,371 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#include "EbsdLib/Core/EbsdArrayAllocator.h"
+#include "EbsdLib/Core/EbsdDataArray.hpp"
+
+#include "UnitTestSupport.hpp"
+
+#include "EbsdLib/Test/EbsdLibTestFileLocations.h"
+
+class EbsdDataArrayTest
+{
+public:
+  EbsdDataArrayTest() = default;
+  virtual ~EbsdDataArrayTest() = default;
+
+  QString PersistentFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("EbsdDataArray_Persistent.bin");
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    QFile::remove(PersistentFile());
+    QFile::remove(PersistentFile() + ".resize");
+    QFile::remove(PersistentFile() + ".old");
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  bool isAligned(const void* ptr, size_t alignment)
+  {
+    return (reinterpret_cast<uintptr_t>(ptr) % alignment) == 0;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestDefaultAllocation()
+  {
+    EbsdLib::FloatArrayType::Pointer array = EbsdLib::FloatArrayType::CreateArray(1000, {3}, "Default", true);
+    DREAM3D_REQUIRE_VALID_POINTER(array.get())
+    DREAM3D_REQUIRE(array->isAllocated())
+    DREAM3D_REQUIRE(array->getArrayAllocator() == nullptr)
+    DREAM3D_REQUIRE(array->getInitializeOnAllocate())
+    for(size_t i = 0; i < array->getSize(); i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(array->getValue(i), 0.0f)
+      array->setValue(i, static_cast<float>(i));
+    }
+
+    // Existing values are kept and the new tuples receive the init value
+    array->setInitValue(-1.0f);
+    array->resizeTuples(1500);
+    DREAM3D_REQUIRE_EQUAL(array->getSize(), 4500)
+    DREAM3D_REQUIRE_EQUAL(array->getValue(2999), 2999.0f)
+    DREAM3D_REQUIRE_EQUAL(array->getValue(3000), -1.0f)
+    DREAM3D_REQUIRE_EQUAL(array->getValue(4499), -1.0f)
+
+    array->resizeTuples(10);
+    DREAM3D_REQUIRE_EQUAL(array->getSize(), 30)
+    DREAM3D_REQUIRE_EQUAL(array->getValue(29), 29.0f)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestAlignedAllocator()
+  {
+    EbsdAlignedAllocator::Pointer allocator = EbsdAlignedAllocator::New();
+    DREAM3D_REQUIRE_EQUAL(allocator->getAlignment(), 64)
+    DREAM3D_REQUIRE_EQUAL(EbsdAlignedAllocator::New(3)->getAlignment(), sizeof(void*))
+
+    EbsdLib::FloatArrayType::Pointer array = EbsdLib::FloatArrayType::CreateUninitializedArray(1001, {4}, "Aligned", allocator);
+    DREAM3D_REQUIRE_VALID_POINTER(array.get())
+    DREAM3D_REQUIRE(array->isAllocated())
+    DREAM3D_REQUIRE(array->getAllocator() == allocator)
+    DREAM3D_REQUIRE(array->getArrayAllocator() == allocator)
+    DREAM3D_REQUIRE(isAligned(array->getPointer(0), 64))
+    for(size_t i = 0; i < array->getSize(); i++)
+    {
+      array->setValue(i, static_cast<float>(i));
+    }
+
+    // Resizing keeps the allocator and the alignment
+    array->resizeTuples(2000);
+    DREAM3D_REQUIRE(isAligned(array->getPointer(0), 64))
+    DREAM3D_REQUIRE(array->getArrayAllocator() == allocator)
+    DREAM3D_REQUIRE_EQUAL(array->getValue(4003), 4003.0f)
+    DREAM3D_REQUIRE_EQUAL(array->getValue(4004), 0.0f)
+    DREAM3D_REQUIRE_EQUAL(array->getValue(7999), 0.0f)
+
+    EbsdLib::FloatArrayType::Pointer copy = array->deepCopy();
+    DREAM3D_REQUIRE_VALID_POINTER(copy.get())
+    DREAM3D_REQUIRE(copy->getArrayAllocator() == allocator)
+    DREAM3D_REQUIRE(isAligned(copy->getPointer(0), 64))
+    DREAM3D_REQUIRE(std::equal(array->begin(), array->end(), copy->begin()))
+
+    // Memory from an allocator can not change owner so the other array receives a copy
+    EbsdLib::FloatArrayType::Pointer moved = copy->moveToDataArrayType<EbsdLib::FloatArrayType>();
+    DREAM3D_REQUIRE_VALID_POINTER(moved.get())
+    DREAM3D_REQUIRE(moved->getPointer(0) != copy->getPointer(0))
+    DREAM3D_REQUIRE(moved->getArrayAllocator() == nullptr)
+    DREAM3D_REQUIRE(std::equal(array->begin(), array->end(), moved->begin()))
+
+    // Memory from new[] still changes owner
+    EbsdLib::FloatArrayType::Pointer plain = EbsdLib::FloatArrayType::CreateArray(10, {1}, "Plain", true);
+    float* plainPtr = plain->getPointer(0);
+    moved = plain->moveToDataArrayType<EbsdLib::FloatArrayType>();
+    DREAM3D_REQUIRE(moved->getPointer(0) == plainPtr)
+
+    // Huge pages only change the alignment of large blocks
+    EbsdAlignedAllocator::Pointer hugeAllocator = EbsdAlignedAllocator::New(64, true);
+    DREAM3D_REQUIRE(hugeAllocator->getUseHugePages())
+    EbsdLib::FloatArrayType::Pointer large = EbsdLib::FloatArrayType::CreateUninitializedArray(EbsdAlignedAllocator::k_HugePageSize, {1}, "Large", hugeAllocator);
+    DREAM3D_REQUIRE_VALID_POINTER(large.get())
+    DREAM3D_REQUIRE(isAligned(large->getPointer(0), EbsdAlignedAllocator::k_HugePageSize))
+    large->initializeWithValue(1.0f);
+    DREAM3D_REQUIRE_EQUAL(large->getValue(large->getSize() - 1), 1.0f)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestUninitializedAllocation()
+  {
+    EbsdLib::Int32ArrayType::Pointer array = EbsdLib::Int32ArrayType::CreateArray(100, {1}, "Uninitialized", false);
+    DREAM3D_REQUIRE(!array->isAllocated())
+    array->setInitializeOnAllocate(false);
+    DREAM3D_REQUIRE(!array->getInitializeOnAllocate())
+    DREAM3D_REQUIRE_EQUAL(array->allocate(), 1)
+    DREAM3D_REQUIRE(array->isAllocated())
+    DREAM3D_REQUIRE_EQUAL(array->getNumberOfTuples(), 100)
+    for(size_t i = 0; i < 100; i++)
+    {
+      array->setValue(i, static_cast<int32_t>(i));
+    }
+
+    // The init value is not written into new tuples but the old values are kept
+    array->setInitValue(7);
+    array->resizeTuples(200);
+    DREAM3D_REQUIRE_EQUAL(array->getValue(99), 99)
+
+    EbsdLib::Int32ArrayType::Pointer copy = array->deepCopy();
+    DREAM3D_REQUIRE(!copy->getInitializeOnAllocate())
+    DREAM3D_REQUIRE_EQUAL(copy->getValue(99), 99)
+
+    EbsdLib::Int32ArrayType::Pointer empty = EbsdLib::Int32ArrayType::CreateUninitializedArray(0, {1}, "Empty");
+    DREAM3D_REQUIRE_VALID_POINTER(empty.get())
+    DREAM3D_REQUIRE_EQUAL(empty->getSize(), 0)
+    DREAM3D_REQUIRE_NULL_POINTER(EbsdLib::Int32ArrayType::CreateUninitializedArray(10, {1}, "").get())
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestArenaAllocator()
+  {
+    const size_t k_BlockSize = 1024 * 1024;
+    EbsdArenaAllocator::Pointer arena = EbsdArenaAllocator::New(k_BlockSize);
+    DREAM3D_REQUIRE_EQUAL(arena->getBlockSize(), k_BlockSize)
+    DREAM3D_REQUIRE_EQUAL(arena->getNumberOfBlocks(), 0)
+
+    std::vector<EbsdLib::FloatArrayType::Pointer> arrays;
+    for(size_t a = 0; a < 10; a++)
+    {
+      EbsdLib::FloatArrayType::Pointer array = EbsdLib::FloatArrayType::CreateUninitializedArray(10000 + a, {1}, "Arena", arena);
+      DREAM3D_REQUIRE_VALID_POINTER(array.get())
+      DREAM3D_REQUIRE(isAligned(array->getPointer(0), 64))
+      array->initializeWithValue(static_cast<float>(a));
+      arrays.push_back(array);
+    }
+    // All the arrays fit into one block and none of them overlap
+    DREAM3D_REQUIRE_EQUAL(arena->getNumberOfBlocks(), 1)
+    for(size_t a = 0; a < arrays.size(); a++)
+    {
+      DREAM3D_REQUIRE_EQUAL(arrays[a]->getValue(0), static_cast<float>(a))
+      DREAM3D_REQUIRE_EQUAL(arrays[a]->getValue(arrays[a]->getSize() - 1), static_cast<float>(a))
+    }
+
+    // Erasing tuples moves the array to new memory of the same arena
+    EbsdLib::FloatArrayType::comp_dims_type idxs = {0, 5, 9999};
+    DREAM3D_REQUIRE_EQUAL(arrays[9]->eraseTuples(idxs), 0)
+    DREAM3D_REQUIRE(arrays[9]->getArrayAllocator() == arena)
+    DREAM3D_REQUIRE_EQUAL(arrays[9]->getSize(), 10006)
+    DREAM3D_REQUIRE_EQUAL(arrays[9]->getValue(10005), 9.0f)
+
+    // Large arrays get a block of their own that is freed with the array
+    EbsdLib::FloatArrayType::Pointer large = EbsdLib::FloatArrayType::CreateUninitializedArray(k_BlockSize / 4, {1}, "Large", arena);
+    DREAM3D_REQUIRE_VALID_POINTER(large.get())
+    DREAM3D_REQUIRE_EQUAL(arena->getNumberOfBlocks(), 2)
+    large = EbsdLib::FloatArrayType::NullPointer();
+    DREAM3D_REQUIRE_EQUAL(arena->getNumberOfBlocks(), 1)
+
+    // The arrays keep the arena alive
+    arena = EbsdArenaAllocator::NullPointer();
+    DREAM3D_REQUIRE_EQUAL(arrays[0]->getValue(9999), 0.0f)
+    arrays.clear();
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestTemporaryFileBackedArray()
+  {
+    EbsdLib::FloatArrayType::Pointer array = EbsdLib::FloatArrayType::CreateFileBackedArray(100000, {4}, "Quats");
+    DREAM3D_REQUIRE_VALID_POINTER(array.get())
+    EbsdMappedFileAllocator::Pointer allocator = std::dynamic_pointer_cast<EbsdMappedFileAllocator>(array->getArrayAllocator());
+    DREAM3D_REQUIRE_VALID_POINTER(allocator.get())
+    DREAM3D_REQUIRE(allocator->getFileMode() == EbsdMappedFileAllocator::FileMode::Temporary)
+    QString filePath = allocator->getMappedFilePath(array->getPointer(0));
+    DREAM3D_REQUIRE(QFile::exists(filePath))
+    DREAM3D_REQUIRE_EQUAL(QFileInfo(filePath).size(), 1600000)
+
+    // A new temporary file reads as zero
+    DREAM3D_REQUIRE(std::all_of(array->begin(), array->end(), [](float value) { return value == 0.0f; }))
+    float value = 0.0f;
+    for(auto& element : *array)
+    {
+      element = value;
+      value += 1.0f;
+    }
+    DREAM3D_REQUIRE_EQUAL(array->getComponent(99999, 3), 399999.0f)
+
+    // Copies between heap and file backed arrays
+    EbsdLib::FloatArrayType::Pointer heapArray = EbsdLib::FloatArrayType::CreateArray(100, {4}, "Heap", true);
+    DREAM3D_REQUIRE(heapArray->copyFromArray(0, array, 1000, 100))
+    DREAM3D_REQUIRE_EQUAL(heapArray->getComponent(0, 0), 4000.0f)
+    heapArray->initializeWithValue(-1.0f);
+    DREAM3D_REQUIRE(array->copyFromArray(0, heapArray, 0, 100))
+    DREAM3D_REQUIRE_EQUAL(array->getComponent(99, 3), -1.0f)
+    DREAM3D_REQUIRE_EQUAL(array->getComponent(100, 0), 400.0f)
+
+    // Copies and new arrays get temporary files of their own
+    EbsdLib::FloatArrayType::Pointer copy = array->deepCopy();
+    DREAM3D_REQUIRE_VALID_POINTER(copy.get())
+    DREAM3D_REQUIRE(copy->getArrayAllocator() == allocator)
+    QString copyPath = allocator->getMappedFilePath(copy->getPointer(0));
+    DREAM3D_REQUIRE(!copyPath.isEmpty())
+    DREAM3D_REQUIRE(copyPath != filePath)
+    DREAM3D_REQUIRE(std::equal(array->begin(), array->end(), copy->begin()))
+
+    EbsdLib::FloatArrayType::Pointer newArray = array->createNewArray(10, {3}, "New", true);
+    DREAM3D_REQUIRE(newArray->getArrayAllocator() == allocator)
+    DREAM3D_REQUIRE_EQUAL(newArray->getValue(29), 0.0f)
+
+    // Resizing moves the values to a new file and removes the old one
+    array->resizeTuples(200000);
+    DREAM3D_REQUIRE(!QFile::exists(filePath))
+    DREAM3D_REQUIRE_EQUAL(array->getComponent(99999, 3), 399999.0f)
+    DREAM3D_REQUIRE_EQUAL(array->getComponent(199999, 3), 0.0f)
+
+    copy = EbsdLib::FloatArrayType::NullPointer();
+    DREAM3D_REQUIRE(!QFile::exists(copyPath))
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestPersistentFileBackedArray()
+  {
+    QFile::remove(PersistentFile());
+    QFile::remove(PersistentFile() + ".resize");
+    QFile::remove(PersistentFile() + ".old");
+
+    EbsdLib::Int32ArrayType::Pointer array = EbsdLib::Int32ArrayType::CreateFileBackedArray(1000, {3}, "Persistent", PersistentFile());
+    DREAM3D_REQUIRE_VALID_POINTER(array.get())
+    EbsdMappedFileAllocator::Pointer allocator = std::dynamic_pointer_cast<EbsdMappedFileAllocator>(array->getArrayAllocator());
+    DREAM3D_REQUIRE_VALID_POINTER(allocator.get())
+    DREAM3D_REQUIRE(allocator->getMappedFilePath(array->getPointer(0)) == PersistentFile())
+    for(size_t i = 0; i < array->getSize(); i++)
+    {
+      array->setValue(i, static_cast<int32_t>(i));
+    }
+
+    // The resized values end up in the same file
+    array->resizeTuples(2000);
+    DREAM3D_REQUIRE(allocator->getMappedFilePath(array->getPointer(0)) == PersistentFile())
+    DREAM3D_REQUIRE(!QFile::exists(PersistentFile() + ".resize"))
+    DREAM3D_REQUIRE(!QFile::exists(PersistentFile() + ".old"))
+    DREAM3D_REQUIRE_EQUAL(array->getValue(2999), 2999)
+    array->setValue(5999, 5999);
+
+    // Copies are not written into the persistent file
+    EbsdLib::Int32ArrayType::Pointer copy = array->deepCopy();
+    EbsdMappedFileAllocator::Pointer copyAllocator = std::dynamic_pointer_cast<EbsdMappedFileAllocator>(copy->getArrayAllocator());
+    DREAM3D_REQUIRE_VALID_POINTER(copyAllocator.get())
+    DREAM3D_REQUIRE(copyAllocator->getFileMode() == EbsdMappedFileAllocator::FileMode::Temporary)
+    DREAM3D_REQUIRE(copyAllocator->getMappedFilePath(copy->getPointer(0)) != PersistentFile())
+    DREAM3D_REQUIRE_EQUAL(copy->getValue(5999), 5999)
+    copy = EbsdLib::Int32ArrayType::NullPointer();
+
+    // The file keeps the values after the array is gone and can be opened again
+    array = EbsdLib::Int32ArrayType::NullPointer();
+    DREAM3D_REQUIRE_EQUAL(QFileInfo(PersistentFile()).size(), static_cast<qint64>(2000 * 3 * sizeof(int32_t)))
+    array = EbsdLib::Int32ArrayType::CreateFileBackedArray(2000, {3}, "Persistent", PersistentFile());
+    DREAM3D_REQUIRE_VALID_POINTER(array.get())
+    DREAM3D_REQUIRE_EQUAL(array->getValue(0), 0)
+    DREAM3D_REQUIRE_EQUAL(array->getValue(2999), 2999)
+    DREAM3D_REQUIRE_EQUAL(array->getValue(5999), 5999)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### EbsdDataArrayTest Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestDefaultAllocation())
+    DREAM3D_REGISTER_TEST(TestAlignedAllocator())
+    DREAM3D_REGISTER_TEST(TestUninitializedAllocation())
+    DREAM3D_REGISTER_TEST(TestArenaAllocator())
+    DREAM3D_REGISTER_TEST(TestTemporaryFileBackedArray())
+    DREAM3D_REGISTER_TEST(TestPersistentFileBackedArray())
+    DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  }
+
+public:
+  EbsdDataArrayTest(const EbsdDataArrayTest&) = delete;            // Copy Constructor Not Implemented
+  EbsdDataArrayTest(EbsdDataArrayTest&&) = delete;                 // Move Constructor Not Implemented
+  EbsdDataArrayTest& operator=(const EbsdDataArrayTest&) = delete; // Copy Assignment Not Implemented
+  EbsdDataArrayTest& operator=(EbsdDataArrayTest&&) = delete;      // Move Assignment Not Implemented
+};
@@ -33,12 +33,16 @@
 *
 * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <cmath>
 #include <cstring>
+#include <map>
+#include <vector>
 
 #include <QtCore/QDebug>
 #include <QtCore/QFile>
 
 #include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/IO/H5ScanCatalog.h"
 #include "EbsdLib/IO/TSL/AngReader.h"
 #include "EbsdLib/IO/TSL/H5OIMReader.h"
 #include "EbsdLib/Test/EbsdLibTestFileLocations.h"
@@ -118,12 +122,122 @@ public:
     }
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestRegionOfInterest()
+  {
+    H5OIMReader::Pointer reader = H5OIMReader::New();
+    reader->setFileName(UnitTest::AngImportTest::EdaxOIMH5File);
+    reader->setHDF5Path("Scan_1");
+    reader->setReadPatternData(false);
+    int err = reader->readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    const size_t numColumns = static_cast<size_t>(reader->getNumColumns());
+    std::vector<float> phi1(reader->getPhi1Pointer(), reader->getPhi1Pointer() + reader->getNumberOfElements());
+    std::vector<int> phases(reader->getPhaseDataPointer(), reader->getPhaseDataPointer() + reader->getNumberOfElements());
+
+    const int x0 = 17;
+    const int y0 = 40;
+    const int width = 101;
+    const int height = 111;
+    reader->setRegionOfInterest(x0, y0, width, height);
+    err = reader->readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRED(reader->getNumberOfElements(), ==, static_cast<size_t>(width * height))
+    DREAM3D_REQUIRED(reader->getXDimension(), ==, 186)
+    DREAM3D_REQUIRED(reader->getYDimension(), ==, 151)
+    float* roiPhi1 = reader->getPhi1Pointer();
+    int* roiPhases = reader->getPhaseDataPointer();
+    for(int y = 0; y < height; y++)
+    {
+      for(int x = 0; x < width; x++)
+      {
+        size_t index = static_cast<size_t>(y0 + y) * numColumns + static_cast<size_t>(x0 + x);
+        DREAM3D_REQUIRED(roiPhi1[y * width + x], ==, phi1[index])
+        DREAM3D_REQUIRED(roiPhases[y * width + x], ==, phases[index])
+      }
+    }
+
+    // The region has to fit inside the scan
+    reader->setRegionOfInterest(100, 100, 50, 52);
+    err = reader->readFile();
+    DREAM3D_REQUIRED(err, <, 0)
+
+    // An empty region reads the complete scan again
+    reader->setRegionOfInterest(0, 0, 0, 0);
+    err = reader->readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRED(reader->getNumberOfElements(), ==, phi1.size())
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestScanCatalog()
+  {
+    H5ScanCatalog::Pointer catalog = H5ScanCatalog::New();
+    DREAM3D_REQUIRED(catalog->summarize(), ==, -3)
+    DREAM3D_REQUIRED(catalog->open("Some Random Path"), ==, -1)
+    DREAM3D_REQUIRE_EQUAL(catalog->isOpen(), false)
+
+    int err = catalog->open(UnitTest::AngImportTest::EdaxOIMH5File);
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRE(catalog->getFormat() == H5ScanCatalog::Format::EdaxOIM)
+    DREAM3D_REQUIRED(catalog->getScans().size(), ==, 1)
+    const H5ScanCatalog::ScanInfo* scan = catalog->getScan("Scan_1");
+    DREAM3D_REQUIRE_VALID_POINTER(scan)
+    DREAM3D_REQUIRED(scan->errorCode, >=, 0)
+    DREAM3D_REQUIRED(scan->numColumns, ==, 186)
+    DREAM3D_REQUIRED(scan->numRows, ==, 151)
+    DREAM3D_REQUIRE(scan->columns.contains(EbsdLib::Ang::CI))
+    DREAM3D_REQUIRE(scan->columns.contains(EbsdLib::Ang::Phase))
+    DREAM3D_REQUIRE_EQUAL(scan->hasSummary, false)
+
+    H5OIMReader::Pointer reader = H5OIMReader::New();
+    reader->setFileName(UnitTest::AngImportTest::EdaxOIMH5File);
+    reader->setHDF5Path("Scan_1");
+    reader->setReadPatternData(false);
+    err = reader->readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRED(scan->phases.size(), ==, static_cast<size_t>(reader->getPhaseVector().size()))
+    DREAM3D_REQUIRED(scan->grid, ==, reader->getGrid())
+
+    // The summary has to match the values of the complete scan
+    err = catalog->summarize();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRE_EQUAL(scan->hasSummary, true)
+    DREAM3D_REQUIRED(scan->qualityName, ==, EbsdLib::Ang::CI)
+    const size_t numPoints = reader->getNumberOfElements();
+    DREAM3D_REQUIRED(scan->numPoints, ==, numPoints)
+    double sum = 0.0;
+    std::map<int, size_t> counts;
+    for(size_t i = 0; i < numPoints; i++)
+    {
+      sum += reader->getConfidenceIndexPointer()[i];
+      counts[reader->getPhaseDataPointer()[i]]++;
+    }
+    DREAM3D_REQUIRED(std::fabs(scan->meanQuality - sum / static_cast<double>(numPoints)), <, 1.0E-6)
+    DREAM3D_REQUIRED(scan->phaseFractions.size(), ==, counts.size())
+    for(const auto& count : counts)
+    {
+      double fraction = static_cast<double>(count.second) / static_cast<double>(numPoints);
+      DREAM3D_REQUIRED(std::fabs(scan->phaseFractions.at(count.first) - fraction), <, 1.0E-9)
+    }
+
+    catalog->close();
+    DREAM3D_REQUIRE_EQUAL(catalog->isOpen(), false)
+    DREAM3D_REQUIRED(catalog->getScans().size(), ==, 0)
+  }
+
   void operator()()
   {
     int err = EXIT_SUCCESS;
     std::cout << "#-- EdaxOIMReaderTest Starting " << std::endl;
 
     DREAM3D_REGISTER_TEST(TestH5OIMReader())
+    DREAM3D_REGISTER_TEST(TestRegionOfInterest())
+    DREAM3D_REGISTER_TEST(TestScanCatalog())
 
     DREAM3D_REGISTER_TEST(RemoveTestFiles())
   }
@@ -1,4 +1,6 @@
 
+#include <vector>
+
 #include <QtCore/QFile>
 #include <QtCore/QString>
 
@@ -210,6 +212,45 @@ public:
 #endif
   }
 
+  // -----------------------------------------------------------------------------
+  void TestRegionOfInterest()
+  {
+    H5EspritReader::Pointer reader = H5EspritReader::New();
+    reader->setFileName(UnitTest::H5EspritReaderTest::InputFile);
+    reader->setHDF5Path(k_HDF5Path);
+    int32_t err = reader->readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    const size_t numColumns = static_cast<size_t>(reader->getNumColumns());
+    std::vector<float> phi1(reader->getphi1Pointer(), reader->getphi1Pointer() + reader->getNumberOfElements());
+    std::vector<int32_t> phases(reader->getPhasePointer(), reader->getPhasePointer() + reader->getNumberOfElements());
+
+    const int x0 = 120;
+    const int y0 = 355;
+    const int width = 64;
+    const int height = 48;
+    reader->setRegionOfInterest(x0, y0, width, height);
+    err = reader->readFile();
+    DREAM3D_REQUIRED(err, >=, 0)
+    DREAM3D_REQUIRED(reader->getNumberOfElements(), ==, static_cast<size_t>(width * height))
+    DREAM3D_REQUIRED(reader->getXDimension(), ==, 600)
+    float* roiPhi1 = reader->getphi1Pointer();
+    int32_t* roiPhases = reader->getPhasePointer();
+    for(int y = 0; y < height; y++)
+    {
+      for(int x = 0; x < width; x++)
+      {
+        size_t index = static_cast<size_t>(y0 + y) * numColumns + static_cast<size_t>(x0 + x);
+        DREAM3D_REQUIRED(roiPhi1[y * width + x], ==, phi1[index])
+        DREAM3D_REQUIRED(roiPhases[y * width + x], ==, phases[index])
+      }
+    }
+
+    // The region has to fit inside the scan
+    reader->setRegionOfInterest(590, 0, 20, 10);
+    err = reader->readFile();
+    DREAM3D_REQUIRED(err, <, 0)
+  }
+
   // -----------------------------------------------------------------------------
   void operator()()
   {
@@ -218,6 +259,7 @@ public:
     std::cout << "#-- H5EspritReaderTest Starting" << std::endl;
 
     DREAM3D_REGISTER_TEST(TestH5EspritReader())
+    DREAM3D_REGISTER_TEST(TestRegionOfInterest())
 
     DREAM3D_REGISTER_TEST(RemoveTestFiles())
   }
@@ -0,0 +1,345 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <hdf5.h>
+
+#include <QtCore/QFile>
+
+#include "EbsdLib/EbsdLib.h"
+#include "EbsdLib/IO/H5PatternAccessor.h"
+#include "EbsdLib/IO/TSL/AngConstants.h"
+#include "EbsdLib/IO/TSL/H5OIMReader.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "EbsdLib/Test/EbsdLibTestFileLocations.h"
+
+class H5PatternAccessorTest
+{
+  const hsize_t k_NumPatterns = 1000;
+  const hsize_t k_PatternHeight = 12;
+  const hsize_t k_PatternWidth = 10;
+  const hsize_t k_ChunkPatterns = 16;
+
+public:
+  H5PatternAccessorTest() = default;
+  virtual ~H5PatternAccessorTest() = default;
+
+  QString OutputFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("H5PatternAccessor_test.h5");
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    QFile::remove(OutputFile());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  uint8_t patternValue(size_t i)
+  {
+    return static_cast<uint8_t>((i * 7 + i / 120) % 256);
+  }
+
+  // -----------------------------------------------------------------------------
+  // Writes a contiguous 'Patterns' dataset and a chunked and compressed copy laid out like an EDAX OIM file
+  // -----------------------------------------------------------------------------
+  void WritePatternFile()
+  {
+    std::vector<uint8_t> patterns(k_NumPatterns * k_PatternHeight * k_PatternWidth);
+    for(size_t i = 0; i < patterns.size(); i++)
+    {
+      patterns[i] = patternValue(i);
+    }
+
+    hid_t fileId = H5Fcreate(OutputFile().toLatin1().data(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    DREAM3D_REQUIRED(fileId, >=, 0)
+    hsize_t dims[3] = {k_NumPatterns, k_PatternHeight, k_PatternWidth};
+    hid_t spaceId = H5Screate_simple(3, dims, nullptr);
+
+    hid_t datasetId = H5Dcreate(fileId, "Patterns", H5T_NATIVE_UINT8, spaceId, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    herr_t err = H5Dwrite(datasetId, H5T_NATIVE_UINT8, H5S_ALL, H5S_ALL, H5P_DEFAULT, patterns.data());
+    DREAM3D_REQUIRED(err, >=, 0)
+    H5Dclose(datasetId);
+
+    QString dataPath = QString("Scan 1/%1/%2").arg(EbsdLib::H5OIM::EBSD, EbsdLib::H5OIM::Data);
+    hid_t lcplId = H5Pcreate(H5P_LINK_CREATE);
+    H5Pset_create_intermediate_group(lcplId, 1);
+    hid_t dcplId = H5Pcreate(H5P_DATASET_CREATE);
+    hsize_t chunkDims[3] = {k_ChunkPatterns, k_PatternHeight, k_PatternWidth};
+    H5Pset_chunk(dcplId, 3, chunkDims);
+    H5Pset_deflate(dcplId, 5);
+    QString datasetPath = dataPath + "/" + EbsdLib::Ang::PatternData;
+    datasetId = H5Dcreate(fileId, datasetPath.toLatin1().data(), H5T_NATIVE_UINT8, spaceId, lcplId, dcplId, H5P_DEFAULT);
+    err = H5Dwrite(datasetId, H5T_NATIVE_UINT8, H5S_ALL, H5S_ALL, H5P_DEFAULT, patterns.data());
+    DREAM3D_REQUIRED(err, >=, 0)
+    H5Dclose(datasetId);
+    H5Pclose(dcplId);
+    H5Pclose(lcplId);
+
+    H5Sclose(spaceId);
+    H5Fclose(fileId);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void checkPatterns(const uint8_t* patterns, size_t first, size_t count)
+  {
+    const size_t patternSize = k_PatternHeight * k_PatternWidth;
+    for(size_t i = 0; i < count * patternSize; i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(patterns[i], patternValue(first * patternSize + i))
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void checkRandomAccess(H5PatternAccessor::Pointer accessor)
+  {
+    const size_t patternSize = k_PatternHeight * k_PatternWidth;
+    DREAM3D_REQUIRE_EQUAL(accessor->getNumberOfPatterns(), k_NumPatterns)
+    DREAM3D_REQUIRE_EQUAL(accessor->getPatternSize(), patternSize)
+    std::vector<size_t> patternDims = accessor->getPatternDims();
+    DREAM3D_REQUIRE_EQUAL(patternDims.size(), 2)
+    DREAM3D_REQUIRE_EQUAL(patternDims[0], k_PatternHeight)
+    DREAM3D_REQUIRE_EQUAL(patternDims[1], k_PatternWidth)
+
+    // Keep the cache smaller than the dataset so blocks get evicted
+    size_t blockBytes = accessor->getPatternsPerBlock() * patternSize;
+    accessor->setCacheSize(3 * blockBytes);
+
+    std::mt19937_64 generator(42);
+    std::vector<uint8_t> patterns(k_NumPatterns * patternSize);
+    for(int i = 0; i < 2000; i++)
+    {
+      size_t index = generator() % k_NumPatterns;
+      int err = accessor->readPattern(index, patterns.data());
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+      checkPatterns(patterns.data(), index, 1);
+      DREAM3D_REQUIRED(accessor->getCachedBytes(), <=, std::max(accessor->getCacheSize(), blockBytes))
+    }
+
+    for(int i = 0; i < 100; i++)
+    {
+      size_t first = generator() % k_NumPatterns;
+      size_t count = 1 + generator() % (k_NumPatterns - first);
+      int err = accessor->readPatterns(first, count, patterns.data());
+      DREAM3D_REQUIRE_EQUAL(err, 0)
+      checkPatterns(patterns.data(), first, count);
+    }
+
+    std::vector<size_t> indices = {k_NumPatterns - 1, 0, 500, 17, 17};
+    int err = accessor->readPatterns(indices, patterns.data());
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    for(size_t i = 0; i < indices.size(); i++)
+    {
+      checkPatterns(patterns.data() + i * patternSize, indices[i], 1);
+    }
+
+    // A second pattern from a cached block does not touch the file
+    accessor->clearCache();
+    size_t blockReads = accessor->getNumberOfBlockReads();
+    accessor->readPattern(0, patterns.data());
+    accessor->readPattern(std::min(accessor->getPatternsPerBlock(), accessor->getNumberOfPatterns()) - 1, patterns.data());
+    DREAM3D_REQUIRE_EQUAL(accessor->getNumberOfBlockReads(), blockReads + 1)
+
+    err = accessor->readPattern(k_NumPatterns, patterns.data());
+    DREAM3D_REQUIRE_EQUAL(err, -2)
+    err = accessor->readPatterns(k_NumPatterns - 10, 11, patterns.data());
+    DREAM3D_REQUIRE_EQUAL(err, -2)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestContiguousDataset()
+  {
+    WritePatternFile();
+    H5PatternAccessor::Pointer accessor = H5PatternAccessor::New();
+    int err = accessor->open(OutputFile(), "Patterns");
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    checkRandomAccess(accessor);
+
+    accessor->close();
+    std::vector<uint8_t> pattern(k_PatternHeight * k_PatternWidth);
+    err = accessor->readPattern(0, pattern.data());
+    DREAM3D_REQUIRE_EQUAL(err, -1)
+
+    err = accessor->open(OutputFile(), "NotAPatternDataset");
+    DREAM3D_REQUIRE_EQUAL(err, -11)
+    err = accessor->open(UnitTest::TestTempDir + "/NonExistentFile.h5", "Patterns");
+    DREAM3D_REQUIRE_EQUAL(err, -10)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestChunkedDataset()
+  {
+    H5OIMReader::Pointer reader = H5OIMReader::New();
+    reader->setFileName(OutputFile());
+    reader->setHDF5Path("Scan 1");
+    H5PatternAccessor::Pointer accessor = reader->createPatternAccessor();
+    DREAM3D_REQUIRE_VALID_POINTER(accessor.get())
+    DREAM3D_REQUIRE_EQUAL(accessor->getPatternsPerBlock(), k_ChunkPatterns)
+    checkRandomAccess(accessor);
+
+    reader->setHDF5Path("Scan 2");
+    accessor = reader->createPatternAccessor();
+    DREAM3D_REQUIRE_NULL_POINTER(accessor.get())
+    DREAM3D_REQUIRE_EQUAL(reader->getErrorCode(), -90040)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestBinnedPatterns()
+  {
+    const size_t patternSize = k_PatternHeight * k_PatternWidth;
+    std::vector<uint8_t> pattern(patternSize);
+    for(size_t i = 0; i < patternSize; i++)
+    {
+      pattern[i] = static_cast<uint8_t>(i);
+    }
+    // 12 x 10 pixels binned by 3 gives 4 x 3 pixels, the last column of the pattern is dropped
+    std::vector<uint8_t> binned(4 * 3);
+    EbsdLib::PatternBinning::binPatterns(pattern.data(), 1, k_PatternHeight, k_PatternWidth, 3, EbsdLib::PatternBinning::Mode::Average, binned.data());
+    DREAM3D_REQUIRE_EQUAL(binned[0], 11)
+    DREAM3D_REQUIRE_EQUAL(binned[5], 47)
+    EbsdLib::PatternBinning::binPatterns(pattern.data(), 1, k_PatternHeight, k_PatternWidth, 3, EbsdLib::PatternBinning::Mode::Subsample, binned.data());
+    DREAM3D_REQUIRE_EQUAL(binned[0], 0)
+    DREAM3D_REQUIRE_EQUAL(binned[5], 36)
+
+    H5OIMReader::Pointer reader = H5OIMReader::New();
+    reader->setFileName(OutputFile());
+    reader->setHDF5Path("Scan 1");
+    H5PatternAccessor::Pointer accessor = reader->createPatternAccessor();
+    DREAM3D_REQUIRE_VALID_POINTER(accessor.get())
+    std::vector<uint8_t> patterns(k_NumPatterns * patternSize);
+    int err = accessor->readPatterns(0, k_NumPatterns, patterns.data());
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    accessor->clearCache();
+    accessor->setCacheSize(0);
+
+    const std::vector<EbsdLib::PatternBinning::Mode> modes = {EbsdLib::PatternBinning::Mode::Average, EbsdLib::PatternBinning::Mode::Subsample};
+    for(size_t factor = 1; factor <= 4; factor++)
+    {
+      std::vector<size_t> binnedDims = accessor->getBinnedPatternDims(factor);
+      DREAM3D_REQUIRE_EQUAL(binnedDims.size(), 2)
+      DREAM3D_REQUIRE_EQUAL(binnedDims[0], k_PatternHeight / factor)
+      DREAM3D_REQUIRE_EQUAL(binnedDims[1], k_PatternWidth / factor)
+      const size_t binnedSize = binnedDims[0] * binnedDims[1];
+      for(const auto& mode : modes)
+      {
+        std::vector<uint8_t> expected(k_NumPatterns * binnedSize);
+        EbsdLib::PatternBinning::binPatterns(patterns.data(), k_NumPatterns, k_PatternHeight, k_PatternWidth, factor, mode, expected.data());
+
+        // A range that starts and ends inside a chunk
+        const size_t first = k_ChunkPatterns / 2;
+        const size_t count = 5 * k_ChunkPatterns + 3;
+        std::vector<uint8_t> actual(count * binnedSize);
+        err = accessor->readBinnedPatterns(first, count, factor, mode, actual.data());
+        DREAM3D_REQUIRE_EQUAL(err, 0)
+        DREAM3D_REQUIRE(std::equal(actual.begin(), actual.end(), expected.begin() + first * binnedSize))
+        // Only the partly binned block at the end of the range is left in the cache
+        DREAM3D_REQUIRED(accessor->getCachedBytes(), <=, k_ChunkPatterns * patternSize)
+
+        // A region of 7 x 4 points of a scan that is 40 points wide
+        const size_t scanColumns = 40;
+        const size_t x0 = 3;
+        const size_t y0 = 2;
+        actual.assign(7 * 4 * binnedSize, 0);
+        err = accessor->readBinnedRegion(scanColumns, x0, y0, 7, 4, factor, mode, actual.data());
+        DREAM3D_REQUIRE_EQUAL(err, 0)
+        for(size_t y = 0; y < 4; y++)
+        {
+          auto expectedRow = expected.begin() + ((y0 + y) * scanColumns + x0) * binnedSize;
+          DREAM3D_REQUIRE(std::equal(expectedRow, expectedRow + 7 * binnedSize, actual.begin() + y * 7 * binnedSize))
+        }
+      }
+    }
+
+    // The rows of a region in a scan that is 4 points wide all lie in the first chunk, which is read once
+    accessor->setCacheSize(1024 * 1024);
+    accessor->clearCache();
+    size_t blockReads = accessor->getNumberOfBlockReads();
+    std::vector<size_t> binnedDims = accessor->getBinnedPatternDims(2);
+    std::vector<uint8_t> region(2 * 4 * binnedDims[0] * binnedDims[1]);
+    err = accessor->readBinnedRegion(4, 1, 0, 2, 4, 2, EbsdLib::PatternBinning::Mode::Average, region.data());
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    DREAM3D_REQUIRE_EQUAL(accessor->getNumberOfBlockReads(), blockReads + 1)
+
+    // Binning by more than the pattern size leaves no pixels
+    DREAM3D_REQUIRE_EQUAL(accessor->getBinnedPatternDims(k_PatternWidth + 1).size(), 0)
+    err = accessor->readBinnedPatterns(0, 1, k_PatternWidth + 1, EbsdLib::PatternBinning::Mode::Average, patterns.data());
+    DREAM3D_REQUIRE_EQUAL(err, -4)
+    err = accessor->readBinnedRegion(40, 35, 0, 6, 1, 2, EbsdLib::PatternBinning::Mode::Average, patterns.data());
+    DREAM3D_REQUIRE_EQUAL(err, -2)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### H5PatternAccessorTest Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestContiguousDataset())
+    DREAM3D_REGISTER_TEST(TestChunkedDataset())
+    DREAM3D_REGISTER_TEST(TestBinnedPatterns())
+    DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  }
+
+public:
+  H5PatternAccessorTest(const H5PatternAccessorTest&) = delete;            // Copy Constructor Not Implemented
+  H5PatternAccessorTest(H5PatternAccessorTest&&) = delete;                 // Move Constructor Not Implemented
+  H5PatternAccessorTest& operator=(const H5PatternAccessorTest&) = delete; // Copy Assignment Not Implemented
+  H5PatternAccessorTest& operator=(H5PatternAccessorTest&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,231 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without
+* modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of
+* its
+* contributors may be used to endorse or promote products derived from this
+* software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+
+#include "EbsdLib/IO/EbsdNumberFormatter.hpp"
+#include "EbsdLib/IO/EbsdTextWriter.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "EbsdLib/Test/EbsdLibTestFileLocations.h"
+
+class NumberFormatterTest
+{
+public:
+  NumberFormatterTest() = default;
+  virtual ~NumberFormatterTest() = default;
+
+  QString WriterOutputFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("NumberFormatter_Writer_test.txt");
+  }
+
+  QString PrintfOutputFile()
+  {
+    return QString("%1/%2").arg(UnitTest::TestTempDir).arg("NumberFormatter_Printf_test.txt");
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    QFile::remove(WriterOutputFile());
+    QFile::remove(PrintfOutputFile());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  QByteArray formatFixed(float value, int precision, int width)
+  {
+    std::vector<char> buffer(EbsdLib::NumberFormatter::maxFixedLength(precision, width));
+    char* end = EbsdLib::NumberFormatter::formatFixed(buffer.data(), value, precision, width);
+    return QByteArray(buffer.data(), static_cast<int>(end - buffer.data()));
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  QByteArray printFixed(float value, int precision, int width)
+  {
+    char buffer[128];
+    int length = ::snprintf(buffer, sizeof(buffer), "%*.*f", width, precision, static_cast<double>(value));
+    return QByteArray(buffer, length);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestIntegers()
+  {
+    std::vector<int32_t> values = {0, 1, -1, 9, 10, -10, 99, 100, 123456789, std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::min()};
+    std::mt19937 generator(5489);
+    std::uniform_int_distribution<int32_t> distribution(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+    for(int i = 0; i < 100000; i++)
+    {
+      values.push_back(distribution(generator));
+    }
+
+    char buffer[32];
+    char expected[32];
+    for(const auto& value : values)
+    {
+      for(int width = 0; width < 14; width += 3)
+      {
+        char* end = EbsdLib::NumberFormatter::formatInt32(buffer, value, width);
+        int length = ::snprintf(expected, sizeof(expected), "%*d", width, value);
+        DREAM3D_REQUIRE(QByteArray(buffer, static_cast<int>(end - buffer)) == QByteArray(expected, length))
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestFloats()
+  {
+    std::vector<float> values = {0.0f,        -0.0f,        0.5f,      -0.5f,    1.5f,    2.5f,     0.125f,    0.00005f, 0.00015f, 12.56637f, 180.0f, -816.0f, 1.0E10f, 1.0E-10f,
+                                 3.4028235E38f, -3.4028235E38f, 1.17549435E-38f, std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN()};
+
+    // Random bit patterns cover every exponent, the other values look like real scan data
+    std::mt19937 generator(5489);
+    std::uniform_int_distribution<uint32_t> bits;
+    std::uniform_real_distribution<float> data(-1000.0f, 1000.0f);
+    for(int i = 0; i < 50000; i++)
+    {
+      uint32_t pattern = bits(generator);
+      float value = 0.0f;
+      ::memcpy(&value, &pattern, sizeof(float));
+      values.push_back(value);
+      values.push_back(data(generator));
+      // Values that land exactly on a rounding tie
+      values.push_back(std::round(data(generator) * 64.0f) / 128.0f);
+    }
+
+    for(const auto& value : values)
+    {
+      for(int precision = 0; precision < 12; precision++)
+      {
+        int width = (precision * 5) % 14;
+        DREAM3D_REQUIRE(formatFixed(value, precision, width) == printFixed(value, precision, width))
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestTextWriter()
+  {
+    const size_t k_NumRows = 30011;
+    std::vector<float> floats(k_NumRows);
+    std::vector<int32_t> ints(k_NumRows);
+    std::mt19937 generator(5489);
+    std::uniform_real_distribution<float> data(-500.0f, 500.0f);
+    std::uniform_int_distribution<int32_t> phases(-1, 12);
+    for(size_t i = 0; i < k_NumRows; i++)
+    {
+      floats[i] = data(generator);
+      ints[i] = phases(generator);
+    }
+
+    // A block size that does not divide the number of rows checks the last partial block
+    EbsdTextWriter writer;
+    writer.setRowsPerBlock(1000);
+    writer.addFloatColumn(floats.data(), 9, 5, ' ');
+    writer.addInt32Column(ints.data(), 2, '\t');
+    writer.addFloatColumn(nullptr, 0, 4, ' ');
+    writer.addInt32Column(nullptr, 0, ' ');
+    DREAM3D_REQUIRE_EQUAL(writer.getColumns().size(), 4)
+
+    FILE* f = fopen(WriterOutputFile().toLatin1().data(), "wb");
+    DREAM3D_REQUIRE_VALID_POINTER(f)
+    int err = writer.writeRows(f, k_NumRows);
+    fclose(f);
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+
+    f = fopen(PrintfOutputFile().toLatin1().data(), "wb");
+    DREAM3D_REQUIRE_VALID_POINTER(f)
+    for(size_t i = 0; i < k_NumRows; i++)
+    {
+      fprintf(f, "%9.5f %2d\t%0.4f %d \n", floats[i], ints[i], 0.0f, 0);
+    }
+    fclose(f);
+
+    QFile writerFile(WriterOutputFile());
+    DREAM3D_REQUIRE(writerFile.open(QIODevice::ReadOnly))
+    QFile printfFile(PrintfOutputFile());
+    DREAM3D_REQUIRE(printfFile.open(QIODevice::ReadOnly))
+    DREAM3D_REQUIRE(writerFile.readAll() == printfFile.readAll())
+
+    err = writer.writeRows(nullptr, k_NumRows);
+    DREAM3D_REQUIRE_EQUAL(err, -1)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### NumberFormatterTest Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestIntegers())
+    DREAM3D_REGISTER_TEST(TestFloats())
+    DREAM3D_REGISTER_TEST(TestTextWriter())
+    DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  }
+
+public:
+  NumberFormatterTest(const NumberFormatterTest&) = delete;            // Copy Constructor Not Implemented
+  NumberFormatterTest(NumberFormatterTest&&) = delete;                 // Move Constructor Not Implemented
+  NumberFormatterTest& operator=(const NumberFormatterTest&) = delete; // Copy Assignment Not Implemented
+  NumberFormatterTest& operator=(NumberFormatterTest&&) = delete;      // Move Assignment Not Implemented
+};
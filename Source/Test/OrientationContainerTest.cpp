@@ -0,0 +1,238 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <iostream>
+#include <vector>
+
+#include "EbsdLib/Core/EbsdDataArray.hpp"
+#include "EbsdLib/Core/OrientationContainer.hpp"
+#include "EbsdLib/Core/Quaternion.hpp"
+#include "EbsdLib/Math/QuaternionBatchMath.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "EbsdLib/Test/EbsdLibTestFileLocations.h"
+
+class OrientationContainerTest
+{
+public:
+  OrientationContainerTest() = default;
+  virtual ~OrientationContainerTest() = default;
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  float testValue(size_t tuple, size_t comp)
+  {
+    return static_cast<float>(tuple * 16 + comp);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestTransposeKernels()
+  {
+    // Not a multiple of the block size so the last block is a partial one
+    const size_t k_NumTuples = 3 * EbsdLib::FloatOrientationContainer::k_BlockSize + 17;
+    const size_t numComps[5] = {1, 3, 4, 5, 9};
+    for(size_t nc : numComps)
+    {
+      std::vector<std::vector<float>> planar(nc, std::vector<float>(k_NumTuples));
+      std::vector<const float*> planarIn(nc);
+      for(size_t c = 0; c < nc; c++)
+      {
+        for(size_t i = 0; i < k_NumTuples; i++)
+        {
+          planar[c][i] = testValue(i, c);
+        }
+        planarIn[c] = planar[c].data();
+      }
+
+      std::vector<float> interleaved(k_NumTuples * nc, -1.0f);
+      EbsdLib::FloatOrientationContainer::Interleave(planarIn, interleaved.data(), k_NumTuples);
+      for(size_t i = 0; i < k_NumTuples; i++)
+      {
+        for(size_t c = 0; c < nc; c++)
+        {
+          DREAM3D_REQUIRE_EQUAL(interleaved[i * nc + c], testValue(i, c))
+        }
+      }
+
+      std::vector<std::vector<float>> roundTrip(nc, std::vector<float>(k_NumTuples, -1.0f));
+      std::vector<float*> planarOut(nc);
+      for(size_t c = 0; c < nc; c++)
+      {
+        planarOut[c] = roundTrip[c].data();
+      }
+      EbsdLib::FloatOrientationContainer::Deinterleave(interleaved.data(), planarOut, k_NumTuples);
+      DREAM3D_REQUIRE(roundTrip == planar)
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestPlanarEulers()
+  {
+    // The way a reader hands out its Phi1, Phi and Phi2 arrays
+    const size_t k_NumTuples = 2500;
+    std::vector<float> phi1(k_NumTuples);
+    std::vector<float> phi(k_NumTuples);
+    std::vector<float> phi2(k_NumTuples);
+    for(size_t i = 0; i < k_NumTuples; i++)
+    {
+      phi1[i] = testValue(i, 0);
+      phi[i] = testValue(i, 1);
+      phi2[i] = testValue(i, 2);
+    }
+
+    EbsdLib::FloatOrientationContainer::Pointer eulers = EbsdLib::FloatOrientationContainer::WrapPlanar({phi1.data(), phi.data(), phi2.data()}, k_NumTuples, "Eulers");
+    DREAM3D_REQUIRE_VALID_POINTER(eulers.get())
+    DREAM3D_REQUIRE(eulers->getLayout() == EbsdLib::FloatOrientationContainer::Layout::Planar)
+    DREAM3D_REQUIRE_EQUAL(eulers->getNumberOfTuples(), k_NumTuples)
+    DREAM3D_REQUIRE_EQUAL(eulers->getNumberOfComponents(), 3)
+    DREAM3D_REQUIRE(eulers->getComponentPointer(1) == phi.data())
+    DREAM3D_REQUIRE(eulers->getInterleavedArray() == nullptr)
+    DREAM3D_REQUIRE_EQUAL(eulers->getValue(17, 2), testValue(17, 2))
+
+    // An interleaved copy for OrientationConverter leaves the container untouched
+    EbsdLib::FloatArrayType::Pointer interleaved = eulers->toInterleaved();
+    DREAM3D_REQUIRE_VALID_POINTER(interleaved.get())
+    DREAM3D_REQUIRE_EQUAL(interleaved->getNumberOfComponents(), 3)
+    DREAM3D_REQUIRE_EQUAL(interleaved->getNumberOfTuples(), k_NumTuples)
+    DREAM3D_REQUIRE(eulers->getLayout() == EbsdLib::FloatOrientationContainer::Layout::Planar)
+    for(size_t i = 0; i < k_NumTuples; i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(interleaved->getValue(i * 3 + 0), phi1[i])
+      DREAM3D_REQUIRE_EQUAL(interleaved->getValue(i * 3 + 1), phi[i])
+      DREAM3D_REQUIRE_EQUAL(interleaved->getValue(i * 3 + 2), phi2[i])
+    }
+
+    // Switching the layout transposes once and then hands out the same array
+    DREAM3D_REQUIRE(eulers->setLayout(EbsdLib::FloatOrientationContainer::Layout::Interleaved))
+    DREAM3D_REQUIRE(eulers->getLayout() == EbsdLib::FloatOrientationContainer::Layout::Interleaved)
+    DREAM3D_REQUIRE(eulers->getPlanarArrays().empty())
+    DREAM3D_REQUIRE(eulers->getComponentPointer(0) == nullptr)
+    DREAM3D_REQUIRE(eulers->toInterleaved() == eulers->getInterleavedArray())
+    eulers->setValue(5, 1, -2.0f);
+    DREAM3D_REQUIRE_EQUAL(eulers->getInterleavedArray()->getValue(5 * 3 + 1), -2.0f)
+    DREAM3D_REQUIRE_EQUAL(phi[5], testValue(5, 1))
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestInterleavedQuats()
+  {
+    // Interleaved quaternions go through the planar SIMD kernels and come back interleaved
+    const size_t k_NumTuples = 1001;
+    EbsdLib::FloatArrayType::Pointer quats = EbsdLib::FloatArrayType::CreateArray(k_NumTuples, {4}, "Quats", true);
+    for(size_t i = 0; i < k_NumTuples; i++)
+    {
+      float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+      quats->setValue(i * 4 + 0, 0.5f);
+      quats->setValue(i * 4 + 1, 0.5f);
+      quats->setValue(i * 4 + 2, 0.5f);
+      quats->setValue(i * 4 + 3, 0.5f * sign);
+    }
+
+    EbsdLib::FloatOrientationContainer::Pointer container = EbsdLib::FloatOrientationContainer::FromInterleaved(quats);
+    DREAM3D_REQUIRE_VALID_POINTER(container.get())
+    DREAM3D_REQUIRE(container->getInterleavedArray() == quats)
+    DREAM3D_REQUIRE(container->setLayout(EbsdLib::FloatOrientationContainer::Layout::Planar))
+    DREAM3D_REQUIRE_EQUAL(container->getPlanarArrays().size(), 4)
+    DREAM3D_REQUIRE_EQUAL(container->getPlanarArrays()[0]->getNumberOfComponents(), 1)
+
+    QuaternionBatchMath::QuatArraysF arrays;
+    arrays.x = container->getComponentPointer(0);
+    arrays.y = container->getComponentPointer(1);
+    arrays.z = container->getComponentPointer(2);
+    arrays.w = container->getComponentPointer(3);
+    QuaternionBatchMath::ToPositiveHemisphere(arrays, arrays, k_NumTuples);
+
+    DREAM3D_REQUIRE(container->setLayout(EbsdLib::FloatOrientationContainer::Layout::Interleaved))
+    EbsdLib::FloatArrayType::Pointer result = container->getInterleavedArray();
+    DREAM3D_REQUIRE(result != quats)
+    for(size_t i = 0; i < k_NumTuples; i++)
+    {
+      float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+      DREAM3D_REQUIRE_EQUAL(result->getValue(i * 4 + 0), 0.5f * sign)
+      DREAM3D_REQUIRE_EQUAL(result->getValue(i * 4 + 3), 0.5f)
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestInvalidInputs()
+  {
+    DREAM3D_REQUIRE(EbsdLib::FloatOrientationContainer::New(10, 0, EbsdLib::FloatOrientationContainer::Layout::Planar, "Empty") == nullptr)
+    DREAM3D_REQUIRE(EbsdLib::FloatOrientationContainer::New(10, 3, EbsdLib::FloatOrientationContainer::Layout::Planar, "") == nullptr)
+    DREAM3D_REQUIRE(EbsdLib::FloatOrientationContainer::FromInterleaved(EbsdLib::FloatArrayType::NullPointer()) == nullptr)
+
+    // DREAM3D_REQUIRE declares its own 'b' so the arrays are not named a, b, c
+    EbsdLib::FloatArrayType::Pointer tenTuples = EbsdLib::FloatArrayType::CreateArray(10, {1}, "A", true);
+    EbsdLib::FloatArrayType::Pointer elevenTuples = EbsdLib::FloatArrayType::CreateArray(11, {1}, "B", true);
+    EbsdLib::FloatArrayType::Pointer threeComps = EbsdLib::FloatArrayType::CreateArray(10, {3}, "C", true);
+    DREAM3D_REQUIRE(EbsdLib::FloatOrientationContainer::FromPlanar({tenTuples, elevenTuples}, "Mismatch") == nullptr)
+    DREAM3D_REQUIRE(EbsdLib::FloatOrientationContainer::FromPlanar({tenTuples, threeComps}, "Mismatch") == nullptr)
+    DREAM3D_REQUIRE_VALID_POINTER(EbsdLib::FloatOrientationContainer::FromPlanar({tenTuples, tenTuples}, "Same").get())
+
+    EbsdLib::DoubleOrientationContainer::Pointer om = EbsdLib::DoubleOrientationContainer::New(10, 9, EbsdLib::DoubleOrientationContainer::Layout::Interleaved, "OM");
+    DREAM3D_REQUIRE_VALID_POINTER(om.get())
+    DREAM3D_REQUIRE_EQUAL(om->getInterleavedArray()->getNumberOfComponents(), 9)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### OrientationContainerTest Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestTransposeKernels())
+    DREAM3D_REGISTER_TEST(TestPlanarEulers())
+    DREAM3D_REGISTER_TEST(TestInterleavedQuats())
+    DREAM3D_REGISTER_TEST(TestInvalidInputs())
+  }
+
+public:
+  OrientationContainerTest(const OrientationContainerTest&) = delete;            // Copy Constructor Not Implemented
+  OrientationContainerTest(OrientationContainerTest&&) = delete;                 // Move Constructor Not Implemented
+  OrientationContainerTest& operator=(const OrientationContainerTest&) = delete; // Copy Assignment Not Implemented
+  OrientationContainerTest& operator=(OrientationContainerTest&&) = delete;      // Move Assignment Not Implemented
+};
@@ -35,6 +35,7 @@
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
@@ -185,10 +186,47 @@ public:
     }
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestFileBackedConversion()
+  {
+    size_t nTuples = 1000;
+    std::vector<size_t> cDims(1, 3);
+    EbsdLib::FloatArrayType::Pointer eulers = EbsdLib::FloatArrayType::CreateFileBackedArray(nTuples, cDims, "Eulers");
+    DREAM3D_REQUIRE_VALID_POINTER(eulers.get())
+    EbsdLib::FloatArrayType::Pointer heapEulers = EbsdLib::FloatArrayType::CreateArray(nTuples, cDims, "Eulers", true);
+    for(size_t i = 0; i < nTuples; i++)
+    {
+      for(int c = 0; c < 3; c++)
+      {
+        float value = static_cast<float>((i * 3 + c) % 90) * EbsdLib::Constants::k_PiOver180;
+        eulers->setComponent(i, c, value);
+        heapEulers->setComponent(i, c, value);
+      }
+    }
+
+    OrientationConverter<EbsdLib::FloatArrayType, float>::Pointer ocEulers = EulerConverter<EbsdLib::FloatArrayType, float>::New();
+    ocEulers->setInputData(eulers);
+    ocEulers->convertRepresentationTo(OrientationRepresentation::Type::Quaternion);
+    EbsdLib::FloatArrayType::Pointer output = ocEulers->getOutputData();
+
+    ocEulers->setInputData(heapEulers);
+    ocEulers->convertRepresentationTo(OrientationRepresentation::Type::Quaternion);
+    EbsdLib::FloatArrayType::Pointer heapOutput = ocEulers->getOutputData();
+
+    // The output of a file backed input is file backed as well
+    DREAM3D_REQUIRE(std::dynamic_pointer_cast<EbsdMappedFileAllocator>(output->getArrayAllocator()) != nullptr)
+    DREAM3D_REQUIRE(heapOutput->getArrayAllocator() == nullptr)
+    DREAM3D_REQUIRE_EQUAL(output->getNumberOfTuples(), nTuples)
+    DREAM3D_REQUIRE(std::equal(output->begin(), output->end(), heapOutput->begin()))
+  }
+
   void operator()()
   {
     int err = 0;
     DREAM3D_REGISTER_TEST(TestEulerConversion());
     DREAM3D_REGISTER_TEST(TestFilterDesign());
+    DREAM3D_REGISTER_TEST(TestFileBackedConversion());
   }
 };
@@ -795,6 +795,78 @@ Orientation Matrix               : | -1.0000   0.0000   0.0000 |
     HO_2_XXX<std::vector<float>>(ho);
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  bool isInline(const Orientation<T>& o)
+  {
+    const char* objBegin = reinterpret_cast<const char*>(&o);
+    const char* ptr = reinterpret_cast<const char*>(o.data());
+    return ptr >= objBegin && ptr < objBegin + sizeof(o);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestInlineStorage()
+  {
+    OrientationType eu(0.1, 0.2, 0.3);
+    DREAM3D_REQUIRE_EQUAL(isInline(eu), true)
+    QuatType qu(0.0, 0.0, 0.0, 1.0);
+    DREAM3D_REQUIRE_EQUAL(isInline(qu), true)
+    OrientationType om(9);
+    DREAM3D_REQUIRE_EQUAL(isInline(om), true)
+    DREAM3D_REQUIRE_EQUAL(om[8], 0.0)
+
+    // Copies get their own inline buffer
+    OrientationType euCopy(eu);
+    DREAM3D_REQUIRE_EQUAL(isInline(euCopy), true)
+    DREAM3D_REQUIRE(euCopy.data() != eu.data())
+    DREAM3D_REQUIRE_EQUAL(euCopy[2], 0.3)
+
+    // Moving out of an inline orientation copies the values
+    OrientationType moved(4);
+    moved = std::move(euCopy);
+    DREAM3D_REQUIRE_EQUAL(isInline(moved), true)
+    DREAM3D_REQUIRE_EQUAL(moved.size(), 3)
+    DREAM3D_REQUIRE_EQUAL(moved[1], 0.2)
+    DREAM3D_REQUIRE_EQUAL(euCopy.size(), 0)
+
+    // Growing past the inline capacity moves the values to the heap and back
+    moved.resize(12);
+    DREAM3D_REQUIRE_EQUAL(isInline(moved), false)
+    DREAM3D_REQUIRE_EQUAL(moved[0], 0.1)
+    DREAM3D_REQUIRE_EQUAL(moved[2], 0.3)
+    DREAM3D_REQUIRE_EQUAL(moved[11], 0.0)
+    moved[3] = 4.0;
+    moved.resize(4);
+    DREAM3D_REQUIRE_EQUAL(isInline(moved), true)
+    DREAM3D_REQUIRE_EQUAL(moved[0], 0.1)
+    DREAM3D_REQUIRE_EQUAL(moved[3], 4.0)
+    moved.resize(6);
+    DREAM3D_REQUIRE_EQUAL(moved[3], 4.0)
+    DREAM3D_REQUIRE_EQUAL(moved[5], 0.0)
+
+    // Wrapped arrays are still used in place and copied out of on resize
+    std::vector<double> values = {1.0, 2.0, 3.0};
+    OrientationType wrapped(values.data(), values.size());
+    DREAM3D_REQUIRE(wrapped.data() == values.data())
+    wrapped.resize(4);
+    DREAM3D_REQUIRE_EQUAL(isInline(wrapped), true)
+    DREAM3D_REQUIRE_EQUAL(wrapped[2], 3.0)
+    DREAM3D_REQUIRE_EQUAL(values[2], 3.0)
+
+    // A conversion chain made entirely of inline temporaries
+    OrientationType ho = OrientationTransformation::eu2ho<OrientationType, OrientationType>(eu);
+    OrientationType eu2 = OrientationTransformation::ho2eu<OrientationType, OrientationType>(ho);
+    DREAM3D_REQUIRE_EQUAL(isInline(eu2), true)
+    for(size_t i = 0; i < 3; i++)
+    {
+      DREAM3D_REQUIRE(std::fabs(eu2[i] - eu[i]) < 1.0E-6)
+    }
+  }
+
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
@@ -926,6 +998,7 @@ Orientation Matrix               : | -1.0000   0.0000   0.0000 |
     DREAM3D_REGISTER_TEST(Test_ho2_XXX());
 
     DREAM3D_REGISTER_TEST(TestInputs());
+    DREAM3D_REGISTER_TEST(TestInlineStorage());
   }
 
 public:
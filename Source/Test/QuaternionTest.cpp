@@ -33,7 +33,10 @@
 *
 * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <cmath>
 #include <limits>
+#include <random>
+#include <vector>
 
 #include <Eigen/Core>
 #include <Eigen/Dense>
@@ -42,6 +45,7 @@
 #include "EbsdLib/Math/EbsdMatrixMath.h"
 #include "EbsdLib/EbsdLib.h"
 #include "EbsdLib/Core/Quaternion.hpp"
+#include "EbsdLib/Math/QuaternionBatchMath.h"
 
 #include "UnitTestSupport.hpp"
 
@@ -343,6 +347,154 @@ public:
     DREAM3D_REQUIRE_EQUAL(pass, true)
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  class BatchQuats
+  {
+  public:
+    explicit BatchQuats(size_t count)
+    : x(count)
+    , y(count)
+    , z(count)
+    , w(count)
+    {
+    }
+
+    QuaternionBatchMath::QuatArrays<T> arrays()
+    {
+      QuaternionBatchMath::QuatArrays<T> a;
+      a.x = x.data();
+      a.y = y.data();
+      a.z = z.data();
+      a.w = w.data();
+      return a;
+    }
+
+    Quaternion<T> get(size_t i) const
+    {
+      return Quaternion<T>(x[i], y[i], z[i], w[i]);
+    }
+
+    void set(size_t i, const Quaternion<T>& q)
+    {
+      x[i] = q.x();
+      y[i] = q.y();
+      z[i] = q.z();
+      w[i] = q.w();
+    }
+
+    std::vector<T> x;
+    std::vector<T> y;
+    std::vector<T> z;
+    std::vector<T> w;
+  };
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  BatchQuats<T> randomBatchQuats(size_t count, unsigned int seed)
+  {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<T> distribution(static_cast<T>(-1.0), static_cast<T>(1.0));
+    BatchQuats<T> quats(count);
+    for(size_t i = 0; i < count; i++)
+    {
+      quats.set(i, Quaternion<T>(distribution(generator), distribution(generator), distribution(generator), distribution(generator)).unitQuaternion());
+    }
+    return quats;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  void requireSameQuat(const Quaternion<T>& expected, const Quaternion<T>& actual)
+  {
+    const T tolerance = static_cast<T>(1.0E-5);
+    DREAM3D_REQUIRE(std::fabs(expected.x() - actual.x()) <= tolerance)
+    DREAM3D_REQUIRE(std::fabs(expected.y() - actual.y()) <= tolerance)
+    DREAM3D_REQUIRE(std::fabs(expected.z() - actual.z()) <= tolerance)
+    DREAM3D_REQUIRE(std::fabs(expected.w() - actual.w()) <= tolerance)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  void TestQuaternionBatchMath()
+  {
+    // An odd count exercises the scalar tail after the full SIMD registers
+    const size_t k_Count = 1003;
+    BatchQuats<T> a = randomBatchQuats<T>(k_Count, 5489);
+    BatchQuats<T> b = randomBatchQuats<T>(k_Count, 1234);
+    const Quaternion<T> q = Quaternion<T>(0.25, -0.5, 0.125, 0.75).unitQuaternion();
+
+    const QuaternionBatchMath::Implementation impls[2] = {QuaternionBatchMath::Implementation::Scalar, QuaternionBatchMath::Implementation::Auto};
+    for(QuaternionBatchMath::Implementation impl : impls)
+    {
+      BatchQuats<T> out(k_Count);
+      QuaternionBatchMath::PreMultiply(q, a.arrays(), out.arrays(), k_Count, impl);
+      for(size_t i = 0; i < k_Count; i++)
+      {
+        requireSameQuat<T>(q * a.get(i), out.get(i));
+      }
+
+      QuaternionBatchMath::PostMultiply(a.arrays(), q, out.arrays(), k_Count, impl);
+      for(size_t i = 0; i < k_Count; i++)
+      {
+        requireSameQuat<T>(a.get(i) * q, out.get(i));
+      }
+
+      QuaternionBatchMath::Multiply(a.arrays(), b.arrays(), out.arrays(), k_Count, impl);
+      for(size_t i = 0; i < k_Count; i++)
+      {
+        requireSameQuat<T>(a.get(i) * b.get(i), out.get(i));
+      }
+
+      QuaternionBatchMath::Conjugate(a.arrays(), out.arrays(), k_Count, impl);
+      for(size_t i = 0; i < k_Count; i++)
+      {
+        requireSameQuat<T>(a.get(i).conjugate(), out.get(i));
+      }
+
+      BatchQuats<T> scaled = a;
+      for(size_t i = 0; i < k_Count; i++)
+      {
+        Quaternion<T> s = a.get(i);
+        s.scalarMultiply(static_cast<T>(i % 7 + 1));
+        scaled.set(i, s);
+      }
+      QuaternionBatchMath::Normalize(scaled.arrays(), out.arrays(), k_Count, impl);
+      for(size_t i = 0; i < k_Count; i++)
+      {
+        requireSameQuat<T>(scaled.get(i).unitQuaternion(), out.get(i));
+      }
+
+      QuaternionBatchMath::ToPositiveHemisphere(a.arrays(), out.arrays(), k_Count, impl);
+      for(size_t i = 0; i < k_Count; i++)
+      {
+        Quaternion<T> expected = a.get(i);
+        if(expected.w() < 0)
+        {
+          expected.negate();
+        }
+        requireSameQuat<T>(expected, out.get(i));
+        DREAM3D_REQUIRE(out.w[i] >= 0)
+      }
+
+      // The output may be the same arrays as the input
+      BatchQuats<T> inPlace = a;
+      QuaternionBatchMath::Multiply(inPlace.arrays(), b.arrays(), inPlace.arrays(), k_Count, impl);
+      for(size_t i = 0; i < k_Count; i++)
+      {
+        requireSameQuat<T>(a.get(i) * b.get(i), inPlace.get(i));
+      }
+    }
+  }
+
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
@@ -353,6 +505,8 @@ public:
     int err = EXIT_SUCCESS;
     DREAM3D_REGISTER_TEST(TestEbsdMatrixMath())
     DREAM3D_REGISTER_TEST(TestQuat_t())
+    DREAM3D_REGISTER_TEST(TestQuaternionBatchMath<float>())
+    DREAM3D_REGISTER_TEST(TestQuaternionBatchMath<double>())
     DREAM3D_REGISTER_TEST(RemoveTestFiles())
   }
 
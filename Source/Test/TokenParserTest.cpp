@@ -0,0 +1,225 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without
+* modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of
+* its
+* contributors may be used to endorse or promote products derived from this
+* software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+
+#include "EbsdLib/IO/EbsdTokenParser.hpp"
+
+#include "UnitTestSupport.hpp"
+
+#include "EbsdLib/Test/EbsdLibTestFileLocations.h"
+
+class TokenParserTest
+{
+public:
+  TokenParserTest() = default;
+  virtual ~TokenParserTest() = default;
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+// QFile::remove();
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  // Builds a block of .ang style data lines with the same kinds of values a real file has
+  // -----------------------------------------------------------------------------
+  QByteArray generateDataLines(size_t numLines)
+  {
+    std::mt19937_64 generator(5489);
+    std::uniform_real_distribution<float> angles(0.0f, 6.28318f);
+    std::uniform_real_distribution<float> positions(0.0f, 500.0f);
+    std::uniform_real_distribution<float> quality(0.0f, 5000.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> phases(0, 3);
+
+    QByteArray data;
+    data.reserve(static_cast<int>(numLines * 96));
+    QByteArray line;
+    for(size_t i = 0; i < numLines; i++)
+    {
+      line.clear();
+      line.append(QByteArray::number(angles(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(angles(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(angles(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(positions(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(positions(generator), 'f', 5)).append(' ');
+      line.append(QByteArray::number(quality(generator), 'f', 1)).append(' ');
+      line.append(QByteArray::number(unit(generator), 'f', 3)).append(' ');
+      line.append(QByteArray::number(phases(generator))).append(' ');
+      line.append(QByteArray::number(unit(generator), 'g', 9)).append(' ');
+      line.append(QByteArray::number(unit(generator) * 1.0E-7, 'e', 12)).append('\n');
+      data.append(line);
+    }
+    return data;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestIntegers()
+  {
+    QList<QByteArray> values = {"0", "-0", "+17", "2147483647", "-2147483648", "2147483648", "-2147483649", "99999999999", "1.0", "1,0", "", " ", "-", "x1", "1x", "0x10"};
+    for(const auto& value : values)
+    {
+      bool qtOk = false;
+      int32_t qtValue = value.toInt(&qtOk, 10);
+      bool ok = false;
+      int32_t parsed = EbsdLib::TokenParser::toInt32(value.constData(), value.constData() + value.size(), &ok);
+      DREAM3D_REQUIRE_EQUAL(ok, qtOk)
+      DREAM3D_REQUIRE_EQUAL(parsed, qtValue)
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestFloats()
+  {
+    QList<QByteArray> values = {"0",     "-0",     "1",          "-1.5",          "0.00001",           "3.14159",             "1e5",  "1E-5",  "+2.5", ".5",  "5.",
+                                "1e39",  "1e-50",  "3.4028235e38", "123456789012345678", "0.1234567890123456789", "1.0e-300", "nan", "inf", "-inf", "",    "-",
+                                "e5",    "1e",     "1.5.",       "1,5",           "1 5",               "abc",                 "1e+",  "-.e1"};
+    for(const auto& value : values)
+    {
+      bool qtOk = false;
+      float qtValue = value.toFloat(&qtOk);
+      bool ok = false;
+      float parsed = EbsdLib::TokenParser::toFloat(value.constData(), value.constData() + value.size(), &ok);
+      DREAM3D_REQUIRE_EQUAL(ok, qtOk)
+      if(ok && !std::isnan(qtValue))
+      {
+        DREAM3D_REQUIRE(::memcmp(&parsed, &qtValue, sizeof(float)) == 0)
+      }
+    }
+
+    // European style decimals
+    bool ok = false;
+    QByteArray comma("-12,625");
+    float parsed = EbsdLib::TokenParser::toFloat(comma.constData(), comma.constData() + comma.size(), &ok, EbsdLib::TokenParser::DecimalSeparator::PointOrComma);
+    DREAM3D_REQUIRE_EQUAL(ok, true)
+    DREAM3D_REQUIRE_EQUAL(parsed, -12.625f)
+    parsed = EbsdLib::TokenParser::toFloat(comma.constData(), comma.constData() + comma.size(), &ok, EbsdLib::TokenParser::DecimalSeparator::Comma);
+    DREAM3D_REQUIRE_EQUAL(ok, true)
+    DREAM3D_REQUIRE_EQUAL(parsed, -12.625f)
+    parsed = EbsdLib::TokenParser::toFloat(comma.constData(), comma.constData() + comma.size(), &ok, EbsdLib::TokenParser::DecimalSeparator::Point);
+    DREAM3D_REQUIRE_EQUAL(ok, false)
+    QByteArray point("0.5");
+    EbsdLib::TokenParser::toFloat(point.constData(), point.constData() + point.size(), &ok, EbsdLib::TokenParser::DecimalSeparator::Comma);
+    DREAM3D_REQUIRE_EQUAL(ok, false)
+
+    // Every value of a generated data block must match Qt bit for bit
+    QByteArray data = generateDataLines(20000);
+    QList<QByteArray> tokens = data.simplified().split(' ');
+    for(const auto& token : tokens)
+    {
+      bool qtOk = false;
+      float qtValue = token.toFloat(&qtOk);
+      parsed = EbsdLib::TokenParser::toFloat(token.constData(), token.constData() + token.size(), &ok);
+      DREAM3D_REQUIRE_EQUAL(ok, qtOk)
+      DREAM3D_REQUIRE(::memcmp(&parsed, &qtValue, sizeof(float)) == 0)
+
+      QByteArray european = token;
+      european.replace('.', ',');
+      parsed = EbsdLib::TokenParser::toFloat(european.constData(), european.constData() + european.size(), &ok, EbsdLib::TokenParser::DecimalSeparator::PointOrComma);
+      DREAM3D_REQUIRE_EQUAL(ok, qtOk)
+      DREAM3D_REQUIRE(::memcmp(&parsed, &qtValue, sizeof(float)) == 0)
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestSplit()
+  {
+    EbsdLib::TokenParser::Token tokens[4];
+    QList<QByteArray> lines = {"a\t\tb\t", "", "\t", "a", "a\tb\tc\td\te\tf"};
+    for(const auto& line : lines)
+    {
+      QList<QByteArray> qtTokens = line.split('\t');
+      int numTokens = EbsdLib::TokenParser::split(line.constData(), line.constData() + line.size(), '\t', tokens, 4);
+      DREAM3D_REQUIRE_EQUAL(numTokens, qtTokens.size())
+      for(int t = 0; t < std::min(numTokens, 4); t++)
+      {
+        DREAM3D_REQUIRE(QByteArray(tokens[t].first, static_cast<int>(tokens[t].last - tokens[t].first)) == qtTokens[t])
+      }
+    }
+
+    lines = {"  1.0   2.0\t3.0 \r\n", "", "   ", "1", " 1 2 3 4 5 6 "};
+    for(const auto& line : lines)
+    {
+      QList<QByteArray> qtTokens = line.simplified().split(' ');
+      int numTokens = EbsdLib::TokenParser::splitOnWhiteSpace(line.constData(), line.constData() + line.size(), tokens, 4);
+      DREAM3D_REQUIRE_EQUAL(numTokens, qtTokens.size())
+      for(int t = 0; t < std::min(numTokens, 4); t++)
+      {
+        DREAM3D_REQUIRE(QByteArray(tokens[t].first, static_cast<int>(tokens[t].last - tokens[t].first)) == qtTokens[t])
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    std::cout << "#### TokenParserTest Starting ####" << std::endl;
+
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestIntegers())
+    DREAM3D_REGISTER_TEST(TestFloats())
+    DREAM3D_REGISTER_TEST(TestSplit())
+    DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  }
+
+public:
+  TokenParserTest(const TokenParserTest&) = delete;            // Copy Constructor Not Implemented
+  TokenParserTest(TokenParserTest&&) = delete;                 // Move Constructor Not Implemented
+  TokenParserTest& operator=(const TokenParserTest&) = delete; // Copy Assignment Not Implemented
+  TokenParserTest& operator=(TokenParserTest&&) = delete;      // Move Assignment Not Implemented
+};